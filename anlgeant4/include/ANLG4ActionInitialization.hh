@@ -0,0 +1,71 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef ANLGEANT4_ANLG4ActionInitialization_H
+#define ANLGEANT4_ANLG4ActionInitialization_H 1
+
+#include "G4VUserActionInitialization.hh"
+#include <list>
+
+class G4VUserPrimaryGeneratorAction;
+
+namespace anlgeant4
+{
+
+class ANLG4MTRunManager;
+class InitialInformation;
+class VUserActionAssembly;
+
+/**
+ * User action initialization for the multithreaded mode of Geant4Body.
+ *
+ * Each worker thread gets its own primary generator action, which calls the
+ * primary generator of the ANL module under ANLG4MTRunManager::PrimaryGeneratorMutex(),
+ * and its own event action, which hands off the completed event to the run manager.
+ * The initial information set by the primary generator is staged in the worker
+ * thread and recorded with the event.
+ * The run actions of the user action assemblies are invoked on the master thread,
+ * and their event actions are invoked on the analysis thread by the run manager.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ * @date 2026-10-17 | primary generator runs without the ANL module lock
+ */
+class ANLG4ActionInitialization : public G4VUserActionInitialization
+{
+public:
+  ANLG4ActionInitialization(ANLG4MTRunManager* runManager,
+                            G4VUserPrimaryGeneratorAction* primaryGenerator,
+                            InitialInformation* initialInfo,
+                            const std::list<VUserActionAssembly*>& userActions);
+  virtual ~ANLG4ActionInitialization();
+
+  void Build() const override;
+  void BuildForMaster() const override;
+
+private:
+  ANLG4MTRunManager* runManager_;
+  G4VUserPrimaryGeneratorAction* primaryGenerator_;
+  InitialInformation* initialInfo_;
+  std::list<VUserActionAssembly*> userActions_;
+};
+
+} /* namespace anlgeant4 */
+
+#endif /* ANLGEANT4_ANLG4ActionInitialization_H */
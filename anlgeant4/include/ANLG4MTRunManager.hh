@@ -0,0 +1,145 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef ANLGEANT4_ANLG4MTRunManager_H
+#define ANLGEANT4_ANLG4MTRunManager_H 1
+
+#include "G4MTRunManager.hh"
+#include <anlnext/ANLStatus.hh>
+#include "InitialInformation.hh"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace anlgeant4
+{
+
+class VUserActionAssembly;
+class WorkerEventRecord;
+
+/**
+ * Multithreaded run manager used by Geant4Body.
+ *
+ * Events are simulated by the Geant4 worker threads, which share the geometry
+ * and the physics tables. Every completed event is handed off as a
+ * WorkerEventRecord, and receiveOneEvent() delivers the records to the ANL
+ * analysis thread in the order of the event ID, so that the following ANL
+ * modules see the same event sequence as in the sequential mode.
+ * The number of events waiting for the delivery is bounded; a worker that
+ * runs too far ahead of the analysis thread waits in handOffEvent().
+ *
+ * Worker threads must not modify ANL modules; they defer the modifications
+ * into the WorkerEventRecord of the event. The only exception is the primary
+ * generator module, which the workers call in turn under PrimaryGeneratorMutex().
+ * The analysis thread never takes this mutex, so that the workers can generate
+ * the next events while the ANL modules analyze the current one.
+ * The initial information written by the primary generator goes to a staging
+ * area of the worker thread (see InitialInformation::setStagingArea()).
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ * @date 2026-10-17 | primary generator runs without the ANL module lock
+ */
+class ANLG4MTRunManager : public G4MTRunManager
+{
+public:
+  ANLG4MTRunManager();
+  virtual ~ANLG4MTRunManager();
+
+  /**
+   * set the event actions of the user action assemblies,
+   * which are invoked on the analysis thread when an event is delivered.
+   */
+  void setEventActions(const std::list<VUserActionAssembly*>& userActions)
+  { eventActions_ = userActions; }
+
+  void setEventQueueCapacity(int v) { eventQueueCapacity_ = v; }
+  int EventQueueCapacity() const { return eventQueueCapacity_; }
+
+  /**
+   * register a function called on each worker thread when it starts,
+   * e.g. to attach thread-local sensitive detectors.
+   */
+  void addWorkerInitialization(std::function<void()> func);
+  void performWorkerInitializations();
+
+  std::mutex& PrimaryGeneratorMutex() { return primaryGeneratorMutex_; }
+
+  /**
+   * set the initial information of the primary generator module.
+   * Its values at beginEventHandOff() are the defaults of every event.
+   */
+  void setInitialInformation(InitialInformation* v) { initialInfo_ = v; }
+  const InitialInformation::Values& InitialValues() const { return initialValues_; }
+
+  /**
+   * start the worker threads for the given number of events.
+   * This should be called after RunInitialization().
+   */
+  void beginEventHandOff(G4int numberOfEvents);
+
+  /**
+   * stop accepting events. The workers still running are aborted.
+   * This should be called before RunTermination().
+   */
+  void endEventHandOff();
+
+  /**
+   * (analysis thread) wait for the next event and deliver it.
+   * @return AS_QUIT if all the events have been delivered.
+   */
+  anlnext::ANLStatus receiveOneEvent();
+
+  /**
+   * (worker thread) hand off a completed event.
+   * @return false if the hand-off has been closed.
+   */
+  bool handOffEvent(std::unique_ptr<WorkerEventRecord>&& record);
+
+  /**
+   * (worker thread) notify that the worker finished its event loop.
+   */
+  void notifyWorkerRunEnd();
+
+private:
+  std::list<VUserActionAssembly*> eventActions_;
+  std::list<std::function<void()>> workerInitializations_;
+  int eventQueueCapacity_;
+
+  std::mutex primaryGeneratorMutex_;
+  InitialInformation* initialInfo_ = nullptr;
+  InitialInformation::Values initialValues_;
+
+  std::mutex queueMutex_;
+  std::condition_variable eventHandedOff_;
+  std::condition_variable eventDelivered_;
+  std::map<G4int, std::unique_ptr<WorkerEventRecord>> completedEvents_;
+  G4int nextEventID_ = 0;
+  G4int numberOfEvents_ = 0;
+  int numberOfWorkersFinished_ = 0;
+  bool handOffClosed_ = true;
+};
+
+} /* namespace anlgeant4 */
+
+#endif /* ANLGEANT4_ANLG4MTRunManager_H */
@@ -22,6 +22,8 @@
 
 #include <string>
 #include <memory>
+#include <list>
+#include <functional>
 #include <anlnext/BasicModule.hh>
 #include "globals.hh"
 
@@ -30,18 +32,32 @@ namespace CLHEP
 class HepRandomEngine;
 }
 
+class G4VUserPrimaryGeneratorAction;
+
 namespace anlgeant4
 {
 
 class ANLG4RunManager;
+class ANLG4MTRunManager;
 
 /**
+ * Geant4 run manager module.
+ *
+ * If number_of_threads is positive, the events are simulated by the Geant4
+ * worker threads (multithreaded mode). number_of_events should then be set to
+ * the number of events processed by the ANL loop. The events are handed off to
+ * the following modules in the order of the event ID; see ANLG4MTRunManager.
+ * The user action assemblies must support this mode (see
+ * VUserActionAssembly::isMultithreadingSupported()).
+ *
  * @author Hirokazu Odaka
  * @date 2017-07-28 | 3.0, re-designed.
+ * @date 2026-10-17 | 3.1, multithreaded mode.
+ * @date 2026-10-17 | 3.2, worker initializations are registered before the run manager is initialized.
  */
 class Geant4Body : public anlnext::BasicModule
 {
-  DEFINE_ANL_MODULE(Geant4Body, 3.0);
+  DEFINE_ANL_MODULE(Geant4Body, 3.2);
 public: 
   Geant4Body();
   ~Geant4Body();
@@ -55,7 +71,18 @@ public:
 
   void set_verbose_level(G4int v) { m_VerboseLevel = v; }
   G4int get_verbose_level() { return m_VerboseLevel; }
-  
+
+  bool isMultithreaded() const { return m_NumberOfThreads > 0; }
+
+  /**
+   * (multithreaded mode) register a function called on each worker thread
+   * when it starts, e.g. to attach thread-local sensitive detectors.
+   * The worker threads start in mod_initialize() of this module, so a module
+   * must call this function in its mod_initialize() placed before this module.
+   * @return false if the worker threads have already started.
+   */
+  bool addWorkerInitialization(std::function<void()> func);
+
 protected:
   virtual void initialize_random_generator();
   virtual void set_user_initializations();
@@ -63,10 +90,21 @@ protected:
   virtual void set_user_defined_actions();
   virtual void apply_commands();
 
+private:
+  bool check_multithreading_support();
+
 private:
   std::unique_ptr<ANLG4RunManager> m_G4RunManager;
+  std::unique_ptr<ANLG4MTRunManager> m_G4MTRunManager;
+  std::unique_ptr<G4VUserPrimaryGeneratorAction> m_PrimaryGeneratorAction;
   std::unique_ptr<CLHEP::HepRandomEngine> m_RandomEnginePtr;
   int m_EventIndex = 0;
+  std::list<std::function<void()>> m_WorkerInitializations;
+  bool m_WorkersStarted = false;
+
+  int m_NumberOfThreads;
+  int m_NumberOfEvents;
+  int m_EventQueueCapacity;
   
   std::string m_RandomEngine;
   int m_RandomInitMode;
@@ -32,9 +32,21 @@ namespace anlgeant4 {
 /**
  * store initial particle information
  * @author Hirokazu Odaka
+ * @date 2026-10-17 | Hirokazu Odaka | staging area for the worker threads of the multithreaded mode
  */
 class InitialInformation
 {
+public:
+  struct Values
+  {
+    double energy = 0.0;
+    G4ThreeVector direction = G4ThreeVector(0.0, 0.0, -1.0);
+    double time = 0.0;
+    G4ThreeVector position = G4ThreeVector(0.0, 0.0, 0.0);
+    G4ThreeVector polarization = G4ThreeVector(0.0, 0.0, 0.0);
+    double weight = 1.0;
+  };
+
 public:
   explicit InitialInformation(bool stored, anlnext::BasicModule* mod=nullptr);
 
@@ -43,47 +55,59 @@ public:
   bool WeightStored() const { return weight_stored_; }
   void setWeightStored(bool v=true) { weight_stored_ = v; }
 
-  double InitialEnergy() const              { return energy_; }
-  G4ThreeVector InitialDirection() const    { return direction_; }
-  double InitialTime() const                { return time_; }
-  G4ThreeVector InitialPosition() const     { return position_; }
-  G4ThreeVector InitialPolarization() const { return polarization_; }
+  double InitialEnergy() const              { return values().energy; }
+  G4ThreeVector InitialDirection() const    { return values().direction; }
+  double InitialTime() const                { return values().time; }
+  G4ThreeVector InitialPosition() const     { return values().position; }
+  G4ThreeVector InitialPolarization() const { return values().polarization; }
   
   int64_t EventID() const { return event_id_; }
-  double Weight() const { return weight_; }
+  double Weight() const { return values().weight; }
 
   void setEventID(int64_t i) { event_id_ = i; }
 
   void setInitialEnergy(double v)
-  { energy_ = v; }
+  { values().energy = v; }
   void setInitialDirection(G4ThreeVector v)
-  { direction_ = v;    }
+  { values().direction = v;    }
   void setInitialDirection(double x, double y, double z)
-  { direction_.set(x, y, z); }
+  { values().direction.set(x, y, z); }
   void setInitialTime(double v)
-  { time_ = v; }
+  { values().time = v; }
   void setInitialPosition(G4ThreeVector v)
-  { position_ = v; }
+  { values().position = v; }
   void setInitialPosition(double x, double y, double z)
-  { position_.set(x, y, z); }
+  { values().position.set(x, y, z); }
   void setInitialPolarization(G4ThreeVector v)
-  { polarization_ = v; }
+  { values().polarization = v; }
   void setInitialPolarization(double x, double y, double z)
-  { polarization_.set(x, y, z); }
+  { values().polarization.set(x, y, z); }
   
-  void setWeight(double v) { weight_ = v; }
+  void setWeight(double v) { values().weight = v; }
+
+  Values getValues() const { return values(); }
+  void setValues(const Values& v) { values() = v; }
+
+  /**
+   * redirect the initial information accessed by the calling thread to the given area.
+   * A worker thread of the multithreaded mode sets it while calling the primary generator,
+   * so that the generator does not overwrite the information of the event being analyzed.
+   * @param v staging area, or nullptr to stop the redirection.
+   */
+  static void setStagingArea(Values* v) { staging_ = v; }
 
 private:
+  Values& values() { return staging_ ? *staging_ : values_; }
+  const Values& values() const { return staging_ ? *staging_ : values_; }
+
+private:
+  static thread_local Values* staging_;
+
   bool stored_;
   bool weight_stored_;
 
-  double energy_;
-  G4ThreeVector direction_;
-  double time_;
-  G4ThreeVector position_;
-  G4ThreeVector polarization_;
+  Values values_;
   int64_t event_id_;
-  double weight_;
 };
 
 } /* namespace anlgeant4 */
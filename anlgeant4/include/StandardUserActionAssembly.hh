@@ -32,6 +32,7 @@ class InitialInformation;
  * @date 2011-04-11
  * @date 2016-07-08 | setInitialTime()
  * @date 2017-06-28 | Hirokazu Odaka | redesign, rename class and methods
+ * @date 2026-10-17 | Hirokazu Odaka | support of the multithreaded mode
  */
 class StandardUserActionAssembly : public VMasterUserActionAssembly
 {
@@ -43,6 +44,8 @@ public:
 
   void EventActionAtBeginning(const G4Event* anEvent) override;
 
+  bool isMultithreadingSupported() const override { return !hasStackingAction(); }
+
 protected:
   double getInitialTime() const;
   void setInitialTime(double v);
@@ -44,6 +44,7 @@ public:
   virtual ~VMasterUserActionAssembly();
 
   void registerUserActions(G4RunManager* run_manager) override;
+  std::list<VUserActionAssembly*> userActionList() override;
 
   bool hasStackingAction() const { return (stackingAction_!=nullptr); }
   void appendUserActions(VAppendableUserActionAssembly* user_action_assembly);
@@ -22,6 +22,7 @@
 #define ANLGEANT4_VUserActionAssembly_H 1
 
 #include <anlnext/BasicModule.hh>
+#include <list>
 
 class G4Event;
 class G4Track;
@@ -39,6 +40,7 @@ namespace anlgeant4
  * @author Hirokazu Odaka
  * @date 2012-05-30 | Hirokazu Odaka | redesign (originally came from VPickUpData by Shin Watanabe)
  * @date 2017-06-28 | Hirokazu Odaka | redesign, rename class and methods
+ * @date 2026-10-17 | Hirokazu Odaka | support of the multithreaded mode
  */
 class VUserActionAssembly : public anlnext::BasicModule
 {
@@ -62,6 +64,20 @@ public:
 
   virtual void registerUserActions(G4RunManager* run_manager);
 
+  /**
+   * @return list of the user action assemblies invoked by the user actions,
+   * i.e., this module followed by the appended ones.
+   */
+  virtual std::list<VUserActionAssembly*> userActionList();
+
+  /**
+   * In the multithreaded mode of Geant4Body, the run actions are invoked on
+   * the master thread, and the event actions on the analysis thread when
+   * the event is delivered. The tracking and stepping actions are never invoked.
+   * A module which works correctly under this condition should return true.
+   */
+  virtual bool isMultithreadingSupported() const { return false; }
+
 protected:
   void enableSteppingAction() { steppingActionEnabled_ = true; }
   void disableSteppingAction() { steppingActionEnabled_ = false; }
@@ -0,0 +1,86 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef ANLGEANT4_WorkerEventRecord_H
+#define ANLGEANT4_WorkerEventRecord_H 1
+
+#include <memory>
+#include <vector>
+#include <functional>
+#include "globals.hh"
+
+namespace anlgeant4
+{
+
+/**
+ * A record of an event simulated by a worker thread in the multithreaded mode.
+ * Objects running on a worker thread (e.g. sensitive detectors) must not
+ * modify the ANL modules, which belong to the analysis thread. Instead, they
+ * defer such modifications into the record of the current event, and the
+ * deferred actions are performed on the analysis thread in the event order.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class WorkerEventRecord
+{
+public:
+  explicit WorkerEventRecord(G4int eventID);
+  ~WorkerEventRecord();
+  WorkerEventRecord(const WorkerEventRecord&) = delete;
+  WorkerEventRecord& operator=(const WorkerEventRecord&) = delete;
+
+  G4int EventID() const { return eventID_; }
+
+  /**
+   * register an action that will be performed on the analysis thread
+   * when this event is handed off.
+   */
+  void defer(std::function<void()> action)
+  { actions_.push_back(std::move(action)); }
+
+  /**
+   * perform all the deferred actions in the registration order.
+   */
+  void apply();
+
+  /**
+   * @return the record of the event being simulated by the calling thread,
+   * or nullptr if the calling thread is not a worker thread in the multithreaded mode.
+   */
+  static WorkerEventRecord* current();
+
+  /**
+   * start a new record for the calling thread.
+   */
+  static WorkerEventRecord* begin(G4int eventID);
+
+  /**
+   * detach the record from the calling thread.
+   */
+  static std::unique_ptr<WorkerEventRecord> release();
+
+private:
+  G4int eventID_;
+  std::vector<std::function<void()>> actions_;
+};
+
+} /* namespace anlgeant4 */
+
+#endif /* ANLGEANT4_WorkerEventRecord_H */
@@ -0,0 +1,147 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ANLG4ActionInitialization.hh"
+
+#include <mutex>
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+#include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4UserEventAction.hh"
+#include "G4UserRunAction.hh"
+
+#include "ANLG4MTRunManager.hh"
+#include "InitialInformation.hh"
+#include "UserActionAssemblyRunAction.hh"
+#include "WorkerEventRecord.hh"
+
+namespace anlgeant4
+{
+
+namespace
+{
+
+class WorkerPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
+{
+public:
+  WorkerPrimaryGeneratorAction(ANLG4MTRunManager* runManager,
+                               G4VUserPrimaryGeneratorAction* primaryGenerator,
+                               InitialInformation* initialInfo)
+    : runManager_(runManager),
+      primaryGenerator_(primaryGenerator),
+      initialInfo_(initialInfo)
+  {
+  }
+
+  void GeneratePrimaries(G4Event* anEvent) override
+  {
+    WorkerEventRecord* record = WorkerEventRecord::begin(anEvent->GetEventID());
+
+    InitialInformation::Values values = runManager_->InitialValues();
+    {
+      std::lock_guard<std::mutex> lock(runManager_->PrimaryGeneratorMutex());
+      InitialInformation::setStagingArea(&values);
+      primaryGenerator_->GeneratePrimaries(anEvent);
+      InitialInformation::setStagingArea(nullptr);
+    }
+
+    if (initialInfo_) {
+      InitialInformation* info = initialInfo_;
+      record->defer([info, values]() {
+          info->setValues(values);
+        });
+    }
+  }
+
+private:
+  ANLG4MTRunManager* runManager_;
+  G4VUserPrimaryGeneratorAction* primaryGenerator_;
+  InitialInformation* initialInfo_;
+};
+
+class WorkerEventAction : public G4UserEventAction
+{
+public:
+  explicit WorkerEventAction(ANLG4MTRunManager* runManager)
+    : runManager_(runManager)
+  {
+  }
+
+  void EndOfEventAction(const G4Event* anEvent) override
+  {
+    std::unique_ptr<WorkerEventRecord> record = WorkerEventRecord::release();
+    if (!record) {
+      record.reset(new WorkerEventRecord(anEvent->GetEventID()));
+    }
+
+    if (!runManager_->handOffEvent(std::move(record))) {
+      G4RunManager::GetRunManager()->AbortRun(true);
+    }
+  }
+
+private:
+  ANLG4MTRunManager* runManager_;
+};
+
+class WorkerRunAction : public G4UserRunAction
+{
+public:
+  explicit WorkerRunAction(ANLG4MTRunManager* runManager)
+    : runManager_(runManager)
+  {
+  }
+
+  void EndOfRunAction(const G4Run*) override
+  {
+    runManager_->notifyWorkerRunEnd();
+  }
+
+private:
+  ANLG4MTRunManager* runManager_;
+};
+
+} /* anonymous namespace */
+
+ANLG4ActionInitialization::
+ANLG4ActionInitialization(ANLG4MTRunManager* runManager,
+                          G4VUserPrimaryGeneratorAction* primaryGenerator,
+                          InitialInformation* initialInfo,
+                          const std::list<VUserActionAssembly*>& userActions)
+  : runManager_(runManager),
+    primaryGenerator_(primaryGenerator),
+    initialInfo_(initialInfo),
+    userActions_(userActions)
+{
+}
+
+ANLG4ActionInitialization::~ANLG4ActionInitialization() = default;
+
+void ANLG4ActionInitialization::Build() const
+{
+  SetUserAction(new WorkerPrimaryGeneratorAction(runManager_, primaryGenerator_, initialInfo_));
+  SetUserAction(new WorkerEventAction(runManager_));
+  SetUserAction(new WorkerRunAction(runManager_));
+}
+
+void ANLG4ActionInitialization::BuildForMaster() const
+{
+  SetUserAction(new UserActionAssemblyRunAction(userActions_));
+}
+
+} /* namespace anlgeant4 */
@@ -0,0 +1,179 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ANLG4MTRunManager.hh"
+
+#include "G4Event.hh"
+#include "G4UserWorkerInitialization.hh"
+
+#include "VUserActionAssembly.hh"
+#include "WorkerEventRecord.hh"
+
+namespace anlgeant4
+{
+
+namespace
+{
+
+class ANLG4WorkerInitialization : public G4UserWorkerInitialization
+{
+public:
+  explicit ANLG4WorkerInitialization(ANLG4MTRunManager* runManager)
+    : runManager_(runManager)
+  {
+  }
+
+  void WorkerStart() const override
+  {
+    runManager_->performWorkerInitializations();
+  }
+
+private:
+  ANLG4MTRunManager* runManager_;
+};
+
+constexpr int EventQueueCapacityPerThread = 16;
+
+} /* anonymous namespace */
+
+ANLG4MTRunManager::ANLG4MTRunManager()
+  : eventQueueCapacity_(0)
+{
+  SetUserInitialization(new ANLG4WorkerInitialization(this));
+}
+
+ANLG4MTRunManager::~ANLG4MTRunManager() = default;
+
+void ANLG4MTRunManager::addWorkerInitialization(std::function<void()> func)
+{
+  workerInitializations_.push_back(std::move(func));
+}
+
+void ANLG4MTRunManager::performWorkerInitializations()
+{
+  for (auto& func: workerInitializations_) {
+    func();
+  }
+}
+
+void ANLG4MTRunManager::beginEventHandOff(G4int numberOfEvents)
+{
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    completedEvents_.clear();
+    nextEventID_ = 0;
+    numberOfEvents_ = numberOfEvents;
+    numberOfWorkersFinished_ = 0;
+    handOffClosed_ = false;
+    if (eventQueueCapacity_ < 1) {
+      eventQueueCapacity_ = EventQueueCapacityPerThread * GetNumberOfThreads();
+    }
+  }
+
+  // the workers start from a copy taken before any event is delivered.
+  if (initialInfo_) {
+    initialValues_ = initialInfo_->getValues();
+  }
+
+  // G4MTRunManager assigns event IDs 0, 1, 2, ... on demand;
+  // one event per request keeps the workers close to the delivery order.
+  SetEventModulo(1);
+  InitializeEventLoop(numberOfEvents, nullptr, -1);
+}
+
+void ANLG4MTRunManager::endEventHandOff()
+{
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    handOffClosed_ = true;
+    completedEvents_.clear();
+  }
+  eventDelivered_.notify_all();
+  eventHandedOff_.notify_all();
+}
+
+anlnext::ANLStatus ANLG4MTRunManager::receiveOneEvent()
+{
+  std::unique_ptr<WorkerEventRecord> record;
+  {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    if (nextEventID_ >= numberOfEvents_) {
+      return anlnext::AS_QUIT;
+    }
+
+    eventHandedOff_.wait(lock, [this]() {
+        return handOffClosed_
+          || completedEvents_.count(nextEventID_) > 0
+          || numberOfWorkersFinished_ == GetNumberOfThreads();
+      });
+
+    auto it = completedEvents_.find(nextEventID_);
+    if (it == completedEvents_.end()) {
+      // the run has been aborted.
+      return anlnext::AS_QUIT;
+    }
+
+    record = std::move((*it).second);
+    completedEvents_.erase(it);
+    ++nextEventID_;
+  }
+  eventDelivered_.notify_all();
+
+  G4Event event(record->EventID());
+  for (VUserActionAssembly* uaa: eventActions_) {
+    uaa->EventActionAtBeginning(&event);
+  }
+  record->apply();
+  for (VUserActionAssembly* uaa: eventActions_) {
+    uaa->EventActionAtEnd(&event);
+  }
+
+  return anlnext::AS_OK;
+}
+
+bool ANLG4MTRunManager::handOffEvent(std::unique_ptr<WorkerEventRecord>&& record)
+{
+  const G4int eventID = record->EventID();
+  {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    eventDelivered_.wait(lock, [this, eventID]() {
+        return handOffClosed_ || eventID < nextEventID_ + eventQueueCapacity_;
+      });
+
+    if (handOffClosed_) {
+      return false;
+    }
+
+    completedEvents_[eventID] = std::move(record);
+  }
+  eventHandedOff_.notify_one();
+
+  return true;
+}
+
+void ANLG4MTRunManager::notifyWorkerRunEnd()
+{
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    ++numberOfWorkersFinished_;
+  }
+  eventHandedOff_.notify_one();
+}
+
+} /* namespace anlgeant4 */
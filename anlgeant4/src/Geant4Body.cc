@@ -24,6 +24,8 @@
 #include <boost/lexical_cast.hpp>
 
 #include "ANLG4RunManager.hh"
+#include "ANLG4MTRunManager.hh"
+#include "ANLG4ActionInitialization.hh"
 
 #include "G4VUserDetectorConstruction.hh"
 #include "G4VUserPhysicsList.hh"
@@ -34,6 +36,7 @@
 #include "VANLPhysicsList.hh"
 #include "VANLPrimaryGen.hh"
 #include "VUserActionAssembly.hh"
+#include "InitialInformation.hh"
 
 using namespace anlnext;
 
@@ -41,8 +44,10 @@ namespace anlgeant4
 {
 
 Geant4Body::Geant4Body()
-  : m_G4RunManager(new ANLG4RunManager),
-    m_EventIndex(0),
+  : m_EventIndex(0),
+    m_NumberOfThreads(0),
+    m_NumberOfEvents(0),
+    m_EventQueueCapacity(0),
     m_RandomEngine("MTwistEngine"),
     m_RandomInitMode(1),
     m_RandomSeed1(0),
@@ -69,6 +74,13 @@ ANLStatus Geant4Body::mod_define()
 
   register_parameter(&m_VerboseLevel, "verbose");
   register_parameter(&m_UserCommands, "commands");
+
+  register_parameter(&m_NumberOfThreads, "number_of_threads");
+  set_parameter_description("Number of Geant4 worker threads. If 0, the sequential run manager is used.");
+  register_parameter(&m_NumberOfEvents, "number_of_events");
+  set_parameter_description("Number of events simulated in a run (multithreaded mode only). This should be the number of events of the ANL loop.");
+  register_parameter(&m_EventQueueCapacity, "event_queue_capacity");
+  set_parameter_description("Maximum number of completed events waiting for the analysis (multithreaded mode only). If 0, it is 16 times the number of threads.");
   
   return AS_OK;
 }
@@ -84,16 +96,75 @@ ANLStatus Geant4Body::mod_initialize()
     return AS_QUIT_ERROR;
   }
 
+  // The run manager is created after the random engine is set,
+  // since the multithreaded run manager seeds the workers from the master engine.
+  if (isMultithreaded()) {
+#ifdef G4MULTITHREADED
+    if (m_NumberOfEvents < 1) {
+      std::cout << "Geant4Body: number_of_events must be positive in the multithreaded mode." << std::endl;
+      return AS_QUIT_ERROR;
+    }
+    if (!check_multithreading_support()) {
+      return AS_QUIT_ERROR;
+    }
+    m_G4MTRunManager.reset(new ANLG4MTRunManager);
+    m_G4MTRunManager->SetNumberOfThreads(m_NumberOfThreads);
+    m_G4MTRunManager->setEventQueueCapacity(m_EventQueueCapacity);
+    std::cout << "Geant4Body: multithreaded mode with "
+              << m_NumberOfThreads << " threads" << std::endl;
+#else
+    std::cout << "Geant4Body: Geant4 is not built with multithreading support." << std::endl;
+    return AS_QUIT_ERROR;
+#endif
+  }
+  else {
+    m_G4RunManager.reset(new ANLG4RunManager);
+  }
+
   set_user_initializations();
   set_user_primary_generator_action();
   set_user_defined_actions();
   apply_commands();
 
-  m_G4RunManager->Initialize();
+  if (isMultithreaded()) {
+    for (auto& func: m_WorkerInitializations) {
+      m_G4MTRunManager->addWorkerInitialization(func);
+    }
+    m_WorkersStarted = true;
+    m_G4MTRunManager->Initialize();
+  }
+  else {
+    m_G4RunManager->Initialize();
+  }
 
   return AS_OK;
 }
 
+bool Geant4Body::addWorkerInitialization(std::function<void()> func)
+{
+  if (m_WorkersStarted) {
+    return false;
+  }
+  m_WorkerInitializations.push_back(std::move(func));
+  return true;
+}
+
+bool Geant4Body::check_multithreading_support()
+{
+  VUserActionAssembly* userActionAssembly;
+  get_module_NC("VUserActionAssembly", &userActionAssembly);
+
+  bool supported = true;
+  for (VUserActionAssembly* uaa: userActionAssembly->userActionList()) {
+    if (!uaa->isMultithreadingSupported()) {
+      std::cout << "Geant4Body: " << uaa->module_id()
+                << " does not support the multithreaded mode." << std::endl;
+      supported = false;
+    }
+  }
+  return supported;
+}
+
 void Geant4Body::initialize_random_generator()
 {
   if (m_RandomEngine=="MTwistEngine") {
@@ -136,12 +207,19 @@ void Geant4Body::set_user_initializations()
   VANLGeometry* geometry;
   get_module_NC("VANLGeometry", &geometry);
   G4VUserDetectorConstruction* userDetectorConstruction = geometry->create();
-  m_G4RunManager->SetUserInitialization(userDetectorConstruction);
   
   VANLPhysicsList* physics;
   get_module_NC("VANLPhysicsList", &physics);
   G4VUserPhysicsList* userPhysicsList = physics->create();
-  m_G4RunManager->SetUserInitialization(userPhysicsList);
+
+  if (isMultithreaded()) {
+    m_G4MTRunManager->SetUserInitialization(userDetectorConstruction);
+    m_G4MTRunManager->SetUserInitialization(userPhysicsList);
+  }
+  else {
+    m_G4RunManager->SetUserInitialization(userDetectorConstruction);
+    m_G4RunManager->SetUserInitialization(userPhysicsList);
+  }
 }
 
 void Geant4Body::set_user_primary_generator_action()
@@ -150,14 +228,37 @@ void Geant4Body::set_user_primary_generator_action()
   get_module_NC("VANLPrimaryGen", &primaryGen);
   G4VUserPrimaryGeneratorAction* userPrimaryGeneratorAction
     = primaryGen->create();
-  m_G4RunManager->SetUserAction(userPrimaryGeneratorAction);
+
+  if (isMultithreaded()) {
+    // called by the workers through ANLG4ActionInitialization.
+    m_PrimaryGeneratorAction.reset(userPrimaryGeneratorAction);
+  }
+  else {
+    m_G4RunManager->SetUserAction(userPrimaryGeneratorAction);
+  }
 }
 
 void Geant4Body::set_user_defined_actions()
 {
   VUserActionAssembly* userActionAssembly;
   get_module_NC("VUserActionAssembly", &userActionAssembly);
-  userActionAssembly->registerUserActions(m_G4RunManager.get());
+
+  if (isMultithreaded()) {
+    VANLPrimaryGen* primaryGen;
+    get_module_NC("VANLPrimaryGen", &primaryGen);
+    InitialInformation* initialInfo = dynamic_cast<InitialInformation*>(primaryGen);
+
+    const std::list<VUserActionAssembly*> userActions = userActionAssembly->userActionList();
+    m_G4MTRunManager->SetUserInitialization(new ANLG4ActionInitialization(m_G4MTRunManager.get(),
+                                                                          m_PrimaryGeneratorAction.get(),
+                                                                          initialInfo,
+                                                                          userActions));
+    m_G4MTRunManager->setEventActions(userActions);
+    m_G4MTRunManager->setInitialInformation(initialInfo);
+  }
+  else {
+    userActionAssembly->registerUserActions(m_G4RunManager.get());
+  }
 }
 
 void Geant4Body::apply_commands()
@@ -188,6 +289,20 @@ void Geant4Body::apply_commands()
 
 ANLStatus Geant4Body::mod_begin_run()
 {
+  if (isMultithreaded()) {
+    const G4bool cond = m_G4MTRunManager->ConfirmBeamOnCondition();
+    if (cond) {
+      m_G4MTRunManager->ConstructScoringWorlds();
+      m_G4MTRunManager->RunInitialization();
+      m_G4MTRunManager->beginEventHandOff(m_NumberOfEvents);
+    }
+    else {
+      return AS_QUIT_ERROR;
+    }
+
+    return AS_OK;
+  }
+
   const G4bool cond = m_G4RunManager->ConfirmBeamOnCondition();
   if (cond) {
     m_G4RunManager->ConstructScoringWorlds();
@@ -203,7 +318,9 @@ ANLStatus Geant4Body::mod_begin_run()
 
 ANLStatus Geant4Body::mod_analyze()
 {
-  const ANLStatus status = m_G4RunManager->performOneEvent(m_EventIndex);
+  const ANLStatus status = isMultithreaded() ?
+    m_G4MTRunManager->receiveOneEvent() :
+    m_G4RunManager->performOneEvent(m_EventIndex);
   ++m_EventIndex;
 
   return status;
@@ -211,6 +328,12 @@ ANLStatus Geant4Body::mod_analyze()
 
 ANLStatus Geant4Body::mod_end_run()
 {
+  if (isMultithreaded()) {
+    m_G4MTRunManager->endEventHandOff();
+    m_G4MTRunManager->RunTermination();
+    return AS_OK;
+  }
+
   m_G4RunManager->TerminateEventLoop();
   m_G4RunManager->RunTermination();
 
@@ -224,6 +347,10 @@ ANLStatus Geant4Body::mod_finalize()
   }
 
   m_G4RunManager.reset(nullptr);
+  m_G4MTRunManager.reset(nullptr);
+  m_PrimaryGeneratorAction.reset(nullptr);
+  m_WorkerInitializations.clear();
+  m_WorkersStarted = false;
 
   return AS_OK;
 }
@@ -20,13 +20,12 @@
 #include "InitialInformation.hh"
 #include <anlnext/BasicModule.hh>
 
+thread_local anlgeant4::InitialInformation::Values* anlgeant4::InitialInformation::staging_ = nullptr;
+
 anlgeant4::
 InitialInformation::InitialInformation(bool stored, anlnext::BasicModule* mod)
   : stored_(stored), weight_stored_(stored),
-    energy_(0.0), direction_(0.0, 0.0, -1.0),
-    time_(0.0), position_(0.0, 0.0, 0.0),
-    polarization_(0.0, 0.0, 0.0),
-    event_id_(-1), weight_(1.0)
+    event_id_(-1)
 {
   if (mod) {
     mod->add_alias("InitialInformation");
@@ -45,16 +45,22 @@ void VMasterUserActionAssembly::appendUserActions(VAppendableUserActionAssembly*
   userActionsAppended_.push_back(user_action_assembly);
 }
 
-void VMasterUserActionAssembly::registerUserActions(G4RunManager* run_manager)
+std::list<VUserActionAssembly*> VMasterUserActionAssembly::userActionList()
 {
-  createUserActions();
-
   std::list<VUserActionAssembly*> userActions;
   userActions.push_back(this);
   for (VUserActionAssembly* pud: userActionsAppended_) {
     userActions.push_back(pud);
   }
-  
+  return userActions;
+}
+
+void VMasterUserActionAssembly::registerUserActions(G4RunManager* run_manager)
+{
+  createUserActions();
+
+  const std::list<VUserActionAssembly*> userActions = userActionList();
+
   UserActionAssemblyRunAction* runAction = new UserActionAssemblyRunAction(userActions);
   UserActionAssemblyEventAction* eventAction = new UserActionAssemblyEventAction(userActions);
   UserActionAssemblyTrackingAction* trackingAction = new UserActionAssemblyTrackingAction(userActions);
@@ -39,11 +39,17 @@ VUserActionAssembly::VUserActionAssembly()
 
 VUserActionAssembly::~VUserActionAssembly() = default;
 
-void VUserActionAssembly::registerUserActions(G4RunManager* run_manager)
+std::list<VUserActionAssembly*> VUserActionAssembly::userActionList()
 {
   std::list<VUserActionAssembly*> userActions;
   userActions.push_back(this);
-  
+  return userActions;
+}
+
+void VUserActionAssembly::registerUserActions(G4RunManager* run_manager)
+{
+  const std::list<VUserActionAssembly*> userActions = userActionList();
+
   UserActionAssemblyRunAction* runAction = new UserActionAssemblyRunAction(userActions);
   UserActionAssemblyEventAction* eventAction = new UserActionAssemblyEventAction(userActions);
   UserActionAssemblyTrackingAction* trackingAction = new UserActionAssemblyTrackingAction(userActions);
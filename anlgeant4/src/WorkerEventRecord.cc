@@ -0,0 +1,63 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "WorkerEventRecord.hh"
+
+namespace anlgeant4
+{
+
+namespace
+{
+
+thread_local std::unique_ptr<WorkerEventRecord> current_record;
+
+} /* anonymous namespace */
+
+WorkerEventRecord::WorkerEventRecord(G4int eventID)
+  : eventID_(eventID)
+{
+}
+
+WorkerEventRecord::~WorkerEventRecord() = default;
+
+void WorkerEventRecord::apply()
+{
+  for (auto& action: actions_) {
+    action();
+  }
+  actions_.clear();
+}
+
+WorkerEventRecord* WorkerEventRecord::current()
+{
+  return current_record.get();
+}
+
+WorkerEventRecord* WorkerEventRecord::begin(G4int eventID)
+{
+  current_record.reset(new WorkerEventRecord(eventID));
+  return current_record.get();
+}
+
+std::unique_ptr<WorkerEventRecord> WorkerEventRecord::release()
+{
+  return std::move(current_record);
+}
+
+} /* namespace anlgeant4 */
@@ -10,6 +10,10 @@ message("-- BOOST_LIB: ${BOOST_LIB}")
 ### Workaround for Clang-15 not to use std::unary_function
 add_compile_definitions(_HAS_AUTO_PTR_ETC=FALSE)
 
+### Threads ###
+find_package(Threads REQUIRED)
+set(THREADS_LIB Threads::Threads)
+
 ### ANL ###
 if(NOT DEFINED ANLNEXT_INSTALL)
   if(DEFINED ENV{ANLNEXT_INSTALL})
@@ -6,10 +6,12 @@
  * 
  * @date 2020-02-26 | Hiromasa Suzuki | implementation for Suzuki et al., JATIS, submitted
  * @date 2020-04-21 | Hirokazu Odaka | pack into classes in ComptonSoft
+ * @date 2026-10-17 | Hirokazu Odaka | multithreaded run with a checkpoint file
  */
 
 #include <memory>
 #include <vector>
+#include <thread>
 #include "AstroUnits.hh"
 #include "RectangularGoalRegion.hh"
 #include "CCECalculation.hh"
@@ -24,6 +26,8 @@ int main()
 {
   const std::string efield_file("efield.root");
   const std::string output_file("cce.root");
+  const std::string checkpoint_file("cce_checkpoint.root");
+  const std::string wp_file("weighting_potential.bin");
 
   const double pixelSize = 36.0*unit::um;
   const double thickness = 500.0*unit::um;
@@ -50,9 +54,11 @@ int main()
   cceBuilder->setSemiconductorProperties(carrierPositive, mobility, lifetime, temperature, spreadFactor);
   cceBuilder->unsetCarrierVelocitySaturation();
   cceBuilder->loadEField(efield_file);
-  cceBuilder->useAccurateWeightingPotential();
+  cceBuilder->useAccurateWeightingPotential(wp_file);
   cceBuilder->registerGoal(std::move(goal));
   cceBuilder->setEndingTime(endingTime);
+  cceBuilder->setNumThreads(std::thread::hardware_concurrency());
+  cceBuilder->setCheckpointFile(checkpoint_file);
   cceBuilder->run(numParticles);
   cceBuilder->write();
 	return 0;
@@ -16,6 +16,7 @@ class MakeDetectorHitsWithTimingProcess;
 class ApplyEPICompensation;
 class EventSelection;
 class EventReconstruction;
+class ParallelEventReconstruction;
 class HXIEventSelection;
 class CreateRootFile;
 class SaveData;
@@ -44,6 +45,9 @@ class WriteEventTree;
 class ReadEventTree;
 class ReadEventTreeAsRawHits;
 class ReadEventTreeAsDetectorHits;
+class WriteHitColumns;
+class ReadHitColumns;
+class ConvertTreeToHitColumns;
 class WriteComptonEventTree;
 class ReadComptonEventTree;
 class HistogramPHA;
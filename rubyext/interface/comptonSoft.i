@@ -17,6 +17,7 @@
 #include "ApplyEPICompensation.hh"
 #include "EventSelection.hh"
 #include "EventReconstruction.hh"
+#include "ParallelEventReconstruction.hh"
 #include "HXIEventSelection.hh"
 #include "CreateRootFile.hh"
 #include "SaveData.hh"
@@ -45,6 +46,9 @@
 #include "ReadEventTree.hh"
 #include "ReadEventTreeAsRawHits.hh"
 #include "ReadEventTreeAsDetectorHits.hh"
+#include "WriteHitColumns.hh"
+#include "ReadHitColumns.hh"
+#include "ConvertTreeToHitColumns.hh"
 #include "WriteComptonEventTree.hh"
 #include "ReadComptonEventTree.hh"
 #include "HistogramPHA.hh"
@@ -330,6 +334,14 @@ public:
 };
 
 
+class ParallelEventReconstruction : public EventReconstruction
+{
+public:
+  ParallelEventReconstruction();
+  ~ParallelEventReconstruction();
+};
+
+
 class HXIEventSelection : public VCSModule
 {
 public:
@@ -358,7 +370,7 @@ class ReadDataFile : public VCSModule
 {
 public:
   ReadDataFile();
-  ~ReadDataFile() = default;
+  ~ReadDataFile();
 };
 
 
@@ -561,6 +573,30 @@ public:
 };
 
 
+class WriteHitColumns : public VCSModule
+{
+public:
+  WriteHitColumns();
+  ~WriteHitColumns();
+};
+
+
+class ReadHitColumns : public VCSModule
+{
+public:
+  ReadHitColumns();
+  ~ReadHitColumns();
+};
+
+
+class ConvertTreeToHitColumns : public anlnext::BasicModule
+{
+public:
+  ConvertTreeToHitColumns();
+  ~ConvertTreeToHitColumns();
+};
+
+
 class WriteComptonEventTree : public VCSModule
 {
 public:
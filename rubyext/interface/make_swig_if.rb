@@ -23,6 +23,7 @@ clMod = [
   ANL::SWIGClass.new("ApplyEPICompensation"),
   ANL::SWIGClass.new("EventSelection"),
   ANL::SWIGClass.new("EventReconstruction"),
+  ANL::SWIGClass.new("ParallelEventReconstruction"),
   ANL::SWIGClass.new("HXIEventSelection"),
   ANL::SWIGClass.new("CreateRootFile"),
   ANL::SWIGClass.new("SaveData"),
@@ -51,6 +52,9 @@ clMod = [
   ANL::SWIGClass.new("ReadEventTree"),
   ANL::SWIGClass.new("ReadEventTreeAsRawHits"),
   ANL::SWIGClass.new("ReadEventTreeAsDetectorHits"),
+  ANL::SWIGClass.new("WriteHitColumns"),
+  ANL::SWIGClass.new("ReadHitColumns"),
+  ANL::SWIGClass.new("ConvertTreeToHitColumns"),
   ANL::SWIGClass.new("WriteComptonEventTree"),
   ANL::SWIGClass.new("ReadComptonEventTree"),
   ANL::SWIGClass.new("HistogramPHA"),
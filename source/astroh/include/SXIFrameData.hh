@@ -37,6 +37,7 @@ namespace comptonsoft
  * @author Tsubasa Tamba
  * @date 2019-06-03
  * @date 2019-10-08 | Hirokazu Odaka | delete the assignment operators
+ * @date 2026-10-17 | Hirokazu Odaka | candidates found by EventCandidateFinder
  */
 class SXIFrameData: public FrameData
 {
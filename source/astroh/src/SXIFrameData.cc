@@ -45,28 +45,35 @@ std::vector<XrayEvent_sptr> SXIFrameData::extractEvents()
     return events;
   }
 
-  const int nx = NumPixelsX();
-  const int ny = NumPixelsY();
-  const int margin = 2+TrimSize();
   const int innerSize = 3;
   const int outerSize = 5;
 
-  std::list<std::pair<int, int>> hitPixels;
-  for (int iy=margin; iy<ny-margin; iy++) {
-    for (int ix=margin; ix<nx-margin; ix++) {
-      const double v = sxiFrame[ix][iy];
-      if (v > EventThreshold()) {
-        if (isMaxPixel(ix, iy, innerSize) && !surroundDiscri(sxiFrame, ix, iy, innerSize, SurroundThreshold(), NpixSurroundThreshold()) && !(includeDisabledPixel(ix, iy, outerSize))) {
-          hitPixels.emplace_back(ix, iy);
-        }
-      }
+  EventCandidateFinder::Criteria criteria;
+  criteria.threshold = EventThreshold();
+  criteria.inclusiveThreshold = false;
+  criteria.maxWindowSize = innerSize;
+  criteria.disabledWindowSize = outerSize;
+  criteria.margin = 2+TrimSize();
+  EventCandidateFinder& finder = getEventCandidateFinder();
+  finder.find(sxiFrame, getDisabledPixels(), criteria);
+
+  // in the order of (iy, ix)
+  std::vector<std::pair<int, int>> hitPixels;
+  for (const auto& pixel: finder.Candidates()) {
+    if (!surroundDiscri(sxiFrame, pixel.first, pixel.second, innerSize, SurroundThreshold(), NpixSurroundThreshold())) {
+      hitPixels.push_back(pixel);
     }
   }
+  std::sort(hitPixels.begin(), hitPixels.end(),
+            [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+              return std::make_pair(a.second, a.first) < std::make_pair(b.second, b.first);
+            });
+  events.reserve(hitPixels.size());
 
   for (const auto& pixel: hitPixels) {
     const std::size_t ix = pixel.first;
     const std::size_t iy = pixel.second;  
-    SXIXrayEvent_sptr event(new SXIXrayEvent(outerSize));
+    SXIXrayEvent_sptr event = std::make_shared<SXIXrayEvent>(outerSize);
     outerSplitThreshold_ = SplitThreshold();
     event -> setSplitThreshold(SplitThreshold());
     event -> setOuterSplitThreshold(OuterSplitThreshold());
@@ -22,17 +22,37 @@
 
 #include <memory>
 #include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+#include "TH3.h"
+#include "TFile.h"
 #include "CSTypes.hh"
 #include "VGoalRegion.hh"
 #include "SemiconductorModel.hh"
 
 namespace comptonsoft {
 
+class PointChargePacket;
+
 /**
  * CCE calcultion class
  *
+ * The map is calculated for each column of voxels (ix, iy) independently.
+ * The columns are shared among worker threads, and each column draws random
+ * numbers from its own generator seeded with (random seed, ix, iy), so that
+ * the result does not depend on the number of threads.
+ * If a checkpoint file is set, the partial result is saved there while
+ * running, and an interrupted calculation resumes from it.
+ * The particles started from the same voxel are transported together as a
+ * packet of point charges.
+ *
  * @author Hiromasa Suzuki, Hirokazu Odaka
  * @date 2020-04-18
+ * @date 2026-10-17 | multithreaded and resumable
+ * @date 2026-10-17 | packet transport; adaptive step length
+ * @date 2026-10-17 | drift velocities tabulated before running
+ * @date 2026-10-17 | checkpoints record all the inputs of the map
  */
 class CCECalculation
 {
@@ -47,6 +67,18 @@ public:
                        const std::vector<double>& ys,
                        const std::vector<double>& zs);
   void setStepLength(double v) { stepLength_ = v; }
+
+  /**
+   * enable the adaptive step length; see PointCharge::setAdaptiveStep().
+   * The step length set by setStepLength() is used as the first step.
+   */
+  void setAdaptiveStep(double minStep, double maxStep, double tolerance)
+  {
+    adaptiveStep_ = true;
+    minStep_ = minStep;
+    maxStep_ = maxStep;
+    stepTolerance_ = tolerance;
+  }
   void setEndingTime(double v) { endingTime_ = v; }
   void registerGoal(std::unique_ptr<VGoalRegion>&& goal) { goal_ = std::move(goal); }
   void initializeCCEMap(const std::string& filename);
@@ -59,19 +91,48 @@ public:
   void setCarrierVelocitySaturation(double efield);
   void unsetCarrierVelocitySaturation();
   void loadEField(const std::string& filename);
-  void useAccurateWeightingPotential();
+  void setEFieldInterpolation(bool v);
+
+  /**
+   * use a numerical table of the weighting potential.
+   * @param filename table file; see SemiconductorModel::useAccurateWeightingPotential().
+   */
+  void useAccurateWeightingPotential(const std::string& filename="");
   void setRandomSeed(uint32_t seed);
 
+  void setNumThreads(int v) { numThreads_ = v; }
+  int NumThreads() const { return numThreads_; }
+
+  /**
+   * set a checkpoint file.
+   * @param filename name of the checkpoint file. An empty string disables checkpoints.
+   * @param interval number of columns calculated between two checkpoints.
+   */
+  void setCheckpointFile(const std::string& filename, int interval=64)
+  {
+    checkpointFile_ = filename;
+    checkpointInterval_ = interval;
+  }
+
   void run(int numParticles);
   void write();
 
 private:
   std::vector<double> extendedEdges(const std::vector<double>& xs,
                                     double pixelWidth);
-  void calculate(int ix, int iy, int iz, int numParticles);
-  void transport(int ix, int iy, int iz, double charge);
-  void calculateForOppositeSide(int ix, int iy, int iz);
-  void addCCE(int binx, int biny, int binz, double value);
+  void calculate(int ix, int iy, int numParticles,
+                 std::mt19937& generator, std::vector<double>& signals);
+  void transport(int ix, int iy, int iz, int numParticles,
+                 PointChargePacket& packet, std::vector<double>& signals);
+  void calculateForOppositeSide(int ix, int iy, int iz,
+                                std::vector<double>& signals);
+  std::string checkpointDescription(int numParticles) const;
+  bool loadCheckpoint(const std::string& description,
+                      std::vector<double>& cce,
+                      std::vector<char>& done) const;
+  void saveCheckpoint(const std::string& description,
+                      const std::vector<double>& cce,
+                      const std::vector<char>& done) const;
 
 private:
   double pixelWidthX_ = 0.0;
@@ -81,11 +142,30 @@ private:
   std::vector<double> segmentationY_;
   std::vector<double> segmentationZ_;
   double stepLength_ = 0.0;
+  bool adaptiveStep_ = false;
+  double minStep_ = 0.0;
+  double maxStep_ = 0.0;
+  double stepTolerance_ = 0.0;
   double endingTime_ = 0.0;
+  bool upsideReadout_ = false;
+  bool carrierPositive_ = false;
+  double mobility_ = 0.0;
+  double lifetime_ = 0.0;
+  double temperature_ = 0.0;
+  double spreadFactor_ = 0.0;
+  bool velocitySaturation_ = false;
+  double saturationEField_ = 0.0;
+  std::string efieldFile_;
+  bool accurateWeightingPotential_ = false;
+  std::string weightingPotentialFile_;
   std::unique_ptr<VGoalRegion> goal_;
   std::unique_ptr<SemiconductorModel> field_;
   TH3D* cceMap_ = nullptr;
   std::unique_ptr<TFile> outFile_ = nullptr;
+  uint32_t randomSeed_ = std::mt19937::default_seed;
+  int numThreads_ = 1;
+  std::string checkpointFile_;
+  int checkpointInterval_ = 64;
 };
 
 } /* namespace comptonsoft */
@@ -42,6 +42,11 @@ public:
     : VCSSensitiveDetector(name)
   {
   }
+
+  CSSensitiveDetector* Clone() const override
+  {
+    return new CSSensitiveDetector(*this);
+  }
   
   /**
    * asociate a detector ID with a string identifier of volume hierarchy.
@@ -52,6 +57,7 @@ public:
   {
     detectorMap_[key] = detectorID;
     InsertIntoPositionCalculationSet(detectorID);
+    ClearDetectorCache();
   }
 
   int GetDetectorID(const G4VTouchable* touchable) override
@@ -0,0 +1,94 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ChargeCollectionMapCache_H
+#define COMPTONSOFT_ChargeCollectionMapCache_H 1
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+
+class TH1;
+
+namespace comptonsoft {
+
+/**
+ * A cache of weighting-potential and charge-collection-efficiency maps.
+ *
+ * A set of maps is identified by a description, which is a text of all the
+ * inputs of the map calculation (geometry, grid, charge transport parameters).
+ * Detectors with the same description share one set of maps in memory.
+ * If a directory is given, the maps are also stored there as ROOT files named
+ * by a hash of the description, so that the following runs can load them
+ * instead of calculating again. The description is stored in the file
+ * together with the maps and is compared on loading.
+ *
+ * The cache owns the maps it holds; they are not attached to any ROOT directory.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class ChargeCollectionMapCache
+{
+public:
+  ChargeCollectionMapCache();
+  ~ChargeCollectionMapCache();
+  ChargeCollectionMapCache(const ChargeCollectionMapCache&) = delete;
+  ChargeCollectionMapCache(ChargeCollectionMapCache&&) = delete;
+  ChargeCollectionMapCache& operator=(const ChargeCollectionMapCache&) = delete;
+  ChargeCollectionMapCache& operator=(ChargeCollectionMapCache&&) = delete;
+
+  void setDirectory(const std::string& v) { directory_ = v; }
+  std::string Directory() const { return directory_; }
+  bool isPersistent() const { return !directory_.empty(); }
+
+  /**
+   * find a set of maps in memory or in the cache directory.
+   * @param description text of the inputs of the map calculation.
+   * @param numMaps number of maps in the set.
+   * @return the maps, or an empty vector if they are not cached.
+   */
+  std::vector<TH1*> find(const std::string& description, std::size_t numMaps);
+
+  /**
+   * store copies of a set of maps.
+   * @param description text of the inputs of the map calculation.
+   * @param maps the maps to store, which are not modified.
+   */
+  void store(const std::string& description, const std::vector<const TH1*>& maps);
+
+  std::size_t NumberOfEntries() const { return entries_.size(); }
+
+  static uint64_t hash(const std::string& description);
+  std::string filePath(const std::string& description) const;
+
+private:
+  std::vector<std::unique_ptr<TH1>> load(const std::string& description, std::size_t numMaps) const;
+  void save(const std::string& description, const std::vector<std::unique_ptr<TH1>>& maps) const;
+
+private:
+  std::string directory_;
+  std::map<std::string, std::vector<std::unique_ptr<TH1>>> entries_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ChargeCollectionMapCache_H */
@@ -24,12 +24,15 @@
  * @date 2019-11-01
  * @date 2019-11-15 | H. Odaka | redesign
  * @date 2020-10-27 | T. Tamba | redesign
+ * @date 2026-10-17 | H. Odaka | FFT and projection-matrix decoding modes
  */
 #ifndef COMPTONSOFT_CodedAperture_H
 #define COMPTONSOFT_CodedAperture_H 1
 
 #include "VCodedAperture.hh"
 #include <random>
+#include <vector>
+#include <complex>
 #include "CSTypes.hh"
 
 namespace comptonsoft {
@@ -49,6 +52,7 @@ public:
     detector_element_size_y_ = detector_y;
     aperture_element_size_x_ = aperture_x;
     aperture_element_size_y_ = aperture_y;
+    invalidateProjection();
   }
 
   void setAperturePattern(const std::shared_ptr<image_t>& pattern) override;
@@ -59,28 +63,36 @@ public:
 
   std::shared_ptr<image_t> DecodedImage() const override { return decoded_image_; }
 
-  void setSkyNum(int x, int y) { sky_num_x_ = x; sky_num_y_ = y; }
+  void setSkyNum(int x, int y) { sky_num_x_ = x; sky_num_y_ = y; invalidateProjection(); }
   int SkyNumX() const { return sky_num_x_; }
   int SkyNumY() const { return sky_num_y_; }
-  void setSkyFov(double x, double y) { sky_fov_x_ = x; sky_fov_y_ = y; }
+  void setSkyFov(double x, double y) { sky_fov_x_ = x; sky_fov_y_ = y; invalidateProjection(); }
   double SkyFovX() const { return sky_fov_x_; }
   double SkyFovY() const { return sky_fov_y_; }
-  void setDetectorToApertureDistance(double v) { detector_to_aperture_distance_ = v; }
+  void setDetectorToApertureDistance(double v) { detector_to_aperture_distance_ = v; invalidateProjection(); }
   double DetectorToApertureDistance() const { return detector_to_aperture_distance_; }
 
   double SkyElementAngleX() const override { return sky_element_angle_x_; }
   double SkyElementAngleY() const override { return sky_element_angle_y_; }
 
-  void setDetectorRollAngle(double v) { detector_roll_angle_ = v; }
+  void setDetectorRollAngle(double v) { detector_roll_angle_ = v; invalidateProjection(); }
   double DetectorRollAngle() const { return detector_roll_angle_; }
-  void setApertureRollAngle(double v) { aperture_roll_angle_ = v; }
+  void setApertureRollAngle(double v) { aperture_roll_angle_ = v; invalidateProjection(); }
   double ApertureRollAngle() const { return aperture_roll_angle_; }
-  void setApertureOffset(double x, double y) { aperture_offset_.setX(x); aperture_offset_.setY(y); }
+  void setApertureOffset(double x, double y) { aperture_offset_.setX(x); aperture_offset_.setY(y); invalidateProjection(); }
   vector2_t ApertureOffset() const { return aperture_offset_; }
-  void setSkyOffset(double x, double y) { sky_offset_.setX(x); sky_offset_.setY(y); }
+  void setSkyOffset(double x, double y) { sky_offset_.setX(x); sky_offset_.setY(y); invalidateProjection(); }
   vector2_t SkyOffset() const { return sky_offset_; }
   void setNumDecodingIterations(int v) { num_decoding_iterations_ = v; }
   int NumDecodingIterations() const { return num_decoding_iterations_; }
+  /**
+   * set the decoding mode.
+   * 1: Monte-Carlo sampling based on the sky coordinate;
+   * 2: Monte-Carlo sampling based on the aperture coordinate;
+   * 3: FFT cross-correlation of the encoded image with the decoder array projected onto the detector plane;
+   * 4: sparse sky-detector projection matrix, which is built once and reused for every image.
+   * Modes 3 and 4 give the expectation values of mode 1 without random sampling.
+   */
   void setDecodingMode(int v) { decoding_mode_ = v; }
   int DecodingMode() const { return decoding_mode_; }
   
@@ -135,6 +147,45 @@ private:
 
   void decode_based_on_sky_coordinate();
   void decode_based_on_aperture_coordinate();
+  void decode_by_fft();
+  void decode_by_projection_matrix();
+
+  void invalidateProjection()
+  {
+    projection_ready_ = false;
+    projection_matrix_ready_ = false;
+    projection_matrix_too_large_ = false;
+  }
+  bool buildProjection();
+  bool buildProjectionMatrix();
+
+  /* decoding with the precomputed projection (modes 3 and 4) */
+  struct SkyShiftTap {
+    int lx = 0;
+    int ly = 0;
+    double weight = 0.0;
+  };
+
+  bool projection_ready_ = false;
+  int projection_detector_num_x_ = 0;
+  int projection_detector_num_y_ = 0;
+  int decoder_grid_min_x_ = 0;
+  int decoder_grid_min_y_ = 0;
+  int decoder_grid_num_x_ = 0;
+  int decoder_grid_num_y_ = 0;
+  std::vector<double> decoder_grid_;
+  std::vector<std::size_t> sky_tap_start_;
+  std::vector<SkyShiftTap> sky_taps_;
+  int correlation_num_x_ = 0;
+  int correlation_num_y_ = 0;
+  std::vector<std::complex<double>> decoder_spectrum_;
+  std::vector<std::complex<double>> correlation_buffer_;
+
+  bool projection_matrix_ready_ = false;
+  bool projection_matrix_too_large_ = false;
+  std::vector<std::size_t> projection_matrix_row_start_;
+  std::vector<int> projection_matrix_column_;
+  std::vector<double> projection_matrix_value_;
 
   std::mt19937 randomGenerator_;
 };
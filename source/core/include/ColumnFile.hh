@@ -0,0 +1,208 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ColumnFile_H
+#define COMPTONSOFT_ColumnFile_H 1
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include "MappedFile.hh"
+#include "CSException.hh"
+
+namespace comptonsoft {
+
+/**
+ * element types of a column file.
+ */
+enum class ColumnType : uint8_t {
+  Int16=1, Int32=2, Int64=3, UInt32=4, UInt64=5, Float32=6, Float64=7
+};
+
+/**
+ * encodings of a column file.
+ * DeltaVarint stores the differences between successive integers as
+ * zigzag variable-length integers, and is used only for integer columns.
+ */
+enum class ColumnEncoding : uint8_t { Raw=0, DeltaVarint=1 };
+
+template <typename T> struct column_type_traits;
+template <> struct column_type_traits<int16_t> { static constexpr ColumnType type = ColumnType::Int16; };
+template <> struct column_type_traits<int32_t> { static constexpr ColumnType type = ColumnType::Int32; };
+template <> struct column_type_traits<int64_t> { static constexpr ColumnType type = ColumnType::Int64; };
+template <> struct column_type_traits<uint32_t> { static constexpr ColumnType type = ColumnType::UInt32; };
+template <> struct column_type_traits<uint64_t> { static constexpr ColumnType type = ColumnType::UInt64; };
+template <> struct column_type_traits<float> { static constexpr ColumnType type = ColumnType::Float32; };
+template <> struct column_type_traits<double> { static constexpr ColumnType type = ColumnType::Float64; };
+
+/**
+ * A read-only view of contiguous column values.
+ */
+template <typename T>
+class ColumnSpan
+{
+public:
+  ColumnSpan() = default;
+  ColumnSpan(const T* data, std::size_t size) : data_(data), size_(size) {}
+
+  const T* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T& operator[](std::size_t i) const { return data_[i]; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+
+  ColumnSpan subspan(std::size_t offset, std::size_t count) const
+  { return ColumnSpan(data_+offset, count); }
+
+private:
+  const T* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+/**
+ * A writer of a column file, which holds fixed-width little-endian records
+ * of one type after a header of 64 bytes.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class ColumnWriter
+{
+public:
+  ColumnWriter() = default;
+  ~ColumnWriter();
+  ColumnWriter(const ColumnWriter&) = delete;
+  ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+  /**
+   * open a file. DeltaVarint for a floating-point column falls back to Raw.
+   * @return false if the file cannot be created.
+   */
+  bool open(const std::string& filename, ColumnType type, ColumnEncoding encoding);
+
+  /**
+   * write the remaining records and the header, and close the file.
+   * @return false if writing fails.
+   */
+  bool close();
+
+  bool isOpen() const { return file_.is_open(); }
+  ColumnType Type() const { return type_; }
+  ColumnEncoding Encoding() const { return encoding_; }
+  uint64_t NumberOfRecords() const { return numRecords_; }
+
+  template <typename T>
+  void append(T value)
+  {
+    if (column_type_traits<T>::type != type_) {
+      throw CSException("ColumnWriter: type mismatch of a column "+filename_);
+    }
+    if (encoding_ == ColumnEncoding::DeltaVarint) {
+      appendDelta(static_cast<int64_t>(value));
+    }
+    else {
+      appendRaw(&value, sizeof(T));
+    }
+    ++numRecords_;
+    if (buffer_.size() >= FlushSize) {
+      flush();
+    }
+  }
+
+private:
+  static constexpr std::size_t FlushSize = 1<<20;
+
+  void appendRaw(const void* value, std::size_t size);
+  void appendDelta(int64_t value);
+  void flush();
+  bool writeHeader();
+
+private:
+  std::string filename_;
+  std::ofstream file_;
+  ColumnType type_ = ColumnType::Int32;
+  ColumnEncoding encoding_ = ColumnEncoding::Raw;
+  uint64_t numRecords_ = 0;
+  uint64_t dataBytes_ = 0;
+  int64_t previous_ = 0;
+  std::vector<char> buffer_;
+};
+
+/**
+ * A reader of a column file.
+ * A raw column is memory-mapped and read without copy on a little-endian host;
+ * otherwise the values are decoded into memory when the file is opened.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class ColumnReader
+{
+public:
+  ColumnReader() = default;
+  ~ColumnReader() = default;
+  ColumnReader(const ColumnReader&) = delete;
+  ColumnReader& operator=(const ColumnReader&) = delete;
+
+  /**
+   * open a column file.
+   * @return false if the file cannot be read or is not a valid column file.
+   */
+  bool open(const std::string& filename);
+  void close();
+
+  bool isOpen() const { return open_; }
+  ColumnType Type() const { return type_; }
+  ColumnEncoding Encoding() const { return encoding_; }
+  uint64_t NumberOfRecords() const { return numRecords_; }
+  bool isMapped() const { return mapped_; }
+
+  /**
+   * return the values.
+   * @return an empty span if T does not match the column type.
+   */
+  template <typename T>
+  ColumnSpan<T> span() const
+  {
+    if (column_type_traits<T>::type != type_) {
+      return ColumnSpan<T>();
+    }
+    return ColumnSpan<T>(reinterpret_cast<const T*>(data_), numRecords_);
+  }
+
+private:
+  bool decode(const char* encoded, std::size_t size);
+
+private:
+  MappedFile file_;
+  bool open_ = false;
+  ColumnType type_ = ColumnType::Int32;
+  ColumnEncoding encoding_ = ColumnEncoding::Raw;
+  uint64_t numRecords_ = 0;
+  bool mapped_ = false;
+  const char* data_ = nullptr;
+  std::vector<uint64_t> decoded_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ColumnFile_H */
@@ -0,0 +1,123 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_CrossSectionTable_H
+#define COMPTONSOFT_CrossSectionTable_H 1
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+class TGraph;
+
+namespace comptonsoft {
+
+/**
+ * A table of photon cross sections (total, Compton scattering, and photoabsorption)
+ * sampled on a uniform grid of log energy.
+ * The table is built once from TGraph objects, and then a query costs O(1)
+ * without any access to ROOT objects. Between two grid points, the values are
+ * linearly interpolated in energy; outside the grid, they are linearly
+ * extrapolated from the end points of the original graphs as TGraph::Eval() does.
+ * Since the table is immutable after build(), it can be shared by threads.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class CrossSectionTable
+{
+public:
+  struct Values
+  {
+    double total = 0.0;
+    double compton = 0.0;
+    double photoabsorption = 0.0;
+  };
+
+public:
+  CrossSectionTable() = default;
+  ~CrossSectionTable() = default;
+  CrossSectionTable(const CrossSectionTable&) = default;
+  CrossSectionTable(CrossSectionTable&&) = default;
+  CrossSectionTable& operator=(const CrossSectionTable&) = default;
+  CrossSectionTable& operator=(CrossSectionTable&&) = default;
+
+  /**
+   * build the table.
+   * @param total graph of the total cross section.
+   * @param compton graph of the Compton scattering cross section.
+   * @param photoabsorption graph of the photoabsorption cross section.
+   * @param pointsPerDecade number of grid points per decade of energy.
+   * @return false if the graphs do not have valid (positive) energy ranges.
+   */
+  bool build(const TGraph& total,
+             const TGraph& compton,
+             const TGraph& photoabsorption,
+             int pointsPerDecade);
+
+  bool isBuilt() const { return !table_.empty(); }
+  std::size_t NumberOfPoints() const { return table_.size(); }
+  double MinimumEnergy() const { return energies_.front(); }
+  double MaximumEnergy() const { return energies_.back(); }
+
+  /**
+   * return all the cross sections at the given energy.
+   */
+  Values interpolate(double energy) const
+  {
+    if (energy >= energyMin_ && energy < energyMax_) {
+      const std::size_t k = cellIndex(energy, (std::log(energy)-logEnergyMin_)*gridPerLogEnergy_);
+      return interpolateInCell(k, energy);
+    }
+    return extrapolate(energy);
+  }
+
+  /**
+   * batched version of interpolate().
+   * @param energies array of energies (size n).
+   * @param values (output) array of cross sections (size n).
+   * @param n number of energies.
+   */
+  void interpolate(const double* energies, Values* values, std::size_t n) const;
+
+private:
+  std::size_t cellIndex(double energy, double position) const;
+  Values interpolateInCell(std::size_t k, double energy) const;
+  Values extrapolate(double energy) const;
+
+private:
+  double energyMin_ = 0.0;
+  double energyMax_ = 0.0;
+  double logEnergyMin_ = 0.0;
+  double gridPerLogEnergy_ = 0.0;
+
+  std::vector<double> energies_;
+  std::vector<double> inverseWidths_;
+  std::vector<Values> table_;
+
+  /* linear extrapolation: value = offset + slope * energy */
+  Values lowOffset_;
+  Values lowSlope_;
+  Values highOffset_;
+  Values highSlope_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_CrossSectionTable_H */
@@ -0,0 +1,141 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_DataFileStream_H
+#define COMPTONSOFT_DataFileStream_H 1
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace comptonsoft {
+
+/**
+ * A sequential reader of binary data files, which reads the files in large chunks
+ * and hands out views of packets in the chunks.
+ *
+ * The files are read one after another as a single stream, but a packet never
+ * spans two files; an incomplete packet at the end of a file is discarded.
+ * A view is valid until the next call of read(), and is copied only if it spans two chunks.
+ * The address of a packet is congruent to its offset in the file modulo 8,
+ * so that aligned words in a file are aligned in memory as well.
+ * In the background mode, the chunks are read by a worker thread.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ * @date 2026-10-17 | continued packets
+ */
+class DataFileStream
+{
+public:
+  /**
+   * @param chunkSize size of a chunk in bytes, rounded up to a multiple of 8.
+   * @param background true if the chunks are read in a worker thread.
+   */
+  DataFileStream(std::size_t chunkSize, bool background);
+  ~DataFileStream();
+  DataFileStream(const DataFileStream&) = delete;
+  DataFileStream& operator=(const DataFileStream&) = delete;
+
+  /**
+   * start reading the files.
+   */
+  void open(const std::vector<std::string>& files);
+  void close();
+
+  /**
+   * read a packet.
+   * @param size size of the packet in bytes.
+   * @param continued true if the packet must follow the previous packet in
+   * the same file. If that file ends before the packet is complete,
+   * nullptr is returned, and the next read starts at the next file.
+   * @return pointer to the packet, or nullptr if no file remains.
+   */
+  const char* read(std::size_t size, bool continued=false);
+
+  const std::string& CurrentFilename() const;
+  uint64_t NumberOfBytes() const { return numBytes_; }
+  uint64_t NumberOfPackets() const { return numPackets_; }
+
+  /** seconds from open() to the last packet read */
+  double ElapsedTime() const;
+
+private:
+  struct Chunk
+  {
+    std::vector<uint64_t> buffer;
+    std::size_t size = 0;
+    uint64_t fileOffset = 0;
+    int fileIndex = -1;
+    bool endOfFile = false;
+    bool endOfStream = false;
+
+    const char* data() const { return reinterpret_cast<const char*>(buffer.data()); }
+    char* data() { return reinterpret_cast<char*>(buffer.data()); }
+  };
+
+  static constexpr std::size_t NumChunks = 3;
+
+  void produce();
+  void readChunk(Chunk& chunk);
+  bool fetchChunk();
+  void releaseChunk();
+  const char* assemblePacket(std::size_t size);
+  void countPacket(std::size_t size);
+
+private:
+  const std::size_t chunkSize_;
+  const bool background_;
+  std::vector<std::string> files_;
+
+  /* producer side */
+  std::ifstream fin_;
+  int fileIndex_ = -1;
+  uint64_t fileOffset_ = 0;
+  std::thread worker_;
+
+  /* shared */
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::unique_ptr<Chunk>> freeChunks_;
+  std::deque<std::unique_ptr<Chunk>> readyChunks_;
+  bool stop_ = false;
+
+  /* consumer side */
+  std::unique_ptr<Chunk> current_;
+  std::size_t position_ = 0;
+  bool finished_ = false;
+  std::vector<uint64_t> spill_;
+  uint64_t numBytes_ = 0;
+  uint64_t numPackets_ = 0;
+  std::chrono::steady_clock::time_point startTime_;
+  std::chrono::steady_clock::time_point lastTime_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_DataFileStream_H */
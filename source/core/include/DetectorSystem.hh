@@ -42,6 +42,7 @@ class MultiChannelData;
 class ChannelMap;
 class DeviceSimulation;
 class VCSSensitiveDetector;
+class ChargeCollectionMapCache;
 
 /**
  * A manager class of a whole detector system.
@@ -51,6 +52,7 @@ class VCSSensitiveDetector;
  * @date 2016-08-22 | new XML scheme (version 4)
  * @date 2018-03-09 | new XML schema (detector config v5, detector parameters v2)
  * @date 2020-03-30 | new XML schema (channel properties v2, detector parameters v3)
+ * @date 2026-10-17 | cache of WP/CCE maps
  */
 class DetectorSystem : private boost::noncopyable
 {
@@ -223,6 +225,8 @@ public:
   { return deviceSimulationVector_[index]; }
   std::vector<DeviceSimulation*>& getDeviceSimulationVector()
   { return deviceSimulationVector_; }
+  ChargeCollectionMapCache* getChargeCollectionMapCache()
+  { return CCEMapCache_.get(); }
 
   // Setup detector system manually
   void addDetector(std::unique_ptr<VRealDetectorUnit>&& detector);
@@ -238,6 +242,12 @@ public:
   void readDetectorParameters(const std::string& filename);
   void registerGeant4SensitiveDetectors();
 
+  /**
+   * register thread-local copies of the sensitive detectors.
+   * This should be called on each worker thread in the multithreaded mode of Geant4.
+   */
+  void registerGeant4SensitiveDetectorsForWorker();
+
   // for an event loop
   void initializeEvent();
 
@@ -267,6 +277,8 @@ private:
                                DeviceSimulation* ds);
   void setupReconstructionParameters(const DetectorSystem::ParametersNodeContents parameters,
                                      VRealDetectorUnit* detector);
+
+  void registerGeant4SensitiveDetector(VCSSensitiveDetector* sd);
   
 private:
   bool MCSimulation_;
@@ -282,6 +294,7 @@ private:
   std::vector<DeviceSimulation*> deviceSimulationVector_;
   std::vector<VCSSensitiveDetector*> sensitiveDetectorVector_;
   std::unique_ptr<TFile> ROOTFile_;
+  std::unique_ptr<ChargeCollectionMapCache> CCEMapCache_;
 
   std::map<std::string, std::unique_ptr<DetectorGroup>> detectorGroupMap_;
   std::vector<HitPattern> hitPatterns_;
@@ -31,6 +31,7 @@ class TSpline;
 namespace comptonsoft {
 
 class DetectorHit;
+class ChargeCollectionMapCache;
 
 /**
  * A class for simulating a semiconductor detector device.
@@ -42,6 +43,8 @@ class DetectorHit;
  * @date 2014-11-07
  * @date 2015-05-14 | introduce EPI compensation.
  * @date 2020-09-02 | treat EPI as a tuple of its value and error
+ * @date 2026-10-17 | use a cache of the WP/CCE maps
+ * @date 2026-10-17 | WP/CCE maps are built by multiple threads
  */
 class DeviceSimulation : public VDeviceSimulation
 {
@@ -73,6 +76,14 @@ public:
   EFieldModel::FieldShape EFieldMode() const { return EField_->EFieldMode(); }
   double EFieldParam(int i) const { return EField_->EFieldParam(i); }
 
+  /**
+   * set the number of threads used for building the WP/CCE maps.
+   * Less than 1 means the number of hardware threads.
+   */
+  void setNumThreadsInMapCalculation(int val)
+  { numThreadsInMapCalculation_ = val; }
+  int NumThreadsInMapCalculation() const;
+
   void setNumPixelsInWPCalculation(double val)
   { numPixelsInWPCalculation_ = val; }
   double NumPixelsInWPCalculation() const
@@ -172,6 +183,16 @@ public:
   virtual double DiffusionSigmaAnode(double z);
   virtual double DiffusionSigmaCathode(double z);
 
+  /**
+   * set a cache of the WP/CCE maps, which is not owned by this object.
+   * If set, buildWPMap() and buildCCEMap() take maps from the cache when
+   * they are calculated with the same parameters.
+   */
+  void setChargeCollectionMapCache(ChargeCollectionMapCache* v)
+  { CCEMapCache_ = v; }
+  ChargeCollectionMapCache* getChargeCollectionMapCache()
+  { return CCEMapCache_; }
+
   virtual bool isCCEMapPrepared() { return false; }
   virtual void buildWPMap() {}
   virtual void buildWPMap(int /* nx */, int /* ny */, int /* nz */,
@@ -192,11 +213,25 @@ protected:
   double calculateCCE(double z)
   { return EField_->CCE(z); }
 
+  /**
+   * the electric field model, a copy of which is used by each thread that
+   * calculates CCE maps.
+   */
+  const EFieldModel& getEFieldModel() const { return *EField_; }
+
+  /**
+   * text of the charge transport parameters that determine the CCE maps,
+   * used as a part of a cache description.
+   */
+  std::string ChargeTransportDescription() const;
+
 private:
   int chargeCollectionMode_;
   std::string CCEMapName_;
   std::unique_ptr<EFieldModel> EField_;
   double numPixelsInWPCalculation_;
+  ChargeCollectionMapCache* CCEMapCache_;
+  int numThreadsInMapCalculation_;
 
   int diffusionMode_;
   int diffusionDivisionNumber_;
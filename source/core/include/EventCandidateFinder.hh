@@ -0,0 +1,120 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_EventCandidateFinder_H
+#define COMPTONSOFT_EventCandidateFinder_H 1
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <boost/multi_array.hpp>
+#include "CSTypes.hh"
+
+namespace comptonsoft
+{
+
+/**
+ * A finder of event-center candidates in a frame.
+ *
+ * A candidate is a pixel inside the margin that passes the threshold, is
+ * larger than all the other pixels of the surrounding window (the local
+ * maximum test of FrameData::isMaxPixel()), and has no disabled pixel in
+ * another surrounding window.
+ * The frame is divided into bands of rows, which are processed in parallel.
+ * In each band, the maximum over the window excluding the center is
+ * obtained by a separable max filter (first along the rows, which are
+ * contiguous, then across them), and all the tests are loops over a whole
+ * row. Rows without any pixel above the threshold are skipped after the
+ * first loop.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class EventCandidateFinder
+{
+public:
+  using flags_t = boost::multi_array<int, 2>;
+
+  struct Criteria
+  {
+    double threshold = 0.0;
+    /* v >= threshold if true, v > threshold otherwise */
+    bool inclusiveThreshold = true;
+    /* size of the window for the local maximum test */
+    int maxWindowSize = 1;
+    /* size of the window that must not contain disabled pixels */
+    int disabledWindowSize = 1;
+    /* must not be smaller than the half sizes of the windows */
+    int margin = 0;
+  };
+
+public:
+  EventCandidateFinder();
+  ~EventCandidateFinder();
+  EventCandidateFinder(const EventCandidateFinder&) = default;
+  EventCandidateFinder(EventCandidateFinder&&) = default;
+  EventCandidateFinder& operator=(const EventCandidateFinder&) = default;
+  EventCandidateFinder& operator=(EventCandidateFinder&&) = default;
+
+  void setNumThreads(int v) { numThreads_ = v; }
+  int NumThreads() const { return numThreads_; }
+
+  /**
+   * find the candidates of a frame.
+   * @param frame frame image.
+   * @param disabled disabled-pixel flags of the same shape.
+   * @param criteria selection criteria.
+   */
+  void find(const image_t& frame, const flags_t& disabled, const Criteria& criteria);
+
+  /** candidates found by the last find() in the order of (ix, iy) */
+  const std::vector<std::pair<int, int>>& Candidates() const { return candidates_; }
+
+  bool isCandidate(int ix, int iy) const
+  {
+    return bitmap_[static_cast<std::size_t>(ix)*ny_+iy] != 0;
+  }
+
+private:
+  struct Workspace
+  {
+    std::vector<double> rowMax;
+    std::vector<double> neighborMax;
+    std::vector<uint8_t> aboveThreshold;
+    std::vector<uint8_t> disabledNearby;
+  };
+
+  void findInBand(const image_t& frame, const flags_t& disabled, const Criteria& criteria,
+                  int band, Workspace& workspace);
+
+private:
+  static constexpr int BandSize = 64;
+
+  int numThreads_ = 1;
+  int nx_ = 0;
+  int ny_ = 0;
+  std::vector<uint8_t> bitmap_;
+  std::vector<std::pair<int, int>> candidates_;
+  std::vector<std::vector<std::pair<int, int>>> bandCandidates_;
+  std::vector<Workspace> workspaces_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_EventCandidateFinder_H */
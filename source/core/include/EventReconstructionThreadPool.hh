@@ -0,0 +1,101 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_EventReconstructionThreadPool_H
+#define COMPTONSOFT_EventReconstructionThreadPool_H 1
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "DetectorHit_sptr.hh"
+#include "BasicComptonEvent.hh"
+
+namespace comptonsoft {
+
+class VEventReconstructionAlgorithm;
+
+/**
+ * A pool of worker threads that reconstructs a batch of events in parallel.
+ * Each worker owns a clone of the prototype algorithm, so the algorithms
+ * need not be thread-safe as long as their copies do not share mutable state.
+ * Results are returned in the order of the input events.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class EventReconstructionThreadPool
+{
+public:
+  /**
+   * constructor.
+   * @param prototype algorithm to be cloned for each worker. The parameters must be already loaded.
+   * @param numThreads number of worker threads.
+   */
+  EventReconstructionThreadPool(const VEventReconstructionAlgorithm& prototype,
+                                int numThreads);
+  ~EventReconstructionThreadPool();
+  EventReconstructionThreadPool(const EventReconstructionThreadPool&) = delete;
+  EventReconstructionThreadPool(EventReconstructionThreadPool&&) = delete;
+  EventReconstructionThreadPool& operator=(const EventReconstructionThreadPool&) = delete;
+  EventReconstructionThreadPool& operator=(EventReconstructionThreadPool&&) = delete;
+
+  int NumberOfThreads() const { return workers_.size(); }
+
+  /**
+   * reconstruct a batch of events. This function blocks until all the events are processed.
+   * @param hitsBatch vector of hit vectors, one for each event.
+   * @param baseEvents base events, one for each event.
+   * @param eventsReconstructed (output) reconstructed events for each event, in the input order.
+   * @param results (output) true if the reconstruction of each event is successful.
+   */
+  void reconstruct(const std::vector<std::vector<DetectorHit_sptr>>& hitsBatch,
+                   const std::vector<BasicComptonEvent>& baseEvents,
+                   std::vector<std::vector<BasicComptonEvent_sptr>>& eventsReconstructed,
+                   std::vector<bool>& results);
+
+private:
+  void run(std::size_t workerIndex);
+  void processBatch(VEventReconstructionAlgorithm& algorithm);
+
+private:
+  std::vector<std::unique_ptr<VEventReconstructionAlgorithm>> algorithms_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable batchStarted_;
+  std::condition_variable batchFinished_;
+  uint64_t batchGeneration_ = 0;
+  int numActiveWorkers_ = 0;
+  bool stopping_ = false;
+
+  const std::vector<std::vector<DetectorHit_sptr>>* hitsBatch_ = nullptr;
+  const std::vector<BasicComptonEvent>* baseEvents_ = nullptr;
+  std::vector<std::vector<BasicComptonEvent_sptr>>* eventsReconstructed_ = nullptr;
+  std::vector<char> results_;
+  std::atomic<std::size_t> nextIndex_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_EventReconstructionThreadPool_H */
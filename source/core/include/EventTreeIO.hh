@@ -23,10 +23,12 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <array>
+#include <vector>
+#include <string>
 #include "DetectorHit_sptr.hh"
 
 class TTree;
+class TBranch;
 
 namespace comptonsoft {
 
@@ -37,22 +39,42 @@ namespace comptonsoft {
  * @date 2016-09-07
  * @date 2020-11-24 | add the particle branch
  * @date 2020-12-25 | add the track ID branch
+ * @date 2026-10-17 | add getRealTime()
+ * @date 2026-10-17 | growable hit buffers, branch selection
+ * @date 2026-10-17 | num_hits branch keyed on the tree number
  */
 class EventTreeIO
 {
 public:
-  static const std::size_t MaxHits = 65536;
+  static const std::size_t InitialCapacity = 64;
   
 public:
   EventTreeIO();
   virtual ~EventTreeIO();
 
-  virtual void setTree(TTree* tree)
-  { tree_ = tree; }
+  virtual void setTree(TTree* tree);
 
   virtual void defineBranches();
   virtual void setBranchAddresses();
 
+  /**
+   * read an entry of the tree.
+   * The hit buffers are enlarged before reading if the entry has more hits
+   * than their capacity, so entries must be read by this function
+   * instead of TTree::GetEntry().
+   * @return the return value of TTree::GetEntry().
+   */
+  int getEntry(int64_t entry);
+
+  /**
+   * read only the given branches in the following entries.
+   * The num_hits branch is always read. The buffers of the other branches keep their values.
+   */
+  void readOnlyBranches(const std::vector<std::string>& branches);
+  void readAllBranches();
+
+  std::size_t HitCapacity() const { return capacity_; }
+
   void fillHits(int64_t eventID, const std::vector<DetectorHit_sptr>& hits);
   void fillHits(const std::vector<DetectorHit_sptr>& hits)
   { fillHits(-1, hits); }
@@ -60,11 +82,20 @@ public:
 
   int64_t getEventID() const { return eventid_; }
   int64_t getNumberOfHits() const { return num_hits_; }
+  double getRealTime(std::size_t i) const;
   DetectorHit_sptr retrieveHit(std::size_t i) const;
   std::vector<DetectorHit_sptr> retrieveHits(int64_t& entry, bool get_entry=true);
   
+private:
+  void reserveHits(std::size_t n);
+  void setHitBranchAddresses();
+
 private:
   TTree* tree_;
+  bool branchesBound_ = false;
+  std::size_t capacity_ = 0;
+  int currentTreeNumber_ = -1;
+  TBranch* numHitsBranch_ = nullptr;
 
   /*
    * tree contents
@@ -74,40 +105,40 @@ private:
   // measured data
   int64_t ti_ = 0;
   int16_t instrument_ = 0;
-  std::array<int16_t, MaxHits> detector_;
-  std::array<int16_t, MaxHits> det_section_;
-  std::array<int16_t, MaxHits> readout_module_;
-  std::array<int16_t, MaxHits> section_;
-  std::array<int16_t, MaxHits> channel_;
-  std::array<int16_t, MaxHits> pixelx_;
-  std::array<int16_t, MaxHits> pixely_;
-  std::array<int16_t, MaxHits> pixelz_;
-  std::array<int32_t, MaxHits> rawpha_;
-  std::array<float, MaxHits> pha_;
-  std::array<float, MaxHits> epi_;
+  std::vector<int16_t> detector_;
+  std::vector<int16_t> det_section_;
+  std::vector<int16_t> readout_module_;
+  std::vector<int16_t> section_;
+  std::vector<int16_t> channel_;
+  std::vector<int16_t> pixelx_;
+  std::vector<int16_t> pixely_;
+  std::vector<int16_t> pixelz_;
+  std::vector<int32_t> rawpha_;
+  std::vector<float> pha_;
+  std::vector<float> epi_;
   uint64_t flag_data_ = 0ul;
   uint64_t flags_ = 0ul;
   // simulation
-  std::array<int32_t, MaxHits> trackid_;
-  std::array<int32_t, MaxHits> particle_;
-  std::array<double, MaxHits> real_time_;
-  std::array<double, MaxHits> time_trig_;
-  std::array<int16_t, MaxHits> time_group_;
-  std::array<float, MaxHits> real_posx_;
-  std::array<float, MaxHits> real_posy_;
-  std::array<float, MaxHits> real_posz_;
-  std::array<float, MaxHits> edep_;
-  std::array<float, MaxHits> echarge_;
-  std::array<uint32_t, MaxHits> process_;
+  std::vector<int32_t> trackid_;
+  std::vector<int32_t> particle_;
+  std::vector<double> real_time_;
+  std::vector<double> time_trig_;
+  std::vector<int16_t> time_group_;
+  std::vector<float> real_posx_;
+  std::vector<float> real_posy_;
+  std::vector<float> real_posz_;
+  std::vector<float> edep_;
+  std::vector<float> echarge_;
+  std::vector<uint32_t> process_;
   // reconstructed
-  std::array<float, MaxHits> energy_;
-  std::array<float, MaxHits> posx_;
-  std::array<float, MaxHits> posy_;
-  std::array<float, MaxHits> posz_;
-  std::array<float, MaxHits> local_posx_;
-  std::array<float, MaxHits> local_posy_;
-  std::array<float, MaxHits> local_posz_;
-  std::array<double, MaxHits> time_;
+  std::vector<float> energy_;
+  std::vector<float> posx_;
+  std::vector<float> posy_;
+  std::vector<float> posz_;
+  std::vector<float> local_posx_;
+  std::vector<float> local_posy_;
+  std::vector<float> local_posz_;
+  std::vector<double> time_;
   int32_t grade_ = 0;
 };
 
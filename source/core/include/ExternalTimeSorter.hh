@@ -0,0 +1,118 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ExternalTimeSorter_H
+#define COMPTONSOFT_ExternalTimeSorter_H 1
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+
+namespace comptonsoft {
+
+/**
+ * A sorter of (time, entry) keys that can exceed the memory.
+ * Keys are accumulated in a chunk of bounded size, and every full chunk is sorted
+ * and written to a temporary run file. After finish(), next() returns the keys
+ * in time order by a k-way heap merge of the runs, reading each run through a small buffer.
+ * Keys of the same time are returned in the order of the entries.
+ * If all the keys fit in one chunk, no file is written.
+ * The memory budget is shared by the run buffers during the merge, but each buffer
+ * holds at least 1024 keys, so a very small budget may be exceeded.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class ExternalTimeSorter
+{
+public:
+  struct Key
+  {
+    double time;
+    int64_t entry;
+  };
+
+public:
+  /**
+   * constructor.
+   * @param memoryBudget upper limit of the memory used for the keys in bytes.
+   * @param directory directory where run files are created.
+   */
+  ExternalTimeSorter(std::size_t memoryBudget, const std::string& directory);
+  ~ExternalTimeSorter();
+  ExternalTimeSorter(const ExternalTimeSorter&) = delete;
+  ExternalTimeSorter(ExternalTimeSorter&&) = delete;
+  ExternalTimeSorter& operator=(const ExternalTimeSorter&) = delete;
+  ExternalTimeSorter& operator=(ExternalTimeSorter&&) = delete;
+
+  /**
+   * add a key. This must not be called after finish().
+   * @return false if a run file cannot be written.
+   */
+  bool add(double time, int64_t entry);
+
+  /**
+   * finish adding keys, and prepare for the merge.
+   * @return false if a run file cannot be written or read.
+   */
+  bool finish();
+
+  /**
+   * get the next key in time order.
+   * @return false if all the keys have been returned.
+   */
+  bool next(Key& key);
+
+  std::size_t NumberOfKeys() const { return numKeys_; }
+  std::size_t NumberOfRuns() const { return runs_.size(); }
+
+private:
+  struct Run
+  {
+    std::string filename;
+    std::ifstream file;
+    std::vector<Key> buffer;
+    std::size_t position = 0;
+    std::size_t numRemaining = 0;
+  };
+
+  bool writeRun();
+  bool refill(Run& run);
+  void removeRunFiles();
+
+private:
+  const std::size_t chunkSize_;
+  const std::string directory_;
+  std::size_t numKeys_ = 0;
+  bool finished_ = false;
+
+  std::vector<Key> chunk_;
+  std::size_t chunkPosition_ = 0;
+  std::vector<std::unique_ptr<Run>> runs_;
+
+  /* heap of the current keys of the runs; the second is the run index */
+  std::vector<std::pair<Key, std::size_t>> heap_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ExternalTimeSorter_H */
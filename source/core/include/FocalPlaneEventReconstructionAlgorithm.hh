@@ -39,6 +39,9 @@ public:
   FocalPlaneEventReconstructionAlgorithm& operator=(const FocalPlaneEventReconstructionAlgorithm&) = default;
   FocalPlaneEventReconstructionAlgorithm& operator=(FocalPlaneEventReconstructionAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new FocalPlaneEventReconstructionAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
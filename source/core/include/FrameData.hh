@@ -24,8 +24,10 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include "XrayEvent.hh"
-#include "OutlierStore.hh"
+#include "OutlierStoreArray.hh"
+#include "EventCandidateFinder.hh"
 
 namespace comptonsoft
 {
@@ -44,6 +46,10 @@ class VGainFunction;
  * @date 2020-07-31 | Hirokazu odaka | byte order of raw data
  * @date 2020-08-01 | Hirokazu odaka | pixel shift at odd rows
  * @date 2021-09-13 | Taihei Watanabe | extract events by checking eventCheckPixels
+ * @date 2026-10-17 | Hirokazu Odaka | memory-mapped loading with specialized decoders
+ * @date 2026-10-17 | Hirokazu Odaka | outlier stores of all pixels in one block
+ * @date 2026-10-17 | Hirokazu Odaka | event candidates found by EventCandidateFinder
+ * @date 2026-10-17 | Hirokazu Odaka | raw frames read outside the frame and swapped in
  */
 class FrameData
 {
@@ -51,6 +57,16 @@ public:
   using flags_t = boost::multi_array<int, 2>;
   enum class CornerID { BottomLeft=0, UpperLeft=1, BottomRight=2, UpperRight=3 };
 
+  /**
+   * working buffers used to read and decode a raw frame file.
+   */
+  struct DecodeBuffers
+  {
+    std::vector<char> file;
+    std::vector<uint16_t> rows;
+    std::vector<double> unshifted;
+  };
+
 public:
   FrameData(int nx, int ny);
   virtual ~FrameData();
@@ -88,6 +104,25 @@ public:
   
   void resetRawFrame();
   virtual bool load(const std::string& filename);
+
+  /**
+   * read a raw frame file into an image with the decoding settings of this frame.
+   * The frame itself is not modified, so this function can be called from
+   * another thread while the frame is being processed, unless the settings are changed.
+   * @param filename name of the raw frame file.
+   * @param image (output) image of the same size as the frame.
+   * @param buffers working buffers, which must not be shared with another thread.
+   * A file shorter than a frame overwrites only the beginning of buffers.file.
+   */
+  bool readRawFrame(const std::string& filename,
+                    image_t& image,
+                    DecodeBuffers& buffers) const;
+
+  /**
+   * exchange the raw frame with the given image without copying the pixels.
+   * The image must have the same size as the frame.
+   */
+  void swapRawFrame(std::unique_ptr<image_t>& image);
   void stack();
 
   void setPedestals(double v);
@@ -98,10 +133,10 @@ public:
   void selectGoodPixels(double mean_min, double mean_max,
                         double sigma_min, double sigma_max);
 
-  void setRawFrame(const image_t& v) { rawFrame_ = v; }
+  void setRawFrame(const image_t& v) { *rawFrame_.image = v; }
   void setFrame(const image_t& v) { frame_ = v; }
-  const image_t& getRawFrame() const { return rawFrame_; }
-  image_t& getRawFrame() { return rawFrame_; }
+  const image_t& getRawFrame() const { return *rawFrame_.image; }
+  image_t& getRawFrame() { return *rawFrame_.image; }
   const image_t& getFrame() const { return frame_; }
   image_t& getFrame() { return frame_; }
 
@@ -132,6 +167,12 @@ public:
   void clearEventCheckPixels() { eventCheckPixels_.clear(); }
   void addEventCheckPixels(int ix, int iy) { eventCheckPixels_.emplace_back(ix, iy); }
 
+  /**
+   * set the number of threads used to find event candidates.
+   */
+  void setNumEventExtractionThreads(int v) { candidateFinder_.setNumThreads(v); }
+  int NumEventExtractionThreads() const { return candidateFinder_.NumThreads(); }
+
   void setTrimSize(int v) { trimSize_ = v; }
   int TrimSize() { return trimSize_; }
 
@@ -142,9 +183,21 @@ public:
   void correctGains();
 
 protected:
+  /**
+   * find event-center candidates of the current frame among eventCheckPixels.
+   * @return the candidates in the order of eventCheckPixels, valid until the next call.
+   */
+  const std::vector<std::pair<int, int>>& findEventCandidates(const EventCandidateFinder::Criteria& criteria);
+  EventCandidateFinder& getEventCandidateFinder() { return candidateFinder_; }
+
   bool isMaxPixel(int ix, int iy, int size) const;
   bool includeDisabledPixel(int ix, int iy, int size) const;
 
+  /**
+   * convert raw 16-bit data of a whole frame into an image.
+   */
+  void decodeRawFrame(const char* data, image_t& image, DecodeBuffers& buffers) const;
+
   VGainFunction* getGainFunction(int ix, int iy) const;
   double correctGain(int ix, int iy, double pha) const;
 
@@ -152,6 +205,15 @@ private:
   FrameData& operator=(const FrameData& r) = delete;
   FrameData& operator=(FrameData&& r) = delete;
 
+  /* an image owned through a pointer, which keeps the copy semantics of image_t */
+  struct SwappableImage
+  {
+    SwappableImage(int nx, int ny) : image(new image_t(boost::extents[nx][ny])) {}
+    SwappableImage(const SwappableImage& r) : image(new image_t(*r.image)) {}
+    SwappableImage(SwappableImage&& r) = default;
+    std::unique_ptr<image_t> image;
+  };
+
 private:
   const int num_pixels_x_ = 1;
   const int num_pixels_y_ = 1;
@@ -170,10 +232,12 @@ private:
   double splitThreshold_ = 0.0;
 
   std::vector<std::pair<int, int>> eventCheckPixels_;
+  EventCandidateFinder candidateFinder_;
+  std::vector<std::pair<int, int>> hitPixels_;
 
-  std::vector<char> buf_;
+  DecodeBuffers decodeBuffers_;
 
-  image_t rawFrame_;
+  SwappableImage rawFrame_;
   image_t frame_;
   image_t pedestals_;
 
@@ -182,7 +246,7 @@ private:
   image_t sum2_;
   image_t deviation_;
   flags_t disabledPixels_;
-  boost::multi_array<std::unique_ptr<OutlierStore>, 2> pixelValuesToExclude_;
+  OutlierStoreArray pixelValuesToExclude_;
 
   using gain_func_array_t = boost::multi_array<std::shared_ptr<VGainFunction>, 2>;
   bool shareGainFunction_ = true;
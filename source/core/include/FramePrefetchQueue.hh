@@ -0,0 +1,112 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_FramePrefetchQueue_H
+#define COMPTONSOFT_FramePrefetchQueue_H 1
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include "XrayEvent.hh"
+
+namespace comptonsoft {
+
+/**
+ * A bounded queue of frames that are read in advance by a background thread.
+ * A reader function is pushed for each frame, and the background thread
+ * runs them in order, each filling one of the image buffers owned by the queue.
+ * pop() hands over the oldest image by exchanging it with an image of the caller,
+ * which is then reused as a buffer, so that no pixel is copied.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ * @date 2026-10-17 | exceptions of the readers are caught
+ */
+class FramePrefetchQueue
+{
+public:
+  using reader_t = std::function<bool (image_t& image)>;
+
+public:
+  /**
+   * constructor.
+   * @param capacity maximum number of frames read in advance.
+   * @param image initial content of all the buffers. Pixels that a reader does
+   * not write keep the values of this image or of the image last exchanged.
+   */
+  FramePrefetchQueue(std::size_t capacity, const image_t& image);
+  ~FramePrefetchQueue();
+  FramePrefetchQueue(const FramePrefetchQueue&) = delete;
+  FramePrefetchQueue(FramePrefetchQueue&&) = delete;
+  FramePrefetchQueue& operator=(const FramePrefetchQueue&) = delete;
+  FramePrefetchQueue& operator=(FramePrefetchQueue&&) = delete;
+
+  std::size_t Capacity() const { return slots_.size(); }
+
+  /**
+   * return the number of frames pushed but not popped yet.
+   */
+  std::size_t size() const;
+  bool isFull() const { return size() == Capacity(); }
+
+  /**
+   * add a reader of the next frame. The queue must not be full.
+   */
+  void push(reader_t reader);
+
+  /**
+   * wait for the oldest frame, and exchange it with the given image.
+   * @param image image to be exchanged. It has the same size as the buffers.
+   * @return the return value of the reader, or false if the reader threw an exception.
+   */
+  bool pop(std::unique_ptr<image_t>& image);
+
+private:
+  void run();
+
+private:
+  struct Slot
+  {
+    std::unique_ptr<image_t> image;
+    reader_t reader;
+    bool status = false;
+    std::string error;
+  };
+
+  std::vector<Slot> slots_;
+  std::thread worker_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable pushed_;
+  std::condition_variable completed_;
+  uint64_t numPushed_ = 0;
+  uint64_t numCompleted_ = 0;
+  uint64_t numPopped_ = 0;
+  bool stopping_ = false;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_FramePrefetchQueue_H */
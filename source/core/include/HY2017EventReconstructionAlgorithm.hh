@@ -41,6 +41,9 @@ public:
   HY2017EventReconstructionAlgorithm& operator=(const HY2017EventReconstructionAlgorithm&) = default;
   HY2017EventReconstructionAlgorithm& operator=(HY2017EventReconstructionAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new HY2017EventReconstructionAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
@@ -65,7 +68,7 @@ protected:
   bool reconstructOrderedHits(const std::vector<DetectorHit_sptr>& ordered_hits,
                               BasicComptonEvent& eventReconstructed,
                               double incident_energy,
-                              bool is_escape_event = false);
+                              bool is_escape_event = false) override;
 
   double calReconstructionFraction(const std::vector<DetectorHit_sptr>& ordered_hits,
                                    double incident_energy,
@@ -34,6 +34,7 @@ namespace comptonsoft {
  * @date 2020-11-18 | Hiroki Yoneda
  * @date 2021-01-04 | Hirokazu Odaka | code cleanup
  * @date 2022-12-28 | Hiroki Yoneda | code cleanup
+ * @date 2026-10-17 | Hirokazu Odaka | scattering-order search in the base class
  */
 class HY2020EventReconstructionAlgorithm : public VEventReconstructionAlgorithm
 {
@@ -45,6 +46,9 @@ public:
   HY2020EventReconstructionAlgorithm& operator=(const HY2020EventReconstructionAlgorithm&) = default;
   HY2020EventReconstructionAlgorithm& operator=(HY2020EventReconstructionAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new HY2020EventReconstructionAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
@@ -72,7 +76,12 @@ protected:
   bool reconstructOrderedHits(const std::vector<DetectorHit_sptr>& ordered_hits,
                               BasicComptonEvent& eventReconstructed,
                               double incident_energy,
-                              bool is_escape_event = false);
+                              bool is_escape_event = false) override;
+
+  double energyMarginForScatteringAngle(double energy) override;
+
+  bool checksFirstScatteringKinematics() const override
+  { return kinematics_check_; }
 
   double calLikelihood(const std::vector<DetectorHit_sptr>& ordered_hits,
                        double incident_energy,
@@ -0,0 +1,168 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_HitColumnStore_H
+#define COMPTONSOFT_HitColumnStore_H 1
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "CSTypes.hh"
+#include "DetectorHit_sptr.hh"
+#include "ColumnFile.hh"
+
+namespace comptonsoft {
+
+/**
+ * A writer of a columnar hit store, an alternative to hit trees and event trees.
+ *
+ * A store is a directory with one column file (NAME.col) per quantity.
+ * Each fillHits() makes one event, which corresponds to one entry of an event tree.
+ * The per-hit columns have the same names, types, and units as the branches of a hit tree.
+ * The per-event columns are eventid, event_offsets (index of the first hit of each event,
+ * with the total number of hits at the end), and the initial information if enabled.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class HitColumnStoreWriter
+{
+public:
+  HitColumnStoreWriter();
+  ~HitColumnStoreWriter();
+  HitColumnStoreWriter(const HitColumnStoreWriter&) = delete;
+  HitColumnStoreWriter& operator=(const HitColumnStoreWriter&) = delete;
+
+  /**
+   * create a store. The directory is created if it does not exist.
+   * @param directory path of the store.
+   * @param initialInfo true if the initial information is recorded.
+   * @param compression true if integer columns are delta-encoded.
+   * @return false if a column file cannot be created.
+   */
+  bool open(const std::string& directory, bool initialInfo, bool compression);
+  bool close();
+
+  void setInitialInfo(double energy,
+                      const vector3_t& direction,
+                      double time,
+                      const vector3_t& position,
+                      const vector3_t& polarization);
+  void setWeight(double v) { weight_ = v; }
+
+  /**
+   * add an event.
+   * @param eventID event ID. If negative, the event ID of the first hit is used.
+   * @param hits hits of the event, which may be empty.
+   */
+  void fillHits(int64_t eventID, const std::vector<DetectorHit_sptr>& hits);
+
+  uint64_t NumberOfEvents() const { return numEvents_; }
+  uint64_t NumberOfHits() const { return numHits_; }
+
+private:
+  std::vector<std::unique_ptr<ColumnWriter>> eventColumns_;
+  std::vector<std::unique_ptr<ColumnWriter>> hitColumns_;
+  bool initialInfo_ = false;
+  uint64_t numEvents_ = 0;
+  uint64_t numHits_ = 0;
+
+  double iniEnergy_ = 0.0;
+  vector3_t iniDirection_;
+  double iniTime_ = 0.0;
+  vector3_t iniPosition_;
+  vector3_t iniPolarization_;
+  double weight_ = 1.0;
+};
+
+/**
+ * A reader of a columnar hit store.
+ * The columns are memory-mapped, and each of them can be accessed as a span
+ * of values without copy unless it is delta-encoded.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class HitColumnStoreReader
+{
+public:
+  HitColumnStoreReader();
+  ~HitColumnStoreReader();
+  HitColumnStoreReader(const HitColumnStoreReader&) = delete;
+  HitColumnStoreReader& operator=(const HitColumnStoreReader&) = delete;
+
+  /**
+   * open a store.
+   * @return false if a column is missing or broken.
+   */
+  bool open(const std::string& directory);
+  void close();
+
+  std::size_t NumberOfEvents() const { return eventIDs_.size(); }
+  std::size_t NumberOfHits() const { return offsets_.empty() ? 0 : offsets_[offsets_.size()-1]; }
+  bool hasInitialInfo() const { return initialInfo_; }
+
+  int64_t EventID(std::size_t event) const { return eventIDs_[event]; }
+  std::size_t FirstHit(std::size_t event) const { return offsets_[event]; }
+  std::size_t NumberOfHits(std::size_t event) const { return offsets_[event+1]-offsets_[event]; }
+
+  /**
+   * return the values of a column.
+   * For a per-hit column, the hits of an event are in
+   * [FirstHit(event), FirstHit(event)+NumberOfHits(event)).
+   * @return an empty span if the column does not exist or T does not match its type.
+   */
+  template <typename T>
+  ColumnSpan<T> column(const std::string& name) const
+  {
+    const ColumnReader* reader = findColumn(name);
+    return reader ? reader->span<T>() : ColumnSpan<T>();
+  }
+
+  std::vector<DetectorHit_sptr> retrieveHits(std::size_t event) const;
+
+  double InitialEnergy(std::size_t event) const;
+  vector3_t InitialDirection(std::size_t event) const;
+  double InitialTime(std::size_t event) const;
+  vector3_t InitialPosition(std::size_t event) const;
+  vector3_t InitialPolarization(std::size_t event) const;
+  double Weight(std::size_t event) const;
+
+private:
+  const ColumnReader* findColumn(const std::string& name) const;
+  DetectorHit_sptr retrieveHit(int64_t eventID, std::size_t hit) const;
+
+  template <typename T>
+  const T& value(const std::vector<std::unique_ptr<ColumnReader>>& columns,
+                 int index, std::size_t i) const
+  { return columns[index]->span<T>()[i]; }
+
+private:
+  std::vector<std::unique_ptr<ColumnReader>> eventColumns_;
+  std::vector<std::unique_ptr<ColumnReader>> hitColumns_;
+  bool initialInfo_ = false;
+  ColumnSpan<int64_t> eventIDs_;
+  ColumnSpan<uint64_t> offsets_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_HitColumnStore_H */
@@ -0,0 +1,147 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_HitTreeBlock_H
+#define COMPTONSOFT_HitTreeBlock_H 1
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "CSTypes.hh"
+#include "DetectorHit_sptr.hh"
+
+namespace comptonsoft {
+
+/**
+ * A block of consecutive entries of a hit tree, read by HitTreeIO::readBlock().
+ * The entries are held in columns, one vector for each branch, which are
+ * filled branch by branch. The ihit branch is not read.
+ * Indices of the methods are relative to the first entry of the block.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ * @date 2026-10-17 | columns
+ */
+class HitTreeBlock
+{
+public:
+  struct InitialInfo
+  {
+    double energy = 0.0;
+    vector3_t direction;
+    double time = 0.0;
+    vector3_t position;
+    vector3_t polarization;
+    double weight = 1.0;
+  };
+
+  /**
+   * columns named after the branches; see HitTreeIO::Entry.
+   */
+  struct Columns
+  {
+    std::vector<int64_t> eventid;
+    std::vector<int32_t> num_hits;
+    // measured data
+    std::vector<int64_t> ti;
+    std::vector<int16_t> instrument;
+    std::vector<int16_t> detector;
+    std::vector<int16_t> det_section;
+    std::vector<int16_t> readout_module;
+    std::vector<int16_t> section;
+    std::vector<int16_t> channel;
+    std::vector<int16_t> pixelx;
+    std::vector<int16_t> pixely;
+    std::vector<int16_t> pixelz;
+    std::vector<int32_t> rawpha;
+    std::vector<float> pha;
+    std::vector<float> epi;
+    std::vector<float> epi_error;
+    std::vector<uint64_t> flag_data;
+    std::vector<uint64_t> flags;
+    // simulation
+    std::vector<int32_t> trackid;
+    std::vector<int32_t> particle;
+    std::vector<double> real_time;
+    std::vector<double> time_trig;
+    std::vector<int16_t> time_group;
+    std::vector<float> real_posx;
+    std::vector<float> real_posy;
+    std::vector<float> real_posz;
+    std::vector<float> edep;
+    std::vector<float> echarge;
+    std::vector<uint32_t> process;
+    // reconstructed
+    std::vector<float> energy;
+    std::vector<float> energy_error;
+    std::vector<float> posx;
+    std::vector<float> posy;
+    std::vector<float> posz;
+    std::vector<float> posx_error;
+    std::vector<float> posy_error;
+    std::vector<float> posz_error;
+    std::vector<float> local_posx;
+    std::vector<float> local_posy;
+    std::vector<float> local_posz;
+    std::vector<float> local_posx_error;
+    std::vector<float> local_posy_error;
+    std::vector<float> local_posz_error;
+    std::vector<double> time;
+    std::vector<double> time_error;
+    std::vector<int32_t> grade;
+  };
+
+public:
+  HitTreeBlock() = default;
+  ~HitTreeBlock() = default;
+  HitTreeBlock(const HitTreeBlock&) = default;
+  HitTreeBlock(HitTreeBlock&&) = default;
+  HitTreeBlock& operator=(const HitTreeBlock&) = default;
+  HitTreeBlock& operator=(HitTreeBlock&&) = default;
+
+  /**
+   * clear the columns, keeping their capacities.
+   */
+  void clear();
+
+  int64_t FirstEntry() const { return firstEntry_; }
+  void setFirstEntry(int64_t v) { firstEntry_ = v; }
+  std::size_t size() const { return columns_.eventid.size(); }
+  bool empty() const { return columns_.eventid.empty(); }
+
+  int64_t EventID(std::size_t i) const { return columns_.eventid[i]; }
+  int32_t NumberOfHits(std::size_t i) const { return columns_.num_hits[i]; }
+  DetectorHit_sptr retrieveHit(std::size_t i) const;
+
+  bool hasInitialInfo() const { return !initialInfo_.empty(); }
+  const InitialInfo& getInitialInfo(std::size_t i) const { return initialInfo_[i]; }
+
+  Columns& columns() { return columns_; }
+  const Columns& columns() const { return columns_; }
+  std::vector<InitialInfo>& initialInfo() { return initialInfo_; }
+
+private:
+  int64_t firstEntry_ = 0;
+  Columns columns_;
+  std::vector<InitialInfo> initialInfo_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_HitTreeBlock_H */
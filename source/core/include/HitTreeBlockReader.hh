@@ -0,0 +1,94 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_HitTreeBlockReader_H
+#define COMPTONSOFT_HitTreeBlockReader_H 1
+
+#include <vector>
+#include <future>
+#include <cstdint>
+#include "DetectorHit_sptr.hh"
+#include "HitTreeBlock.hh"
+
+namespace comptonsoft {
+
+class HitTreeIO;
+
+/**
+ * A sequential reader of a hit tree that reads blocks of entries and builds
+ * the hits of each event from the block.
+ * In the background mode, the next block is read in a worker thread while
+ * the current one is used; the tree and the HitTreeIO object must not be
+ * accessed by other code until this reader is destroyed.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class HitTreeBlockReader
+{
+public:
+  /**
+   * @param treeIO tree I/O whose branch addresses have been set.
+   * @param numEntries number of entries of the tree.
+   * @param blockSize number of entries read at once.
+   * @param background true if blocks are read in a worker thread.
+   */
+  HitTreeBlockReader(HitTreeIO* treeIO, int64_t numEntries, int64_t blockSize, bool background);
+  ~HitTreeBlockReader();
+  HitTreeBlockReader(const HitTreeBlockReader&) = delete;
+  HitTreeBlockReader& operator=(const HitTreeBlockReader&) = delete;
+
+  /**
+   * retrieve the hits of the next event.
+   * @param hits (output) hits of the event.
+   * @param trustNumHits if true, an event is made of num_hits entries;
+   * otherwise, of consecutive entries having the same event ID.
+   * @return false if no entry remains.
+   */
+  bool retrieveHits(std::vector<DetectorHit_sptr>& hits, bool trustNumHits=false);
+
+  /* properties of the event retrieved last */
+  int64_t EventID() const { return eventID_; }
+  bool hasInitialInfo() const { return hasInitialInfo_; }
+  const HitTreeBlock::InitialInfo& getInitialInfo() const { return initialInfo_; }
+
+private:
+  bool loadNextBlock();
+  void requestBlock(int64_t first);
+
+private:
+  HitTreeIO* treeIO_;
+  const int64_t numEntries_;
+  const int64_t blockSize_;
+  const bool background_;
+
+  HitTreeBlock current_;
+  HitTreeBlock next_;
+  std::future<int64_t> pending_;
+  int64_t nextFirst_ = 0;
+  std::size_t index_ = 0;
+
+  int64_t eventID_ = 0;
+  bool hasInitialInfo_ = false;
+  HitTreeBlock::InitialInfo initialInfo_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_HitTreeBlockReader_H */
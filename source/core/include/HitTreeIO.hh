@@ -25,9 +25,12 @@
 #include "DetectorHit_sptr.hh"
 
 class TTree;
+class TBranch;
 
 namespace comptonsoft {
 
+class HitTreeBlock;
+
 /**
  * 
  * @author Hirokazu Odaka
@@ -37,9 +40,69 @@ namespace comptonsoft {
  * @date 2020-11-24 | add the particle branch
  * @date 2020-12-25 | add the track ID branch
  * @date 2022-04-27 | add the pixel-z
+ * @date 2026-10-17 | branch contents in Entry, block reading
+ * @date 2026-10-17 | block reading branch by branch
  */
 class HitTreeIO
 {
+public:
+  /**
+   * contents of one entry of a hit tree.
+   */
+  struct Entry
+  {
+    int64_t eventid = 0;
+    int16_t ihit = 0;
+    int32_t num_hits = 0;
+    // measured data
+    int64_t ti = 0;
+    int16_t instrument = 0;
+    int16_t detector = -1;
+    int16_t det_section = -1;
+    int16_t readout_module = -1;
+    int16_t section = -1;
+    int16_t channel = -1;
+    int16_t pixelx = -1;
+    int16_t pixely = -1;
+    int16_t pixelz = -1;
+    int32_t rawpha = 0;
+    float pha = 0.0;
+    float epi = 0.0;
+    float epi_error = 0.0;
+    uint64_t flag_data = 0ul;
+    uint64_t flags = 0ul;
+    // simulation
+    int32_t trackid = 0;
+    int32_t particle = 0;
+    double real_time = 0.0;
+    double time_trig = 0.0;
+    int16_t time_group = 0;
+    float real_posx = 0.0;
+    float real_posy = 0.0;
+    float real_posz = 0.0;
+    float edep = 0.0;
+    float echarge = 0.0;
+    uint32_t process = 0u;
+    // reconstructed
+    float energy = 0.0;
+    float energy_error = 0.0;
+    float posx = 0.0;
+    float posy = 0.0;
+    float posz = 0.0;
+    float posx_error = 0.0;
+    float posy_error = 0.0;
+    float posz_error = 0.0;
+    float local_posx = 0.0;
+    float local_posy = 0.0;
+    float local_posz = 0.0;
+    float local_posx_error = 0.0;
+    float local_posy_error = 0.0;
+    float local_posz_error = 0.0;
+    double time = 0.0;
+    double time_error = 0.0;
+    int32_t grade = 0;
+  };
+
 public:
   HitTreeIO();
   virtual ~HitTreeIO();
@@ -54,11 +117,36 @@ public:
   void fillHits(const std::vector<DetectorHit_sptr>& hits)
   { fillHits(-1, hits); }
 
-  int64_t getEventID() const { return eventid_; }
-  int64_t getNumberOfHits() const { return num_hits_; }
-  DetectorHit_sptr retrieveHit() const;
+  int64_t getEventID() const { return entry_.eventid; }
+  int64_t getNumberOfHits() const { return entry_.num_hits; }
+  DetectorHit_sptr retrieveHit() const { return retrieveHit(entry_); }
   std::vector<DetectorHit_sptr> retrieveHits(int64_t& entry,
                                              bool get_first_entry=true);
+
+  /**
+   * read consecutive entries into a block.
+   * Each branch is read separately over the entries into a column of the block.
+   * This may be called from a worker thread as long as no other thread
+   * uses this object or the tree meanwhile.
+   * @param first first entry to read.
+   * @param n number of entries to read.
+   * @param block (output) block of the entries.
+   * @return number of entries read, which is less than n at the end of the tree.
+   */
+  int64_t readBlock(int64_t first, int64_t n, HitTreeBlock& block);
+
+  static DetectorHit_sptr retrieveHit(const Entry& entry);
+
+  /**
+   * find a branch of a tree; throws CSException if it does not exist.
+   */
+  static TBranch* findBranch(TTree* tree, const char* name);
+
+protected:
+  /**
+   * read entries [first, first+n) of the tree (not a chain) into the block.
+   */
+  virtual void readColumns(TTree* tree, int64_t first, int64_t n, HitTreeBlock& block);
   
 private:
   TTree* hittree_;
@@ -66,56 +154,7 @@ private:
   /*
    * tree contents
    */
-  int64_t eventid_ = 0;
-  int16_t ihit_ = 0;
-  int32_t num_hits_ = 0;
-  // measured data
-  int64_t ti_ = 0;
-  int16_t instrument_ = 0;
-  int16_t detector_ = -1;
-  int16_t det_section_ = -1;
-  int16_t readout_module_ = -1;
-  int16_t section_ = -1;
-  int16_t channel_ = -1;
-  int16_t pixelx_ = -1;
-  int16_t pixely_ = -1;
-  int16_t pixelz_ = -1;
-  int32_t rawpha_ = 0;
-  float pha_ = 0.0;
-  float epi_ = 0.0;
-  float epi_error_ = 0.0;
-  uint64_t flag_data_ = 0ul;
-  uint64_t flags_ = 0ul;
-  // simulation
-  int32_t trackid_ = 0;
-  int32_t particle_ = 0;
-  double real_time_ = 0.0;
-  double time_trig_ = 0.0;
-  int16_t time_group_ = 0;
-  float real_posx_ = 0.0;
-  float real_posy_ = 0.0;
-  float real_posz_ = 0.0;
-  float edep_ = 0.0;
-  float echarge_ = 0.0;
-  uint32_t process_ = 0u;
-  // reconstructed
-  float energy_ = 0.0;
-  float energy_error_ = 0.0;
-  float posx_ = 0.0;
-  float posy_ = 0.0;
-  float posz_ = 0.0;
-  float posx_error_ = 0.0;
-  float posy_error_ = 0.0;
-  float posz_error_ = 0.0;
-  float local_posx_ = 0.0;
-  float local_posy_ = 0.0;
-  float local_posz_ = 0.0;
-  float local_posx_error_ = 0.0;
-  float local_posy_error_ = 0.0;
-  float local_posz_error_ = 0.0;
-  double time_ = 0.0;
-  double time_error_ = 0.0;
-  int32_t grade_ = 0;
+  Entry entry_;
 };
 
 } /* namespace comptonsoft */
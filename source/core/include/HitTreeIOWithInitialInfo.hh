@@ -29,6 +29,8 @@ namespace comptonsoft {
  * 
  * @author Hirokazu Odaka
  * @date 2014-12-02
+ * @date 2026-10-17 | initial information in blocks
+ * @date 2026-10-17 | read by branch
  */
 class HitTreeIOWithInitialInfo : public HitTreeIO, public InitialInfoTreeIO
 {
@@ -39,6 +41,9 @@ public:
   void setTree(TTree* tree);
   void defineBranches();
   void setBranchAddresses();
+
+protected:
+  void readColumns(TTree* tree, int64_t first, int64_t n, HitTreeBlock& block) override;
 };
 
 } /* namespace comptonsoft */
@@ -31,6 +31,7 @@ namespace comptonsoft {
  * @author Hirokazu Odaka
  * @date 2014-12-02
  * @date 2016-09-07 | time_ is double.
+ * @date 2026-10-17 | isInitialInfoRecordEnabled()
  */
 class InitialInfoTreeIO
 {
@@ -42,6 +43,7 @@ public:
 
   void enableInitialInfoRecord() { enabled_ = true; }
   void disableInitialInfoRecord() { enabled_ = false; }
+  bool isInitialInfoRecordEnabled() const { return enabled_; }
 
   virtual void defineBranches();
   virtual void setBranchAddresses();
@@ -0,0 +1,68 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_MappedFile_H
+#define COMPTONSOFT_MappedFile_H 1
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace comptonsoft {
+
+/**
+ * A read-only memory mapping of a whole file.
+ *
+ * The contents are paged in by the operating system on access, and the
+ * pages are shared by all processes that map the same file.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * map a file.
+   * @return false if the file cannot be opened or is empty.
+   */
+  bool open(const std::string& filename);
+  void close();
+
+  bool isOpen() const { return region_ != nullptr; }
+  const std::string& Filename() const { return filename_; }
+  const char* data() const;
+  std::size_t size() const;
+
+private:
+  std::string filename_;
+  std::unique_ptr<boost::interprocess::file_mapping> mapping_;
+  std::unique_ptr<boost::interprocess::mapped_region> region_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_MappedFile_H */
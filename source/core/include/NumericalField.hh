@@ -22,21 +22,34 @@
 #define COMPTONSOFT_NumericalField_H 1
 
 #include <vector>
-#include <boost/multi_array.hpp>
+#include <string>
+#include <memory>
+#include <boost/align/aligned_allocator.hpp>
 #include "CSTypes.hh"
 
 namespace comptonsoft {
 
+class MappedFile;
+
 /**
  * A field fucntion with a numerical table
  *
+ * The values are stored in one contiguous, cache-line aligned array in the
+ * order of (x, y, z) with z running fastest, and are trilinearly
+ * interpolated. A grid with uniform spacing is found in O(1); otherwise a
+ * binary search is used.
+ * The table can be saved to a binary file, which is memory-mapped when it is
+ * loaded again, so that a large field is neither rebuilt nor parsed.
+ *
  * @author Hirokazu Odaka
  * @date 2020-04-18
+ * @date 2026-10-17 | flat storage, O(1) lookup on uniform grids, batched queries, binary file
+ * @date 2026-10-17 | parameters stored in the binary file
  */
 class NumericalField
 {
 public:
-  NumericalField() = default;
+  NumericalField();
   virtual ~NumericalField();
 
   void defineGrids(const std::vector<double>& xs,
@@ -44,12 +57,12 @@ public:
                    const std::vector<double>& zs);
   void setZeros();
   
-  std::size_t num_x() const { return xs_.size(); }
-  std::size_t num_y() const { return ys_.size(); }
-  std::size_t num_z() const { return zs_.size(); }
-  double get_x(std::size_t i) const { return xs_[i]; }
-  double get_y(std::size_t i) const { return ys_[i]; }
-  double get_z(std::size_t i) const { return zs_[i]; }
+  std::size_t num_x() const { return xs_.points.size(); }
+  std::size_t num_y() const { return ys_.points.size(); }
+  std::size_t num_z() const { return zs_.points.size(); }
+  double get_x(std::size_t i) const { return xs_.points[i]; }
+  double get_y(std::size_t i) const { return ys_.points[i]; }
+  double get_z(std::size_t i) const { return zs_.points[i]; }
   vector3_t get_position(std::size_t ix,
                          std::size_t iy,
                          std::size_t iz) const
@@ -62,14 +75,15 @@ public:
                        std::size_t iz,
                        double v)
   {
-    field_[ix][iy][iz] = v;
+    if (mappedFile_) { detachFromFile(); }
+    values_[index(ix, iy, iz)] = v;
   }
 
   double get_field_value(std::size_t ix,
                          std::size_t iy,
                          std::size_t iz) const
   {
-    return field_[ix][iy][iz];
+    return data_[index(ix, iy, iz)];
   }
 
   double field(double x, double y, double z) const;
@@ -79,13 +93,67 @@ public:
     return field(position.x(), position.y(), position.z());
   }
 
+  /**
+   * batched version of field().
+   * @param xs array of x (size n).
+   * @param ys array of y (size n).
+   * @param zs array of z (size n).
+   * @param values (output) array of the field values (size n).
+   * @param n number of positions.
+   */
+  void field(const double* xs, const double* ys, const double* zs,
+             double* values, std::size_t n) const;
+
+  /**
+   * set parameters describing how the table was made (at most 8 values),
+   * which are saved with the table and checked by the user when it is loaded.
+   * @return false if there are too many parameters.
+   */
+  bool setParameters(const std::vector<double>& v);
+  const std::vector<double>& Parameters() const { return parameters_; }
+
+  /**
+   * save the grids, the parameters and the values to a binary file (native byte order).
+   * @return false if the file cannot be written.
+   */
+  bool save(const std::string& filename) const;
+
+  /**
+   * load a binary file written by save(). The file is memory-mapped and
+   * the values are read directly from the mapping.
+   * @return false if the file cannot be mapped or is not a valid field file.
+   */
+  bool load(const std::string& filename);
+
+private:
+  struct Axis
+  {
+    std::vector<double> points;
+    bool uniform = false;
+    double origin = 0.0;
+    double inverseSpacing = 0.0;
+
+    void define(const std::vector<double>& xs);
+    void findIndexPair(double a, std::size_t& i0, std::size_t& i1) const;
+  };
+
+  std::size_t index(std::size_t ix, std::size_t iy, std::size_t iz) const
+  {
+    return (ix*num_y() + iy)*num_z() + iz;
+  }
+
+  void detachFromFile();
+
 private:
-  std::vector<double> xs_;
-  std::vector<double> ys_;
-  std::vector<double> zs_;
-  boost::multi_array<double, 3> field_;
+  Axis xs_;
+  Axis ys_;
+  Axis zs_;
+  std::vector<double> parameters_;
+  std::vector<double, boost::alignment::aligned_allocator<double, 64>> values_;
+  std::unique_ptr<MappedFile> mappedFile_;
+  const double* data_ = nullptr;
 };
 
 } /* namespace comptonsoft */
 
-#endif /* COMPTONSOFT_NumericalField_H */
\ No newline at end of file
+#endif /* COMPTONSOFT_NumericalField_H */
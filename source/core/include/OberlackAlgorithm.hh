@@ -34,6 +34,7 @@ namespace comptonsoft {
  * @date 2020-11-18 | Hiroki Yoneda
  * @date 2021-01-04 | Hirokazu Odaka | code cleanup
  * @date 2022-12-28 | Hiroki Yoneda | review
+ * @date 2026-10-17 | Hirokazu Odaka | scattering-order search in the base class
  */
 class OberlackAlgorithm : public VEventReconstructionAlgorithm
 {
@@ -45,6 +46,9 @@ public:
   OberlackAlgorithm& operator=(const OberlackAlgorithm&) = default;
   OberlackAlgorithm& operator=(OberlackAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new OberlackAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
@@ -72,7 +76,9 @@ protected:
   bool reconstructOrderedHits(const std::vector<DetectorHit_sptr>& ordered_hits,
                               BasicComptonEvent& eventReconstructed,
                               double incident_energy,
-                              bool is_escape_event = false);
+                              bool is_escape_event = false) override;
+
+  double energyMarginForScatteringAngle(double energy) override;
 
   double calFOM(const std::vector<DetectorHit_sptr>& ordered_hits,
                        double incident_energy,
@@ -0,0 +1,105 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_OutlierStoreArray_H
+#define COMPTONSOFT_OutlierStoreArray_H 1
+
+#include <vector>
+#include <cstddef>
+#include <boost/align/aligned_allocator.hpp>
+
+namespace comptonsoft
+{
+
+/**
+ * A set of outlier stores, one for each pixel, which behaves as an array of
+ * OutlierStore objects that always receive one value per pixel together.
+ *
+ * All the stores are held in one contiguous block of fixed-size slots
+ * without per-pixel allocation. Once the slots are full, a new value is
+ * first screened against flat arrays of the current thresholds in a
+ * branch-free loop; only the pixels with a new outlier touch their slots.
+ * The slots of each pixel keep the same contents and order as OutlierStore,
+ * so sum() and sum2() give identical results.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class OutlierStoreArray
+{
+public:
+  explicit OutlierStoreArray(std::size_t num_pixels);
+  ~OutlierStoreArray();
+  OutlierStoreArray(const OutlierStoreArray&) = default;
+  OutlierStoreArray(OutlierStoreArray&&) = default;
+  OutlierStoreArray& operator=(const OutlierStoreArray&) = default;
+  OutlierStoreArray& operator=(OutlierStoreArray&&) = default;
+
+  /**
+   * set the capacities of all the pixels and clear the stores.
+   */
+  void set_capacities(int low, int high);
+  int capacity_low() const { return capacity_low_; }
+  int capacity_high() const { return capacity_high_; }
+  int capacity() const { return capacity_low_ + capacity_high_; }
+
+  std::size_t num_pixels() const { return num_pixels_; }
+
+  /** number of values stored for each pixel */
+  int num() const { return num_; }
+
+  /**
+   * propose one value for each pixel.
+   * @param xs array of values (size num_pixels()).
+   */
+  void propose(const double* xs);
+
+  /**
+   * sums of the stored values and of their squares for all the pixels.
+   * @param sums (output) array of size num_pixels().
+   * @param sums2 (output) array of size num_pixels().
+   */
+  void sums(double* sums, double* sums2) const;
+
+private:
+  double& slot(int k, std::size_t i) { return slots_[i*capacity()+k]; }
+  double slot(int k, std::size_t i) const { return slots_[i*capacity()+k]; }
+  void sortSlots(std::size_t i, int begin, int end);
+  void updateThresholds();
+  void replaceOutliers(std::size_t i, double x);
+
+private:
+  std::size_t num_pixels_ = 0;
+  int capacity_low_ = 0;
+  int capacity_high_ = 0;
+  int num_ = 0;
+
+  using array_t = std::vector<double, boost::alignment::aligned_allocator<double, 64>>;
+  /* slots_[i*capacity()+k]: k-th slot of pixel i */
+  array_t slots_;
+  /* largest of the low outliers (slot capacity_low-1), or -inf */
+  array_t lowThresholds_;
+  /* smallest of the high outliers (slot capacity_low), or +inf */
+  array_t highThresholds_;
+  std::vector<std::size_t> candidates_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_OutlierStoreArray_H */
@@ -0,0 +1,76 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ParallelFor_H
+#define COMPTONSOFT_ParallelFor_H 1
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+namespace comptonsoft {
+
+/**
+ * Call func(i, threadIndex) for every i in [begin, end) using a number of threads.
+ * The indices are handed out one by one, so that the load is balanced even
+ * if the cost of func varies with i. The calling thread works as thread 0.
+ * func must be safe to call from multiple threads at the same time.
+ *
+ * @param begin first index
+ * @param end index next to the last
+ * @param numThreads number of threads; less than 1 is treated as 1.
+ * @param func callable as void(int i, int threadIndex)
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+template <typename Func>
+void parallelFor(int begin, int end, int numThreads, Func func)
+{
+  if (end <= begin) { return; }
+  numThreads = std::max(1, std::min(numThreads, end-begin));
+
+  if (numThreads == 1) {
+    for (int i=begin; i<end; i++) {
+      func(i, 0);
+    }
+    return;
+  }
+
+  std::atomic<int> next(begin);
+  auto run = [&](int threadIndex) {
+    for (int i=next++; i<end; i=next++) {
+      func(i, threadIndex);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t=1; t<numThreads; t++) {
+    threads.emplace_back(run, t);
+  }
+  run(0);
+  for (auto& thread: threads) {
+    thread.join();
+  }
+}
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ParallelFor_H */
@@ -40,6 +40,9 @@ public:
   PhotoAbsorptionEventReconstructionAlgorithm& operator=(const PhotoAbsorptionEventReconstructionAlgorithm&) = default;
   PhotoAbsorptionEventReconstructionAlgorithm& operator=(PhotoAbsorptionEventReconstructionAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new PhotoAbsorptionEventReconstructionAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
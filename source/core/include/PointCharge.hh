@@ -21,6 +21,7 @@
 #ifndef COMPTONSOFT_PointCharge_H
 #define COMPTONSOFT_PointCharge_H 1
 
+#include <random>
 #include <boost/multi_array.hpp>
 #include "CSTypes.hh"
 #include "VGoalRegion.hh"
@@ -33,6 +34,8 @@ namespace comptonsoft {
  *
  * @author Hiromasa Suzuki, Hirokazu Odaka
  * @date 2020-04-18
+ * @date 2026-10-17 | a random generator can be given from outside
+ * @date 2026-10-17 | weighting potentials carried forward; adaptive step length
  */
 class PointCharge
 {
@@ -58,11 +61,32 @@ public:
 
   void setField(SemiconductorModel* field) { field_ = field; }
 
+  /**
+   * set a random generator used for diffusion. If not set, the generator
+   * of the field model is used.
+   */
+  void setRandomGenerator(std::mt19937* generator) { randomGenerator_ = generator; }
+
+  /**
+   * enable the adaptive step length. The step length is chosen so that the
+   * drift velocity changes by about the given fraction over one step,
+   * estimated from the change of the velocity over the previous step,
+   * and is limited within [minStep, maxStep].
+   */
+  void setAdaptiveStep(double minStep, double maxStep, double tolerance);
+  void unsetAdaptiveStep() { adaptiveStep_ = false; }
+  bool isAdaptiveStep() const { return adaptiveStep_; }
+
+  /**
+   * transport the charge and return the induced signals of the 3x3 pixels.
+   * @param dl step length; the first step length in the adaptive mode.
+   */
   boost::multi_array<double, 2> transport(double dl);
 
 private:
   void advance(double dl);
   void integrateSignals();
+  double nextStepLength(double dl) const;
 
 private:
   static constexpr int PixelExtenstion = 3;
@@ -74,8 +98,16 @@ private:
   double endingTime_ = 0.0;
   boost::multi_array<double, 2> signals_;
   boost::multi_array<vector3_t, 2> shifts_;
+  boost::multi_array<double, 2> wp0_;
+  vector3_t velocity_;
+  vector3_t velocity0_;
+  bool adaptiveStep_ = false;
+  double minStep_ = 0.0;
+  double maxStep_ = 0.0;
+  double stepTolerance_ = 0.0;
   SemiconductorModel* field_ = nullptr;
   VGoalRegion* goal_ = nullptr;
+  std::mt19937* randomGenerator_ = nullptr;
 };
 
 } /* namespace comptonsoft */
@@ -0,0 +1,138 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_PointChargePacket_H
+#define COMPTONSOFT_PointChargePacket_H 1
+
+#include <vector>
+#include <array>
+#include <random>
+#include <boost/multi_array.hpp>
+#include "CSTypes.hh"
+#include "VGoalRegion.hh"
+#include "SemiconductorModel.hh"
+
+namespace comptonsoft {
+
+/**
+ * A packet of point charges transported together.
+ *
+ * This class does the same calculation as PointCharge for many carriers.
+ * The states of the carriers are held in structure-of-arrays form, and each
+ * step is done as a sequence of loops over the active carriers (velocity,
+ * motion, weighting potentials, decay, termination), which keeps the lookups
+ * of the same field close together. A carrier leaves the packet when it
+ * reaches the goal or the ending time. The weighting potentials at the end of
+ * a step are carried forward to the next step, and the step length can be
+ * adapted to the local gradient of the drift velocity for each carrier.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class PointChargePacket
+{
+public:
+  PointChargePacket();
+  ~PointChargePacket();
+  PointChargePacket(const PointChargePacket&) = default;
+  PointChargePacket(PointChargePacket&&) = default;
+  PointChargePacket& operator=(const PointChargePacket&) = default;
+  PointChargePacket& operator=(PointChargePacket&&) = default;
+
+  void setGoal(VGoalRegion* p) { goal_ = p; }
+  void setField(SemiconductorModel* field) { field_ = field; }
+  void setRandomGenerator(std::mt19937* generator) { randomGenerator_ = generator; }
+  void setEndingTime(double v) { endingTime_ = v; }
+  double EndingTime() const { return endingTime_; }
+  void setPixelSeparations(double x, double y);
+
+  /**
+   * enable the adaptive step length; see PointCharge::setAdaptiveStep().
+   */
+  void setAdaptiveStep(double minStep, double maxStep, double tolerance);
+  void unsetAdaptiveStep() { adaptiveStep_ = false; }
+  bool isAdaptiveStep() const { return adaptiveStep_; }
+
+  void clear();
+  void addCarrier(const vector3_t& position, double effectiveQ);
+  void addCarriers(const vector3_t& position, double effectiveQ, int n);
+  int NumberOfCarriers() const { return x_.size(); }
+
+  /**
+   * transport all the carriers and return the sum of their induced signals
+   * of the 3x3 pixels.
+   * @param dl step length; the first step length in the adaptive mode.
+   */
+  boost::multi_array<double, 2> transport(double dl);
+
+private:
+  static constexpr int PixelExtenstion = 3;
+  static constexpr int NumShifts = PixelExtenstion*PixelExtenstion;
+
+  void computeVelocities();
+  void move();
+  void integrateSignals();
+  void removeFinishedCarriers();
+  void updateStepLengths();
+
+private:
+  SemiconductorModel* field_ = nullptr;
+  VGoalRegion* goal_ = nullptr;
+  std::mt19937* randomGenerator_ = nullptr;
+  double endingTime_ = 0.0;
+  std::array<double, NumShifts> shiftX_;
+  std::array<double, NumShifts> shiftY_;
+
+  bool adaptiveStep_ = false;
+  double minStep_ = 0.0;
+  double maxStep_ = 0.0;
+  double stepTolerance_ = 0.0;
+
+  /* carrier states */
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> z_;
+  std::vector<double> t_;
+  std::vector<double> effectiveQ_;
+  std::vector<double> vx_;
+  std::vector<double> vy_;
+  std::vector<double> vz_;
+  std::vector<double> vx0_;
+  std::vector<double> vy0_;
+  std::vector<double> vz0_;
+  std::vector<double> dt_;
+  std::vector<double> step_;
+  std::vector<double> previousStep_;
+  std::vector<int> numSteps_;
+  /* weighting potentials: wp0_[shift*NumberOfCarriers() + carrier] */
+  std::vector<double> wp0_;
+
+  /* indices of the carriers still moving */
+  std::vector<int> active_;
+  /* work arrays for batched weighting-potential queries */
+  std::vector<double> queryX_;
+  std::vector<double> queryY_;
+  std::vector<double> queryZ_;
+  std::vector<double> wp1_;
+  std::array<double, NumShifts> signals_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_PointChargePacket_H */
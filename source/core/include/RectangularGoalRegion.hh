@@ -32,6 +32,7 @@ namespace comptonsoft {
  *
  * @author Hirokazu Odaka
  * @date 2020-04-18
+ * @date 2026-10-17 | description()
  */
 class RectangularGoalRegion : public VGoalRegion
 {
@@ -39,6 +40,7 @@ public:
   RectangularGoalRegion() = default;
   void addRegion(double x0, double x1, double y0, double y1, double z0, double z1);
   bool isReached(const vector3_t& position) override;
+  std::string description() const override;
 
 private:
   using region_t = std::tuple<double, double, double, double, double, double>;
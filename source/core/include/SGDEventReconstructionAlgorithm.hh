@@ -41,6 +41,9 @@ public:
   SGDEventReconstructionAlgorithm& operator=(const SGDEventReconstructionAlgorithm&) = default;
   SGDEventReconstructionAlgorithm& operator=(SGDEventReconstructionAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new SGDEventReconstructionAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
@@ -0,0 +1,103 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ScatteringOrderSearch_H
+#define COMPTONSOFT_ScatteringOrderSearch_H 1
+
+#include <vector>
+
+namespace comptonsoft {
+
+namespace scattering_order_search_impl {
+
+template <typename PrefixFunc, typename OrderFunc>
+void expand(int depth,
+            std::vector<int>& order,
+            std::vector<char>& used,
+            const std::vector<int>& numCompletions,
+            int& index,
+            PrefixFunc& acceptPrefix,
+            OrderFunc& processOrder)
+{
+  const int n = order.size();
+  for (int i=0; i<n; i++) {
+    if (used[i]) { continue; }
+
+    order[depth] = i;
+    if (!acceptPrefix(order, depth)) {
+      index += numCompletions[depth];
+      continue;
+    }
+
+    if (depth == n-1) {
+      processOrder(order, index);
+      ++index;
+      continue;
+    }
+
+    used[i] = 1;
+    expand(depth+1, order, used, numCompletions, index, acceptPrefix, processOrder);
+    used[i] = 0;
+  }
+}
+
+} /* namespace scattering_order_search_impl */
+
+/**
+ * Depth-first search over the scattering orders (permutations) of hits.
+ *
+ * The orders are visited in the lexicographic order, i.e., the same sequence
+ * as std::next_permutation() starting from {0, 1, ..., num_hits-1}, and each
+ * order is given the same index as in that sequence.
+ * When acceptPrefix rejects a partial order, none of the orders beginning
+ * with it is visited, but they are still counted by the index.
+ *
+ * @param num_hits number of hits.
+ * @param acceptPrefix callable as bool(const std::vector<int>& order, int depth),
+ * which tests the partial order order[0], ..., order[depth].
+ * It is called with increasing depth, so that it can keep partial results for each depth.
+ * @param processOrder callable as void(const std::vector<int>& order, int index),
+ * which is invoked for every complete order whose prefixes are all accepted.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+template <typename PrefixFunc, typename OrderFunc>
+void searchScatteringOrders(int num_hits,
+                            PrefixFunc acceptPrefix,
+                            OrderFunc processOrder)
+{
+  if (num_hits < 1) { return; }
+
+  std::vector<int> numCompletions(num_hits);
+  numCompletions[num_hits-1] = 1;
+  for (int depth=num_hits-2; depth>=0; depth--) {
+    numCompletions[depth] = numCompletions[depth+1] * (num_hits-depth-1);
+  }
+
+  std::vector<int> order(num_hits);
+  std::vector<char> used(num_hits, 0);
+  int index = 0;
+  scattering_order_search_impl::expand(0, order, used, numCompletions, index,
+                                       acceptPrefix, processOrder);
+}
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ScatteringOrderSearch_H */
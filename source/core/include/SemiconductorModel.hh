@@ -24,13 +24,13 @@
 #include <memory>
 #include <random>
 #include <vector>
-#include <TH3.h>
-#include <TFile.h>
+#include <string>
 #include "CSTypes.hh"
 
 namespace comptonsoft {
 
 class NumericalField;
+class VectorFieldTable;
 
 
 /**
@@ -38,6 +38,9 @@ class NumericalField;
  *
  * @author Hiromasa Suzuki, Hirokazu Odaka
  * @date 2020-04-18
+ * @date 2026-10-17 | diffusion with an external random generator
+ * @date 2026-10-17 | batched weighting potentials; weighting-potential table file
+ * @date 2026-10-17 | electric field held in an interleaved table; drift velocity table
  */
 class SemiconductorModel
 {
@@ -54,10 +57,39 @@ public:
                      double spreadFactor);
   void setVelocitySaturation(double efield);
   void unsetVelocitySaturation();
+
+  /**
+   * load the electric field from histograms efieldx, efieldy, efieldz in a
+   * ROOT file. The histograms are converted into a table and the file is
+   * closed.
+   */
   void load(const std::string& filename);
+
+  /**
+   * select the lookup of the electric field: the value of the bin containing
+   * the position (default), or trilinear interpolation between bin centers.
+   */
+  void setEFieldInterpolation(bool v);
+  bool isEFieldInterpolation() const { return EFieldInterpolation_; }
+
+  /**
+   * calculate the drift velocity at every bin of the electric field with
+   * the current carrier properties, so that ChargeVelocity() needs only one
+   * lookup. With interpolation, the velocity is then interpolated instead
+   * of the field. The table is dropped when the properties are changed.
+   */
+  void precomputeChargeVelocity();
+
+  /**
+   * use a numerical table of the weighting potential on the given grids.
+   * @param filename binary table file. If it exists and has the same grids,
+   * pixel geometry and readout side, the table is mapped from the file;
+   * otherwise it is calculated and saved there. An empty string disables the file.
+   */
   void useAccurateWeightingPotential(const std::vector<double>& grids_x,
                                      const std::vector<double>& grids_y,
-                                     const std::vector<double>& grids_z);
+                                     const std::vector<double>& grids_z,
+                                     const std::string& filename="");
 
   void setRandomSeed(uint32_t seed);
 
@@ -65,8 +97,15 @@ public:
   
   vector3_t EField(const vector3_t& position) const;
   vector3_t ChargeVelocity(const vector3_t& position) const;
+  vector3_t ChargeVelocityAtEField(const vector3_t& Evec) const;
   double WeightingPotential(const vector3_t& position) const;
 
+  /**
+   * batched version of WeightingPotential().
+   */
+  void WeightingPotential(const double* xs, const double* ys, const double* zs,
+                          double* wp, std::size_t n) const;
+
   bool SaturationMode() const { return saturationMode_; }
   double SaturationEField() const { return saturationEField_; }
 
@@ -79,6 +118,12 @@ public:
 
   vector3_t Diffusion(double t);
 
+  /**
+   * diffusion displacement drawn from a given generator instead of the
+   * model's own one, so that threads can share this model.
+   */
+  vector3_t Diffusion(double t, std::mt19937& generator) const;
+
 protected:
   double WeightingPotentialPlaneParallel(double z) const;
 
@@ -98,10 +143,9 @@ private:
   bool saturationMode_ = false;
   double saturationEField_ = 0.0;
   
-  std::unique_ptr<TFile> file_;
-  TH3* fx_ = nullptr;
-  TH3* fy_ = nullptr;
-  TH3* fz_ = nullptr;
+  bool EFieldInterpolation_ = false;
+  std::unique_ptr<VectorFieldTable> EField_;
+  std::unique_ptr<VectorFieldTable> velocityField_;
 
   std::unique_ptr<NumericalField> WPField_;
   
@@ -34,6 +34,8 @@ namespace comptonsoft {
  * @date 2008-08-25
  * @date 2009-10-26
  * @date 2014-11-20
+ * @date 2026-10-17 | WP/CCE maps can be taken from ChargeCollectionMapCache
+ * @date 2026-10-17 | WP/CCE maps are built by multiple threads
  */
 class SimDetectorUnit2DPixel
   : public RealDetectorUnit2DPixel, public DeviceSimulation
@@ -50,7 +52,7 @@ public:
   void setCCEMap(TH3D* h3) { CCEMap_ = h3; }
   TH3D* getCCEMap() { return CCEMap_; }
 
-  void setWPMap(TH3D* h3) { WPMap_ = h3; }
+  void setWPMap(TH3D* h3) { WPMap_ = h3; WPMapDescription_.clear(); }
   TH3D* getWPMap() { return WPMap_; }
  
   double ChargeCollectionEfficiency(const PixelID& pixel,
@@ -81,6 +83,7 @@ private:
   bool usingSymmetry_;
   TH3D* CCEMap_;
   TH3D* WPMap_;
+  std::string WPMapDescription_;
 };
 
 inline bool SimDetectorUnit2DPixel::checkRange(const PixelID& pixel) const
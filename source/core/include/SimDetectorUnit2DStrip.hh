@@ -20,6 +20,7 @@
 #ifndef COMPTONSOFT_SimDetectorUnit2DStrip_H
 #define COMPTONSOFT_SimDetectorUnit2DStrip_H 1
 
+#include <vector>
 #include "TH2.h"
 
 #include "RealDetectorUnit2DStrip.hh"
@@ -33,6 +34,9 @@ namespace comptonsoft {
  * @date 2008-08-25
  * @date 2009-05-20
  * @date 2009-10-26
+ * @date 2026-10-17 | strip signals with diffusion are summed up in dense accumulators
+ * @date 2026-10-17 | WP/CCE maps can be taken from ChargeCollectionMapCache
+ * @date 2026-10-17 | WP/CCE maps are built by multiple threads
  */
 class SimDetectorUnit2DStrip
   : public RealDetectorUnit2DStrip, public DeviceSimulation
@@ -52,9 +56,9 @@ public:
   void setCCEMapYStrip(TH2D* h3) { CCEMapYStrip_ = h3; }
   TH2D* getCCEMapYStrip() { return CCEMapYStrip_; }
 
-  void setWPMapXStrip(TH2D* h3) { WPMapXStrip_ = h3; }
+  void setWPMapXStrip(TH2D* h3) { WPMapXStrip_ = h3; WPMapDescription_.clear(); }
   TH2D* getWPMapXStrip() { return WPMapXStrip_; }
-  void setWPMapYStrip(TH2D* h3) { WPMapYStrip_ = h3; }
+  void setWPMapYStrip(TH2D* h3) { WPMapYStrip_ = h3; WPMapDescription_.clear(); }
   TH2D* getWPMapYStrip() { return WPMapYStrip_; }
 
   bool isCCEMapPrepared() override;
@@ -79,7 +83,46 @@ protected:
   PixelID TableIndexToPixelID(int index) const override;
 
 private:
+  /**
+   * energy deposits and charges summed up for each strip of one side,
+   * with the list of the strips filled in the order of their first filling.
+   */
+  class StripAccumulator
+  {
+  public:
+    void reset(int numStrips);
+
+    void add(int strip, double energyDeposit, double energyCharge)
+    {
+      if (!filled_[strip]) {
+        filled_[strip] = 1;
+        strips_.push_back(strip);
+      }
+      energyDeposit_[strip] += energyDeposit;
+      energyCharge_[strip] += energyCharge;
+    }
+
+    const std::vector<int>& Strips() const { return strips_; }
+    double EnergyDeposit(int strip) const { return energyDeposit_[strip]; }
+    double EnergyCharge(int strip) const { return energyCharge_[strip]; }
+
+  private:
+    std::vector<double> energyDeposit_;
+    std::vector<double> energyCharge_;
+    std::vector<char> filled_;
+    std::vector<int> strips_;
+  };
+
   void simulatePulseHeights() override;
+  void addNearStripSignal(const DetectorHit& rawhit,
+                          const DetectorHit& hit,
+                          const PixelID& sp,
+                          const PixelID& nearStrip,
+                          StripAccumulator& accumulator);
+  void drawDiffusionDisplacements(int n, double sigma);
+
+  void fillWPMap(TH2D* wpMap, double pitch, bool upside);
+  void fillCCEMap(TH2D* cceMap, const TH2D* wpMap, bool upside);
   
 private:
   bool usingSymmetry_;
@@ -87,6 +130,13 @@ private:
   TH2D* CCEMapYStrip_;
   TH2D* WPMapXStrip_;
   TH2D* WPMapYStrip_;
+  std::string WPMapDescription_;
+
+  StripAccumulator xStripAccumulator_;
+  StripAccumulator yStripAccumulator_;
+  std::vector<double> diffusionRandoms_;
+  std::vector<double> diffusionDX_;
+  std::vector<double> diffusionDY_;
 };
 
 inline bool SimDetectorUnit2DStrip::checkRange(const PixelID& sp) const
@@ -0,0 +1,109 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_SlidingWindowMedian_H
+#define COMPTONSOFT_SlidingWindowMedian_H 1
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace comptonsoft
+{
+
+/**
+ * Running medians of many pixels over a sliding window of frames.
+ *
+ * Each pixel keeps the values of the last W frames in W slots, which are
+ * used as a ring buffer indexed by the frame. The values of a pixel are
+ * arranged in two heaps: a max-heap of the lower (W+1)/2 values and a
+ * min-heap of the upper W/2 values, so that the median is read from the
+ * tops. Since the window size is fixed, an update replaces the value of the
+ * expiring slot in place and restores the heaps in O(log W), without any
+ * allocation. The heaps of all the pixels are stored in flat arrays.
+ *
+ * The medians are the same as those of the sorted window: the middle value
+ * for odd W, and the mean of the two middle values for even W.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class SlidingWindowMedian
+{
+public:
+  /**
+   * @param num_pixels number of pixels.
+   * @param window window size W (1 to 65535).
+   */
+  SlidingWindowMedian(std::size_t num_pixels, int window);
+  ~SlidingWindowMedian();
+  SlidingWindowMedian(const SlidingWindowMedian&) = default;
+  SlidingWindowMedian(SlidingWindowMedian&&) = default;
+  SlidingWindowMedian& operator=(const SlidingWindowMedian&) = default;
+  SlidingWindowMedian& operator=(SlidingWindowMedian&&) = default;
+
+  static constexpr int MaxWindowSize = 65535;
+
+  std::size_t NumPixels() const { return num_pixels_; }
+  int WindowSize() const { return window_; }
+
+  /**
+   * set the values of a slot of all the pixels before build().
+   * @param slot slot index (0 to W-1).
+   * @param xs values (size NumPixels()).
+   */
+  void fill(int slot, const double* xs);
+
+  /**
+   * arrange the filled values into the heaps. All the slots must be filled.
+   */
+  void build();
+
+  /**
+   * replace the values of a slot of all the pixels after build().
+   * @param slot slot index (0 to W-1).
+   * @param xs new values (size NumPixels()).
+   * @param medians (output) medians of the updated windows (size NumPixels()).
+   */
+  void replace(int slot, const double* xs, double* medians);
+
+private:
+  using index_t = uint16_t;
+
+  void replaceValue(std::size_t pixel, int slot, double x);
+  double median(std::size_t pixel) const;
+
+private:
+  std::size_t num_pixels_ = 0;
+  int window_ = 1;
+  int lowerSize_ = 1;
+
+  /*
+   * For pixel p, the W entries from p*W hold the heaps: positions
+   * [0, lowerSize_) for the max-heap and [lowerSize_, W) for the min-heap.
+   */
+  std::vector<double> heapValues_;
+  std::vector<index_t> heapSlots_;
+  /* heap position of each slot, W entries per pixel */
+  std::vector<index_t> positions_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_SlidingWindowMedian_H */
@@ -41,6 +41,9 @@ public:
   StandardEventReconstructionAlgorithm& operator=(const StandardEventReconstructionAlgorithm&) = default;
   StandardEventReconstructionAlgorithm& operator=(StandardEventReconstructionAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new StandardEventReconstructionAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
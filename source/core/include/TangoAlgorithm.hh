@@ -22,9 +22,8 @@
 #define COMPTONSOFT_TangoAlgorithm_H 1
 
 #include "VEventReconstructionAlgorithm.hh"
-#include "TString.h"
-#include "TFile.h"
-#include "TGraph.h"
+#include <memory>
+#include "CrossSectionTable.hh"
 
 namespace comptonsoft {
 
@@ -34,6 +33,8 @@ namespace comptonsoft {
  * @date 2020-11-18 | Hiroki Yoneda
  * @date 2021-01-04 | Hirokazu Odaka | code cleanup
  * @date 2022-12-28 | Hiroki Yoneda | review
+ * @date 2026-10-17 | Hirokazu Odaka | cross section table
+ * @date 2026-10-17 | Hirokazu Odaka | scattering-order search in the base class
  */
 class TangoAlgorithm : public VEventReconstructionAlgorithm
 {
@@ -45,6 +46,9 @@ public:
   TangoAlgorithm& operator=(const TangoAlgorithm&) = default;
   TangoAlgorithm& operator=(TangoAlgorithm&&) = default;
 
+  std::unique_ptr<VEventReconstructionAlgorithm> clone() const override
+  { return std::unique_ptr<VEventReconstructionAlgorithm>(new TangoAlgorithm(*this)); }
+
   void initializeEvent() override;
 
   /**
@@ -72,7 +76,9 @@ protected:
   bool reconstructOrderedHits(const std::vector<DetectorHit_sptr>& ordered_hits,
                               BasicComptonEvent& eventReconstructed,
                               double incident_energy,
-                              bool is_escape_event = false);
+                              bool is_escape_event = false) override;
+
+  double energyMarginForScatteringAngle(double energy) override;
 
   double calFOM(const std::vector<DetectorHit_sptr>& ordered_hits,
                        double incident_energy,
@@ -82,16 +88,17 @@ protected:
   void selectMaximumLikelihoodOrder(std::vector<BasicComptonEvent_sptr>& eventsReconstructed);
 
 private:
+  bool loadCrossSectionTable();
   void setTotalEnergyDepositsAndNumHits(const std::vector<DetectorHit_sptr>& hits);
   double getEnergyResolution(double energy);
 
   double getErrorCosThetaGeom(const vector3_t& incident_direction, const vector3_t& scattering_direction);
   double probEnergyDetection(double energy_real, double energy_detected, double sigma_energy);
-  double probCompton(double gammaray_energy_before_hit, double path_length);
-  double probComptonFirst(double gammaray_energy_before_hit);
-  double probAbsorption(double gammaray_energy_before_hit, double path_length);
-  double probEscapeSimple(double gammaray_energy_before_lasthit, double energy_deposit_lasthit);
-  double probEscapeOriginal(double gammaray_energy_before_lasthit, double energy_deposit_lasthit, const vector3_t position_last, const vector3_t position_second_from_last);
+  double probCompton(const CrossSectionTable::Values& cross_section, double path_length);
+  double probComptonFirst(const CrossSectionTable::Values& cross_section);
+  double probAbsorption(const CrossSectionTable::Values& cross_section, double path_length);
+  double probEscapeSimple(const CrossSectionTable::Values& cross_section_escape);
+  double probEscapeOriginal(const CrossSectionTable::Values& cross_section_escape, const vector3_t position_last, const vector3_t position_second_from_last);
   double compScatteringAngle(const std::vector<DetectorHit_sptr>& ordered_hits, int i_hit, double incident_energy, bool is_escape_event);
   double compScatteringAngleWithInitialDirection(const std::vector<DetectorHit_sptr>& ordered_hits, double incident_energy, bool is_escape_event);
 
@@ -127,11 +134,10 @@ private:
   double escape_weight_;
 
   std::string cross_section_filename_;
-  TFile* cross_section_file_;
-  TGraph* tg_cross_section_compton_;
-  TGraph* tg_cross_section_phot_abs_;
-  TGraph* tg_cross_section_pair_;
-  TGraph* tg_cross_section_tot_;
+  int cross_section_table_points_per_decade_;
+  std::shared_ptr<const CrossSectionTable> cross_section_table_;
+  std::vector<double> energies_for_cross_section_;
+  std::vector<CrossSectionTable::Values> cross_sections_;
 
   bool selecting_maximum_likelihood_order_ = true;
 
@@ -22,12 +22,20 @@
 #define COMPTONSOFT_VCSSensitiveDetector_H 1
 
 #include "G4VSensitiveDetector.hh"
+#include <cstdint>
 #include <set>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+class G4VPhysicalVolume;
+class G4VProcess;
 
 namespace comptonsoft
 {
 
 class DetectorSystem;
+class DeviceSimulation;
 
 /**
  * A sensitive detector class of Compton Soft.
@@ -35,6 +43,8 @@ class DetectorSystem;
  * @author Hirokazu Odaka
  * @date 2011-04-04
  * @date 2014-11-14
+ * @date 2026-10-17 | cache of detector lookup and process classification
+ * @date 2026-10-17 | thread-local copies for the multithreaded mode
  */
 class VCSSensitiveDetector : public G4VSensitiveDetector
 {
@@ -51,8 +61,18 @@ public:
    */
   G4bool ProcessHits(G4Step* aStep, G4TouchableHistory* ROhist) override;
 
+  /**
+   * make a copy for a worker thread of Geant4.
+   * On a worker thread, the hits are not inserted into the detector system
+   * directly but deferred to the analysis thread via anlgeant4::WorkerEventRecord.
+   */
+  VCSSensitiveDetector* Clone() const override = 0;
+
   void SetDetectorSystem(comptonsoft::DetectorSystem* detectorSystem)
-  { detectorSystem_ = detectorSystem; }
+  {
+    detectorSystem_ = detectorSystem;
+    ClearDetectorCache();
+  }
 
   /**
    * If you call this method with true, hit position is determined according to the Geant4 geometry.
@@ -71,7 +91,11 @@ public:
   void SetSDCheck(bool v=true)
   { SDCheck_ = v; }
 
-  void SetLayerOffset(int v) { layerOffset_ = v; }
+  void SetLayerOffset(int v)
+  {
+    layerOffset_ = v;
+    ClearDetectorCache();
+  }
   int LayerOffset() const { return layerOffset_; }
   
   /**
@@ -83,13 +107,49 @@ protected:
   void InsertIntoPositionCalculationSet(int detectorID)
   { positionCalculationSet_.insert(detectorID); }
   G4String HierarchyString(const G4VTouchable* touchable) const;
-  
+
+  /**
+   * clear the cache of detector lookup.
+   * This should be called when the association of volumes with detector IDs is changed.
+   */
+  void ClearDetectorCache();
+
+private:
+  /**
+   * physical volumes and replica numbers from the world volume,
+   * which identify a touchable.
+   */
+  using VolumePath = std::vector<std::pair<const G4VPhysicalVolume*, G4int>>;
+
+  struct VolumePathHash
+  {
+    std::size_t operator()(const VolumePath& path) const;
+  };
+
+  struct DetectorCacheEntry
+  {
+    int detectorID = -1;
+    DeviceSimulation* device = nullptr;
+  };
+
+  const DetectorCacheEntry& FindDetector(const G4VTouchable* touchable);
+  uint32_t ClassifyProcess(const G4VProcess* process);
+
 private:
   bool positionCalculation_;
   bool SDCheck_;
   int layerOffset_;
   comptonsoft::DetectorSystem* detectorSystem_;
   std::set<int> positionCalculationSet_;
+
+  VolumePath volumePath_;
+  VolumePath lastVolumePath_;
+  DetectorCacheEntry lastDetector_;
+  std::unordered_map<VolumePath, DetectorCacheEntry, VolumePathHash> detectorCache_;
+
+  const G4VProcess* lastProcess_ = nullptr;
+  uint32_t lastProcessFlag_ = 0;
+  std::unordered_map<const G4VProcess*, uint32_t> processFlagCache_;
 };
 
 inline G4String VCSSensitiveDetector::
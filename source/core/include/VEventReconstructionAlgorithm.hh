@@ -36,6 +36,8 @@ namespace comptonsoft {
  * @date 2014-11-17
  * @date 2020-07-02 | multiple reconstructed events
  * @date 2021-01-04 | add parameter file
+ * @date 2026-10-17 | clone() for multithreaded reconstruction
+ * @date 2026-10-17 | scattering-order search with a fixed incident energy
  */
 class VEventReconstructionAlgorithm
 {
@@ -47,6 +49,12 @@ public:
   VEventReconstructionAlgorithm& operator=(const VEventReconstructionAlgorithm&) = default;
   VEventReconstructionAlgorithm& operator=(VEventReconstructionAlgorithm&&) = default;
 
+  /**
+   * create a copy of this algorithm including the loaded parameters.
+   * Each worker thread of a parallel reconstruction owns its own clone.
+   */
+  virtual std::unique_ptr<VEventReconstructionAlgorithm> clone() const = 0;
+
   void setMaxHits(int v) { maxHits_ = v; }
   int MaxHits() const { return maxHits_; }
 
@@ -72,6 +80,43 @@ protected:
   virtual bool loadParameters(boost::property_tree::ptree&)
   { return true; }
 
+  /**
+   * reconstruct events of all the scattering orders of the hits, given the incident energy.
+   * The orders are searched depth first, and orders beginning with a partial
+   * order that violates the Compton kinematics are skipped as a whole.
+   * The remaining orders are evaluated by reconstructOrderedHits().
+   * Each event has the same reconstructed-order index as in the exhaustive
+   * search with std::next_permutation().
+   * @return true if any event is reconstructed.
+   */
+  bool reconstructWithFixedIncidentEnergy(const std::vector<DetectorHit_sptr>& hits,
+                                          const BasicComptonEvent& baseEvent,
+                                          double incident_energy,
+                                          bool is_escape_event,
+                                          std::vector<BasicComptonEvent_sptr>& eventsReconstructed);
+
+  /**
+   * reconstruct an event from the hits in a scattering order;
+   * this gives the scoring of an algorithm.
+   */
+  virtual bool reconstructOrderedHits(const std::vector<DetectorHit_sptr>& /* ordered_hits */,
+                                      BasicComptonEvent& /* eventReconstructed */,
+                                      double /* incident_energy */,
+                                      bool /* is_escape_event */)
+  { return false; }
+
+  /**
+   * energy margin given to checkScatteringAngle() at a hit of the energy deposit.
+   */
+  virtual double energyMarginForScatteringAngle(double /* energy */)
+  { return 0.0; }
+
+  /**
+   * true if an order is rejected by the kinematics of the first scattering.
+   */
+  virtual bool checksFirstScatteringKinematics() const
+  { return true; }
+
 private:
   int maxHits_;
   std::string parameterFile_;
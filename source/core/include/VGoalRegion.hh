@@ -20,6 +20,7 @@
 #ifndef COMPTONSOFT_VGoalRegion_H
 #define COMPTONSOFT_VGoalRegion_H 1
 
+#include <string>
 #include "CSTypes.hh"
 
 namespace comptonsoft {
@@ -29,6 +30,7 @@ namespace comptonsoft {
  *
  * @author Hirokazu Odaka
  * @date 2020-04-18
+ * @date 2026-10-17 | description()
  */
 class VGoalRegion
 {
@@ -37,6 +39,11 @@ public:
   virtual ~VGoalRegion();
 
   virtual bool isReached(const vector3_t&) = 0;
+
+  /**
+   * @return text that identifies the region, e.g. for the checkpoints of CCECalculation.
+   */
+  virtual std::string description() const;
 };
 
 } /* namespace comptonsoft */
@@ -0,0 +1,151 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_VectorFieldTable_H
+#define COMPTONSOFT_VectorFieldTable_H 1
+
+#include <vector>
+#include <cstddef>
+#include "CSTypes.hh"
+
+class TH3;
+class TAxis;
+
+namespace comptonsoft {
+
+/**
+ * A vector field on the bins of 3D histograms.
+ *
+ * The three components given as three TH3 histograms with the same binning
+ * are copied at build time into one array with interleaved components
+ * (vx, vy, vz) per bin, so that a query costs one bin search and no access
+ * to ROOT objects. The table is immutable after build() except through
+ * transform(), and can be shared by threads.
+ *
+ * Two lookups are provided: nearest() returns the value of the bin
+ * containing the position, including the underflow and overflow bins, just
+ * as TH3::GetBinContent() with TAxis::FindBin() does; trilinear()
+ * interpolates linearly between the bin centers and takes the value of the
+ * nearest center outside them.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class VectorFieldTable
+{
+public:
+  VectorFieldTable() = default;
+  ~VectorFieldTable() = default;
+  VectorFieldTable(const VectorFieldTable&) = default;
+  VectorFieldTable(VectorFieldTable&&) = default;
+  VectorFieldTable& operator=(const VectorFieldTable&) = default;
+  VectorFieldTable& operator=(VectorFieldTable&&) = default;
+
+  /**
+   * build the table.
+   * @param fx histogram of the x component.
+   * @param fy histogram of the y component.
+   * @param fz histogram of the z component.
+   * @param valueUnit factor multiplied to the bin contents.
+   * @return false if the histograms have different binnings.
+   */
+  bool build(const TH3& fx, const TH3& fy, const TH3& fz, double valueUnit);
+
+  bool isBuilt() const { return !values_.empty(); }
+
+  /**
+   * apply a function vector3_t(const vector3_t&) to the values of all bins.
+   */
+  template <typename Func>
+  void transform(Func func)
+  {
+    for (std::size_t i=0; i<values_.size(); i+=3) {
+      const vector3_t v = func(vector3_t(values_[i], values_[i+1], values_[i+2]));
+      values_[i] = v.x();
+      values_[i+1] = v.y();
+      values_[i+2] = v.z();
+    }
+  }
+
+  vector3_t nearest(double x, double y, double z) const
+  {
+    const std::size_t k = index(xAxis_.findBin(x), yAxis_.findBin(y), zAxis_.findBin(z));
+    return vector3_t(values_[k], values_[k+1], values_[k+2]);
+  }
+
+  vector3_t trilinear(double x, double y, double z) const;
+
+  /** lower edge of the first bin of the z axis */
+  double MinimumZ() const { return zAxis_.edges.front(); }
+  /** upper edge of the last bin of the z axis */
+  double MaximumZ() const { return zAxis_.edges.back(); }
+
+private:
+  struct Axis
+  {
+    int numBins = 0;
+    bool fixedBins = true;
+    double min = 0.0;
+    double max = 0.0;
+    std::vector<double> edges;
+    std::vector<double> centers;
+
+    void define(const TAxis& axis);
+    bool isSame(const TAxis& axis) const;
+
+    /** same as TAxis::FindFixBin() */
+    int findBin(double a) const;
+
+    /** cell between the centers of bins i0 and i1=i0+1, with the fraction in it */
+    void findCenterPair(double a, int& i0, int& i1, double& r) const;
+  };
+
+  std::size_t index(int ix, int iy, int iz) const
+  {
+    return 3*((static_cast<std::size_t>(ix)*(yAxis_.numBins+2) + iy)*(zAxis_.numBins+2) + iz);
+  }
+
+private:
+  Axis xAxis_;
+  Axis yAxis_;
+  Axis zAxis_;
+  std::vector<double> values_;
+};
+
+inline int VectorFieldTable::Axis::findBin(const double a) const
+{
+  if (a < min) { return 0; }
+  if (!(a < max)) { return numBins+1; }
+  if (fixedBins) {
+    return 1 + static_cast<int>(numBins*(a-min)/(max-min));
+  }
+  int lo = 0;
+  int hi = numBins;
+  // largest i with edges[i] <= a
+  while (hi - lo > 1) {
+    const int mid = (lo+hi)/2;
+    if (edges[mid] <= a) { lo = mid; }
+    else { hi = mid; }
+  }
+  return 1 + lo;
+}
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_VectorFieldTable_H */
@@ -28,6 +28,7 @@ namespace comptonsoft {
 /**
  * A class for calculating weighting potentials in a pixel detector.
  * @author Hirokazu Odaka
+ * @date 2026-10-17 | batched evaluation over depths
  */
 class WeightingPotentialPixel
 {
@@ -58,11 +59,11 @@ public:
     thickness_ = thickness;
   }
 
-  double SizeX() { return sizeX_; }
-  double SizeY() { return sizeY_; }
-  double PitchX() { return pitchX_; }
-  double PitchY() { return pitchY_; }
-  double Thickness() { return thickness_; }
+  double SizeX() const { return sizeX_; }
+  double SizeY() const { return sizeY_; }
+  double PitchX() const { return pitchX_; }
+  double PitchY() const { return pitchY_; }
+  double Thickness() const { return thickness_; }
   
   void initializeTable();
   void printTable();
@@ -70,6 +71,19 @@ public:
   double calculateWeightingPotential(double x0, double y0, double z0);
   double calculateWeightingPotential(double z0);
 
+  /**
+   * calculate weighting potentials at a position (x0, y0) for a batch of depths.
+   * This function does not change the object, so that it can be called from
+   * multiple threads at the same time.
+   * @param x0 x position
+   * @param y0 y position
+   * @param z0 array of depths (size n)
+   * @param phi (output) array of weighting potentials (size n)
+   * @param n number of depths
+   */
+  void calculateWeightingPotential(double x0, double y0,
+                                   const double* z0, double* phi, int n) const;
+
 private:
   static const int NumGrids_ = 500;
   
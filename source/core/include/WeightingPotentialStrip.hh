@@ -28,6 +28,7 @@ namespace comptonsoft {
 /**
  * A class for calculating weighting potentials in a strip detector.
  * @author Hirokazu Odaka
+ * @date 2026-10-17 | batched evaluation over depths
  */
 class WeightingPotentialStrip
 {
@@ -54,9 +55,9 @@ public:
     thickness_ = thickness;
   }
 
-  double SizeX() { return sizeX_; }
-  double PitchX() { return pitchX_; }
-  double Thickness() { return thickness_; }
+  double SizeX() const { return sizeX_; }
+  double PitchX() const { return pitchX_; }
+  double Thickness() const { return thickness_; }
   
   void initializeTable();
   void printTable();
@@ -64,6 +65,17 @@ public:
   double calculateWeightingPotential(double x0, double z0);
   double calculateWeightingPotential(double z0);
 
+  /**
+   * calculate weighting potentials at a position x0 for a batch of depths.
+   * This function does not change the object, so that it can be called from
+   * multiple threads at the same time.
+   * @param x0 position across the strips
+   * @param z0 array of depths (size n)
+   * @param phi (output) array of weighting potentials (size n)
+   * @param n number of depths
+   */
+  void calculateWeightingPotential(double x0, const double* z0, double* phi, int n) const;
+
 private:
   static const int NumGrids_ = 500;
 
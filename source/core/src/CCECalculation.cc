@@ -19,8 +19,18 @@
  *************************************************************************/
 
 #include "CCECalculation.hh"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <mutex>
+#include <boost/filesystem.hpp>
+#include "TROOT.h"
+#include "TDirectory.h"
+#include "TObjString.h"
+#include "TVectorD.h"
 #include "AstroUnits.hh"
-#include "PointCharge.hh"
+#include "PointChargePacket.hh"
+#include "ParallelFor.hh"
 
 namespace unit = anlgeant4::unit;
 namespace constant = anlgeant4::constant;
@@ -36,6 +46,7 @@ CCECalculation::~CCECalculation() = default;
 
 void CCECalculation::setUpsideReadout(bool v)
 {
+  upsideReadout_ = v;
   field_->setUpsideReadout(v);
 }
 
@@ -98,34 +109,52 @@ setSemiconductorProperties(bool carrier_positive,
                            double temperature,
                            double spreadFactor)
 {
+  carrierPositive_ = carrier_positive;
+  mobility_ = mobility;
+  lifetime_ = lifetime;
+  temperature_ = temperature;
+  spreadFactor_ = spreadFactor;
   field_->setProperties(carrier_positive, mobility, lifetime, temperature, spreadFactor);
 }
 
 void CCECalculation::setCarrierVelocitySaturation(double efield)
 {
+  velocitySaturation_ = true;
+  saturationEField_ = efield;
   field_->setVelocitySaturation(efield);
 }
 
 void CCECalculation::unsetCarrierVelocitySaturation()
 {
+  velocitySaturation_ = false;
+  saturationEField_ = 0.0;
   field_->unsetVelocitySaturation();
 }
 
 void CCECalculation::loadEField(const std::string& filename)
 {
+  efieldFile_ = filename;
   field_->load(filename);
 }
 
-void CCECalculation::useAccurateWeightingPotential()
+void CCECalculation::setEFieldInterpolation(const bool v)
+{
+  field_->setEFieldInterpolation(v);
+}
+
+void CCECalculation::useAccurateWeightingPotential(const std::string& filename)
 {
   const std::vector<double> edgesX = extendedEdges(segmentationX_, pixelWidthX_);
   const std::vector<double> edgesY = extendedEdges(segmentationY_, pixelWidthY_);
   const std::vector<double> edgesZ = segmentationZ_;
-  field_->useAccurateWeightingPotential(edgesX, edgesX, edgesZ);
+  accurateWeightingPotential_ = true;
+  weightingPotentialFile_ = filename;
+  field_->useAccurateWeightingPotential(edgesX, edgesX, edgesZ, filename);
 }
 
 void CCECalculation::setRandomSeed(uint32_t seed)
 {
+  randomSeed_ = seed;
   field_->setRandomSeed(seed);
 }
 
@@ -134,44 +163,126 @@ void CCECalculation::run(const int numParticles)
   const int nx = segmentationX_.size() - 1;
   const int ny = segmentationY_.size() - 1;
   const int nz = segmentationZ_.size() - 1;
-  for (int ix=0; ix<nx; ix++) {
-    std::cout << "ix: " << ix << std::endl;
-    for (int iy=0; iy<ny; iy++) {
-      std::cout << " iy: " << iy << " => ";
-      for (int iz=0; iz<nz; iz++) {
-        std::cout << "*";
-        std::cout.flush();
-        calculate(ix, iy, iz, numParticles);
+  const int numColumns = nx*ny;
+  const std::string description = checkpointDescription(numParticles);
+
+  // The velocity table is shared read-only by the worker threads.
+  field_->precomputeChargeVelocity();
+
+  // flat buffer of the extended map; index = ((binx-1)*3ny + (biny-1))*nz + (binz-1)
+  std::vector<double> cce(9*nx*ny*nz, 0.0);
+  std::vector<char> done(numColumns, 0);
+  if (!checkpointFile_.empty() && loadCheckpoint(description, cce, done)) {
+    std::cout << "Resuming from checkpoint " << checkpointFile_ << ": "
+              << std::count(done.begin(), done.end(), 1) << " of "
+              << numColumns << " columns are already calculated." << std::endl;
+  }
+
+  std::vector<int> columns;
+  for (int column=0; column<numColumns; column++) {
+    if (!done[column]) { columns.push_back(column); }
+  }
+
+  if (numThreads_ > 1) {
+    ROOT::EnableThreadSafety();
+  }
+
+  std::mutex mutex;
+  std::mutex checkpointMutex;
+  int numDone = numColumns - static_cast<int>(columns.size());
+  int numDoneSinceCheckpoint = 0;
+  parallelFor(0, static_cast<int>(columns.size()), numThreads_,
+              [&](int index, int) {
+                const int column = columns[index];
+                const int ix = column/ny;
+                const int iy = column%ny;
+
+                std::seed_seq seeds{randomSeed_, static_cast<uint32_t>(ix), static_cast<uint32_t>(iy)};
+                std::mt19937 generator(seeds);
+                // signals[((px+1)*3 + (py+1))*nz + iz] for the pixel shifted by (px, py)
+                std::vector<double> signals(9*nz, 0.0);
+                calculate(ix, iy, numParticles, generator, signals);
+
+                std::unique_lock<std::mutex> lock(mutex);
+                for (int i=0; i<3; i++) {
+                  for (int j=0; j<3; j++) {
+                    const int binx = 1 + nx + ix + (i-1)*nx;
+                    const int biny = 1 + ny + iy + (j-1)*ny;
+                    for (int iz=0; iz<nz; iz++) {
+                      cce[((binx-1)*3*ny + (biny-1))*nz + iz] += signals[(i*3+j)*nz + iz];
+                    }
+                  }
+                }
+                done[column] = 1;
+                ++numDone;
+                std::cout << "ix: " << ix << " iy: " << iy
+                          << " [" << numDone << "/" << numColumns << "]" << std::endl;
+
+                ++numDoneSinceCheckpoint;
+                if (checkpointFile_.empty() || numDoneSinceCheckpoint < checkpointInterval_) {
+                  return;
+                }
+
+                // The snapshot is copied under the lock and written outside it,
+                // so that the other threads keep merging while the file is written.
+                // If another thread is still writing, this checkpoint is postponed.
+                std::unique_lock<std::mutex> writeLock(checkpointMutex, std::try_to_lock);
+                if (!writeLock.owns_lock()) {
+                  return;
+                }
+                std::vector<double> cceSnapshot(cce);
+                std::vector<char> doneSnapshot(done);
+                numDoneSinceCheckpoint = 0;
+                lock.unlock();
+
+                saveCheckpoint(description, cceSnapshot, doneSnapshot);
+              });
+
+  if (!checkpointFile_.empty()) {
+    saveCheckpoint(description, cce, done);
+  }
+
+  for (int binx=1; binx<=3*nx; binx++) {
+    for (int biny=1; biny<=3*ny; biny++) {
+      for (int binz=1; binz<=nz; binz++) {
+        const double v0 = cceMap_->GetBinContent(binx, biny, binz);
+        const double v = cce[((binx-1)*3*ny + (biny-1))*nz + (binz-1)];
+        cceMap_->SetBinContent(binx, biny, binz, v0+v);
       }
-      std::cout << std::endl;
     }
   }
 }
 
-void CCECalculation::calculate(const int ix, const int iy, const int iz, const int numParticles)
+void CCECalculation::calculate(const int ix, const int iy, const int numParticles,
+                               std::mt19937& generator, std::vector<double>& signals)
 {
-  // pixel-electrode side
-  for (int j=0; j<numParticles; j++) {
-    transport(ix, iy, iz, 1.0/numParticles);
+  // One packet object is reused for all the voxels of the column.
+  PointChargePacket packet;
+  packet.setGoal(goal_.get());
+  packet.setPixelSeparations(pixelWidthX_, pixelWidthY_);
+  packet.setField(field_.get());
+  packet.setRandomGenerator(&generator);
+  packet.setEndingTime(endingTime_);
+  if (adaptiveStep_) {
+    packet.setAdaptiveStep(minStep_, maxStep_, stepTolerance_);
   }
 
-  // flat-electrode side
-  calculateForOppositeSide(ix, iy, iz);
+  const int nz = segmentationZ_.size() - 1;
+  for (int iz=0; iz<nz; iz++) {
+    // pixel-electrode side
+    transport(ix, iy, iz, numParticles, packet, signals);
 
-#if 0
-  const int nx = segmentationX_.size() - 1;
-  const int ny = segmentationY_.size() - 1;
-  const int binx = 1 + nx + ix;
-  const int biny = 1 + ny + iy;
-  const int binz = 1 + iz;
-  std::cout << "CCE= " << cceMap_->GetBinContent(binx, biny, binz) << std::endl;
-#endif
+    // flat-electrode side
+    calculateForOppositeSide(ix, iy, iz, signals);
+  }
 }
 
-void CCECalculation::transport(const int ix, const int iy, const int iz, const double charge)
+void CCECalculation::transport(const int ix, const int iy, const int iz, const int numParticles,
+                               PointChargePacket& packet, std::vector<double>& signals)
 {
   const int nx = segmentationX_.size() - 1;
   const int ny = segmentationY_.size() - 1;
+  const int nz = segmentationZ_.size() - 1;
   const int binx = 1 + nx + ix;
   const int biny = 1 + ny + iy;
   const int binz = 1 + iz;
@@ -180,30 +291,23 @@ void CCECalculation::transport(const int ix, const int iy, const int iz, const d
   const double z = cceMap_->GetZaxis()->GetBinCenter(binz) * unit::cm;
   const vector3_t position(x, y, z);
 
-  auto particle = std::make_unique<PointCharge>();
-  particle->setPosition(position);
-  particle->setGoal(goal_.get());
-  particle->setEffectiveQ(charge);
-  particle->setPixelSeparations(pixelWidthX_, pixelWidthY_);
-  particle->setField(field_.get());
-  particle->setEndingTime(endingTime_);
+  packet.clear();
+  packet.addCarriers(position, 1.0/numParticles, numParticles);
 
-  const boost::multi_array<double, 2> resultCCE = particle->transport(stepLength_);
-  addCCE(binx-nx, biny-ny, binz, resultCCE[0][0]);
-  addCCE(binx-nx, biny,    binz, resultCCE[0][1]);
-  addCCE(binx-nx, biny+ny, binz, resultCCE[0][2]);
-  addCCE(binx,    biny-ny, binz, resultCCE[1][0]);
-  addCCE(binx,    biny,    binz, resultCCE[1][1]);
-  addCCE(binx,    biny+ny, binz, resultCCE[1][2]);
-  addCCE(binx+nx, biny-ny, binz, resultCCE[2][0]);
-  addCCE(binx+nx, biny,    binz, resultCCE[2][1]);
-  addCCE(binx+nx, biny+ny, binz, resultCCE[2][2]);
+  const boost::multi_array<double, 2> resultCCE = packet.transport(stepLength_);
+  for (int i=0; i<3; i++) {
+    for (int j=0; j<3; j++) {
+      signals[(i*3+j)*nz + iz] += resultCCE[i][j];
+    }
+  }
 }
 
-void CCECalculation::calculateForOppositeSide(const int ix, const int iy, const int iz)
+void CCECalculation::calculateForOppositeSide(const int ix, const int iy, const int iz,
+                                              std::vector<double>& signals)
 {
   const int nx = segmentationX_.size() - 1;
   const int ny = segmentationY_.size() - 1;
+  const int nz = segmentationZ_.size() - 1;
   const int binx = 1 + nx + ix;
   const int biny = 1 + ny + iy;
   const int binz = 1 + iz;
@@ -219,17 +323,126 @@ void CCECalculation::calculateForOppositeSide(const int ix, const int iy, const
       const double wp0 = field_->WeightingPotential(position);
       const double wp1 = 0.0;
       const double signal = wp0 - wp1;
-      const int binx_shifted = binx + px*nx;
-      const int biny_shifted = biny + py*ny;
-      addCCE(binx_shifted, biny_shifted, binz, signal);
+      signals[((px+1)*3 + (py+1))*nz + iz] += signal;
     }
   }
 }
 
-void CCECalculation::addCCE(const int binx, const int biny, const int binz, const double value)
+std::string CCECalculation::checkpointDescription(const int numParticles) const
 {
-  const double v0 = cceMap_->GetBinContent(binx, biny, binz);
-  cceMap_->SetBinContent(binx, biny, binz, v0+value);
+  // every input of the map must appear here; a checkpoint is resumed only if
+  // the description matches exactly.
+  std::ostringstream os;
+  os.precision(17);
+  os << "num_particles=" << numParticles
+     << " seed=" << randomSeed_
+     << " pixel=" << pixelWidthX_ << "," << pixelWidthY_ << "," << thickness_
+     << " upside_readout=" << upsideReadout_
+     << " carrier=" << (carrierPositive_ ? "positive" : "negative")
+     << " mobility=" << mobility_
+     << " lifetime=" << lifetime_
+     << " temperature=" << temperature_
+     << " spread_factor=" << spreadFactor_;
+  if (velocitySaturation_) {
+    os << " velocity_saturation=" << saturationEField_;
+  }
+  os << " efield_file=" << efieldFile_;
+  boost::system::error_code error;
+  const auto efieldFileSize = boost::filesystem::file_size(efieldFile_, error);
+  if (!error) {
+    os << "," << efieldFileSize << "," << boost::filesystem::last_write_time(efieldFile_, error);
+  }
+  if (field_->isEFieldInterpolation()) {
+    os << " efield_interpolation";
+  }
+  if (accurateWeightingPotential_) {
+    os << " accurate_wp=" << weightingPotentialFile_;
+  }
+  os << " step=" << stepLength_;
+  if (adaptiveStep_) {
+    os << " adaptive_step=" << minStep_ << "," << maxStep_ << "," << stepTolerance_;
+  }
+  os << " ending_time=" << endingTime_;
+  if (goal_) {
+    os << " goal=" << goal_->description();
+  }
+  const std::vector<double>* segmentations[3] = { &segmentationX_, &segmentationY_, &segmentationZ_ };
+  for (const std::vector<double>* edges: segmentations) {
+    os << " edges=";
+    for (const double edge: *edges) {
+      os << edge << ",";
+    }
+  }
+  return os.str();
+}
+
+bool CCECalculation::loadCheckpoint(const std::string& description,
+                                    std::vector<double>& cce,
+                                    std::vector<char>& done) const
+{
+  if (!boost::filesystem::exists(checkpointFile_)) {
+    return false;
+  }
+
+  TDirectory::TContext directoryContext;
+  std::unique_ptr<TFile> file(TFile::Open(checkpointFile_.c_str()));
+  if (!file || file->IsZombie()) {
+    std::cout << "Warning: checkpoint file " << checkpointFile_ << " cannot be opened." << std::endl;
+    return false;
+  }
+
+  const TObjString* storedDescription = dynamic_cast<TObjString*>(file->Get("description"));
+  const TVectorD* storedCCE = dynamic_cast<TVectorD*>(file->Get("cce"));
+  const TVectorD* storedDone = dynamic_cast<TVectorD*>(file->Get("done"));
+  if (storedDescription == nullptr || storedCCE == nullptr || storedDone == nullptr
+      || storedDescription->GetString() != description.c_str()
+      || storedCCE->GetNrows() != static_cast<int>(cce.size())
+      || storedDone->GetNrows() != static_cast<int>(done.size())) {
+    std::cout << "Warning: checkpoint file " << checkpointFile_
+              << " is for a different calculation and is ignored." << std::endl;
+    return false;
+  }
+
+  for (std::size_t i=0; i<cce.size(); i++) {
+    cce[i] = (*storedCCE)[i];
+  }
+  for (std::size_t i=0; i<done.size(); i++) {
+    done[i] = ((*storedDone)[i] != 0.0);
+  }
+  return true;
+}
+
+void CCECalculation::saveCheckpoint(const std::string& description,
+                                    const std::vector<double>& cce,
+                                    const std::vector<char>& done) const
+{
+  // The file is written under a temporary name and then renamed, so that an
+  // interruption never leaves a broken checkpoint.
+  const std::string temporaryFile = checkpointFile_ + ".tmp";
+  {
+    TDirectory::TContext directoryContext;
+    TFile file(temporaryFile.c_str(), "RECREATE");
+    if (file.IsZombie()) {
+      std::cout << "Warning: checkpoint file " << temporaryFile << " cannot be created." << std::endl;
+      return;
+    }
+    TObjString storedDescription(description.c_str());
+    TVectorD storedCCE(cce.size(), cce.data());
+    TVectorD storedDone(done.size());
+    for (std::size_t i=0; i<done.size(); i++) {
+      storedDone[i] = done[i];
+    }
+    file.WriteTObject(&storedDescription, "description");
+    file.WriteTObject(&storedCCE, "cce");
+    file.WriteTObject(&storedDone, "done");
+    file.Close();
+  }
+
+  boost::system::error_code error;
+  boost::filesystem::rename(temporaryFile, checkpointFile_, error);
+  if (error) {
+    std::cout << "Warning: checkpoint file " << checkpointFile_ << " cannot be written." << std::endl;
+  }
 }
 
 void CCECalculation::write()
@@ -0,0 +1,165 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ChargeCollectionMapCache.hh"
+
+#include <iostream>
+#include <boost/format.hpp>
+#include <boost/filesystem.hpp>
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TObjString.h"
+
+namespace comptonsoft {
+
+ChargeCollectionMapCache::ChargeCollectionMapCache() = default;
+
+ChargeCollectionMapCache::~ChargeCollectionMapCache() = default;
+
+std::vector<TH1*> ChargeCollectionMapCache::find(const std::string& description, std::size_t numMaps)
+{
+  auto it = entries_.find(description);
+  if (it == entries_.end() && isPersistent()) {
+    std::vector<std::unique_ptr<TH1>> maps = load(description, numMaps);
+    if (!maps.empty()) {
+      std::cout << "Charge collection maps are loaded from " << filePath(description) << std::endl;
+      it = entries_.emplace(description, std::move(maps)).first;
+    }
+  }
+
+  std::vector<TH1*> maps;
+  if (it != entries_.end() && it->second.size() == numMaps) {
+    for (const auto& h: it->second) {
+      maps.push_back(h.get());
+    }
+  }
+  return maps;
+}
+
+void ChargeCollectionMapCache::store(const std::string& description, const std::vector<const TH1*>& maps)
+{
+  std::vector<std::unique_ptr<TH1>> copies;
+  for (const TH1* h: maps) {
+    TH1* copy = static_cast<TH1*>(h->Clone());
+    copy->SetDirectory(nullptr);
+    copies.emplace_back(copy);
+  }
+
+  if (isPersistent()) {
+    save(description, copies);
+  }
+  entries_[description] = std::move(copies);
+}
+
+uint64_t ChargeCollectionMapCache::hash(const std::string& description)
+{
+  // 64-bit FNV-1a, which does not depend on the platform.
+  uint64_t h = 14695981039346656037ull;
+  for (const unsigned char c: description) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::string ChargeCollectionMapCache::filePath(const std::string& description) const
+{
+  const std::string filename = (boost::format("ccemap_%016x.root") % hash(description)).str();
+  return (boost::filesystem::path(directory_) / filename).string();
+}
+
+std::vector<std::unique_ptr<TH1>> ChargeCollectionMapCache::
+load(const std::string& description, std::size_t numMaps) const
+{
+  std::vector<std::unique_ptr<TH1>> maps;
+
+  const std::string path = filePath(description);
+  if (!boost::filesystem::exists(path)) {
+    return maps;
+  }
+
+  TDirectory::TContext directoryContext;
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str()));
+  if (!file || file->IsZombie()) {
+    std::cout << "Warning: cache file " << path << " cannot be opened." << std::endl;
+    return maps;
+  }
+
+  const TObjString* storedDescription = dynamic_cast<TObjString*>(file->Get("description"));
+  if (storedDescription == nullptr || storedDescription->GetString() != description.c_str()) {
+    std::cout << "Warning: cache file " << path << " is for different parameters." << std::endl;
+    return maps;
+  }
+
+  for (std::size_t i=0; i<numMaps; i++) {
+    const std::string name = (boost::format("map%d") % i).str();
+    TH1* h = dynamic_cast<TH1*>(file->Get(name.c_str()));
+    if (h == nullptr) {
+      std::cout << "Warning: cache file " << path << " is broken." << std::endl;
+      maps.clear();
+      return maps;
+    }
+    h->SetDirectory(nullptr);
+    maps.emplace_back(h);
+  }
+
+  return maps;
+}
+
+void ChargeCollectionMapCache::
+save(const std::string& description, const std::vector<std::unique_ptr<TH1>>& maps) const
+{
+  boost::system::error_code error;
+  boost::filesystem::create_directories(directory_, error);
+  if (error) {
+    std::cout << "Warning: cache directory " << directory_ << " cannot be created." << std::endl;
+    return;
+  }
+
+  // The file is written under a temporary name and then renamed, so that
+  // jobs running at the same time never read a file being written.
+  const std::string path = filePath(description);
+  const boost::filesystem::path temporaryPath = boost::filesystem::unique_path(path + ".%%%%%%%%");
+  {
+    TDirectory::TContext directoryContext;
+    TFile file(temporaryPath.c_str(), "RECREATE");
+    if (file.IsZombie()) {
+      std::cout << "Warning: cache file " << temporaryPath << " cannot be created." << std::endl;
+      return;
+    }
+    TObjString storedDescription(description.c_str());
+    storedDescription.Write("description");
+    for (std::size_t i=0; i<maps.size(); i++) {
+      const std::string name = (boost::format("map%d") % i).str();
+      maps[i]->Write(name.c_str());
+    }
+    file.Close();
+  }
+
+  boost::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    std::cout << "Warning: cache file " << path << " cannot be written." << std::endl;
+    boost::filesystem::remove(temporaryPath, error);
+    return;
+  }
+  std::cout << "Charge collection maps are saved to " << path << std::endl;
+}
+
+} /* namespace comptonsoft */
@@ -19,11 +19,78 @@
  *************************************************************************/
 
 #include "CodedAperture.hh"
+#include <cmath>
+#include <algorithm>
 #include "AstroUnits.hh"
 #include "Randomize.hh"
 
 namespace unit = anlgeant4::unit;
 
+namespace {
+
+/* upper limit of the number of (dense) elements of the projection matrix */
+constexpr std::size_t MaxProjectionMatrixElements = std::size_t(1)<<28;
+
+/* number of decoder grid points per detector element (in each axis) */
+constexpr int DecoderGridSubdivision = 4;
+
+int next_power_of_two(int n)
+{
+  int p = 1;
+  while (p < n) { p <<= 1; }
+  return p;
+}
+
+/* in-place radix-2 FFT of data[0], data[stride], ..., data[(n-1)*stride] */
+void fft1d(std::complex<double>* data, int n, int stride, bool inverse)
+{
+  for (int i=1, j=0; i<n; i++) {
+    int bit = n>>1;
+    for (; j&bit; bit>>=1) { j ^= bit; }
+    j ^= bit;
+    if (i < j) { std::swap(data[i*stride], data[j*stride]); }
+  }
+
+  const double sign = inverse ? 1.0 : -1.0;
+  for (int len=2; len<=n; len<<=1) {
+    const double angle = sign*CLHEP::twopi/len;
+    const std::complex<double> wlen(std::cos(angle), std::sin(angle));
+    for (int i=0; i<n; i+=len) {
+      std::complex<double> w(1.0, 0.0);
+      for (int k=0; k<len/2; k++) {
+        const std::complex<double> u = data[(i+k)*stride];
+        const std::complex<double> v = data[(i+k+len/2)*stride]*w;
+        data[(i+k)*stride] = u+v;
+        data[(i+k+len/2)*stride] = u-v;
+        w *= wlen;
+      }
+    }
+  }
+}
+
+/* 2D FFT of a row-major nx x ny array; the inverse transform is normalized. */
+void fft2d(std::vector<std::complex<double>>& data, int nx, int ny, bool inverse)
+{
+  for (int ix=0; ix<nx; ix++) {
+    fft1d(&data[ix*ny], ny, 1, inverse);
+  }
+  for (int iy=0; iy<ny; iy++) {
+    fft1d(&data[iy], nx, ny, inverse);
+  }
+  if (inverse) {
+    const double norm = 1.0/(static_cast<double>(nx)*ny);
+    for (auto& v: data) { v *= norm; }
+  }
+}
+
+int wrap_index(int i, int n)
+{
+  const int r = i%n;
+  return (r<0) ? r+n : r;
+}
+
+} /* anonymous namespace */
+
 namespace comptonsoft
 {
 
@@ -36,6 +103,7 @@ CodedAperture::~CodedAperture() = default;
 void CodedAperture::setAperturePattern(const std::shared_ptr<image_t>& pattern)
 {
   aperture_pattern_ = pattern;
+  invalidateProjection();
 
   const int Nmx = (*aperture_pattern_).shape()[0];
   const int Nmy = (*aperture_pattern_).shape()[1];
@@ -72,6 +140,8 @@ bool CodedAperture::buildSkyImage()
   const double sizex = sky_fov_x_;
   const double sizey = sky_fov_y_;
 
+  invalidateProjection();
+
   const bool number_determined = (Nsx>0) && (Nsy>0);
   const bool size_determined = (sizex>0.0) && (sizey>0.0);
   if (!number_determined) {
@@ -135,6 +205,12 @@ void CodedAperture::decode()
   else if (decoding_mode_==2) {
     decode_based_on_aperture_coordinate();
   }
+  else if (decoding_mode_==3) {
+    decode_by_fft();
+  }
+  else if (decoding_mode_==4) {
+    decode_by_projection_matrix();
+  }
   else {
     std::cerr << "Decoding mode not set appropriately." << std::endl;
   }
@@ -225,6 +301,276 @@ void CodedAperture::decode_based_on_aperture_coordinate()
 
 }
 
+bool CodedAperture::buildProjection()
+{
+  /*
+   * In mode 1, a pair of a sky element s and a detector element d contributes
+   * E(d)*T(x_d + shift(s)), where T is the decoder array seen on the detector
+   * plane and shift(s) = dist*tan(detected angle of s). Since this depends only on
+   * x_d + shift(s), the decoded image is a cross-correlation of E and T evaluated
+   * at real-valued shifts. T is averaged over each detector element and sampled on
+   * a grid finer than the detector elements, so that each sky element can be
+   * represented by bilinear taps at a set of sub-element directions.
+   */
+  const int u = DecoderGridSubdivision;
+  const int Ndx = encoded_image_->shape()[0];
+  const int Ndy = encoded_image_->shape()[1];
+  const int Nsx = decoded_image_->shape()[0];
+  const int Nsy = decoded_image_->shape()[1];
+  const int Nmx = aperture_pattern_->shape()[0];
+  const int Nmy = aperture_pattern_->shape()[1];
+  const double ddx = detector_element_size_x_;
+  const double ddy = detector_element_size_y_;
+  const double cdx = 0.5*(Ndx-1.0);
+  const double cdy = 0.5*(Ndy-1.0);
+  const double dist = DetectorToApertureDistance();
+  const image_t& t = *decoder_array_;
+
+  double pxmin = 0.0, pxmax = 0.0, pymin = 0.0, pymax = 0.0;
+  for (int corner=0; corner<4; corner++) {
+    const double ax = 0.5*Nmx*aperture_element_size_x_;
+    const double ay = 0.5*Nmy*aperture_element_size_y_;
+    vector2_t v((corner&1) ? ax : -ax, (corner&2) ? ay : -ay);
+    v.rotate(-aperture_roll_angle_);
+    v += aperture_offset_;
+    if (corner==0) {
+      pxmin = pxmax = v.x();
+      pymin = pymax = v.y();
+    }
+    else {
+      pxmin = std::min(pxmin, v.x());
+      pxmax = std::max(pxmax, v.x());
+      pymin = std::min(pymin, v.y());
+      pymax = std::max(pymax, v.y());
+    }
+  }
+
+  const int gxmin = static_cast<int>(std::floor(cdx+pxmin/ddx)) - 1;
+  const int gxmax = static_cast<int>(std::ceil(cdx+pxmax/ddx)) + 1;
+  const int gymin = static_cast<int>(std::floor(cdy+pymin/ddy)) - 1;
+  const int gymax = static_cast<int>(std::ceil(cdy+pymax/ddy)) + 1;
+  const int Mx = u*(gxmax - gxmin) + 1;
+  const int My = u*(gymax - gymin) + 1;
+  if (Mx<=0 || My<=0) {
+    std::cerr << "CodedAperture: invalid projection of the aperture." << std::endl;
+    return false;
+  }
+
+  const double detectorToApertureRatio = std::max(ddx/aperture_element_size_x_, ddy/aperture_element_size_y_);
+  const int nd = std::min(64, std::max(16, static_cast<int>(std::ceil(32.0*detectorToApertureRatio))));
+  decoder_grid_.assign(Mx*My, 0.0);
+  for (int gx=0; gx<Mx; gx++) {
+    for (int gy=0; gy<My; gy++) {
+      double sum = 0.0;
+      for (int i=0; i<nd; i++) {
+        for (int j=0; j<nd; j++) {
+          const vector2_t p((gxmin+static_cast<double>(gx)/u-cdx+(i+0.5)/nd-0.5)*ddx,
+                            (gymin+static_cast<double>(gy)/u-cdy+(j+0.5)/nd-0.5)*ddy);
+          const CodedAperture::ID aperture_id = ApertureID(DetectorToAperture(p));
+          if (!aperture_id.invalid) {
+            sum += t[aperture_id.ix][aperture_id.iy];
+          }
+        }
+      }
+      decoder_grid_[gx*My+gy] = sum/(nd*nd);
+    }
+  }
+
+  const double skyElementExtent = dist*std::max(sky_element_angle_x_/ddx, sky_element_angle_y_/ddy);
+  const int ns = std::min(16, std::max(1, static_cast<int>(std::ceil(skyElementExtent))+1));
+  const double sampleWeight = 1.0/(ns*ns);
+  const double csx = 0.5*(Nsx-1.0);
+  const double csy = 0.5*(Nsy-1.0);
+  sky_tap_start_.assign(Nsx*Nsy+1, 0);
+  sky_taps_.clear();
+  for (int sx=0; sx<Nsx; sx++) {
+    for (int sy=0; sy<Nsy; sy++) {
+      sky_tap_start_[sx*Nsy+sy] = sky_taps_.size();
+      for (int i=0; i<ns; i++) {
+        for (int j=0; j<ns; j++) {
+          const vector2_t sky_angle((sx-csx+(i+0.5)/ns-0.5)*sky_element_angle_x_,
+                                    (sy-csy+(j+0.5)/ns-0.5)*sky_element_angle_y_);
+          const vector2_t detected_angle = SkyAngleToDetectedAngle(sky_angle);
+          const double lx = u*(dist*std::tan(detected_angle.x())/ddx - gxmin);
+          const double ly = u*(dist*std::tan(detected_angle.y())/ddy - gymin);
+          const int lx0 = static_cast<int>(std::floor(lx));
+          const int ly0 = static_cast<int>(std::floor(ly));
+          const double fx = lx - lx0;
+          const double fy = ly - ly0;
+          for (int a=0; a<2; a++) {
+            for (int b=0; b<2; b++) {
+              SkyShiftTap tap;
+              tap.lx = lx0 + a;
+              tap.ly = ly0 + b;
+              tap.weight = (a ? fx : 1.0-fx) * (b ? fy : 1.0-fy) * sampleWeight;
+              if (tap.weight==0.0
+                  || tap.lx < -u*(Ndx-1) || tap.lx >= Mx
+                  || tap.ly < -u*(Ndy-1) || tap.ly >= My) {
+                continue;
+              }
+              sky_taps_.push_back(tap);
+            }
+          }
+        }
+      }
+    }
+  }
+  sky_tap_start_[Nsx*Nsy] = sky_taps_.size();
+
+  correlation_num_x_ = next_power_of_two(u*(Ndx-1)+Mx);
+  correlation_num_y_ = next_power_of_two(u*(Ndy-1)+My);
+  decoder_spectrum_.assign(correlation_num_x_*correlation_num_y_, std::complex<double>(0.0, 0.0));
+  for (int gx=0; gx<Mx; gx++) {
+    for (int gy=0; gy<My; gy++) {
+      decoder_spectrum_[gx*correlation_num_y_+gy] = decoder_grid_[gx*My+gy];
+    }
+  }
+  fft2d(decoder_spectrum_, correlation_num_x_, correlation_num_y_, false);
+
+  projection_detector_num_x_ = Ndx;
+  projection_detector_num_y_ = Ndy;
+  decoder_grid_min_x_ = gxmin;
+  decoder_grid_min_y_ = gymin;
+  decoder_grid_num_x_ = Mx;
+  decoder_grid_num_y_ = My;
+  projection_ready_ = true;
+  projection_matrix_ready_ = false;
+  projection_matrix_too_large_ = false;
+  return true;
+}
+
+bool CodedAperture::buildProjectionMatrix()
+{
+  const int u = DecoderGridSubdivision;
+  const int Ndx = projection_detector_num_x_;
+  const int Ndy = projection_detector_num_y_;
+  const int Mx = decoder_grid_num_x_;
+  const int My = decoder_grid_num_y_;
+  const std::size_t Ns = sky_tap_start_.size() - 1;
+  const std::size_t Nd = static_cast<std::size_t>(Ndx)*Ndy;
+  if (Ns*Nd > MaxProjectionMatrixElements) {
+    std::cerr << "CodedAperture: projection matrix is too large ("
+              << Ns << " x " << Nd << "). Decoding mode 3 is used instead." << std::endl;
+    projection_matrix_too_large_ = true;
+    return false;
+  }
+
+  projection_matrix_row_start_.assign(Ns+1, 0);
+  projection_matrix_column_.clear();
+  projection_matrix_value_.clear();
+  std::vector<double> row(Nd);
+  for (std::size_t s=0; s<Ns; s++) {
+    projection_matrix_row_start_[s] = projection_matrix_column_.size();
+    std::fill(row.begin(), row.end(), 0.0);
+    for (std::size_t k=sky_tap_start_[s]; k<sky_tap_start_[s+1]; k++) {
+      const SkyShiftTap& tap = sky_taps_[k];
+      for (int dx=0; dx<Ndx; dx++) {
+        const int gx = u*dx + tap.lx;
+        if (gx<0 || gx>=Mx) { continue; }
+        for (int dy=0; dy<Ndy; dy++) {
+          const int gy = u*dy + tap.ly;
+          if (gy<0 || gy>=My) { continue; }
+          row[dx*Ndy+dy] += tap.weight * decoder_grid_[gx*My+gy];
+        }
+      }
+    }
+    for (std::size_t d=0; d<Nd; d++) {
+      if (row[d] != 0.0) {
+        projection_matrix_column_.push_back(d);
+        projection_matrix_value_.push_back(row[d]);
+      }
+    }
+  }
+  projection_matrix_row_start_[Ns] = projection_matrix_column_.size();
+
+  projection_matrix_ready_ = true;
+  return true;
+}
+
+void CodedAperture::decode_by_fft()
+{
+  const int Ndx = encoded_image_->shape()[0];
+  const int Ndy = encoded_image_->shape()[1];
+  if (!projection_ready_ || Ndx!=projection_detector_num_x_ || Ndy!=projection_detector_num_y_) {
+    if (!buildProjection()) {
+      return;
+    }
+  }
+
+  const int Nsx = decoded_image_->shape()[0];
+  const int Nsy = decoded_image_->shape()[1];
+  const int Px = correlation_num_x_;
+  const int Py = correlation_num_y_;
+
+  const int u = DecoderGridSubdivision;
+
+  image_t& imageD = *decoded_image_;
+  const image_t& imageE = *encoded_image_;
+
+  correlation_buffer_.assign(Px*Py, std::complex<double>(0.0, 0.0));
+  for (int dx=0; dx<Ndx; dx++) {
+    for (int dy=0; dy<Ndy; dy++) {
+      if (imageE[dx][dy]>0.0) {
+        correlation_buffer_[(u*dx)*Py+(u*dy)] = imageE[dx][dy];
+      }
+    }
+  }
+  fft2d(correlation_buffer_, Px, Py, false);
+  for (std::size_t k=0; k<correlation_buffer_.size(); k++) {
+    correlation_buffer_[k] = std::conj(correlation_buffer_[k]) * decoder_spectrum_[k];
+  }
+  fft2d(correlation_buffer_, Px, Py, true);
+
+  for (int sx=0; sx<Nsx; sx++) {
+    for (int sy=0; sy<Nsy; sy++) {
+      const int s = sx*Nsy+sy;
+      double v = 0.0;
+      for (std::size_t k=sky_tap_start_[s]; k<sky_tap_start_[s+1]; k++) {
+        const SkyShiftTap& tap = sky_taps_[k];
+        v += tap.weight * correlation_buffer_[wrap_index(tap.lx, Px)*Py+wrap_index(tap.ly, Py)].real();
+      }
+      imageD[sx][sy] += num_decoding_iterations_ * v;
+    }
+  }
+}
+
+void CodedAperture::decode_by_projection_matrix()
+{
+  const int Ndx = encoded_image_->shape()[0];
+  const int Ndy = encoded_image_->shape()[1];
+  if (!projection_ready_ || Ndx!=projection_detector_num_x_ || Ndy!=projection_detector_num_y_) {
+    if (!buildProjection()) {
+      return;
+    }
+  }
+  if (!projection_matrix_ready_) {
+    if (projection_matrix_too_large_ || !buildProjectionMatrix()) {
+      decode_by_fft();
+      return;
+    }
+  }
+
+  const int Nsx = decoded_image_->shape()[0];
+  const int Nsy = decoded_image_->shape()[1];
+
+  image_t& imageD = *decoded_image_;
+  const double* imageE = encoded_image_->data();
+
+  for (int sx=0; sx<Nsx; sx++) {
+    for (int sy=0; sy<Nsy; sy++) {
+      const int s = sx*Nsy+sy;
+      double v = 0.0;
+      for (std::size_t k=projection_matrix_row_start_[s]; k<projection_matrix_row_start_[s+1]; k++) {
+        const double e = imageE[projection_matrix_column_[k]];
+        if (e>0.0) {
+          v += projection_matrix_value_[k] * e;
+        }
+      }
+      imageD[sx][sy] += num_decoding_iterations_ * v;
+    }
+  }
+}
+
 CodedAperture::ID CodedAperture::DetectorID(const vector2_t& v) const
 {
   const int nx = encoded_image_->shape()[0];
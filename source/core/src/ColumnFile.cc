@@ -0,0 +1,271 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ColumnFile.hh"
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+namespace comptonsoft {
+
+namespace {
+
+constexpr std::size_t HeaderSize = 64;
+constexpr char Magic[8] = {'C', 'S', 'C', 'O', 'L', 'U', 'M', 'N'};
+constexpr uint32_t FormatVersion = 1;
+
+bool host_is_little_endian()
+{
+  const uint16_t v = 1;
+  unsigned char c;
+  std::memcpy(&c, &v, 1);
+  return c == 1;
+}
+
+std::size_t element_size(ColumnType type)
+{
+  switch (type) {
+  case ColumnType::Int16: return 2;
+  case ColumnType::Int32: return 4;
+  case ColumnType::Int64: return 8;
+  case ColumnType::UInt32: return 4;
+  case ColumnType::UInt64: return 8;
+  case ColumnType::Float32: return 4;
+  case ColumnType::Float64: return 8;
+  }
+  return 0;
+}
+
+bool is_integer(ColumnType type)
+{
+  return !(type == ColumnType::Float32 || type == ColumnType::Float64);
+}
+
+void store_le(char* p, uint64_t v, std::size_t size)
+{
+  for (std::size_t i=0; i<size; i++) {
+    p[i] = static_cast<char>((v >> (8*i)) & 0xff);
+  }
+}
+
+uint64_t load_le(const char* p, std::size_t size)
+{
+  uint64_t v = 0;
+  for (std::size_t i=0; i<size; i++) {
+    v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8*i);
+  }
+  return v;
+}
+
+/* converts a sign-extended integer into a value of the column type */
+void store_integer(char* p, int64_t v, ColumnType type)
+{
+  switch (type) {
+  case ColumnType::Int16: { const int16_t x = v; std::memcpy(p, &x, 2); break; }
+  case ColumnType::Int32: { const int32_t x = v; std::memcpy(p, &x, 4); break; }
+  case ColumnType::UInt32: { const uint32_t x = v; std::memcpy(p, &x, 4); break; }
+  default: { std::memcpy(p, &v, 8); break; }
+  }
+}
+
+} /* anonymous namespace */
+
+ColumnWriter::~ColumnWriter()
+{
+  if (isOpen()) {
+    close();
+  }
+}
+
+bool ColumnWriter::open(const std::string& filename, ColumnType type, ColumnEncoding encoding)
+{
+  filename_ = filename;
+  type_ = type;
+  encoding_ = is_integer(type) ? encoding : ColumnEncoding::Raw;
+  numRecords_ = 0;
+  dataBytes_ = 0;
+  previous_ = 0;
+  buffer_.clear();
+
+  file_.open(filename, std::ios::binary|std::ios::trunc);
+  if (!file_) {
+    std::cout << "ColumnWriter: cannot open " << filename << std::endl;
+    return false;
+  }
+  return writeHeader();
+}
+
+void ColumnWriter::appendRaw(const void* value, std::size_t size)
+{
+  const std::size_t n = buffer_.size();
+  buffer_.resize(n+size);
+  char* p = &buffer_[n];
+  std::memcpy(p, value, size);
+  if (!host_is_little_endian()) {
+    std::reverse(p, p+size);
+  }
+}
+
+void ColumnWriter::appendDelta(int64_t value)
+{
+  const uint64_t delta = static_cast<uint64_t>(value) - static_cast<uint64_t>(previous_);
+  previous_ = value;
+  uint64_t zigzag = (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+  while (zigzag >= 0x80) {
+    buffer_.push_back(static_cast<char>((zigzag & 0x7f) | 0x80));
+    zigzag >>= 7;
+  }
+  buffer_.push_back(static_cast<char>(zigzag));
+}
+
+void ColumnWriter::flush()
+{
+  file_.write(buffer_.data(), buffer_.size());
+  dataBytes_ += buffer_.size();
+  buffer_.clear();
+}
+
+bool ColumnWriter::writeHeader()
+{
+  char header[HeaderSize] = {};
+  std::memcpy(header, Magic, sizeof(Magic));
+  store_le(header+8, FormatVersion, 4);
+  header[12] = static_cast<char>(type_);
+  header[13] = static_cast<char>(element_size(type_));
+  header[14] = static_cast<char>(encoding_);
+  store_le(header+16, numRecords_, 8);
+  store_le(header+24, dataBytes_, 8);
+
+  file_.seekp(0);
+  file_.write(header, HeaderSize);
+  return static_cast<bool>(file_);
+}
+
+bool ColumnWriter::close()
+{
+  flush();
+  const bool status = writeHeader();
+  file_.close();
+  if (!status || !file_) {
+    std::cout << "ColumnWriter: cannot write " << filename_ << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ColumnReader::open(const std::string& filename)
+{
+  close();
+  if (!file_.open(filename) || file_.size() < HeaderSize) {
+    std::cout << "ColumnReader: cannot read " << filename << std::endl;
+    return false;
+  }
+
+  const char* header = file_.data();
+  const uint8_t type = header[12];
+  const uint8_t encoding = header[14];
+  if (std::memcmp(header, Magic, sizeof(Magic)) != 0
+      || load_le(header+8, 4) != FormatVersion
+      || type < static_cast<uint8_t>(ColumnType::Int16)
+      || type > static_cast<uint8_t>(ColumnType::Float64)
+      || encoding > static_cast<uint8_t>(ColumnEncoding::DeltaVarint)) {
+    std::cout << "ColumnReader: " << filename << " is not a valid column file." << std::endl;
+    file_.close();
+    return false;
+  }
+
+  type_ = static_cast<ColumnType>(type);
+  encoding_ = static_cast<ColumnEncoding>(encoding);
+  numRecords_ = load_le(header+16, 8);
+  const uint64_t dataBytes = load_le(header+24, 8);
+  const std::size_t elementSize = element_size(type_);
+  if (static_cast<uint8_t>(header[13]) != elementSize
+      || dataBytes > file_.size()-HeaderSize
+      || (encoding_ == ColumnEncoding::Raw && dataBytes != numRecords_*elementSize)
+      || (encoding_ == ColumnEncoding::DeltaVarint && numRecords_ > dataBytes)) {
+    std::cout << "ColumnReader: " << filename << " is broken." << std::endl;
+    file_.close();
+    return false;
+  }
+
+  const char* encoded = file_.data() + HeaderSize;
+  if (encoding_ == ColumnEncoding::Raw && host_is_little_endian()) {
+    data_ = encoded;
+    mapped_ = true;
+    open_ = true;
+    return true;
+  }
+
+  const bool status = decode(encoded, dataBytes);
+  file_.close();
+  if (!status) {
+    std::cout << "ColumnReader: " << filename << " is broken." << std::endl;
+    return false;
+  }
+  data_ = reinterpret_cast<const char*>(decoded_.data());
+  open_ = true;
+  return true;
+}
+
+bool ColumnReader::decode(const char* encoded, std::size_t size)
+{
+  const std::size_t elementSize = element_size(type_);
+  decoded_.assign((numRecords_*elementSize+7)/8, 0);
+  char* out = reinterpret_cast<char*>(decoded_.data());
+
+  if (encoding_ == ColumnEncoding::Raw) {
+    // big-endian host
+    for (uint64_t i=0; i<numRecords_; i++) {
+      const char* p = encoded + i*elementSize;
+      std::reverse_copy(p, p+elementSize, out + i*elementSize);
+    }
+    return true;
+  }
+
+  const char* p = encoded;
+  const char* end = encoded + size;
+  uint64_t value = 0;
+  for (uint64_t i=0; i<numRecords_; i++) {
+    uint64_t zigzag = 0;
+    int shift = 0;
+    while (true) {
+      if (p == end || shift > 63) { return false; }
+      const uint8_t byte = *p++;
+      zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) { break; }
+      shift += 7;
+    }
+    const uint64_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+    value += delta;
+    store_integer(out + i*elementSize, static_cast<int64_t>(value), type_);
+  }
+  return true;
+}
+
+void ColumnReader::close()
+{
+  file_.close();
+  std::vector<uint64_t>().swap(decoded_);
+  data_ = nullptr;
+  numRecords_ = 0;
+  mapped_ = false;
+  open_ = false;
+}
+
+} /* namespace comptonsoft */
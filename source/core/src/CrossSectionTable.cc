@@ -0,0 +1,182 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "CrossSectionTable.hh"
+#include <cmath>
+#include <algorithm>
+#include "TGraph.h"
+
+namespace comptonsoft {
+
+namespace {
+
+void linear_extrapolation_coefficients(const TGraph& graph,
+                                       bool low,
+                                       double& offset,
+                                       double& slope)
+{
+  const int n = graph.GetN();
+  if (n < 2) {
+    offset = (n==1) ? graph.GetY()[0] : 0.0;
+    slope = 0.0;
+    return;
+  }
+
+  const int i0 = low ? 0 : n-2;
+  const double x0 = graph.GetX()[i0];
+  const double y0 = graph.GetY()[i0];
+  const double x1 = graph.GetX()[i0+1];
+  const double y1 = graph.GetY()[i0+1];
+  slope = (x1 != x0) ? (y1-y0)/(x1-x0) : 0.0;
+  offset = y0 - slope*x0;
+}
+
+} /* anonymous namespace */
+
+bool CrossSectionTable::build(const TGraph& total,
+                              const TGraph& compton,
+                              const TGraph& photoabsorption,
+                              int pointsPerDecade)
+{
+  const TGraph* graphs[3] = { &total, &compton, &photoabsorption };
+
+  double emin = 0.0;
+  double emax = 0.0;
+  bool first = true;
+  for (const TGraph* g: graphs) {
+    const int n = g->GetN();
+    if (n < 1) { return false; }
+    const double x0 = *std::min_element(g->GetX(), g->GetX()+n);
+    const double x1 = *std::max_element(g->GetX(), g->GetX()+n);
+    if (first) {
+      emin = x0;
+      emax = x1;
+      first = false;
+    }
+    else {
+      emin = std::min(emin, x0);
+      emax = std::max(emax, x1);
+    }
+  }
+
+  if (!(emin > 0.0 && emax > emin && pointsPerDecade > 0)) {
+    return false;
+  }
+
+  const double logEnergyMin = std::log(emin);
+  const double logEnergyMax = std::log(emax);
+  const double numDecades = (logEnergyMax-logEnergyMin)/std::log(10.0);
+  const std::size_t numPoints = static_cast<std::size_t>(std::ceil(numDecades*pointsPerDecade)) + 1;
+  const double logStep = (logEnergyMax-logEnergyMin)/(numPoints-1);
+
+  energyMin_ = emin;
+  energyMax_ = emax;
+  logEnergyMin_ = logEnergyMin;
+  gridPerLogEnergy_ = 1.0/logStep;
+
+  energies_.resize(numPoints);
+  inverseWidths_.assign(numPoints, 0.0);
+  table_.resize(numPoints);
+  for (std::size_t k=0; k<numPoints; k++) {
+    const double energy = (k==numPoints-1) ? emax : std::exp(logEnergyMin+logStep*k);
+    energies_[k] = energy;
+    Values& v = table_[k];
+    v.total = total.Eval(energy);
+    v.compton = compton.Eval(energy);
+    v.photoabsorption = photoabsorption.Eval(energy);
+  }
+  for (std::size_t k=0; k+1<numPoints; k++) {
+    inverseWidths_[k] = 1.0/(energies_[k+1]-energies_[k]);
+  }
+
+  linear_extrapolation_coefficients(total, true, lowOffset_.total, lowSlope_.total);
+  linear_extrapolation_coefficients(compton, true, lowOffset_.compton, lowSlope_.compton);
+  linear_extrapolation_coefficients(photoabsorption, true, lowOffset_.photoabsorption, lowSlope_.photoabsorption);
+  linear_extrapolation_coefficients(total, false, highOffset_.total, highSlope_.total);
+  linear_extrapolation_coefficients(compton, false, highOffset_.compton, highSlope_.compton);
+  linear_extrapolation_coefficients(photoabsorption, false, highOffset_.photoabsorption, highSlope_.photoabsorption);
+
+  return true;
+}
+
+std::size_t CrossSectionTable::cellIndex(double energy, double position) const
+{
+  const std::size_t lastCell = table_.size()-2;
+  const std::size_t k = static_cast<std::size_t>(position);
+  // rounding of log() may shift the index by one at a cell boundary.
+  if (k > lastCell) { return lastCell; }
+  if (energy < energies_[k]) { return (k>0) ? k-1 : 0; }
+  if (energy >= energies_[k+1] && k < lastCell) { return k+1; }
+  return k;
+}
+
+CrossSectionTable::Values CrossSectionTable::interpolateInCell(std::size_t k, double energy) const
+{
+  const double t = (energy-energies_[k])*inverseWidths_[k];
+  const Values& v0 = table_[k];
+  const Values& v1 = table_[k+1];
+  Values v;
+  v.total = v0.total + (v1.total-v0.total)*t;
+  v.compton = v0.compton + (v1.compton-v0.compton)*t;
+  v.photoabsorption = v0.photoabsorption + (v1.photoabsorption-v0.photoabsorption)*t;
+  return v;
+}
+
+CrossSectionTable::Values CrossSectionTable::extrapolate(double energy) const
+{
+  const bool low = !(energy >= energyMin_);
+  const Values& offset = low ? lowOffset_ : highOffset_;
+  const Values& slope = low ? lowSlope_ : highSlope_;
+  Values v;
+  v.total = offset.total + slope.total*energy;
+  v.compton = offset.compton + slope.compton*energy;
+  v.photoabsorption = offset.photoabsorption + slope.photoabsorption*energy;
+  return v;
+}
+
+void CrossSectionTable::interpolate(const double* energies, Values* values, std::size_t n) const
+{
+  constexpr std::size_t ChunkSize = 64;
+  double position[ChunkSize];
+
+  for (std::size_t start=0; start<n; start+=ChunkSize) {
+    const std::size_t m = std::min(ChunkSize, n-start);
+    const double* e = energies + start;
+    Values* out = values + start;
+
+    // grid coordinates; this loop has no branch and no gather.
+    for (std::size_t i=0; i<m; i++) {
+      const double x = std::max(e[i], energyMin_);
+      position[i] = (std::log(x)-logEnergyMin_)*gridPerLogEnergy_;
+    }
+
+    for (std::size_t i=0; i<m; i++) {
+      const double energy = e[i];
+      if (energy >= energyMin_ && energy < energyMax_) {
+        const std::size_t k = cellIndex(energy, position[i]);
+        out[i] = interpolateInCell(k, energy);
+      }
+      else {
+        out[i] = extrapolate(energy);
+      }
+    }
+  }
+}
+
+} /* namespace comptonsoft */
@@ -0,0 +1,278 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "DataFileStream.hh"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace comptonsoft {
+
+DataFileStream::DataFileStream(std::size_t chunkSize, bool background)
+  : chunkSize_(std::max<std::size_t>((chunkSize+7)/8*8, 8)),
+    background_(background)
+{
+}
+
+DataFileStream::~DataFileStream()
+{
+  close();
+}
+
+void DataFileStream::open(const std::vector<std::string>& files)
+{
+  close();
+
+  files_ = files;
+  fileIndex_ = -1;
+  fileOffset_ = 0;
+  stop_ = false;
+  finished_ = false;
+  numBytes_ = 0;
+  numPackets_ = 0;
+  startTime_ = std::chrono::steady_clock::now();
+  lastTime_ = startTime_;
+
+  const std::size_t numChunks = background_ ? NumChunks : 1;
+  for (std::size_t i=0; i<numChunks; i++) {
+    std::unique_ptr<Chunk> chunk(new Chunk);
+    chunk->buffer.resize(chunkSize_/8);
+    freeChunks_.push_back(std::move(chunk));
+  }
+
+  if (background_) {
+    worker_ = std::thread(&DataFileStream::produce, this);
+  }
+}
+
+void DataFileStream::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+
+  fin_.close();
+  current_.reset();
+  position_ = 0;
+  freeChunks_.clear();
+  readyChunks_.clear();
+}
+
+void DataFileStream::produce()
+{
+  while (true) {
+    std::unique_ptr<Chunk> chunk;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this]() { return stop_ || !freeChunks_.empty(); });
+      if (stop_) { return; }
+      chunk = std::move(freeChunks_.front());
+      freeChunks_.pop_front();
+    }
+
+    readChunk(*chunk);
+    const bool endOfStream = chunk->endOfStream;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      readyChunks_.push_back(std::move(chunk));
+    }
+    condition_.notify_all();
+
+    if (endOfStream) { return; }
+  }
+}
+
+void DataFileStream::readChunk(Chunk& chunk)
+{
+  chunk.size = 0;
+  chunk.endOfFile = false;
+  chunk.endOfStream = false;
+
+  if (!fin_.is_open()) {
+    ++fileIndex_;
+    if (fileIndex_ >= static_cast<int>(files_.size())) {
+      chunk.fileIndex = fileIndex_;
+      chunk.endOfStream = true;
+      return;
+    }
+
+    fin_.clear();
+    fin_.open(files_[fileIndex_].c_str(), std::ios::binary);
+    if (!fin_) {
+      std::cout << "DataFileStream: cannot open " << files_[fileIndex_] << std::endl;
+      chunk.fileIndex = fileIndex_;
+      chunk.endOfStream = true;
+      return;
+    }
+    fileOffset_ = 0;
+  }
+
+  fin_.read(chunk.data(), chunkSize_);
+  chunk.size = fin_.gcount();
+  chunk.fileIndex = fileIndex_;
+  chunk.fileOffset = fileOffset_;
+  fileOffset_ += chunk.size;
+
+  if (!fin_ || fin_.peek() == std::ifstream::traits_type::eof()) {
+    chunk.endOfFile = true;
+    fin_.close();
+  }
+}
+
+bool DataFileStream::fetchChunk()
+{
+  if (finished_) { return false; }
+
+  if (background_) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return !readyChunks_.empty(); });
+    current_ = std::move(readyChunks_.front());
+    readyChunks_.pop_front();
+  }
+  else {
+    current_ = std::move(freeChunks_.front());
+    freeChunks_.pop_front();
+    readChunk(*current_);
+  }
+  position_ = 0;
+
+  if (current_->endOfStream) {
+    finished_ = true;
+    releaseChunk();
+    return false;
+  }
+
+  if (current_->fileOffset == 0) {
+    std::cout << "DataFileStream: read " << files_[current_->fileIndex] << std::endl;
+  }
+  return true;
+}
+
+void DataFileStream::releaseChunk()
+{
+  if (!current_) { return; }
+
+  if (background_) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      freeChunks_.push_back(std::move(current_));
+    }
+    condition_.notify_all();
+  }
+  else {
+    freeChunks_.push_back(std::move(current_));
+  }
+  position_ = 0;
+}
+
+const char* DataFileStream::read(std::size_t size, bool continued)
+{
+  while (true) {
+    if (!current_) {
+      if (!fetchChunk()) {
+        return nullptr;
+      }
+    }
+
+    const std::size_t remaining = current_->size - position_;
+    if (remaining >= size) {
+      const char* packet = current_->data() + position_;
+      position_ += size;
+      countPacket(size);
+      return packet;
+    }
+
+    if (!current_->endOfFile) {
+      const char* packet = assemblePacket(size);
+      if (packet) {
+        countPacket(size);
+        return packet;
+      }
+    }
+    else if (remaining > 0) {
+      std::cout << "DataFileStream: " << remaining << " bytes at the end of "
+                << files_[current_->fileIndex] << " are discarded." << std::endl;
+    }
+
+    releaseChunk();
+    if (continued) {
+      // the file ended in the middle of the packet.
+      return nullptr;
+    }
+  }
+}
+
+const char* DataFileStream::assemblePacket(std::size_t size)
+{
+  const uint64_t offset = current_->fileOffset + position_;
+  const std::size_t shift = offset % 8;
+  spill_.resize((shift+size+7)/8);
+  char* packet = reinterpret_cast<char*>(spill_.data()) + shift;
+
+  std::size_t filled = 0;
+  while (true) {
+    const std::size_t n = std::min(size-filled, current_->size-position_);
+    std::memcpy(packet+filled, current_->data()+position_, n);
+    filled += n;
+    position_ += n;
+    if (filled == size) {
+      return packet;
+    }
+
+    if (current_->endOfFile) {
+      std::cout << "DataFileStream: " << filled << " bytes at the end of "
+                << files_[current_->fileIndex] << " are discarded." << std::endl;
+      return nullptr;
+    }
+
+    releaseChunk();
+    if (!fetchChunk()) {
+      return nullptr;
+    }
+  }
+}
+
+void DataFileStream::countPacket(std::size_t size)
+{
+  numBytes_ += size;
+  ++numPackets_;
+  lastTime_ = std::chrono::steady_clock::now();
+}
+
+const std::string& DataFileStream::CurrentFilename() const
+{
+  static const std::string empty;
+  if (!current_ || current_->fileIndex < 0) {
+    return empty;
+  }
+  return files_[current_->fileIndex];
+}
+
+double DataFileStream::ElapsedTime() const
+{
+  return std::chrono::duration<double>(lastTime_-startTime_).count();
+}
+
+} /* namespace comptonsoft */
@@ -47,6 +47,7 @@
 #include "FrameData.hh"
 #include "GainFunctionCubic.hh"
 #include "DeviceSimulation.hh"
+#include "ChargeCollectionMapCache.hh"
 #include "CSSensitiveDetector.hh"
 
 namespace unit = anlgeant4::unit;
@@ -58,7 +59,8 @@ DetectorSystem::DetectorSystem()
     simAutoPosition_(false),
     simSDCheck_(false),
     detectorConstructed_(false),
-    ROOTFile_(nullptr)
+    ROOTFile_(nullptr),
+    CCEMapCache_(new ChargeCollectionMapCache)
 {
   std::vector<std::string> defaultGroups = {"Anti", "Trigger", "Off", "LowZ", "HighZ"};
   for (auto& groupName: defaultGroups) {
@@ -129,18 +131,31 @@ void DetectorSystem::printDetectorGroups() const
 void DetectorSystem::registerGeant4SensitiveDetectors()
 {
   for (auto& sd: sensitiveDetectorVector_) {
-    G4String name = sd->GetName();
-    G4SDManager::GetSDMpointer()->AddNewDetector(sd);
-    G4LogicalVolume* logicalVolume =
-      G4LogicalVolumeStore::GetInstance()->GetVolume(name);
-    if (logicalVolume) {
-      logicalVolume->SetSensitiveDetector(sd);
-    }
-    else {
-      std::ostringstream message;
-      message << "Error: Logical volume = " << name << " is not found.\n";
-      BOOST_THROW_EXCEPTION( CSException(message.str()) );
-    }
+    registerGeant4SensitiveDetector(sd);
+  }
+}
+
+void DetectorSystem::registerGeant4SensitiveDetectorsForWorker()
+{
+  for (auto& sd: sensitiveDetectorVector_) {
+    // owned by the G4SDManager of the worker thread.
+    registerGeant4SensitiveDetector(sd->Clone());
+  }
+}
+
+void DetectorSystem::registerGeant4SensitiveDetector(VCSSensitiveDetector* sd)
+{
+  G4String name = sd->GetName();
+  G4SDManager::GetSDMpointer()->AddNewDetector(sd);
+  G4LogicalVolume* logicalVolume =
+    G4LogicalVolumeStore::GetInstance()->GetVolume(name);
+  if (logicalVolume) {
+    logicalVolume->SetSensitiveDetector(sd);
+  }
+  else {
+    std::ostringstream message;
+    message << "Error: Logical volume = " << name << " is not found.\n";
+    BOOST_THROW_EXCEPTION( CSException(message.str()) );
   }
 }
 
@@ -704,6 +719,16 @@ loadDetectorParametersRootNode(const boost::property_tree::ptree& RootNode,
     ROOTFile_.reset(new TFile(fullPath.c_str()));
   }
 
+  if (optional<std::string> cacheDirectory = mainNode.get_optional<std::string>("charge_collection_map_cache.<xmlattr>.directory")) {
+    boost::filesystem::path fullPath(*cacheDirectory);
+    if (fullPath.is_relative()) {
+      boost::filesystem::path paramFilePath(filename);
+      fullPath = paramFilePath.parent_path() / fullPath;
+    }
+    std::cout << "Charge collection map cache: " << fullPath << std::endl;
+    CCEMapCache_->setDirectory(fullPath.string());
+  }
+
   if (optional<int> autoPositionFlag = mainNode.get_optional<int>("auto_position.<xmlattr>.flag")) {
     if (autoPositionFlag && *autoPositionFlag==1) {
       std::cout << "Auto position mode: On" << std::endl;
@@ -1074,6 +1099,7 @@ void DetectorSystem::setupDetectorParameters(const DetectorSystem::ParametersNod
     }
 
     if (ds->ChargeCollectionMode()>=2 && !ds->isCCEMapPrepared()) {
+      ds->setChargeCollectionMapCache(CCEMapCache_.get());
       ds->buildWPMap();
       ds->buildCCEMap();
     }
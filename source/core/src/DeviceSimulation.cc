@@ -18,6 +18,8 @@
  *************************************************************************/
 
 #include "DeviceSimulation.hh"
+#include <thread>
+#include <boost/format.hpp>
 #include "AstroUnits.hh"
 #include "TSpline.h"
 #include "DetectorHit.hh"
@@ -32,6 +34,8 @@ DeviceSimulation::DeviceSimulation()
     CCEMapName_(""),
     EField_(new EFieldModel),
     numPixelsInWPCalculation_(5.0),
+    CCEMapCache_(nullptr),
+    numThreadsInMapCalculation_(0),
     diffusionMode_(0),
     diffusionDivisionNumber_(64),
     diffusionSigmaConstantAnode_(0.0),
@@ -69,6 +73,25 @@ calculateEnergyCharge(const PixelID& pixel,
   return energyCharge;
 }
 
+int DeviceSimulation::NumThreadsInMapCalculation() const
+{
+  if (numThreadsInMapCalculation_ > 0) {
+    return numThreadsInMapCalculation_;
+  }
+  const int numHardwareThreads = std::thread::hardware_concurrency();
+  return (numHardwareThreads > 0) ? numHardwareThreads : 1;
+}
+
+std::string DeviceSimulation::ChargeTransportDescription() const
+{
+  return (boost::format("thickness=%.17g upside_anode=%d mutau_e=%.17g mutau_h=%.17g "
+                        "bias=%.17g efield_mode=%d efield_params=%.17g,%.17g,%.17g,%.17g")
+          % getThickness() % isUpSideAnode()
+          % MuTauElectron() % MuTauHole()
+          % BiasVoltage() % static_cast<int>(EFieldMode())
+          % EFieldParam(0) % EFieldParam(1) % EFieldParam(2) % EFieldParam(3)).str();
+}
+
 double DeviceSimulation::DiffusionSigmaAnode(double z)
 {
   // electron diffusion
@@ -0,0 +1,172 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "EventCandidateFinder.hh"
+#include <algorithm>
+#include <limits>
+#include "ParallelFor.hh"
+
+namespace
+{
+
+/* the larger one; a NaN in b is ignored as the comparisons in FrameData do. */
+inline double larger(double a, double b)
+{
+  return (b > a) ? b : a;
+}
+
+} /* anonymous namespace */
+
+namespace comptonsoft
+{
+
+EventCandidateFinder::EventCandidateFinder() = default;
+
+EventCandidateFinder::~EventCandidateFinder() = default;
+
+void EventCandidateFinder::find(const image_t& frame, const flags_t& disabled, const Criteria& criteria)
+{
+  const int nx = frame.shape()[0];
+  const int ny = frame.shape()[1];
+  if (nx != nx_ || ny != ny_) {
+    nx_ = nx;
+    ny_ = ny;
+    bitmap_.assign(static_cast<std::size_t>(nx)*ny, 0);
+  }
+  else {
+    for (const auto& pixel: candidates_) {
+      bitmap_[static_cast<std::size_t>(pixel.first)*ny_+pixel.second] = 0;
+    }
+  }
+  candidates_.clear();
+
+  const int margin = criteria.margin;
+  const int numRows = nx - 2*margin;
+  if (numRows <= 0 || ny - 2*margin <= 0) {
+    return;
+  }
+
+  const int numBands = (numRows+BandSize-1)/BandSize;
+  const int numThreads = std::max(1, std::min(numThreads_, numBands));
+  bandCandidates_.resize(numBands);
+  workspaces_.resize(numThreads);
+
+  parallelFor(0, numBands, numThreads,
+              [&](int band, int threadIndex) {
+                findInBand(frame, disabled, criteria, band, workspaces_[threadIndex]);
+              });
+
+  for (auto& candidates: bandCandidates_) {
+    for (const auto& pixel: candidates) {
+      bitmap_[static_cast<std::size_t>(pixel.first)*ny_+pixel.second] = 1;
+    }
+    candidates_.insert(candidates_.end(), candidates.begin(), candidates.end());
+  }
+}
+
+void EventCandidateFinder::findInBand(const image_t& frame, const flags_t& disabled, const Criteria& criteria,
+                                      const int band, Workspace& workspace)
+{
+  std::vector<std::pair<int, int>>& candidates = bandCandidates_[band];
+  candidates.clear();
+
+  const int h = criteria.maxWindowSize/2;
+  const int hd = criteria.disabledWindowSize/2;
+  const int margin = criteria.margin;
+  const int r0 = margin + band*BandSize;
+  const int r1 = std::min(r0+BandSize, nx_-margin);
+  const int c0 = margin;
+  const int m = ny_ - 2*margin;
+  const double threshold = criteria.threshold;
+  const double lowest = -std::numeric_limits<double>::infinity();
+
+  workspace.rowMax.resize(static_cast<std::size_t>(r1-r0+2*h)*m);
+  workspace.neighborMax.resize(m);
+  workspace.aboveThreshold.resize(m);
+  workspace.disabledNearby.resize(m);
+  double* neighborMax = workspace.neighborMax.data();
+  uint8_t* above = workspace.aboveThreshold.data();
+  uint8_t* disabledNearby = workspace.disabledNearby.data();
+
+  // max filter along the rows, including the center
+  for (int xp=r0-h; xp<r1+h; xp++) {
+    const double* f = &frame[xp][c0];
+    double* out = &workspace.rowMax[static_cast<std::size_t>(xp-(r0-h))*m];
+    std::fill(out, out+m, lowest);
+    for (int dy=-h; dy<=h; dy++) {
+      for (int j=0; j<m; j++) {
+        out[j] = larger(out[j], f[j+dy]);
+      }
+    }
+  }
+
+  for (int x=r0; x<r1; x++) {
+    const double* f = &frame[x][c0];
+
+    int numAbove = 0;
+    if (criteria.inclusiveThreshold) {
+      for (int j=0; j<m; j++) {
+        above[j] = (f[j] >= threshold);
+        numAbove += above[j];
+      }
+    }
+    else {
+      for (int j=0; j<m; j++) {
+        above[j] = (f[j] > threshold);
+        numAbove += above[j];
+      }
+    }
+    if (numAbove == 0) { continue; }
+
+    // maximum of the window except the center: the center row without the
+    // center, and the filtered neighboring rows
+    std::fill(neighborMax, neighborMax+m, lowest);
+    for (int dy=-h; dy<=h; dy++) {
+      if (dy == 0) { continue; }
+      for (int j=0; j<m; j++) {
+        neighborMax[j] = larger(neighborMax[j], f[j+dy]);
+      }
+    }
+    for (int dx=-h; dx<=h; dx++) {
+      if (dx == 0) { continue; }
+      const double* rowMax = &workspace.rowMax[static_cast<std::size_t>(x+dx-(r0-h))*m];
+      for (int j=0; j<m; j++) {
+        neighborMax[j] = larger(neighborMax[j], rowMax[j]);
+      }
+    }
+
+    std::fill(disabledNearby, disabledNearby+m, 0);
+    for (int dx=-hd; dx<=hd; dx++) {
+      for (int dy=-hd; dy<=hd; dy++) {
+        const int* d = &disabled[x+dx][c0+dy];
+        for (int j=0; j<m; j++) {
+          disabledNearby[j] |= (d[j] != 0);
+        }
+      }
+    }
+
+    for (int j=0; j<m; j++) {
+      if (above[j] && f[j] > neighborMax[j] && !disabledNearby[j]) {
+        candidates.emplace_back(x, c0+j);
+      }
+    }
+  }
+}
+
+} /* namespace comptonsoft */
@@ -0,0 +1,130 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "EventReconstructionThreadPool.hh"
+#include "VEventReconstructionAlgorithm.hh"
+
+namespace comptonsoft {
+
+EventReconstructionThreadPool::
+EventReconstructionThreadPool(const VEventReconstructionAlgorithm& prototype,
+                              int numThreads)
+  : nextIndex_(0)
+{
+  if (numThreads < 1) { numThreads = 1; }
+
+  for (int i=0; i<numThreads; i++) {
+    algorithms_.push_back(prototype.clone());
+  }
+
+  for (int i=0; i<numThreads; i++) {
+    workers_.emplace_back(&EventReconstructionThreadPool::run, this, i);
+  }
+}
+
+EventReconstructionThreadPool::~EventReconstructionThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  batchStarted_.notify_all();
+
+  for (auto& worker: workers_) {
+    worker.join();
+  }
+}
+
+void EventReconstructionThreadPool::
+reconstruct(const std::vector<std::vector<DetectorHit_sptr>>& hitsBatch,
+            const std::vector<BasicComptonEvent>& baseEvents,
+            std::vector<std::vector<BasicComptonEvent_sptr>>& eventsReconstructed,
+            std::vector<bool>& results)
+{
+  const std::size_t n = hitsBatch.size();
+  eventsReconstructed.resize(n);
+  for (auto& events: eventsReconstructed) {
+    events.clear();
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    hitsBatch_ = &hitsBatch;
+    baseEvents_ = &baseEvents;
+    eventsReconstructed_ = &eventsReconstructed;
+    results_.assign(n, 0);
+    nextIndex_ = 0;
+    numActiveWorkers_ = workers_.size();
+    ++batchGeneration_;
+  }
+  batchStarted_.notify_all();
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    batchFinished_.wait(lock, [this](){ return numActiveWorkers_ == 0; });
+    hitsBatch_ = nullptr;
+    baseEvents_ = nullptr;
+    eventsReconstructed_ = nullptr;
+  }
+
+  results.assign(results_.begin(), results_.end());
+}
+
+void EventReconstructionThreadPool::run(std::size_t workerIndex)
+{
+  VEventReconstructionAlgorithm& algorithm = *algorithms_[workerIndex];
+  uint64_t generationDone = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      batchStarted_.wait(lock, [this, generationDone](){
+          return stopping_ || batchGeneration_ != generationDone;
+        });
+      if (stopping_) { return; }
+      generationDone = batchGeneration_;
+    }
+
+    processBatch(algorithm);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --numActiveWorkers_;
+      if (numActiveWorkers_ == 0) {
+        batchFinished_.notify_one();
+      }
+    }
+  }
+}
+
+void EventReconstructionThreadPool::processBatch(VEventReconstructionAlgorithm& algorithm)
+{
+  const std::size_t n = hitsBatch_->size();
+  while (true) {
+    const std::size_t index = nextIndex_++;
+    if (index >= n) { break; }
+
+    const bool result = algorithm.reconstruct((*hitsBatch_)[index],
+                                              (*baseEvents_)[index],
+                                              (*eventsReconstructed_)[index]);
+    results_[index] = result ? 1 : 0;
+  }
+}
+
+} /* namespace comptonsoft */
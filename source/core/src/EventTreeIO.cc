@@ -18,8 +18,10 @@
  *************************************************************************/
 
 #include "EventTreeIO.hh"
+#include <algorithm>
 #include "AstroUnits.hh"
 #include "TTree.h"
+#include "TBranch.h"
 #include "DetectorHit.hh"
 
 namespace unit = anlgeant4::unit;
@@ -30,10 +32,19 @@ namespace comptonsoft
 EventTreeIO::EventTreeIO()
   : tree_(nullptr)
 {
+  reserveHits(InitialCapacity);
 }
 
 EventTreeIO::~EventTreeIO() = default;
 
+void EventTreeIO::setTree(TTree* tree)
+{
+  tree_ = tree;
+  branchesBound_ = false;
+  currentTreeNumber_ = -1;
+  numHitsBranch_ = nullptr;
+}
+
 void EventTreeIO::defineBranches()
 {
   tree_->Branch("eventid",        &eventid_,              "eventid/L");
@@ -79,16 +90,27 @@ void EventTreeIO::defineBranches()
   tree_->Branch("local_posz",     local_posz_.data(),     "local_posz[num_hits]/F");
   tree_->Branch("time",           time_.data(),           "time[num_hits]/D");
   tree_->Branch("grade",          &grade_,                "grade/I");
+
+  branchesBound_ = true;
 }
 
 void EventTreeIO::setBranchAddresses()
 {
   tree_->SetBranchAddress("eventid",        &eventid_);
   tree_->SetBranchAddress("num_hits",       &num_hits_);
-
-  // measured data
   tree_->SetBranchAddress("ti",             &ti_);
   tree_->SetBranchAddress("instrument",     &instrument_);
+  tree_->SetBranchAddress("flag_data",      &flag_data_);
+  tree_->SetBranchAddress("flags",          &flags_);
+  tree_->SetBranchAddress("grade",          &grade_);
+  setHitBranchAddresses();
+
+  branchesBound_ = true;
+}
+
+void EventTreeIO::setHitBranchAddresses()
+{
+  // measured data
   tree_->SetBranchAddress("detector",       detector_.data());
   tree_->SetBranchAddress("det_section",    det_section_.data());
   tree_->SetBranchAddress("readout_module", readout_module_.data());
@@ -100,8 +122,6 @@ void EventTreeIO::setBranchAddresses()
   tree_->SetBranchAddress("rawpha",         rawpha_.data());
   tree_->SetBranchAddress("pha",            pha_.data());
   tree_->SetBranchAddress("epi",            epi_.data());
-  tree_->SetBranchAddress("flag_data",      &flag_data_);
-  tree_->SetBranchAddress("flags",          &flags_);
 
   // simulation
   tree_->SetBranchAddress("trackid",        trackid_.data());
@@ -125,7 +145,88 @@ void EventTreeIO::setBranchAddresses()
   tree_->SetBranchAddress("local_posy",     local_posy_.data());
   tree_->SetBranchAddress("local_posz",     local_posz_.data());
   tree_->SetBranchAddress("time",           time_.data());
-  tree_->SetBranchAddress("grade",          &grade_);
+}
+
+void EventTreeIO::reserveHits(std::size_t n)
+{
+  if (n <= capacity_) { return; }
+
+  std::size_t capacity = std::max<std::size_t>(capacity_, 1);
+  while (capacity < n) { capacity *= 2; }
+
+  detector_.resize(capacity);
+  det_section_.resize(capacity);
+  readout_module_.resize(capacity);
+  section_.resize(capacity);
+  channel_.resize(capacity);
+  pixelx_.resize(capacity);
+  pixely_.resize(capacity);
+  pixelz_.resize(capacity);
+  rawpha_.resize(capacity);
+  pha_.resize(capacity);
+  epi_.resize(capacity);
+  trackid_.resize(capacity);
+  particle_.resize(capacity);
+  real_time_.resize(capacity);
+  time_trig_.resize(capacity);
+  time_group_.resize(capacity);
+  real_posx_.resize(capacity);
+  real_posy_.resize(capacity);
+  real_posz_.resize(capacity);
+  edep_.resize(capacity);
+  echarge_.resize(capacity);
+  process_.resize(capacity);
+  energy_.resize(capacity);
+  posx_.resize(capacity);
+  posy_.resize(capacity);
+  posz_.resize(capacity);
+  local_posx_.resize(capacity);
+  local_posy_.resize(capacity);
+  local_posz_.resize(capacity);
+  time_.resize(capacity);
+  capacity_ = capacity;
+
+  // the buffers may have moved.
+  if (branchesBound_) {
+    setHitBranchAddresses();
+  }
+}
+
+int EventTreeIO::getEntry(int64_t entry)
+{
+  // num_hits is read first to size the buffers.
+  const int64_t localEntry = tree_->LoadTree(entry);
+  if (localEntry < 0) { return 0; }
+
+  // A new tree of a chain may be allocated at the address of the deleted one,
+  // so the tree number tells when the branch must be looked up again.
+  const int treeNumber = tree_->GetTreeNumber();
+  if (treeNumber != currentTreeNumber_) {
+    currentTreeNumber_ = treeNumber;
+    numHitsBranch_ = tree_->GetTree()->GetBranch("num_hits");
+  }
+  if (numHitsBranch_ != nullptr) {
+    numHitsBranch_->GetEntry(localEntry);
+    if (num_hits_ > 0) {
+      reserveHits(num_hits_);
+    }
+  }
+
+  return tree_->GetEntry(entry);
+}
+
+void EventTreeIO::readOnlyBranches(const std::vector<std::string>& branches)
+{
+  tree_->SetBranchStatus("*", 0);
+  tree_->SetBranchStatus("num_hits", 1);
+  for (const std::string& name: branches) {
+    tree_->SetBranchStatus(name.c_str(), 1);
+  }
+}
+
+void EventTreeIO::readAllBranches()
+{
+  tree_->SetBranchStatus("*", 1);
 }
 
 void EventTreeIO::fillHits(const int64_t eventID,
@@ -134,6 +235,7 @@ void EventTreeIO::fillHits(const int64_t eventID,
   const int NumHits = hits.size();
   if (NumHits==0) return;
 
+  reserveHits(NumHits);
   num_hits_ = NumHits;
 
   const DetectorHit_sptr& hit = hits[0];
@@ -194,6 +296,11 @@ void EventTreeIO::fillUndetectedEvent(const int64_t eventID)
   tree_->Fill();
 }
 
+double EventTreeIO::getRealTime(std::size_t i) const
+{
+  return real_time_[i] * unit::second;
+}
+
 DetectorHit_sptr EventTreeIO::retrieveHit(std::size_t i) const
 {
   DetectorHit_sptr hit(new DetectorHit);
@@ -231,7 +338,7 @@ std::vector<DetectorHit_sptr> EventTreeIO::retrieveHits(int64_t& entry, bool get
   std::vector<DetectorHit_sptr> hits;
 
   if (get_entry) {
-    tree_->GetEntry(entry);
+    getEntry(entry);
   }
   
   const int numHits = getNumberOfHits();
@@ -0,0 +1,176 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ExternalTimeSorter.hh"
+#include <algorithm>
+#include <iostream>
+#include <boost/filesystem.hpp>
+
+namespace comptonsoft {
+
+namespace {
+
+constexpr std::size_t MinimumBufferSize = 1024;
+
+bool key_less(const ExternalTimeSorter::Key& a, const ExternalTimeSorter::Key& b)
+{
+  if (a.time < b.time) { return true; }
+  if (b.time < a.time) { return false; }
+  return a.entry < b.entry;
+}
+
+/* ordering for std::push_heap(), which puts the earliest key on the top */
+bool heap_later(const std::pair<ExternalTimeSorter::Key, std::size_t>& a,
+                const std::pair<ExternalTimeSorter::Key, std::size_t>& b)
+{
+  return key_less(b.first, a.first);
+}
+
+} /* anonymous namespace */
+
+ExternalTimeSorter::ExternalTimeSorter(std::size_t memoryBudget, const std::string& directory)
+  : chunkSize_(std::max(memoryBudget/sizeof(Key), MinimumBufferSize)),
+    directory_(directory)
+{
+  // growth of the vector would temporarily need twice the budget.
+  chunk_.reserve(chunkSize_);
+}
+
+ExternalTimeSorter::~ExternalTimeSorter()
+{
+  removeRunFiles();
+}
+
+bool ExternalTimeSorter::add(double time, int64_t entry)
+{
+  if (chunk_.size() == chunkSize_) {
+    if (!writeRun()) { return false; }
+  }
+  chunk_.push_back(Key{time, entry});
+  ++numKeys_;
+  return true;
+}
+
+bool ExternalTimeSorter::writeRun()
+{
+  std::sort(chunk_.begin(), chunk_.end(), key_less);
+
+  namespace fs = boost::filesystem;
+  std::unique_ptr<Run> run(new Run);
+  run->filename = (fs::path(directory_) / fs::unique_path("sort_run_%%%%%%%%%%%%.bin")).string();
+
+  std::ofstream fout(run->filename, std::ios::binary);
+  fout.write(reinterpret_cast<const char*>(chunk_.data()), chunk_.size()*sizeof(Key));
+  fout.close();
+  if (!fout) {
+    std::cout << "ExternalTimeSorter: cannot write a run file " << run->filename << std::endl;
+    boost::system::error_code error;
+    fs::remove(run->filename, error);
+    return false;
+  }
+
+  run->numRemaining = chunk_.size();
+  runs_.push_back(std::move(run));
+  chunk_.clear();
+  return true;
+}
+
+bool ExternalTimeSorter::finish()
+{
+  finished_ = true;
+  std::sort(chunk_.begin(), chunk_.end(), key_less);
+  chunkPosition_ = 0;
+  if (runs_.empty()) {
+    return true;
+  }
+
+  if (!chunk_.empty()) {
+    if (!writeRun()) { return false; }
+  }
+  std::vector<Key>().swap(chunk_);
+
+  // the memory budget is divided among the run buffers.
+  const std::size_t bufferSize = std::max(chunkSize_/runs_.size(), MinimumBufferSize);
+  heap_.clear();
+  for (std::size_t i=0; i<runs_.size(); i++) {
+    Run& run = *runs_[i];
+    run.file.open(run.filename, std::ios::binary);
+    run.buffer.resize(bufferSize);
+    if (!refill(run)) { return false; }
+    heap_.emplace_back(run.buffer[0], i);
+    run.position = 1;
+  }
+  std::make_heap(heap_.begin(), heap_.end(), heap_later);
+  return true;
+}
+
+bool ExternalTimeSorter::refill(Run& run)
+{
+  const std::size_t n = std::min(run.buffer.size(), run.numRemaining);
+  if (n == 0) { return false; }
+  run.file.read(reinterpret_cast<char*>(run.buffer.data()), n*sizeof(Key));
+  if (!run.file) {
+    std::cout << "ExternalTimeSorter: cannot read a run file " << run.filename << std::endl;
+    return false;
+  }
+  run.buffer.resize(n);
+  run.position = 0;
+  run.numRemaining -= n;
+  return true;
+}
+
+bool ExternalTimeSorter::next(Key& key)
+{
+  if (!finished_) { return false; }
+
+  if (runs_.empty()) {
+    if (chunkPosition_ == chunk_.size()) { return false; }
+    key = chunk_[chunkPosition_++];
+    return true;
+  }
+
+  if (heap_.empty()) { return false; }
+
+  std::pop_heap(heap_.begin(), heap_.end(), heap_later);
+  key = heap_.back().first;
+  const std::size_t runIndex = heap_.back().second;
+  heap_.pop_back();
+
+  Run& run = *runs_[runIndex];
+  if (run.position < run.buffer.size() || refill(run)) {
+    heap_.emplace_back(run.buffer[run.position++], runIndex);
+    std::push_heap(heap_.begin(), heap_.end(), heap_later);
+  }
+  else {
+    run.file.close();
+    std::vector<Key>().swap(run.buffer);
+  }
+  return true;
+}
+
+void ExternalTimeSorter::removeRunFiles()
+{
+  boost::system::error_code error;
+  for (auto& run: runs_) {
+    run->file.close();
+    boost::filesystem::remove(run->filename, error);
+  }
+}
+
+} /* namespace comptonsoft */
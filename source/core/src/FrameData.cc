@@ -23,11 +23,107 @@
 #include <fstream>
 #include <iostream>
 #include <cstdint>
-#include <list>
+#include <cstring>
 #include <algorithm>
 
 #include "VGainFunction.hh"
 #include "GainFunctionLinear.hh"
+#include "MappedFile.hh"
+
+namespace
+{
+
+/* number of file rows decoded at once when the rows run along x */
+constexpr int RowBlockSize = 8;
+
+using decode_func_t = void (*)(const char* src, int nx, int ny, double* dst, uint16_t* rows);
+
+bool host_is_little_endian()
+{
+  const uint16_t one = 1u;
+  unsigned char first = 0;
+  std::memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+template <bool Swap>
+inline void decode_row(const char* src, const int n, uint16_t* row)
+{
+  std::memcpy(row, src, sizeof(uint16_t)*n);
+  if (Swap) {
+    // written so that the compiler can vectorize it
+    for (int i=0; i<n; i++) {
+      row[i] = static_cast<uint16_t>((row[i]>>8) | (row[i]<<8));
+    }
+  }
+}
+
+/* file rows run along y: each row is a contiguous row of the image. */
+template <bool Swap, bool FlipX, bool FlipY>
+void decode_frame_along_y(const char* src, const int nx, const int ny, double* dst, uint16_t* rows)
+{
+  for (int ix=0; ix<nx; ix++) {
+    const int ixFile = FlipX ? (nx-1-ix) : ix;
+    decode_row<Swap>(src+sizeof(uint16_t)*ixFile*ny, ny, rows);
+    double* out = dst + static_cast<std::size_t>(ix)*ny;
+    if (FlipY) {
+      for (int iy=0; iy<ny; iy++) {
+        out[iy] = rows[ny-1-iy];
+      }
+    }
+    else {
+      for (int iy=0; iy<ny; iy++) {
+        out[iy] = rows[iy];
+      }
+    }
+  }
+}
+
+/* file rows run along x: blocks of rows are decoded and transposed. */
+template <bool Swap, bool FlipX, bool FlipY>
+void decode_frame_along_x(const char* src, const int nx, const int ny, double* dst, uint16_t* rows)
+{
+  for (int iy0=0; iy0<ny; iy0+=RowBlockSize) {
+    const int m = std::min(RowBlockSize, ny-iy0);
+    for (int b=0; b<m; b++) {
+      const int iy = iy0 + b;
+      const int iyFile = FlipY ? (ny-1-iy) : iy;
+      decode_row<Swap>(src+sizeof(uint16_t)*iyFile*nx, nx, rows+b*nx);
+    }
+    for (int ix=0; ix<nx; ix++) {
+      const int ixFile = FlipX ? (nx-1-ix) : ix;
+      double* out = dst + static_cast<std::size_t>(ix)*ny + iy0;
+      for (int b=0; b<m; b++) {
+        out[b] = rows[b*nx+ixFile];
+      }
+    }
+  }
+}
+
+template <bool Swap, bool FlipX, bool FlipY>
+decode_func_t decoder(const bool alongX)
+{
+  if (alongX) {
+    return &decode_frame_along_x<Swap, FlipX, FlipY>;
+  }
+  return &decode_frame_along_y<Swap, FlipX, FlipY>;
+}
+
+decode_func_t select_decoder(const bool alongX, const bool swap, const bool flipX, const bool flipY)
+{
+  if (swap) {
+    if (flipX) {
+      return flipY ? decoder<true, true, true>(alongX) : decoder<true, true, false>(alongX);
+    }
+    return flipY ? decoder<true, false, true>(alongX) : decoder<true, false, false>(alongX);
+  }
+  if (flipX) {
+    return flipY ? decoder<false, true, true>(alongX) : decoder<false, true, false>(alongX);
+  }
+  return flipY ? decoder<false, false, true>(alongX) : decoder<false, false, false>(alongX);
+}
+
+} /* anonymous namespace */
 
 namespace comptonsoft
 {
@@ -36,7 +132,7 @@ FrameData::FrameData(const int nx, const int ny)
   : num_pixels_x_(nx),
     num_pixels_y_(ny),
     startPosition_(CornerID::BottomLeft),
-    rawFrame_(boost::extents[nx][ny]),
+    rawFrame_(nx, ny),
     frame_(boost::extents[nx][ny]),
     pedestals_(boost::extents[nx][ny]),
     weight_(boost::extents[nx][ny]),
@@ -44,7 +140,7 @@ FrameData::FrameData(const int nx, const int ny)
     sum2_(boost::extents[nx][ny]),
     deviation_(boost::extents[nx][ny]),
     disabledPixels_(boost::extents[nx][ny]),
-    pixelValuesToExclude_(boost::extents[nx][ny])
+    pixelValuesToExclude_(static_cast<std::size_t>(nx)*ny)
 {
   for (int ix=0; ix<nx; ix++) {
     for (int iy=0; iy<ny; iy++) {
@@ -52,11 +148,10 @@ FrameData::FrameData(const int nx, const int ny)
       sum2_[ix][iy] = 0.0;
       deviation_[ix][iy] = 0.0;
       disabledPixels_[ix][iy] = 0;
-      pixelValuesToExclude_[ix][iy] = std::make_unique<OutlierStore>();
       addEventCheckPixels(ix, iy);
     }
   }
-  buf_.resize(2*nx*ny);
+  decodeBuffers_.file.resize(2*nx*ny);
 
   commonGainFunction_ = std::make_shared<GainFunctionLinear>(0.0, 1.0);
 }
@@ -65,97 +160,107 @@ FrameData::~FrameData() = default;
 
 void FrameData::setStatisticsExclusionNumbers(int num_low, int num_high)
 {
-  const int nx = NumPixelsX();
-  const int ny = NumPixelsY();
-  for (int ix=0; ix<nx; ix++) {
-    for (int iy=0; iy<ny; iy++) {
-      pixelValuesToExclude_[ix][iy]->set_capacities(num_low, num_high);
-    }
-  }
+  pixelValuesToExclude_.set_capacities(num_low, num_high);
 }
 
 void FrameData::resetRawFrame()
 {
   const int nx = NumPixelsX();
   const int ny = NumPixelsY();
+  image_t& rawFrame = getRawFrame();
   for (int ix=0; ix<nx; ix++) {
     for (int iy=0; iy<ny; iy++) {
-      rawFrame_[ix][iy] = 0.0;
+      rawFrame[ix][iy] = 0.0;
     }
   }
 }
 
 bool FrameData::load(const std::string& filename)
 {
-  std::ifstream infile;
-  const std::size_t length = buf_.size();
+  return readRawFrame(filename, getRawFrame(), decodeBuffers_);
+}
+
+bool FrameData::readRawFrame(const std::string& filename,
+                             image_t& image,
+                             DecodeBuffers& buffers) const
+{
+  const std::size_t length = 2*static_cast<std::size_t>(NumPixelsX())*NumPixelsY();
 
+  MappedFile mappedFile;
+  if (mappedFile.open(filename) && mappedFile.size() >= length) {
+    decodeRawFrame(mappedFile.data(), image, buffers);
+    return true;
+  }
+  mappedFile.close();
+
+  // A short or empty file is read as before; the rest of the buffer is kept.
+  std::ifstream infile;
   infile.open(filename);
   if (!infile) {
     std::cerr << " cannot open file: " << filename << std::endl;
     return false;
   }
 
-  infile.read(&buf_[0], length);
+  buffers.file.resize(length);
+  infile.read(&buffers.file[0], length);
   infile.close();
 
-  const int odd_row_pixel_shift = OddRowPixelShift();
-  const bool regular_pixel_arrangement = (odd_row_pixel_shift == 0);
+  decodeRawFrame(buffers.file.data(), image, buffers);
+  return true;
+}
+
+void FrameData::swapRawFrame(std::unique_ptr<image_t>& image)
+{
+  rawFrame_.image.swap(image);
+}
 
+void FrameData::decodeRawFrame(const char* data, image_t& image, DecodeBuffers& buffers) const
+{
   const int nx = NumPixelsX();
   const int ny = NumPixelsY();
-  for (int ix=0; ix<nx; ix++) {
-    for (int iy=0; iy<ny; iy++) {
-      int t = -1;
-      if (!readDirectionX_) {
-        if (startPosition_==CornerID::BottomLeft)  { t = ix*ny+iy; }
-        if (startPosition_==CornerID::UpperLeft)   { t = ix*ny+(ny-1-iy); }
-        if (startPosition_==CornerID::BottomRight) { t = (nx-1-ix)*ny+iy; }
-        if (startPosition_==CornerID::UpperRight)  { t = (nx-1-ix)*ny+(ny-1-iy); }
-      }
-      else {
-        if (startPosition_==CornerID::BottomLeft)  { t = iy*nx+ix; }
-        if (startPosition_==CornerID::UpperLeft)   { t = (ny-1-iy)*nx+ix; }
-        if (startPosition_==CornerID::BottomRight) { t = iy*nx+(nx-1-ix); }
-        if (startPosition_==CornerID::UpperRight)  { t = (ny-1-iy)*nx+(nx-1-ix); }
-      }
 
-      unsigned int v = 0u;
-      if (ByteOrder()) {
-        v = ((static_cast<uint16_t>(buf_[2*t])&0xff)<<8) + (static_cast<uint16_t>(buf_[2*t+1])&0xff);
-      }
-      else {
-        v = ((static_cast<uint16_t>(buf_[2*t+1])&0xff)<<8) + (static_cast<uint16_t>(buf_[2*t])&0xff);
-      }
+  const bool flipX = (startPosition_==CornerID::BottomRight || startPosition_==CornerID::UpperRight);
+  const bool flipY = (startPosition_==CornerID::UpperLeft || startPosition_==CornerID::UpperRight);
+  // ByteOrder() is true for big endian data.
+  const bool swap = (ByteOrder() == host_is_little_endian());
+  const decode_func_t decode = select_decoder(readDirectionX_, swap, flipX, flipY);
 
-      if (regular_pixel_arrangement) {
-        rawFrame_[ix][iy] = v;
-      }
-      else {
-        const int pixel_shift = (iy%2==0) ? 0 : odd_row_pixel_shift;
-        const int ix_shifted = ix + pixel_shift;
-        if (0<=ix_shifted && ix_shifted<ny) {
-          rawFrame_[ix_shifted][iy] = v;
-        }
+  buffers.rows.resize(RowBlockSize*std::max(nx, ny));
+
+  const int odd_row_pixel_shift = OddRowPixelShift();
+  const bool regular_pixel_arrangement = (odd_row_pixel_shift == 0);
+  if (regular_pixel_arrangement) {
+    decode(data, nx, ny, image.origin(), buffers.rows.data());
+    return;
+  }
+
+  buffers.unshifted.resize(static_cast<std::size_t>(nx)*ny);
+  decode(data, nx, ny, buffers.unshifted.data(), buffers.rows.data());
+  for (int ix=0; ix<nx; ix++) {
+    for (int iy=0; iy<ny; iy++) {
+      const int pixel_shift = (iy%2==0) ? 0 : odd_row_pixel_shift;
+      const int ix_shifted = ix + pixel_shift;
+      if (0<=ix_shifted && ix_shifted<ny && ix_shifted<nx) {
+        image[ix_shifted][iy] = buffers.unshifted[static_cast<std::size_t>(ix)*ny+iy];
       }
     }
   }
-  return true;
 }
 
 void FrameData::stack()
 {
-  const int nx = NumPixelsX();
-  const int ny = NumPixelsY();
-  for (int ix=0; ix<nx; ix++) {
-    for (int iy=0; iy<ny; iy++) {
-      const double v = rawFrame_[ix][iy];
-      weight_[ix][iy] += 1.0;
-      sum_[ix][iy] += v;
-      sum2_[ix][iy] += v*v;
-      pixelValuesToExclude_[ix][iy]->propose(v);
-    }
+  const image_t& rawFrame = getRawFrame();
+  const std::size_t n = rawFrame.num_elements();
+  const double* v = rawFrame.origin();
+  double* weight = weight_.origin();
+  double* sum = sum_.origin();
+  double* sum2 = sum2_.origin();
+  for (std::size_t i=0; i<n; i++) {
+    weight[i] += 1.0;
+    sum[i] += v[i];
+    sum2[i] += v[i]*v[i];
   }
+  pixelValuesToExclude_.propose(v);
 }
 
 void FrameData::setPedestals(const double v)
@@ -171,17 +276,24 @@ void FrameData::setPedestals(const double v)
 
 void FrameData::calculateStatistics()
 {
-  const int nx = NumPixelsX();
-  const int ny = NumPixelsY();
-  for (int ix=0; ix<nx; ix++) {
-    for (int iy=0; iy<ny; iy++) {
-      const double w = weight_[ix][iy] - pixelValuesToExclude_[ix][iy]->num();
-      const double sum = sum_[ix][iy] - pixelValuesToExclude_[ix][iy]->sum();
-      const double sum2 = sum2_[ix][iy] - pixelValuesToExclude_[ix][iy]->sum2();
-      if (w != 0.0) {
-        pedestals_[ix][iy] = sum/w;
-        deviation_[ix][iy] = sqrt(sum2/w - (sum*sum)/(w*w));
-      }
+  const std::size_t n = weight_.num_elements();
+  std::vector<double> excludedSum(n);
+  std::vector<double> excludedSum2(n);
+  pixelValuesToExclude_.sums(excludedSum.data(), excludedSum2.data());
+  const double excludedNum = pixelValuesToExclude_.num();
+
+  const double* weight = weight_.origin();
+  const double* sum = sum_.origin();
+  const double* sum2 = sum2_.origin();
+  double* pedestals = pedestals_.origin();
+  double* deviation = deviation_.origin();
+  for (std::size_t i=0; i<n; i++) {
+    const double w = weight[i] - excludedNum;
+    const double s = sum[i] - excludedSum[i];
+    const double s2 = sum2[i] - excludedSum2[i];
+    if (w != 0.0) {
+      pedestals[i] = s/w;
+      deviation[i] = sqrt(s2/w - (s*s)/(w*w));
     }
   }
 }
@@ -190,9 +302,10 @@ void FrameData::subtractPedestals()
 {
   const int nx = NumPixelsX();
   const int ny = NumPixelsY();
+  const image_t& rawFrame = getRawFrame();
   for (int ix=0; ix<nx; ix++) {
     for (int iy=0; iy<ny; iy++) {
-      frame_[ix][iy] = rawFrame_[ix][iy] - pedestals_[ix][iy];
+      frame_[ix][iy] = rawFrame[ix][iy] - pedestals_[ix][iy];
     }
   }
 }
@@ -217,29 +330,20 @@ std::vector<XrayEvent_sptr> FrameData::extractEvents()
     return events;
   }
 
-  const int nx = NumPixelsX();
-  const int ny = NumPixelsY();
   const int size = EventSize();
-  const int margin = size/2+TrimSize();
-
-  std::list<std::pair<int, int>> hitPixels;
-  for (std::size_t i=0; i<eventCheckPixels_.size(); i++){
-    const int ix = eventCheckPixels_[i].first;
-    const int iy = eventCheckPixels_[i].second;
-    const double v = frame_[ix][iy];
-    if (ix>=margin && ix<nx-margin && iy>=margin && iy<ny-margin) {
-      if (isNotDisabledPixel(ix, iy) && v>=EventThreshold()) {
-        if (isMaxPixel(ix, iy, size) && !(includeDisabledPixel(ix, iy, size))) {
-          hitPixels.emplace_back(ix, iy);
-        }
-      }
-    }
-  }
-  
+  EventCandidateFinder::Criteria criteria;
+  criteria.threshold = EventThreshold();
+  criteria.inclusiveThreshold = true;
+  criteria.maxWindowSize = size;
+  criteria.disabledWindowSize = size;
+  criteria.margin = size/2+TrimSize();
+  const std::vector<std::pair<int, int>>& hitPixels = findEventCandidates(criteria);
+
+  events.reserve(hitPixels.size());
   for (const auto& pixel: hitPixels) {
     const int ix = pixel.first;
     const int iy = pixel.second;
-    XrayEvent_sptr event(new XrayEvent(size));
+    XrayEvent_sptr event = std::make_shared<XrayEvent>(size);
     event->setSplitThreshold(SplitThreshold());
     event->copyFrom(frame_, ix, iy);
     event->reduce();
@@ -249,6 +353,27 @@ std::vector<XrayEvent_sptr> FrameData::extractEvents()
   return events;
 }
 
+const std::vector<std::pair<int, int>>&
+FrameData::findEventCandidates(const EventCandidateFinder::Criteria& criteria)
+{
+  candidateFinder_.find(frame_, disabledPixels_, criteria);
+
+  // The candidates are picked up in the order of eventCheckPixels_.
+  const int nx = NumPixelsX();
+  const int ny = NumPixelsY();
+  const int margin = criteria.margin;
+  hitPixels_.clear();
+  for (const auto& pixel: eventCheckPixels_) {
+    const int ix = pixel.first;
+    const int iy = pixel.second;
+    if (ix>=margin && ix<nx-margin && iy>=margin && iy<ny-margin
+        && candidateFinder_.isCandidate(ix, iy)) {
+      hitPixels_.push_back(pixel);
+    }
+  }
+  return hitPixels_;
+}
+
 bool FrameData::isMaxPixel(int ix, int iy, int size) const
 {
   const int halfSize = size/2;
@@ -309,11 +434,12 @@ double FrameData::RawFrameMedian() const
 {
   const int nx = NumPixelsX();
   const int ny = NumPixelsY();
+  const image_t& rawFrame = getRawFrame();
   std::vector<double> v;
   for (int ix=0; ix<nx; ix++) {
     for (int iy=0; iy<ny; iy++) {
       if (isNotDisabledPixel(ix, iy)) {
-        v.push_back(rawFrame_[ix][iy]);
+        v.push_back(rawFrame[ix][iy]);
       }
     }
   }
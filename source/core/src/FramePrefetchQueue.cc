@@ -0,0 +1,119 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "FramePrefetchQueue.hh"
+#include <algorithm>
+#include <iostream>
+#include <exception>
+#include "CSException.hh"
+
+namespace comptonsoft {
+
+FramePrefetchQueue::FramePrefetchQueue(std::size_t capacity, const image_t& image)
+  : slots_(std::max<std::size_t>(capacity, 1))
+{
+  for (Slot& slot: slots_) {
+    slot.image.reset(new image_t(image));
+  }
+  worker_ = std::thread(&FramePrefetchQueue::run, this);
+}
+
+FramePrefetchQueue::~FramePrefetchQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  pushed_.notify_all();
+  worker_.join();
+}
+
+std::size_t FramePrefetchQueue::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numPushed_ - numPopped_;
+}
+
+void FramePrefetchQueue::push(reader_t reader)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (numPushed_ - numPopped_ == slots_.size()) {
+      throw CSException("FramePrefetchQueue::push(): queue is full");
+    }
+    Slot& slot = slots_[numPushed_ % slots_.size()];
+    slot.reader = std::move(reader);
+    ++numPushed_;
+  }
+  pushed_.notify_one();
+}
+
+bool FramePrefetchQueue::pop(std::unique_ptr<image_t>& image)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (numPopped_ == numPushed_) {
+    throw CSException("FramePrefetchQueue::pop(): queue is empty");
+  }
+  completed_.wait(lock, [this](){ return numCompleted_ > numPopped_; });
+
+  Slot& slot = slots_[numPopped_ % slots_.size()];
+  slot.image.swap(image);
+  slot.reader = nullptr;
+  ++numPopped_;
+  if (!slot.error.empty()) {
+    std::cout << "FramePrefetchQueue: the frame reader failed: " << slot.error << std::endl;
+    slot.error.clear();
+  }
+  return slot.status;
+}
+
+void FramePrefetchQueue::run()
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pushed_.wait(lock, [this](){ return stopping_ || numCompleted_ < numPushed_; });
+    if (stopping_) { return; }
+
+    // The slot being read is never touched by pop() since it is not completed yet.
+    Slot& slot = slots_[numCompleted_ % slots_.size()];
+    lock.unlock();
+
+    // an exception must not escape the thread, which would terminate the program.
+    bool status = false;
+    std::string error;
+    try {
+      status = slot.reader(*slot.image);
+    }
+    catch (const std::exception& ex) {
+      error = ex.what();
+    }
+    catch (...) {
+      error = "unknown exception";
+    }
+
+    lock.lock();
+    slot.status = status;
+    slot.error = std::move(error);
+    ++numCompleted_;
+    lock.unlock();
+    completed_.notify_one();
+  }
+}
+
+} /* namespace comptonsoft */
@@ -155,40 +155,8 @@ reconstructFullDepositEvent(const std::vector<DetectorHit_sptr>& hits,
                             const BasicComptonEvent& baseEvent,
                             std::vector<BasicComptonEvent_sptr>& eventsReconstructed)
 {
-  bool result = false;
-
-  std::vector<int> scattering_order(num_hits_);
-  for (int i_hit = 0; i_hit < num_hits_; ++i_hit){
-    scattering_order[i_hit] = i_hit;
-  }
-
-  int reconstructedOrder = 0;
-  do {
-    auto eventReconstructed = std::make_shared<BasicComptonEvent>(baseEvent);
-
-    std::vector<DetectorHit_sptr> ordered_hits(num_hits_);
-    for (int i_hit = 0; i_hit < num_hits_; ++i_hit){
-      ordered_hits[i_hit] = hits[ scattering_order[i_hit] ];
-    }
-
-    bool this_result;
-    if (assume_initial_gammaray_energy){
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, known_initial_gammaray_energy);
-    }
-    else{
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, total_energy_deposits_);
-    }
-
-    if (this_result) {
-      eventReconstructed->setReconstructedOrder(reconstructedOrder);
-      eventsReconstructed.push_back(eventReconstructed);
-      result = this_result;
-    }
-    
-    ++reconstructedOrder;
-  } while (std::next_permutation(scattering_order.begin(), scattering_order.end()));
-
-  return result;
+  const double incident_energy = assume_initial_gammaray_energy ? known_initial_gammaray_energy : total_energy_deposits_;
+  return reconstructWithFixedIncidentEnergy(hits, baseEvent, incident_energy, false, eventsReconstructed);
 }
 
 bool HY2020EventReconstructionAlgorithm::
@@ -196,6 +164,10 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
                        const BasicComptonEvent& baseEvent,
                        std::vector<BasicComptonEvent_sptr>& eventsReconstructed)
 {
+  if (assume_initial_gammaray_energy) {
+    return reconstructWithFixedIncidentEnergy(hits, baseEvent, known_initial_gammaray_energy, true, eventsReconstructed);
+  }
+
   bool result = false;
 
   std::vector<int> scattering_order(num_hits_);
@@ -213,24 +185,19 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
     }
     
     bool this_result;
-    if (assume_initial_gammaray_energy){
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, known_initial_gammaray_energy, true);
+    double escaped_energy = 0.0;
+    if (use_averaged_escaped_energy) {
+      this_result = estimateAveragedEscapedEnergy(ordered_hits, escaped_energy);
+    } else {
+      this_result = estimateEscapedEnergy(ordered_hits, escaped_energy);
     }
-    else{
-      double escaped_energy = 0.0;
-      if (use_averaged_escaped_energy) {
-        this_result = estimateAveragedEscapedEnergy(ordered_hits, escaped_energy);
-      } else {
-        this_result = estimateEscapedEnergy(ordered_hits, escaped_energy);
-      }
-      if (!this_result) { 
-        ++reconstructedOrder;
-        continue; 
-      }
-      const double corrected_total_energy = total_energy_deposits_ + escaped_energy;
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, corrected_total_energy, true);
+    if (!this_result) { 
+      ++reconstructedOrder;
+      continue; 
     }
-   
+    const double corrected_total_energy = total_energy_deposits_ + escaped_energy;
+    this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, corrected_total_energy, true);
+
     if (this_result) {
       eventReconstructed->setReconstructedOrder(reconstructedOrder);
       eventsReconstructed.push_back(eventReconstructed);
@@ -243,6 +210,11 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
   return result;
 }
 
+double HY2020EventReconstructionAlgorithm::energyMarginForScatteringAngle(double energy)
+{
+  return sigma_level_energy_margin_for_checkScatteringAngle_ * getEnergyResolution(energy);
+}
+
 bool HY2020EventReconstructionAlgorithm::
 reconstructOrderedHits(const std::vector<DetectorHit_sptr>& ordered_hits,
                        BasicComptonEvent& eventReconstructed,
@@ -0,0 +1,467 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "HitColumnStore.hh"
+#include <iostream>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include "AstroUnits.hh"
+#include "DetectorHit.hh"
+
+namespace unit = anlgeant4::unit;
+
+namespace comptonsoft {
+
+namespace {
+
+struct ColumnDefinition
+{
+  const char* name;
+  ColumnType type;
+};
+
+enum EventColumnIndex {
+  EventOffsets, EventIDs,
+  IniEnergy, IniDirX, IniDirY, IniDirZ, IniTime, IniPosX, IniPosY, IniPosZ,
+  IniPolarX, IniPolarY, IniPolarZ, EventWeight,
+  NumEventColumns
+};
+
+constexpr int NumBasicEventColumns = IniEnergy;
+
+const ColumnDefinition EventColumns[NumEventColumns] = {
+  {"event_offsets", ColumnType::UInt64},
+  {"eventid",       ColumnType::Int64},
+  {"ini_energy",    ColumnType::Float32},
+  {"ini_dirx",      ColumnType::Float32},
+  {"ini_diry",      ColumnType::Float32},
+  {"ini_dirz",      ColumnType::Float32},
+  {"ini_time",      ColumnType::Float64},
+  {"ini_posx",      ColumnType::Float32},
+  {"ini_posy",      ColumnType::Float32},
+  {"ini_posz",      ColumnType::Float32},
+  {"ini_polarx",    ColumnType::Float32},
+  {"ini_polary",    ColumnType::Float32},
+  {"ini_polarz",    ColumnType::Float32},
+  {"weight",        ColumnType::Float32},
+};
+
+enum HitColumnIndex {
+  TI, Instrument, Detector, DetSection, ReadoutModule, Section, Channel,
+  PixelX, PixelY, PixelZ, RawPHA, PHA, EPI, EPIError, FlagData, Flags,
+  TrackID, Particle, RealTime, TimeTrig, TimeGroup, RealPosX, RealPosY, RealPosZ,
+  Edep, Echarge, Process,
+  Energy, EnergyError, PosX, PosY, PosZ, PosXError, PosYError, PosZError,
+  LocalPosX, LocalPosY, LocalPosZ, LocalPosXError, LocalPosYError, LocalPosZError,
+  Time, TimeError, Grade,
+  NumHitColumns
+};
+
+const ColumnDefinition HitColumns[NumHitColumns] = {
+  {"ti",               ColumnType::Int64},
+  {"instrument",       ColumnType::Int16},
+  {"detector",         ColumnType::Int16},
+  {"det_section",      ColumnType::Int16},
+  {"readout_module",   ColumnType::Int16},
+  {"section",          ColumnType::Int16},
+  {"channel",          ColumnType::Int16},
+  {"pixelx",           ColumnType::Int16},
+  {"pixely",           ColumnType::Int16},
+  {"pixelz",           ColumnType::Int16},
+  {"rawpha",           ColumnType::Int32},
+  {"pha",              ColumnType::Float32},
+  {"epi",              ColumnType::Float32},
+  {"epi_error",        ColumnType::Float32},
+  {"flag_data",        ColumnType::UInt64},
+  {"flags",            ColumnType::UInt64},
+  {"trackid",          ColumnType::Int32},
+  {"particle",         ColumnType::Int32},
+  {"real_time",        ColumnType::Float64},
+  {"time_trig",        ColumnType::Float64},
+  {"time_group",       ColumnType::Int16},
+  {"real_posx",        ColumnType::Float32},
+  {"real_posy",        ColumnType::Float32},
+  {"real_posz",        ColumnType::Float32},
+  {"edep",             ColumnType::Float32},
+  {"echarge",          ColumnType::Float32},
+  {"process",          ColumnType::UInt32},
+  {"energy",           ColumnType::Float32},
+  {"energy_error",     ColumnType::Float32},
+  {"posx",             ColumnType::Float32},
+  {"posy",             ColumnType::Float32},
+  {"posz",             ColumnType::Float32},
+  {"posx_error",       ColumnType::Float32},
+  {"posy_error",       ColumnType::Float32},
+  {"posz_error",       ColumnType::Float32},
+  {"local_posx",       ColumnType::Float32},
+  {"local_posy",       ColumnType::Float32},
+  {"local_posz",       ColumnType::Float32},
+  {"local_posx_error", ColumnType::Float32},
+  {"local_posy_error", ColumnType::Float32},
+  {"local_posz_error", ColumnType::Float32},
+  {"time",             ColumnType::Float64},
+  {"time_error",       ColumnType::Float64},
+  {"grade",            ColumnType::Int32},
+};
+
+std::string column_filename(const std::string& directory, const char* name)
+{
+  return (boost::filesystem::path(directory) / (std::string(name)+".col")).string();
+}
+
+} /* anonymous namespace */
+
+HitColumnStoreWriter::HitColumnStoreWriter() = default;
+
+HitColumnStoreWriter::~HitColumnStoreWriter()
+{
+  close();
+}
+
+bool HitColumnStoreWriter::open(const std::string& directory, bool initialInfo, bool compression)
+{
+  close();
+
+  boost::system::error_code error;
+  boost::filesystem::create_directories(directory, error);
+  if (error) {
+    std::cout << "HitColumnStoreWriter: cannot create " << directory << std::endl;
+    return false;
+  }
+
+  const ColumnEncoding encoding = compression ? ColumnEncoding::DeltaVarint : ColumnEncoding::Raw;
+  initialInfo_ = initialInfo;
+  numEvents_ = 0;
+  numHits_ = 0;
+
+  const int numEventColumns = initialInfo_ ? NumEventColumns : NumBasicEventColumns;
+
+  // The reader detects the initial information by its columns, so the ones
+  // left by a previous store in the same directory must not survive.
+  for (int i=numEventColumns; i<NumEventColumns; i++) {
+    boost::filesystem::remove(column_filename(directory, EventColumns[i].name), error);
+    if (error) {
+      std::cout << "HitColumnStoreWriter: cannot remove " << EventColumns[i].name << " in " << directory << std::endl;
+      return false;
+    }
+  }
+
+  for (int i=0; i<numEventColumns; i++) {
+    eventColumns_.emplace_back(new ColumnWriter);
+    if (!eventColumns_.back()->open(column_filename(directory, EventColumns[i].name), EventColumns[i].type, encoding)) {
+      return false;
+    }
+  }
+  for (int i=0; i<NumHitColumns; i++) {
+    hitColumns_.emplace_back(new ColumnWriter);
+    if (!hitColumns_.back()->open(column_filename(directory, HitColumns[i].name), HitColumns[i].type, encoding)) {
+      return false;
+    }
+  }
+
+  eventColumns_[EventOffsets]->append<uint64_t>(0);
+  return true;
+}
+
+bool HitColumnStoreWriter::close()
+{
+  bool status = true;
+  for (auto& column: eventColumns_) {
+    if (column->isOpen() && !column->close()) { status = false; }
+  }
+  for (auto& column: hitColumns_) {
+    if (column->isOpen() && !column->close()) { status = false; }
+  }
+  eventColumns_.clear();
+  hitColumns_.clear();
+  return status;
+}
+
+void HitColumnStoreWriter::setInitialInfo(double energy,
+                                          const vector3_t& direction,
+                                          double time,
+                                          const vector3_t& position,
+                                          const vector3_t& polarization)
+{
+  iniEnergy_ = energy;
+  iniDirection_ = direction;
+  iniTime_ = time;
+  iniPosition_ = position;
+  iniPolarization_ = polarization;
+}
+
+void HitColumnStoreWriter::fillHits(int64_t eventID, const std::vector<DetectorHit_sptr>& hits)
+{
+  if (eventID < 0) {
+    eventID = hits.empty() ? 0 : hits[0]->EventID();
+  }
+
+  for (const DetectorHit_sptr& hit: hits) {
+    auto& c = hitColumns_;
+    c[TI]->append<int64_t>(hit->TI());
+    c[Instrument]->append<int16_t>(hit->InstrumentID());
+    c[Detector]->append<int16_t>(hit->DetectorID());
+    c[DetSection]->append<int16_t>(hit->DetectorSection());
+    c[ReadoutModule]->append<int16_t>(hit->ReadoutModuleID());
+    c[Section]->append<int16_t>(hit->ReadoutSection());
+    c[Channel]->append<int16_t>(hit->ReadoutChannel());
+    c[PixelX]->append<int16_t>(hit->VoxelX());
+    c[PixelY]->append<int16_t>(hit->VoxelY());
+    c[PixelZ]->append<int16_t>(hit->VoxelZ());
+    c[RawPHA]->append<int32_t>(hit->RawPHA());
+    c[PHA]->append<float>(hit->PHA());
+    c[EPI]->append<float>(hit->EPI() / unit::keV);
+    c[EPIError]->append<float>(hit->EPIError() / unit::keV);
+    c[FlagData]->append<uint64_t>(hit->FlagData());
+    c[Flags]->append<uint64_t>(hit->Flags());
+    c[TrackID]->append<int32_t>(hit->TrackID());
+    c[Particle]->append<int32_t>(hit->Particle());
+    c[RealTime]->append<double>(hit->RealTime() / unit::second);
+    c[TimeTrig]->append<double>(hit->TriggeredTime() / unit::second);
+    c[TimeGroup]->append<int16_t>(hit->TimeGroup());
+    c[RealPosX]->append<float>(hit->RealPositionX() / unit::cm);
+    c[RealPosY]->append<float>(hit->RealPositionY() / unit::cm);
+    c[RealPosZ]->append<float>(hit->RealPositionZ() / unit::cm);
+    c[Edep]->append<float>(hit->EnergyDeposit() / unit::keV);
+    c[Echarge]->append<float>(hit->EnergyCharge() / unit::keV);
+    c[Process]->append<uint32_t>(hit->Process());
+    c[Energy]->append<float>(hit->Energy() / unit::keV);
+    c[EnergyError]->append<float>(hit->EnergyError() / unit::keV);
+    c[PosX]->append<float>(hit->PositionX() / unit::cm);
+    c[PosY]->append<float>(hit->PositionY() / unit::cm);
+    c[PosZ]->append<float>(hit->PositionZ() / unit::cm);
+    c[PosXError]->append<float>(hit->PositionErrorX() / unit::cm);
+    c[PosYError]->append<float>(hit->PositionErrorY() / unit::cm);
+    c[PosZError]->append<float>(hit->PositionErrorZ() / unit::cm);
+    c[LocalPosX]->append<float>(hit->LocalPositionX() / unit::cm);
+    c[LocalPosY]->append<float>(hit->LocalPositionY() / unit::cm);
+    c[LocalPosZ]->append<float>(hit->LocalPositionZ() / unit::cm);
+    c[LocalPosXError]->append<float>(hit->LocalPositionErrorX() / unit::cm);
+    c[LocalPosYError]->append<float>(hit->LocalPositionErrorY() / unit::cm);
+    c[LocalPosZError]->append<float>(hit->LocalPositionErrorZ() / unit::cm);
+    c[Time]->append<double>(hit->Time() / unit::second);
+    c[TimeError]->append<double>(hit->TimeError() / unit::second);
+    c[Grade]->append<int32_t>(hit->Grade());
+  }
+  numHits_ += hits.size();
+
+  auto& c = eventColumns_;
+  c[EventIDs]->append<int64_t>(eventID);
+  c[EventOffsets]->append<uint64_t>(numHits_);
+  if (initialInfo_) {
+    c[IniEnergy]->append<float>(iniEnergy_ / unit::keV);
+    c[IniDirX]->append<float>(iniDirection_.x());
+    c[IniDirY]->append<float>(iniDirection_.y());
+    c[IniDirZ]->append<float>(iniDirection_.z());
+    c[IniTime]->append<double>(iniTime_ / unit::second);
+    c[IniPosX]->append<float>(iniPosition_.x() / unit::cm);
+    c[IniPosY]->append<float>(iniPosition_.y() / unit::cm);
+    c[IniPosZ]->append<float>(iniPosition_.z() / unit::cm);
+    c[IniPolarX]->append<float>(iniPolarization_.x());
+    c[IniPolarY]->append<float>(iniPolarization_.y());
+    c[IniPolarZ]->append<float>(iniPolarization_.z());
+    c[EventWeight]->append<float>(weight_);
+  }
+  ++numEvents_;
+}
+
+HitColumnStoreReader::HitColumnStoreReader() = default;
+
+HitColumnStoreReader::~HitColumnStoreReader() = default;
+
+bool HitColumnStoreReader::open(const std::string& directory)
+{
+  close();
+
+  initialInfo_ = boost::filesystem::exists(column_filename(directory, EventColumns[IniEnergy].name));
+  const int numEventColumns = initialInfo_ ? NumEventColumns : NumBasicEventColumns;
+  for (int i=0; i<numEventColumns; i++) {
+    eventColumns_.emplace_back(new ColumnReader);
+    ColumnReader& column = *eventColumns_.back();
+    if (!column.open(column_filename(directory, EventColumns[i].name)) || column.Type() != EventColumns[i].type) {
+      std::cout << "HitColumnStoreReader: invalid column " << EventColumns[i].name << std::endl;
+      close();
+      return false;
+    }
+  }
+
+  offsets_ = eventColumns_[EventOffsets]->span<uint64_t>();
+  eventIDs_ = eventColumns_[EventIDs]->span<int64_t>();
+  if (offsets_.size() != eventIDs_.size()+1) {
+    std::cout << "HitColumnStoreReader: inconsistent event columns in " << directory << std::endl;
+    close();
+    return false;
+  }
+
+  // hits are read with the offsets, which must be non-decreasing from zero.
+  if (offsets_[0] != 0
+      || !std::is_sorted(offsets_.begin(), offsets_.end())) {
+    std::cout << "HitColumnStoreReader: invalid event offsets in " << directory << std::endl;
+    close();
+    return false;
+  }
+
+  for (int i=0; i<numEventColumns; i++) {
+    if (i != EventOffsets && eventColumns_[i]->NumberOfRecords() != eventIDs_.size()) {
+      std::cout << "HitColumnStoreReader: inconsistent column " << EventColumns[i].name << std::endl;
+      close();
+      return false;
+    }
+  }
+
+  const uint64_t numHits = NumberOfHits();
+  for (int i=0; i<NumHitColumns; i++) {
+    hitColumns_.emplace_back(new ColumnReader);
+    ColumnReader& column = *hitColumns_.back();
+    if (!column.open(column_filename(directory, HitColumns[i].name))
+        || column.Type() != HitColumns[i].type
+        || column.NumberOfRecords() != numHits) {
+      std::cout << "HitColumnStoreReader: invalid column " << HitColumns[i].name << std::endl;
+      close();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void HitColumnStoreReader::close()
+{
+  eventIDs_ = ColumnSpan<int64_t>();
+  offsets_ = ColumnSpan<uint64_t>();
+  eventColumns_.clear();
+  hitColumns_.clear();
+  initialInfo_ = false;
+}
+
+const ColumnReader* HitColumnStoreReader::findColumn(const std::string& name) const
+{
+  for (std::size_t i=0; i<eventColumns_.size(); i++) {
+    if (name == EventColumns[i].name) { return eventColumns_[i].get(); }
+  }
+  for (std::size_t i=0; i<hitColumns_.size(); i++) {
+    if (name == HitColumns[i].name) { return hitColumns_[i].get(); }
+  }
+  return nullptr;
+}
+
+std::vector<DetectorHit_sptr> HitColumnStoreReader::retrieveHits(std::size_t event) const
+{
+  const int64_t eventID = EventID(event);
+  const std::size_t first = FirstHit(event);
+  const std::size_t n = NumberOfHits(event);
+
+  std::vector<DetectorHit_sptr> hits;
+  hits.reserve(n);
+  for (std::size_t i=first; i<first+n; i++) {
+    hits.push_back(retrieveHit(eventID, i));
+  }
+  return hits;
+}
+
+DetectorHit_sptr HitColumnStoreReader::retrieveHit(int64_t eventID, std::size_t i) const
+{
+  const auto& c = hitColumns_;
+  const int16_t channel = value<int16_t>(c, Channel, i);
+
+  DetectorHit_sptr hit(new DetectorHit);
+  hit->setEventID(eventID);
+  hit->setTI(value<int64_t>(c, TI, i));
+  hit->setInstrumentID(value<int16_t>(c, Instrument, i));
+  hit->setDetectorChannelID(value<int16_t>(c, Detector, i), value<int16_t>(c, DetSection, i), channel);
+  hit->setReadoutChannelID(value<int16_t>(c, ReadoutModule, i), value<int16_t>(c, Section, i), channel);
+  hit->setVoxel(value<int16_t>(c, PixelX, i), value<int16_t>(c, PixelY, i), value<int16_t>(c, PixelZ, i));
+  hit->setRawPHA(value<int32_t>(c, RawPHA, i));
+  hit->setPHA(value<float>(c, PHA, i));
+  hit->setEPI(value<float>(c, EPI, i) * unit::keV);
+  hit->setEPIError(value<float>(c, EPIError, i) * unit::keV);
+  hit->setFlagData(value<uint64_t>(c, FlagData, i));
+  hit->setFlags(value<uint64_t>(c, Flags, i));
+  hit->setTrackID(value<int32_t>(c, TrackID, i));
+  hit->setParticle(value<int32_t>(c, Particle, i));
+  hit->setRealTime(value<double>(c, RealTime, i) * unit::second);
+  hit->setTriggeredTime(value<double>(c, TimeTrig, i) * unit::second);
+  hit->setTimeGroup(value<int16_t>(c, TimeGroup, i));
+  hit->setRealPosition(value<float>(c, RealPosX, i) * unit::cm,
+                       value<float>(c, RealPosY, i) * unit::cm,
+                       value<float>(c, RealPosZ, i) * unit::cm);
+  hit->setEnergyDeposit(value<float>(c, Edep, i) * unit::keV);
+  hit->setEnergyCharge(value<float>(c, Echarge, i) * unit::keV);
+  hit->setProcess(value<uint32_t>(c, Process, i));
+  hit->setEnergy(value<float>(c, Energy, i) * unit::keV);
+  hit->setEnergyError(value<float>(c, EnergyError, i) * unit::keV);
+  hit->setPosition(value<float>(c, PosX, i) * unit::cm,
+                   value<float>(c, PosY, i) * unit::cm,
+                   value<float>(c, PosZ, i) * unit::cm);
+  hit->setPositionError(value<float>(c, PosXError, i) * unit::cm,
+                        value<float>(c, PosYError, i) * unit::cm,
+                        value<float>(c, PosZError, i) * unit::cm);
+  hit->setLocalPosition(value<float>(c, LocalPosX, i) * unit::cm,
+                        value<float>(c, LocalPosY, i) * unit::cm,
+                        value<float>(c, LocalPosZ, i) * unit::cm);
+  hit->setLocalPositionError(value<float>(c, LocalPosXError, i) * unit::cm,
+                             value<float>(c, LocalPosYError, i) * unit::cm,
+                             value<float>(c, LocalPosZError, i) * unit::cm);
+  hit->setTime(value<double>(c, Time, i) * unit::second);
+  hit->setTimeError(value<double>(c, TimeError, i) * unit::second);
+  hit->setGrade(value<int32_t>(c, Grade, i));
+
+  return hit;
+}
+
+double HitColumnStoreReader::InitialEnergy(std::size_t event) const
+{
+  return value<float>(eventColumns_, IniEnergy, event) * unit::keV;
+}
+
+vector3_t HitColumnStoreReader::InitialDirection(std::size_t event) const
+{
+  const auto& c = eventColumns_;
+  return vector3_t(value<float>(c, IniDirX, event),
+                   value<float>(c, IniDirY, event),
+                   value<float>(c, IniDirZ, event));
+}
+
+double HitColumnStoreReader::InitialTime(std::size_t event) const
+{
+  return value<double>(eventColumns_, IniTime, event) * unit::second;
+}
+
+vector3_t HitColumnStoreReader::InitialPosition(std::size_t event) const
+{
+  const auto& c = eventColumns_;
+  return vector3_t(value<float>(c, IniPosX, event) * unit::cm,
+                   value<float>(c, IniPosY, event) * unit::cm,
+                   value<float>(c, IniPosZ, event) * unit::cm);
+}
+
+vector3_t HitColumnStoreReader::InitialPolarization(std::size_t event) const
+{
+  const auto& c = eventColumns_;
+  return vector3_t(value<float>(c, IniPolarX, event),
+                   value<float>(c, IniPolarY, event),
+                   value<float>(c, IniPolarZ, event));
+}
+
+double HitColumnStoreReader::Weight(std::size_t event) const
+{
+  return value<float>(eventColumns_, EventWeight, event);
+}
+
+} /* namespace comptonsoft */
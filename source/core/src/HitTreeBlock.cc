@@ -0,0 +1,132 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "HitTreeBlock.hh"
+#include "HitTreeIO.hh"
+
+namespace comptonsoft
+{
+
+void HitTreeBlock::clear()
+{
+  Columns& c = columns_;
+  c.eventid.clear();
+  c.num_hits.clear();
+  c.ti.clear();
+  c.instrument.clear();
+  c.detector.clear();
+  c.det_section.clear();
+  c.readout_module.clear();
+  c.section.clear();
+  c.channel.clear();
+  c.pixelx.clear();
+  c.pixely.clear();
+  c.pixelz.clear();
+  c.rawpha.clear();
+  c.pha.clear();
+  c.epi.clear();
+  c.epi_error.clear();
+  c.flag_data.clear();
+  c.flags.clear();
+  c.trackid.clear();
+  c.particle.clear();
+  c.real_time.clear();
+  c.time_trig.clear();
+  c.time_group.clear();
+  c.real_posx.clear();
+  c.real_posy.clear();
+  c.real_posz.clear();
+  c.edep.clear();
+  c.echarge.clear();
+  c.process.clear();
+  c.energy.clear();
+  c.energy_error.clear();
+  c.posx.clear();
+  c.posy.clear();
+  c.posz.clear();
+  c.posx_error.clear();
+  c.posy_error.clear();
+  c.posz_error.clear();
+  c.local_posx.clear();
+  c.local_posy.clear();
+  c.local_posz.clear();
+  c.local_posx_error.clear();
+  c.local_posy_error.clear();
+  c.local_posz_error.clear();
+  c.time.clear();
+  c.time_error.clear();
+  c.grade.clear();
+  initialInfo_.clear();
+}
+
+DetectorHit_sptr HitTreeBlock::retrieveHit(std::size_t i) const
+{
+  // the hit is built by the same conversion as HitTreeIO::retrieveHit().
+  const Columns& c = columns_;
+  HitTreeIO::Entry entry;
+  entry.eventid = c.eventid[i];
+  entry.num_hits = c.num_hits[i];
+  entry.ti = c.ti[i];
+  entry.instrument = c.instrument[i];
+  entry.detector = c.detector[i];
+  entry.det_section = c.det_section[i];
+  entry.readout_module = c.readout_module[i];
+  entry.section = c.section[i];
+  entry.channel = c.channel[i];
+  entry.pixelx = c.pixelx[i];
+  entry.pixely = c.pixely[i];
+  entry.pixelz = c.pixelz[i];
+  entry.rawpha = c.rawpha[i];
+  entry.pha = c.pha[i];
+  entry.epi = c.epi[i];
+  entry.epi_error = c.epi_error[i];
+  entry.flag_data = c.flag_data[i];
+  entry.flags = c.flags[i];
+  entry.trackid = c.trackid[i];
+  entry.particle = c.particle[i];
+  entry.real_time = c.real_time[i];
+  entry.time_trig = c.time_trig[i];
+  entry.time_group = c.time_group[i];
+  entry.real_posx = c.real_posx[i];
+  entry.real_posy = c.real_posy[i];
+  entry.real_posz = c.real_posz[i];
+  entry.edep = c.edep[i];
+  entry.echarge = c.echarge[i];
+  entry.process = c.process[i];
+  entry.energy = c.energy[i];
+  entry.energy_error = c.energy_error[i];
+  entry.posx = c.posx[i];
+  entry.posy = c.posy[i];
+  entry.posz = c.posz[i];
+  entry.posx_error = c.posx_error[i];
+  entry.posy_error = c.posy_error[i];
+  entry.posz_error = c.posz_error[i];
+  entry.local_posx = c.local_posx[i];
+  entry.local_posy = c.local_posy[i];
+  entry.local_posz = c.local_posz[i];
+  entry.local_posx_error = c.local_posx_error[i];
+  entry.local_posy_error = c.local_posy_error[i];
+  entry.local_posz_error = c.local_posz_error[i];
+  entry.time = c.time[i];
+  entry.time_error = c.time_error[i];
+  entry.grade = c.grade[i];
+  return HitTreeIO::retrieveHit(entry);
+}
+
+} /* namespace comptonsoft */
@@ -0,0 +1,122 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "HitTreeBlockReader.hh"
+#include <sstream>
+#include <utility>
+#include "CSException.hh"
+#include "HitTreeIO.hh"
+
+namespace comptonsoft
+{
+
+HitTreeBlockReader::HitTreeBlockReader(HitTreeIO* treeIO,
+                                       int64_t numEntries,
+                                       int64_t blockSize,
+                                       bool background)
+  : treeIO_(treeIO),
+    numEntries_(numEntries),
+    blockSize_(blockSize>0 ? blockSize : 1),
+    background_(background)
+{
+  if (background_ && numEntries_ > 0) {
+    requestBlock(0);
+  }
+}
+
+HitTreeBlockReader::~HitTreeBlockReader()
+{
+  if (pending_.valid()) {
+    pending_.wait();
+  }
+}
+
+void HitTreeBlockReader::requestBlock(int64_t first)
+{
+  pending_ = std::async(std::launch::async,
+                        [this, first]() { return treeIO_->readBlock(first, blockSize_, next_); });
+}
+
+bool HitTreeBlockReader::loadNextBlock()
+{
+  if (background_) {
+    if (!pending_.valid()) {
+      return false;
+    }
+    pending_.get();
+    std::swap(current_, next_);
+    nextFirst_ = current_.FirstEntry() + current_.size();
+    if (!current_.empty() && nextFirst_ < numEntries_) {
+      requestBlock(nextFirst_);
+    }
+  }
+  else {
+    if (nextFirst_ >= numEntries_) {
+      return false;
+    }
+    treeIO_->readBlock(nextFirst_, blockSize_, current_);
+    nextFirst_ += current_.size();
+  }
+
+  index_ = 0;
+  return !current_.empty();
+}
+
+bool HitTreeBlockReader::retrieveHits(std::vector<DetectorHit_sptr>& hits, bool trustNumHits)
+{
+  hits.clear();
+  if (index_ == current_.size()) {
+    if (!loadNextBlock()) {
+      return false;
+    }
+  }
+
+  eventID_ = current_.EventID(index_);
+  const int32_t numHits = current_.NumberOfHits(index_);
+  hasInitialInfo_ = current_.hasInitialInfo();
+  if (hasInitialInfo_) {
+    initialInfo_ = current_.getInitialInfo(index_);
+  }
+
+  while (true) {
+    hits.push_back(current_.retrieveHit(index_));
+    ++index_;
+    if (trustNumHits && static_cast<int32_t>(hits.size()) >= numHits) {
+      break;
+    }
+    if (index_ == current_.size()) {
+      if (!loadNextBlock()) {
+        break;
+      }
+    }
+    if (current_.EventID(index_) != eventID_) {
+      if (trustNumHits) {
+        std::ostringstream message;
+        message << "Error: inconsistent Event ID at "
+                << eventID_ << '\n';
+        BOOST_THROW_EXCEPTION( CSException(message.str()) );
+      }
+      break;
+    }
+  }
+
+  return true;
+}
+
+} /* namespace comptonsoft */
@@ -19,16 +19,40 @@
 
 #include "HitTreeIO.hh"
 #include <sstream>
+#include <algorithm>
 #include "AstroUnits.hh"
 #include "TTree.h"
+#include "TBranch.h"
 #include "CSException.hh"
 #include "DetectorHit.hh"
+#include "HitTreeBlock.hh"
 
 namespace unit = anlgeant4::unit;
 
 namespace comptonsoft
 {
 
+namespace
+{
+
+/**
+ * read a branch over entries [first, first+n) of a tree, one branch at a time,
+ * and append the values, which are written by ROOT into value, to the column.
+ */
+template <typename T>
+void read_column(TTree* tree, const char* name, const T& value,
+                 int64_t first, int64_t n, std::vector<T>& column)
+{
+  TBranch* branch = HitTreeIO::findBranch(tree, name);
+  column.reserve(column.size()+n);
+  for (int64_t entry=first; entry<first+n; entry++) {
+    branch->GetEntry(entry);
+    column.push_back(value);
+  }
+}
+
+} /* anonymous namespace */
+
 HitTreeIO::HitTreeIO()
   : hittree_(nullptr)
 {
@@ -38,211 +62,211 @@ HitTreeIO::~HitTreeIO() = default;
 
 void HitTreeIO::defineBranches()
 {
-  hittree_->Branch("eventid",          &eventid_,          "eventid/L");
-  hittree_->Branch("ihit",             &ihit_,             "ihit/S");
-  hittree_->Branch("num_hits",         &num_hits_,         "num_hits/I");
+  hittree_->Branch("eventid",          &entry_.eventid,          "eventid/L");
+  hittree_->Branch("ihit",             &entry_.ihit,             "ihit/S");
+  hittree_->Branch("num_hits",         &entry_.num_hits,         "num_hits/I");
   
   // measured data
-  hittree_->Branch("ti",               &ti_,               "ti/L");
-  hittree_->Branch("instrument",       &instrument_,       "instrument/S");
-  hittree_->Branch("detector",         &detector_,         "detector/S");
-  hittree_->Branch("det_section",      &det_section_,      "det_section/S");
-  hittree_->Branch("readout_module",   &readout_module_,   "readout_module/S");
-  hittree_->Branch("section",          &section_,          "section/S");
-  hittree_->Branch("channel",          &channel_,          "channel/S");
-  hittree_->Branch("pixelx",           &pixelx_,           "pixelx/S");
-  hittree_->Branch("pixely",           &pixely_,           "pixely/S");
-  hittree_->Branch("pixelz",           &pixelz_,           "pixelz/S");
-  hittree_->Branch("rawpha",           &rawpha_,           "rawpha/I");
-  hittree_->Branch("pha",              &pha_,              "pha/F");
-  hittree_->Branch("epi",              &epi_,              "epi/F");
-  hittree_->Branch("epi_error",        &epi_error_,        "epi_error/F");
-  hittree_->Branch("flag_data",        &flag_data_,        "flag_data/l");
-  hittree_->Branch("flags",            &flags_,            "flags/l");
+  hittree_->Branch("ti",               &entry_.ti,               "ti/L");
+  hittree_->Branch("instrument",       &entry_.instrument,       "instrument/S");
+  hittree_->Branch("detector",         &entry_.detector,         "detector/S");
+  hittree_->Branch("det_section",      &entry_.det_section,      "det_section/S");
+  hittree_->Branch("readout_module",   &entry_.readout_module,   "readout_module/S");
+  hittree_->Branch("section",          &entry_.section,          "section/S");
+  hittree_->Branch("channel",          &entry_.channel,          "channel/S");
+  hittree_->Branch("pixelx",           &entry_.pixelx,           "pixelx/S");
+  hittree_->Branch("pixely",           &entry_.pixely,           "pixely/S");
+  hittree_->Branch("pixelz",           &entry_.pixelz,           "pixelz/S");
+  hittree_->Branch("rawpha",           &entry_.rawpha,           "rawpha/I");
+  hittree_->Branch("pha",              &entry_.pha,              "pha/F");
+  hittree_->Branch("epi",              &entry_.epi,              "epi/F");
+  hittree_->Branch("epi_error",        &entry_.epi_error,        "epi_error/F");
+  hittree_->Branch("flag_data",        &entry_.flag_data,        "flag_data/l");
+  hittree_->Branch("flags",            &entry_.flags,            "flags/l");
   
   // simulation
-  hittree_->Branch("trackid",          &trackid_,          "trackid/I");
-  hittree_->Branch("particle",         &particle_,         "particle/I");
-  hittree_->Branch("real_time",        &real_time_,        "real_time/D");
-  hittree_->Branch("time_trig",        &time_trig_,        "time_trig/D");
-  hittree_->Branch("time_group",       &time_group_,       "time_group/S");
-  hittree_->Branch("real_posx",        &real_posx_,        "real_posx/F");
-  hittree_->Branch("real_posy",        &real_posy_,        "real_posy/F");
-  hittree_->Branch("real_posz",        &real_posz_,        "real_posz/F");
-  hittree_->Branch("edep",             &edep_,             "edep/F");
-  hittree_->Branch("echarge",          &echarge_,          "echarge/F");
-  hittree_->Branch("process",          &process_,          "process/i");
+  hittree_->Branch("trackid",          &entry_.trackid,          "trackid/I");
+  hittree_->Branch("particle",         &entry_.particle,         "particle/I");
+  hittree_->Branch("real_time",        &entry_.real_time,        "real_time/D");
+  hittree_->Branch("time_trig",        &entry_.time_trig,        "time_trig/D");
+  hittree_->Branch("time_group",       &entry_.time_group,       "time_group/S");
+  hittree_->Branch("real_posx",        &entry_.real_posx,        "real_posx/F");
+  hittree_->Branch("real_posy",        &entry_.real_posy,        "real_posy/F");
+  hittree_->Branch("real_posz",        &entry_.real_posz,        "real_posz/F");
+  hittree_->Branch("edep",             &entry_.edep,             "edep/F");
+  hittree_->Branch("echarge",          &entry_.echarge,          "echarge/F");
+  hittree_->Branch("process",          &entry_.process,          "process/i");
 
   // reconstructed
-  hittree_->Branch("energy",           &energy_,           "energy/F");
-  hittree_->Branch("energy_error",     &energy_error_,     "energy_error/F");
-  hittree_->Branch("posx",             &posx_,             "posx/F");
-  hittree_->Branch("posy",             &posy_,             "posy/F");
-  hittree_->Branch("posz",             &posz_,             "posz/F");
-  hittree_->Branch("posx_error",       &posx_error_,       "posx_error/F");
-  hittree_->Branch("posy_error",       &posy_error_,       "posy_error/F");
-  hittree_->Branch("posz_error",       &posz_error_,       "posz_error/F");
-  hittree_->Branch("local_posx",       &local_posx_,       "local_posx/F");
-  hittree_->Branch("local_posy",       &local_posy_,       "local_posy/F");
-  hittree_->Branch("local_posz",       &local_posz_,       "local_posz/F");
-  hittree_->Branch("local_posx_error", &local_posx_error_, "local_posx_error/F");
-  hittree_->Branch("local_posy_error", &local_posy_error_, "local_posy_error/F");
-  hittree_->Branch("local_posz_error", &local_posz_error_, "local_posz_error/F");
-  hittree_->Branch("time",             &time_,             "time/D");
-  hittree_->Branch("time_error",       &time_error_,       "time_error/D");
-  hittree_->Branch("grade",            &grade_,            "grade/I");
+  hittree_->Branch("energy",           &entry_.energy,           "energy/F");
+  hittree_->Branch("energy_error",     &entry_.energy_error,     "energy_error/F");
+  hittree_->Branch("posx",             &entry_.posx,             "posx/F");
+  hittree_->Branch("posy",             &entry_.posy,             "posy/F");
+  hittree_->Branch("posz",             &entry_.posz,             "posz/F");
+  hittree_->Branch("posx_error",       &entry_.posx_error,       "posx_error/F");
+  hittree_->Branch("posy_error",       &entry_.posy_error,       "posy_error/F");
+  hittree_->Branch("posz_error",       &entry_.posz_error,       "posz_error/F");
+  hittree_->Branch("local_posx",       &entry_.local_posx,       "local_posx/F");
+  hittree_->Branch("local_posy",       &entry_.local_posy,       "local_posy/F");
+  hittree_->Branch("local_posz",       &entry_.local_posz,       "local_posz/F");
+  hittree_->Branch("local_posx_error", &entry_.local_posx_error, "local_posx_error/F");
+  hittree_->Branch("local_posy_error", &entry_.local_posy_error, "local_posy_error/F");
+  hittree_->Branch("local_posz_error", &entry_.local_posz_error, "local_posz_error/F");
+  hittree_->Branch("time",             &entry_.time,             "time/D");
+  hittree_->Branch("time_error",       &entry_.time_error,       "time_error/D");
+  hittree_->Branch("grade",            &entry_.grade,            "grade/I");
 }
 
 void HitTreeIO::setBranchAddresses()
 {
-  hittree_->SetBranchAddress("eventid",          &eventid_);
-  hittree_->SetBranchAddress("ihit",             &ihit_);
-  hittree_->SetBranchAddress("num_hits",         &num_hits_);
+  hittree_->SetBranchAddress("eventid",          &entry_.eventid);
+  hittree_->SetBranchAddress("ihit",             &entry_.ihit);
+  hittree_->SetBranchAddress("num_hits",         &entry_.num_hits);
 
   // measured data
-  hittree_->SetBranchAddress("ti",               &ti_);
-  hittree_->SetBranchAddress("instrument",       &instrument_);
-  hittree_->SetBranchAddress("detector",         &detector_);
-  hittree_->SetBranchAddress("det_section",      &det_section_);
-  hittree_->SetBranchAddress("readout_module",   &readout_module_);
-  hittree_->SetBranchAddress("section",          &section_);
-  hittree_->SetBranchAddress("channel",          &channel_);
-  hittree_->SetBranchAddress("pixelx",           &pixelx_);
-  hittree_->SetBranchAddress("pixely",           &pixely_);
-  hittree_->SetBranchAddress("pixelz",           &pixelz_);
-  hittree_->SetBranchAddress("rawpha",           &rawpha_);
-  hittree_->SetBranchAddress("pha",              &pha_);
-  hittree_->SetBranchAddress("epi",              &epi_);
-  hittree_->SetBranchAddress("epi_error",        &epi_error_);
-  hittree_->SetBranchAddress("flag_data",        &flag_data_);
-  hittree_->SetBranchAddress("flags",            &flags_);
+  hittree_->SetBranchAddress("ti",               &entry_.ti);
+  hittree_->SetBranchAddress("instrument",       &entry_.instrument);
+  hittree_->SetBranchAddress("detector",         &entry_.detector);
+  hittree_->SetBranchAddress("det_section",      &entry_.det_section);
+  hittree_->SetBranchAddress("readout_module",   &entry_.readout_module);
+  hittree_->SetBranchAddress("section",          &entry_.section);
+  hittree_->SetBranchAddress("channel",          &entry_.channel);
+  hittree_->SetBranchAddress("pixelx",           &entry_.pixelx);
+  hittree_->SetBranchAddress("pixely",           &entry_.pixely);
+  hittree_->SetBranchAddress("pixelz",           &entry_.pixelz);
+  hittree_->SetBranchAddress("rawpha",           &entry_.rawpha);
+  hittree_->SetBranchAddress("pha",              &entry_.pha);
+  hittree_->SetBranchAddress("epi",              &entry_.epi);
+  hittree_->SetBranchAddress("epi_error",        &entry_.epi_error);
+  hittree_->SetBranchAddress("flag_data",        &entry_.flag_data);
+  hittree_->SetBranchAddress("flags",            &entry_.flags);
 
   // simulation
-  hittree_->SetBranchAddress("trackid",          &trackid_);
-  hittree_->SetBranchAddress("particle",         &particle_);
-  hittree_->SetBranchAddress("real_time",        &real_time_);
-  hittree_->SetBranchAddress("time_trig",        &time_trig_);
-  hittree_->SetBranchAddress("time_group",       &time_group_);
-  hittree_->SetBranchAddress("real_posx",        &real_posx_);
-  hittree_->SetBranchAddress("real_posy",        &real_posy_);
-  hittree_->SetBranchAddress("real_posz",        &real_posz_);
-  hittree_->SetBranchAddress("edep",             &edep_);
-  hittree_->SetBranchAddress("echarge",          &echarge_);
-  hittree_->SetBranchAddress("process",          &process_);
+  hittree_->SetBranchAddress("trackid",          &entry_.trackid);
+  hittree_->SetBranchAddress("particle",         &entry_.particle);
+  hittree_->SetBranchAddress("real_time",        &entry_.real_time);
+  hittree_->SetBranchAddress("time_trig",        &entry_.time_trig);
+  hittree_->SetBranchAddress("time_group",       &entry_.time_group);
+  hittree_->SetBranchAddress("real_posx",        &entry_.real_posx);
+  hittree_->SetBranchAddress("real_posy",        &entry_.real_posy);
+  hittree_->SetBranchAddress("real_posz",        &entry_.real_posz);
+  hittree_->SetBranchAddress("edep",             &entry_.edep);
+  hittree_->SetBranchAddress("echarge",          &entry_.echarge);
+  hittree_->SetBranchAddress("process",          &entry_.process);
 
   // reconstructed
-  hittree_->SetBranchAddress("energy",           &energy_);
-  hittree_->SetBranchAddress("energy_error",     &energy_error_);
-  hittree_->SetBranchAddress("posx",             &posx_);
-  hittree_->SetBranchAddress("posy",             &posy_);
-  hittree_->SetBranchAddress("posz",             &posz_);
-  hittree_->SetBranchAddress("posx_error",       &posx_error_);
-  hittree_->SetBranchAddress("posy_error",       &posy_error_);
-  hittree_->SetBranchAddress("posz_error",       &posz_error_);
-  hittree_->SetBranchAddress("local_posx",       &local_posx_);
-  hittree_->SetBranchAddress("local_posy",       &local_posy_);
-  hittree_->SetBranchAddress("local_posz",       &local_posz_);
-  hittree_->SetBranchAddress("local_posx_error", &local_posx_error_);
-  hittree_->SetBranchAddress("local_posy_error", &local_posy_error_);
-  hittree_->SetBranchAddress("local_posz_error", &local_posz_error_);
-  hittree_->SetBranchAddress("time",             &time_);
-  hittree_->SetBranchAddress("time_error",       &time_error_);
-  hittree_->SetBranchAddress("grade",            &grade_);
+  hittree_->SetBranchAddress("energy",           &entry_.energy);
+  hittree_->SetBranchAddress("energy_error",     &entry_.energy_error);
+  hittree_->SetBranchAddress("posx",             &entry_.posx);
+  hittree_->SetBranchAddress("posy",             &entry_.posy);
+  hittree_->SetBranchAddress("posz",             &entry_.posz);
+  hittree_->SetBranchAddress("posx_error",       &entry_.posx_error);
+  hittree_->SetBranchAddress("posy_error",       &entry_.posy_error);
+  hittree_->SetBranchAddress("posz_error",       &entry_.posz_error);
+  hittree_->SetBranchAddress("local_posx",       &entry_.local_posx);
+  hittree_->SetBranchAddress("local_posy",       &entry_.local_posy);
+  hittree_->SetBranchAddress("local_posz",       &entry_.local_posz);
+  hittree_->SetBranchAddress("local_posx_error", &entry_.local_posx_error);
+  hittree_->SetBranchAddress("local_posy_error", &entry_.local_posy_error);
+  hittree_->SetBranchAddress("local_posz_error", &entry_.local_posz_error);
+  hittree_->SetBranchAddress("time",             &entry_.time);
+  hittree_->SetBranchAddress("time_error",       &entry_.time_error);
+  hittree_->SetBranchAddress("grade",            &entry_.grade);
 }
 
 void HitTreeIO::fillHits(const int64_t eventID,
                          const std::vector<DetectorHit_sptr>& hits)
 {
   const int NumHits = hits.size();
-  num_hits_ = NumHits;
+  entry_.num_hits = NumHits;
 
   for (int i=0; i<NumHits; i++) {
     const DetectorHit_sptr& hit = hits[i];
-    eventid_ = (eventID >= 0) ? eventID : hit->EventID();
-    ihit_ = i;
+    entry_.eventid = (eventID >= 0) ? eventID : hit->EventID();
+    entry_.ihit = i;
 
-    ti_ = hit->TI();
-    instrument_ = hit->InstrumentID();
-    detector_ = hit->DetectorID();
-    det_section_ = hit->DetectorSection();
-    readout_module_ = hit->ReadoutModuleID();
-    section_ = hit->ReadoutSection();
-    channel_ = hit->ReadoutChannel();
-    pixelx_ = hit->VoxelX();
-    pixely_ = hit->VoxelY();
-    pixelz_ = hit->VoxelZ();
-    rawpha_ = hit->RawPHA();
-    pha_ = hit->PHA();
-    epi_ = hit->EPI() / unit::keV;
-    epi_error_ = hit->EPIError() / unit::keV;
-    flag_data_ = hit->FlagData();
-    flags_ = hit->Flags();
-    trackid_ = hit->TrackID();
-    particle_ = hit->Particle();
-    real_time_ = hit->RealTime() / unit::second;
-    time_trig_ = hit->TriggeredTime() / unit::second;
-    time_group_ = hit->TimeGroup();
-    real_posx_ = hit->RealPositionX() / unit::cm;
-    real_posy_ = hit->RealPositionY() / unit::cm;
-    real_posz_ = hit->RealPositionZ() / unit::cm;
-    edep_ = hit->EnergyDeposit() / unit::keV;
-    echarge_ = hit->EnergyCharge() / unit::keV;
-    process_ = hit->Process();
-    energy_ = hit->Energy() / unit::keV;
-    energy_error_ = hit->EnergyError() / unit::keV;
-    posx_ = hit->PositionX() / unit::cm;
-    posy_ = hit->PositionY() / unit::cm;
-    posz_ = hit->PositionZ() / unit::cm;
-    posx_error_ = hit->PositionErrorX() / unit::cm;
-    posy_error_ = hit->PositionErrorY() / unit::cm;
-    posz_error_ = hit->PositionErrorZ() / unit::cm;
-    local_posx_ = hit->LocalPositionX() / unit::cm;
-    local_posy_ = hit->LocalPositionY() / unit::cm;
-    local_posz_ = hit->LocalPositionZ() / unit::cm;
-    local_posx_error_ = hit->LocalPositionErrorX() / unit::cm;
-    local_posy_error_ = hit->LocalPositionErrorY() / unit::cm;
-    local_posz_error_ = hit->LocalPositionErrorZ() / unit::cm;
-    time_ = hit->Time() / unit::second;
-    time_error_ = hit->TimeError() / unit::second;
-    grade_ = hit->Grade();
+    entry_.ti = hit->TI();
+    entry_.instrument = hit->InstrumentID();
+    entry_.detector = hit->DetectorID();
+    entry_.det_section = hit->DetectorSection();
+    entry_.readout_module = hit->ReadoutModuleID();
+    entry_.section = hit->ReadoutSection();
+    entry_.channel = hit->ReadoutChannel();
+    entry_.pixelx = hit->VoxelX();
+    entry_.pixely = hit->VoxelY();
+    entry_.pixelz = hit->VoxelZ();
+    entry_.rawpha = hit->RawPHA();
+    entry_.pha = hit->PHA();
+    entry_.epi = hit->EPI() / unit::keV;
+    entry_.epi_error = hit->EPIError() / unit::keV;
+    entry_.flag_data = hit->FlagData();
+    entry_.flags = hit->Flags();
+    entry_.trackid = hit->TrackID();
+    entry_.particle = hit->Particle();
+    entry_.real_time = hit->RealTime() / unit::second;
+    entry_.time_trig = hit->TriggeredTime() / unit::second;
+    entry_.time_group = hit->TimeGroup();
+    entry_.real_posx = hit->RealPositionX() / unit::cm;
+    entry_.real_posy = hit->RealPositionY() / unit::cm;
+    entry_.real_posz = hit->RealPositionZ() / unit::cm;
+    entry_.edep = hit->EnergyDeposit() / unit::keV;
+    entry_.echarge = hit->EnergyCharge() / unit::keV;
+    entry_.process = hit->Process();
+    entry_.energy = hit->Energy() / unit::keV;
+    entry_.energy_error = hit->EnergyError() / unit::keV;
+    entry_.posx = hit->PositionX() / unit::cm;
+    entry_.posy = hit->PositionY() / unit::cm;
+    entry_.posz = hit->PositionZ() / unit::cm;
+    entry_.posx_error = hit->PositionErrorX() / unit::cm;
+    entry_.posy_error = hit->PositionErrorY() / unit::cm;
+    entry_.posz_error = hit->PositionErrorZ() / unit::cm;
+    entry_.local_posx = hit->LocalPositionX() / unit::cm;
+    entry_.local_posy = hit->LocalPositionY() / unit::cm;
+    entry_.local_posz = hit->LocalPositionZ() / unit::cm;
+    entry_.local_posx_error = hit->LocalPositionErrorX() / unit::cm;
+    entry_.local_posy_error = hit->LocalPositionErrorY() / unit::cm;
+    entry_.local_posz_error = hit->LocalPositionErrorZ() / unit::cm;
+    entry_.time = hit->Time() / unit::second;
+    entry_.time_error = hit->TimeError() / unit::second;
+    entry_.grade = hit->Grade();
     
     hittree_->Fill();
   }
 }
 
-DetectorHit_sptr HitTreeIO::retrieveHit() const
+DetectorHit_sptr HitTreeIO::retrieveHit(const Entry& entry)
 {
   DetectorHit_sptr hit(new DetectorHit);
-  hit->setEventID(eventid_);
-  hit->setTI(ti_);
-  hit->setInstrumentID(instrument_);
-  hit->setDetectorChannelID(detector_, det_section_, channel_);
-  hit->setReadoutChannelID(readout_module_, section_, channel_);
-  hit->setVoxel(pixelx_, pixely_, pixelz_);
-  hit->setRawPHA(rawpha_);
-  hit->setPHA(pha_);
-  hit->setEPI(epi_ * unit::keV);
-  hit->setEPIError(epi_error_ * unit::keV);
-  hit->setFlagData(flag_data_);
-  hit->setFlags(flags_);
-  hit->setTrackID(trackid_);
-  hit->setParticle(particle_);
-  hit->setRealTime(real_time_ * unit::second);
-  hit->setTriggeredTime(time_trig_ * unit::second);
-  hit->setTimeGroup(time_group_);
-  hit->setRealPosition(real_posx_ * unit::cm, real_posy_ * unit::cm, real_posz_ * unit::cm);
-  hit->setEnergyDeposit(edep_ * unit::keV);
-  hit->setEnergyCharge(echarge_ * unit::keV);
-  hit->setProcess(process_);
-  hit->setEnergy(energy_ * unit::keV);
-  hit->setEnergyError(energy_error_ * unit::keV);
-  hit->setPosition(posx_ * unit::cm, posy_ * unit::cm, posz_ * unit::cm);
-  hit->setPositionError(posx_error_ * unit::cm, posy_error_ * unit::cm, posz_error_ * unit::cm);
-  hit->setLocalPosition(local_posx_ * unit::cm, local_posy_ * unit::cm, local_posz_ * unit::cm);
-  hit->setLocalPositionError(local_posx_error_ * unit::cm, local_posy_error_ * unit::cm, local_posz_error_ * unit::cm);
-  hit->setTime(time_ * unit::second);
-  hit->setTimeError(time_error_ * unit::second);
-  hit->setGrade(grade_);
+  hit->setEventID(entry.eventid);
+  hit->setTI(entry.ti);
+  hit->setInstrumentID(entry.instrument);
+  hit->setDetectorChannelID(entry.detector, entry.det_section, entry.channel);
+  hit->setReadoutChannelID(entry.readout_module, entry.section, entry.channel);
+  hit->setVoxel(entry.pixelx, entry.pixely, entry.pixelz);
+  hit->setRawPHA(entry.rawpha);
+  hit->setPHA(entry.pha);
+  hit->setEPI(entry.epi * unit::keV);
+  hit->setEPIError(entry.epi_error * unit::keV);
+  hit->setFlagData(entry.flag_data);
+  hit->setFlags(entry.flags);
+  hit->setTrackID(entry.trackid);
+  hit->setParticle(entry.particle);
+  hit->setRealTime(entry.real_time * unit::second);
+  hit->setTriggeredTime(entry.time_trig * unit::second);
+  hit->setTimeGroup(entry.time_group);
+  hit->setRealPosition(entry.real_posx * unit::cm, entry.real_posy * unit::cm, entry.real_posz * unit::cm);
+  hit->setEnergyDeposit(entry.edep * unit::keV);
+  hit->setEnergyCharge(entry.echarge * unit::keV);
+  hit->setProcess(entry.process);
+  hit->setEnergy(entry.energy * unit::keV);
+  hit->setEnergyError(entry.energy_error * unit::keV);
+  hit->setPosition(entry.posx * unit::cm, entry.posy * unit::cm, entry.posz * unit::cm);
+  hit->setPositionError(entry.posx_error * unit::cm, entry.posy_error * unit::cm, entry.posz_error * unit::cm);
+  hit->setLocalPosition(entry.local_posx * unit::cm, entry.local_posy * unit::cm, entry.local_posz * unit::cm);
+  hit->setLocalPositionError(entry.local_posx_error * unit::cm, entry.local_posy_error * unit::cm, entry.local_posz_error * unit::cm);
+  hit->setTime(entry.time * unit::second);
+  hit->setTimeError(entry.time_error * unit::second);
+  hit->setGrade(entry.grade);
 
   return hit;
 }
@@ -256,13 +280,13 @@ std::vector<DetectorHit_sptr> HitTreeIO::retrieveHits(int64_t& entry,
     hittree_->GetEntry(entry);
   }
 
-  const int64_t ThisEventID = eventid_;
+  const int64_t ThisEventID = entry_.eventid;
   const int numHits = getNumberOfHits();
   for (int i=0; i<numHits; i++) {
     if (i != 0) {
       hittree_->GetEntry(entry+i);
 
-      if (eventid_ != ThisEventID) {
+      if (entry_.eventid != ThisEventID) {
         std::ostringstream message;
         message << "Error: inconsistent Event ID at "
                 << ThisEventID << '\n';
@@ -277,4 +301,90 @@ std::vector<DetectorHit_sptr> HitTreeIO::retrieveHits(int64_t& entry,
   return hits;
 }
 
+int64_t HitTreeIO::readBlock(int64_t first, int64_t n, HitTreeBlock& block)
+{
+  const int64_t last = std::min(first+n, static_cast<int64_t>(hittree_->GetEntries()));
+  block.clear();
+  block.setFirstEntry(first);
+
+  // The entries are read in ranges within one tree, i.e., one file of a chain.
+  int64_t entry = first;
+  while (entry < last) {
+    const int64_t localEntry = hittree_->LoadTree(entry);
+    if (localEntry < 0) {
+      break;
+    }
+    TTree* tree = hittree_->GetTree();
+    const int64_t count = std::min(last-entry, static_cast<int64_t>(tree->GetEntries())-localEntry);
+    if (count <= 0) {
+      break;
+    }
+    readColumns(tree, localEntry, count, block);
+    entry += count;
+  }
+  return block.size();
+}
+
+TBranch* HitTreeIO::findBranch(TTree* tree, const char* name)
+{
+  TBranch* branch = tree->GetBranch(name);
+  if (branch == nullptr) {
+    std::ostringstream message;
+    message << "Error: branch " << name << " is not found in the hit tree.\n";
+    BOOST_THROW_EXCEPTION( CSException(message.str()) );
+  }
+  return branch;
+}
+
+void HitTreeIO::readColumns(TTree* tree, int64_t first, int64_t n, HitTreeBlock& block)
+{
+  HitTreeBlock::Columns& c = block.columns();
+  read_column(tree, "eventid",          entry_.eventid,          first, n, c.eventid);
+  read_column(tree, "num_hits",         entry_.num_hits,         first, n, c.num_hits);
+  read_column(tree, "ti",               entry_.ti,               first, n, c.ti);
+  read_column(tree, "instrument",       entry_.instrument,       first, n, c.instrument);
+  read_column(tree, "detector",         entry_.detector,         first, n, c.detector);
+  read_column(tree, "det_section",      entry_.det_section,      first, n, c.det_section);
+  read_column(tree, "readout_module",   entry_.readout_module,   first, n, c.readout_module);
+  read_column(tree, "section",          entry_.section,          first, n, c.section);
+  read_column(tree, "channel",          entry_.channel,          first, n, c.channel);
+  read_column(tree, "pixelx",           entry_.pixelx,           first, n, c.pixelx);
+  read_column(tree, "pixely",           entry_.pixely,           first, n, c.pixely);
+  read_column(tree, "pixelz",           entry_.pixelz,           first, n, c.pixelz);
+  read_column(tree, "rawpha",           entry_.rawpha,           first, n, c.rawpha);
+  read_column(tree, "pha",              entry_.pha,              first, n, c.pha);
+  read_column(tree, "epi",              entry_.epi,              first, n, c.epi);
+  read_column(tree, "epi_error",        entry_.epi_error,        first, n, c.epi_error);
+  read_column(tree, "flag_data",        entry_.flag_data,        first, n, c.flag_data);
+  read_column(tree, "flags",            entry_.flags,            first, n, c.flags);
+  read_column(tree, "trackid",          entry_.trackid,          first, n, c.trackid);
+  read_column(tree, "particle",         entry_.particle,         first, n, c.particle);
+  read_column(tree, "real_time",        entry_.real_time,        first, n, c.real_time);
+  read_column(tree, "time_trig",        entry_.time_trig,        first, n, c.time_trig);
+  read_column(tree, "time_group",       entry_.time_group,       first, n, c.time_group);
+  read_column(tree, "real_posx",        entry_.real_posx,        first, n, c.real_posx);
+  read_column(tree, "real_posy",        entry_.real_posy,        first, n, c.real_posy);
+  read_column(tree, "real_posz",        entry_.real_posz,        first, n, c.real_posz);
+  read_column(tree, "edep",             entry_.edep,             first, n, c.edep);
+  read_column(tree, "echarge",          entry_.echarge,          first, n, c.echarge);
+  read_column(tree, "process",          entry_.process,          first, n, c.process);
+  read_column(tree, "energy",           entry_.energy,           first, n, c.energy);
+  read_column(tree, "energy_error",     entry_.energy_error,     first, n, c.energy_error);
+  read_column(tree, "posx",             entry_.posx,             first, n, c.posx);
+  read_column(tree, "posy",             entry_.posy,             first, n, c.posy);
+  read_column(tree, "posz",             entry_.posz,             first, n, c.posz);
+  read_column(tree, "posx_error",       entry_.posx_error,       first, n, c.posx_error);
+  read_column(tree, "posy_error",       entry_.posy_error,       first, n, c.posy_error);
+  read_column(tree, "posz_error",       entry_.posz_error,       first, n, c.posz_error);
+  read_column(tree, "local_posx",       entry_.local_posx,       first, n, c.local_posx);
+  read_column(tree, "local_posy",       entry_.local_posy,       first, n, c.local_posy);
+  read_column(tree, "local_posz",       entry_.local_posz,       first, n, c.local_posz);
+  read_column(tree, "local_posx_error", entry_.local_posx_error, first, n, c.local_posx_error);
+  read_column(tree, "local_posy_error", entry_.local_posy_error, first, n, c.local_posy_error);
+  read_column(tree, "local_posz_error", entry_.local_posz_error, first, n, c.local_posz_error);
+  read_column(tree, "time",             entry_.time,             first, n, c.time);
+  read_column(tree, "time_error",       entry_.time_error,       first, n, c.time_error);
+  read_column(tree, "grade",            entry_.grade,            first, n, c.grade);
+}
+
 } /* namespace comptonsoft */
@@ -18,6 +18,9 @@
  *************************************************************************/
 
 #include "HitTreeIOWithInitialInfo.hh"
+#include <vector>
+#include "TBranch.h"
+#include "HitTreeBlock.hh"
 
 namespace comptonsoft
 {
@@ -42,4 +45,37 @@ void HitTreeIOWithInitialInfo::setBranchAddresses()
   InitialInfoTreeIO::setBranchAddresses();
 }
 
+void HitTreeIOWithInitialInfo::readColumns(TTree* tree, int64_t first, int64_t n, HitTreeBlock& block)
+{
+  HitTreeIO::readColumns(tree, first, n, block);
+
+  if (isInitialInfoRecordEnabled()) {
+    const char* names[] = {
+      "ini_energy", "ini_dirx", "ini_diry", "ini_dirz", "ini_time",
+      "ini_posx", "ini_posy", "ini_posz",
+      "ini_polarx", "ini_polary", "ini_polarz", "weight",
+    };
+    std::vector<TBranch*> branches;
+    for (const char* name: names) {
+      branches.push_back(findBranch(tree, name));
+    }
+
+    std::vector<HitTreeBlock::InitialInfo>& infoColumn = block.initialInfo();
+    infoColumn.reserve(infoColumn.size()+n);
+    for (int64_t entry=first; entry<first+n; entry++) {
+      for (TBranch* branch: branches) {
+        branch->GetEntry(entry);
+      }
+      HitTreeBlock::InitialInfo info;
+      info.energy = getInitialEnergy();
+      info.direction = getInitialDirection();
+      info.time = getInitialTime();
+      info.position = getInitialPosition();
+      info.polarization = getInitialPolarization();
+      info.weight = getWeight();
+      infoColumn.push_back(info);
+    }
+  }
+}
+
 } /* namespace comptonsoft */
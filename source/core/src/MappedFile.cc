@@ -0,0 +1,69 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "MappedFile.hh"
+#include <boost/interprocess/exceptions.hpp>
+
+namespace bip = boost::interprocess;
+
+namespace comptonsoft {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile() = default;
+
+bool MappedFile::open(const std::string& filename)
+{
+  close();
+  try {
+    mapping_.reset(new bip::file_mapping(filename.c_str(), bip::read_only));
+    region_.reset(new bip::mapped_region(*mapping_, bip::read_only));
+  }
+  catch (const bip::interprocess_exception&) {
+    close();
+    return false;
+  }
+
+  if (region_->get_size() == 0) {
+    close();
+    return false;
+  }
+
+  filename_ = filename;
+  return true;
+}
+
+void MappedFile::close()
+{
+  region_.reset();
+  mapping_.reset();
+  filename_.clear();
+}
+
+const char* MappedFile::data() const
+{
+  return static_cast<const char*>(region_->get_address());
+}
+
+std::size_t MappedFile::size() const
+{
+  return region_->get_size();
+}
+
+} /* namespace comptonsoft */
@@ -20,40 +20,148 @@
 
 #include "NumericalField.hh"
 #include <algorithm>
-#include <tuple>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include "MappedFile.hh"
 
 namespace {
 
-std::tuple<std::size_t, std::size_t>
-find_index_pair(double a, const std::vector<double>& as);
+constexpr char FileMagic[8] = {'C', 'S', 'N', 'F', 'I', 'E', 'L', 'D'};
+constexpr uint32_t FileVersion = 2;
+constexpr uint32_t ByteOrderMark = 0x01020304u;
+constexpr std::size_t DataAlignment = 64;
+constexpr std::size_t MaxParameters = 8;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t nx;
+  uint64_t ny;
+  uint64_t nz;
+  uint64_t dataOffset;
+  uint64_t numParameters;
+  double parameters[MaxParameters];
+};
+
+uint64_t data_offset(uint64_t nx, uint64_t ny, uint64_t nz)
+{
+  const uint64_t end = sizeof(FileHeader) + sizeof(double)*(nx+ny+nz);
+  return (end+DataAlignment-1)/DataAlignment*DataAlignment;
+}
+
+inline double trilinear(const double rx, const double ry, const double rz,
+                        const double v000, const double v001,
+                        const double v010, const double v011,
+                        const double v100, const double v101,
+                        const double v110, const double v111)
+{
+  const double c000 = (1.0-rx)*(1.0-ry)*(1.0-rz);
+  const double c001 = (1.0-rx)*(1.0-ry)*     rz;
+  const double c010 = (1.0-rx)*     ry *(1.0-rz);
+  const double c011 = (1.0-rx)*     ry *     rz;
+  const double c100 =      rx *(1.0-ry)*(1.0-rz);
+  const double c101 =      rx *(1.0-ry)*     rz;
+  const double c110 =      rx *     ry *(1.0-rz);
+  const double c111 =      rx *     ry *     rz;
+  return c000*v000 + c001*v001 + c010*v010 + c011*v011 + c100*v100 + c101*v101 + c110*v110 + c111*v111;
+}
+
+inline double fraction(const double a, const double a0, const double a1,
+                       const std::size_t i0, const std::size_t i1)
+{
+  return (i0==i1) ? 0.5 : (a-a0)/(a1-a0);
+}
 
 } /* unnamed namespace */
 
 namespace comptonsoft {
 
+NumericalField::NumericalField() = default;
+
 NumericalField::~NumericalField() = default;
 
+void NumericalField::Axis::define(const std::vector<double>& xs)
+{
+  points = xs;
+  uniform = false;
+  origin = 0.0;
+  inverseSpacing = 0.0;
+
+  const std::size_t n = points.size();
+  if (n < 2) { return; }
+
+  const double spacing = (points[n-1]-points[0])/(n-1);
+  if (!(spacing > 0.0)) { return; }
+
+  const double tolerance = 1.0e-6 * spacing;
+  for (std::size_t i=1; i<n; i++) {
+    if (std::abs((points[i]-points[0]) - spacing*i) > tolerance) {
+      return;
+    }
+  }
+
+  uniform = true;
+  origin = points[0];
+  inverseSpacing = 1.0/spacing;
+}
+
+void NumericalField::Axis::findIndexPair(const double a, std::size_t& i0, std::size_t& i1) const
+{
+  // same result as a search with std::upper_bound()
+  const std::size_t n = points.size();
+  if (a < points[0]) {
+    i0 = i1 = 0;
+    return;
+  }
+  if (!(a < points[n-1])) {
+    i0 = i1 = n-1;
+    return;
+  }
+
+  if (uniform) {
+    std::size_t k = static_cast<std::size_t>((a-origin)*inverseSpacing);
+    if (k > n-2) { k = n-2; }
+    // the rounding may put the guess in a neighboring cell.
+    while (a < points[k]) { --k; }
+    while (!(a < points[k+1])) { ++k; }
+    i0 = k;
+    i1 = k+1;
+    return;
+  }
+
+  const std::size_t k = std::upper_bound(points.begin(), points.end(), a) - points.begin();
+  i0 = k-1;
+  i1 = k;
+}
+
 void NumericalField::
 defineGrids(const std::vector<double>& xs,
             const std::vector<double>& ys,
             const std::vector<double>& zs)
 {
-  xs_ = xs;
-  ys_ = ys;
-  zs_ = zs;
-  const std::size_t nx = xs_.size();
-  const std::size_t ny = ys_.size();
-  const std::size_t nz = zs_.size();
-  field_.resize(boost::extents[nx][ny][nz]);
+  mappedFile_.reset();
+  xs_.define(xs);
+  ys_.define(ys);
+  zs_.define(zs);
+  values_.resize(num_x()*num_y()*num_z());
+  data_ = values_.data();
 }
 
 void NumericalField::setZeros()
 {
-  double* p = field_.origin();
-  for (std::size_t i=0; i<field_.num_elements(); ++i) {
-    *p = 0.0;
-    ++p;
-  }
+  if (mappedFile_) { detachFromFile(); }
+  std::fill(values_.begin(), values_.end(), 0.0);
+}
+
+void NumericalField::detachFromFile()
+{
+  values_.assign(data_, data_+num_x()*num_y()*num_z());
+  data_ = values_.data();
+  mappedFile_.reset();
 }
 
 double NumericalField::field(const double x,
@@ -61,54 +169,138 @@ double NumericalField::field(const double x,
                              const double z) const
 {
   std::size_t ix0, ix1, iy0, iy1, iz0, iz1;
-  std::tie(ix0, ix1) = find_index_pair(x, xs_);
-  std::tie(iy0, iy1) = find_index_pair(y, ys_);
-  std::tie(iz0, iz1) = find_index_pair(z, zs_);
-  const double x0 = get_x(ix0); const double x1 = get_x(ix1);
-  const double y0 = get_y(iy0); const double y1 = get_y(iy1);
-  const double z0 = get_z(iz0); const double z1 = get_z(iz1);
-  const double rx = (ix0==ix1) ? 0.5 : (x-x0)/(x1-x0);
-  const double ry = (iy0==iy1) ? 0.5 : (y-y0)/(y1-y0);
-  const double rz = (iz0==iz1) ? 0.5 : (z-z0)/(z1-z0);
-  const double v000 = get_field_value(ix0, iy0, iz0);
-  const double v001 = get_field_value(ix0, iy0, iz1);
-  const double v010 = get_field_value(ix0, iy1, iz0);
-  const double v011 = get_field_value(ix0, iy1, iz1);
-  const double v100 = get_field_value(ix1, iy0, iz0);
-  const double v101 = get_field_value(ix1, iy0, iz1);
-  const double v110 = get_field_value(ix1, iy1, iz0);
-  const double v111 = get_field_value(ix1, iy1, iz1);
-  const double c000 = (1.0-rx)*(1.0-ry)*(1.0-rz);
-  const double c001 = (1.0-rx)*(1.0-ry)*     rz;
-  const double c010 = (1.0-rx)*     ry *(1.0-rz);
-  const double c011 = (1.0-rx)*     ry *     rz;
-  const double c100 =      rx *(1.0-ry)*(1.0-rz);
-  const double c101 =      rx *(1.0-ry)*     rz;
-  const double c110 =      rx *     ry *(1.0-rz);
-  const double c111 =      rx *     ry *     rz;
-  const double v = c000*v000 + c001*v001 + c010*v010 + c011*v011 + c100*v100 + c101*v101 + c110*v110 + c111*v111;
-  return v;
+  xs_.findIndexPair(x, ix0, ix1);
+  ys_.findIndexPair(y, iy0, iy1);
+  zs_.findIndexPair(z, iz0, iz1);
+  const double rx = fraction(x, get_x(ix0), get_x(ix1), ix0, ix1);
+  const double ry = fraction(y, get_y(iy0), get_y(iy1), iy0, iy1);
+  const double rz = fraction(z, get_z(iz0), get_z(iz1), iz0, iz1);
+  return trilinear(rx, ry, rz,
+                   get_field_value(ix0, iy0, iz0),
+                   get_field_value(ix0, iy0, iz1),
+                   get_field_value(ix0, iy1, iz0),
+                   get_field_value(ix0, iy1, iz1),
+                   get_field_value(ix1, iy0, iz0),
+                   get_field_value(ix1, iy0, iz1),
+                   get_field_value(ix1, iy1, iz0),
+                   get_field_value(ix1, iy1, iz1));
 }
 
-} /* namespace comptonsoft */
+void NumericalField::field(const double* xs, const double* ys, const double* zs,
+                           double* values, const std::size_t n) const
+{
+  constexpr std::size_t ChunkSize = 64;
+  double rx[ChunkSize], ry[ChunkSize], rz[ChunkSize];
+  double v[8][ChunkSize];
 
-namespace {
+  for (std::size_t start=0; start<n; start+=ChunkSize) {
+    const std::size_t m = std::min(ChunkSize, n-start);
+    const double* x = xs + start;
+    const double* y = ys + start;
+    const double* z = zs + start;
+    double* out = values + start;
 
-std::tuple<std::size_t, std::size_t> find_index_pair(const double a, const std::vector<double>& as)
+    // cell search and gather
+    for (std::size_t i=0; i<m; i++) {
+      std::size_t ix0, ix1, iy0, iy1, iz0, iz1;
+      xs_.findIndexPair(x[i], ix0, ix1);
+      ys_.findIndexPair(y[i], iy0, iy1);
+      zs_.findIndexPair(z[i], iz0, iz1);
+      rx[i] = fraction(x[i], get_x(ix0), get_x(ix1), ix0, ix1);
+      ry[i] = fraction(y[i], get_y(iy0), get_y(iy1), iy0, iy1);
+      rz[i] = fraction(z[i], get_z(iz0), get_z(iz1), iz0, iz1);
+      v[0][i] = get_field_value(ix0, iy0, iz0);
+      v[1][i] = get_field_value(ix0, iy0, iz1);
+      v[2][i] = get_field_value(ix0, iy1, iz0);
+      v[3][i] = get_field_value(ix0, iy1, iz1);
+      v[4][i] = get_field_value(ix1, iy0, iz0);
+      v[5][i] = get_field_value(ix1, iy0, iz1);
+      v[6][i] = get_field_value(ix1, iy1, iz0);
+      v[7][i] = get_field_value(ix1, iy1, iz1);
+    }
+
+    // interpolation; this loop has no branch and no gather.
+    for (std::size_t i=0; i<m; i++) {
+      out[i] = trilinear(rx[i], ry[i], rz[i],
+                         v[0][i], v[1][i], v[2][i], v[3][i],
+                         v[4][i], v[5][i], v[6][i], v[7][i]);
+    }
+  }
+}
+
+bool NumericalField::setParameters(const std::vector<double>& v)
+{
+  if (v.size() > MaxParameters) {
+    return false;
+  }
+  parameters_ = v;
+  return true;
+}
+
+bool NumericalField::save(const std::string& filename) const
 {
-  using iter_t = std::vector<double>::const_iterator;
-  const iter_t it = std::upper_bound(as.begin(), as.end(), a);
+  FileHeader header;
+  std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+  header.version = FileVersion;
+  header.byteOrder = ByteOrderMark;
+  header.nx = num_x();
+  header.ny = num_y();
+  header.nz = num_z();
+  header.dataOffset = data_offset(header.nx, header.ny, header.nz);
+  header.numParameters = parameters_.size();
+  std::fill(header.parameters, header.parameters+MaxParameters, 0.0);
+  std::copy(parameters_.begin(), parameters_.end(), header.parameters);
 
-  if (it==as.begin()) {
-    return std::make_tuple(0, 0);
+  std::ofstream fout(filename, std::ios::binary|std::ios::trunc);
+  if (!fout) {
+    return false;
   }
-  else if (it==as.end()) {
-    const std::size_t n = as.size();
-    return std::make_tuple(n-1, n-1);
+  fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fout.write(reinterpret_cast<const char*>(xs_.points.data()), sizeof(double)*num_x());
+  fout.write(reinterpret_cast<const char*>(ys_.points.data()), sizeof(double)*num_y());
+  fout.write(reinterpret_cast<const char*>(zs_.points.data()), sizeof(double)*num_z());
+  const uint64_t padding = header.dataOffset - (sizeof(header) + sizeof(double)*(num_x()+num_y()+num_z()));
+  const char zeros[DataAlignment] = {};
+  fout.write(zeros, padding);
+  fout.write(reinterpret_cast<const char*>(data_), sizeof(double)*num_x()*num_y()*num_z());
+  fout.close();
+  return static_cast<bool>(fout);
+}
+
+bool NumericalField::load(const std::string& filename)
+{
+  auto file = std::make_unique<MappedFile>();
+  if (!file->open(filename)) {
+    return false;
+  }
+
+  if (file->size() < sizeof(FileHeader)) {
+    return false;
+  }
+  FileHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0
+      || header.version != FileVersion
+      || header.byteOrder != ByteOrderMark
+      || header.dataOffset != data_offset(header.nx, header.ny, header.nz)
+      || header.numParameters > MaxParameters
+      || file->size() != header.dataOffset + sizeof(double)*header.nx*header.ny*header.nz) {
+    return false;
   }
 
-  const std::size_t i1 = it-as.begin();
-  return std::make_tuple(i1-1, i1);
+  const double* grids = reinterpret_cast<const double*>(file->data() + sizeof(header));
+  xs_.define(std::vector<double>(grids, grids+header.nx));
+  grids += header.nx;
+  ys_.define(std::vector<double>(grids, grids+header.ny));
+  grids += header.ny;
+  zs_.define(std::vector<double>(grids, grids+header.nz));
+  parameters_.assign(header.parameters, header.parameters+header.numParameters);
+
+  values_.clear();
+  values_.shrink_to_fit();
+  data_ = reinterpret_cast<const double*>(file->data() + header.dataOffset);
+  mappedFile_ = std::move(file);
+  return true;
 }
 
-} /* unnamed namespace */
\ No newline at end of file
+} /* namespace comptonsoft */
@@ -162,6 +162,10 @@ reconstructFullDepositEvent(const std::vector<DetectorHit_sptr>& hits,
                             const BasicComptonEvent& baseEvent,
                             std::vector<BasicComptonEvent_sptr>& eventsReconstructed)
 {
+  if (!Kroger_mode) {
+    return reconstructWithFixedIncidentEnergy(hits, baseEvent, total_energy_deposits_, false, eventsReconstructed);
+  }
+
   bool result = false;
 
   std::vector<int> scattering_order(num_hits_);
@@ -214,6 +218,10 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
                        const BasicComptonEvent& baseEvent,
                        std::vector<BasicComptonEvent_sptr>& eventsReconstructed)
 {
+  if (assume_initial_gammaray_energy) {
+    return reconstructWithFixedIncidentEnergy(hits, baseEvent, known_initial_gammaray_energy, true, eventsReconstructed);
+  }
+
   bool result = false;
 
   std::vector<int> scattering_order(num_hits_);
@@ -231,21 +239,16 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
     }
     
     bool this_result;
-    if (assume_initial_gammaray_energy){
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, known_initial_gammaray_energy, true);
-    }
-    else{
-      double escaped_energy = 0.0;
-      if (use_averaged_escaped_energy) {
-        this_result = estimateAveragedEscapedEnergy(ordered_hits, escaped_energy);
-      } else {
-        this_result = estimateEscapedEnergy(ordered_hits, escaped_energy);
-      }
-      if (!this_result) { continue; }
-      const double corrected_total_energy = total_energy_deposits_ + escaped_energy;
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, corrected_total_energy, true);
+    double escaped_energy = 0.0;
+    if (use_averaged_escaped_energy) {
+      this_result = estimateAveragedEscapedEnergy(ordered_hits, escaped_energy);
+    } else {
+      this_result = estimateEscapedEnergy(ordered_hits, escaped_energy);
     }
-   
+    if (!this_result) { continue; }
+    const double corrected_total_energy = total_energy_deposits_ + escaped_energy;
+    this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, corrected_total_energy, true);
+
     if (this_result) {
       eventReconstructed->setReconstructedOrder(reconstructedOrder);
       eventsReconstructed.push_back(eventReconstructed);
@@ -258,6 +261,11 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
   return result;
 }
 
+double OberlackAlgorithm::energyMarginForScatteringAngle(double energy)
+{
+  return sigma_level_energy_margin_for_checkScatteringAngle_ * getEnergyResolution(energy);
+}
+
 bool OberlackAlgorithm::
 reconstructOrderedHits(const std::vector<DetectorHit_sptr>& ordered_hits,
                        BasicComptonEvent& eventReconstructed,
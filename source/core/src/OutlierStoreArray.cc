@@ -0,0 +1,151 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "OutlierStoreArray.hh"
+#include <algorithm>
+#include <limits>
+
+namespace comptonsoft
+{
+
+OutlierStoreArray::OutlierStoreArray(const std::size_t num_pixels)
+  : num_pixels_(num_pixels)
+{
+}
+
+OutlierStoreArray::~OutlierStoreArray() = default;
+
+void OutlierStoreArray::set_capacities(int low, int high)
+{
+  capacity_low_ = low;
+  capacity_high_ = high;
+  num_ = 0;
+  slots_.assign(capacity()*num_pixels_, 0.0);
+  lowThresholds_.clear();
+  highThresholds_.clear();
+  candidates_.clear();
+}
+
+void OutlierStoreArray::propose(const double* xs)
+{
+  const std::size_t n = num_pixels_;
+  if (num() < capacity()) {
+    const int k = num();
+    for (std::size_t i=0; i<n; i++) {
+      slot(k, i) = xs[i];
+    }
+    ++num_;
+    if (num() == capacity()) {
+      for (std::size_t i=0; i<n; i++) {
+        sortSlots(i, 0, capacity());
+      }
+      updateThresholds();
+    }
+    return;
+  }
+
+  if (capacity() == 0) {
+    return;
+  }
+
+  // screening; this loop has no branch.
+  candidates_.resize(n);
+  std::size_t numCandidates = 0;
+  const double* lows = lowThresholds_.data();
+  const double* highs = highThresholds_.data();
+  for (std::size_t i=0; i<n; i++) {
+    candidates_[numCandidates] = i;
+    numCandidates += static_cast<std::size_t>((xs[i] < lows[i]) | (highs[i] < xs[i]));
+  }
+
+  for (std::size_t c=0; c<numCandidates; c++) {
+    const std::size_t i = candidates_[c];
+    replaceOutliers(i, xs[i]);
+  }
+}
+
+void OutlierStoreArray::sortSlots(const std::size_t i, const int begin, const int end)
+{
+  double* s = &slots_[i*capacity()];
+  std::sort(s+begin, s+end);
+}
+
+void OutlierStoreArray::updateThresholds()
+{
+  const std::size_t n = num_pixels_;
+  const double infinity = std::numeric_limits<double>::infinity();
+  lowThresholds_.assign(n, -infinity);
+  highThresholds_.assign(n, +infinity);
+  for (std::size_t i=0; i<n; i++) {
+    if (capacity_low() != 0) {
+      lowThresholds_[i] = slot(capacity_low()-1, i);
+    }
+    if (capacity_high() != 0) {
+      highThresholds_[i] = slot(capacity_low(), i);
+    }
+  }
+}
+
+void OutlierStoreArray::replaceOutliers(const std::size_t i, const double x)
+{
+  // The slots stay sorted as OutlierStore does with std::sort().
+  if (capacity_low()!=0) {
+    const int last = capacity_low()-1;
+    if (x < slot(last, i)) {
+      int k = last;
+      while (k > 0 && x < slot(k-1, i)) {
+        slot(k, i) = slot(k-1, i);
+        --k;
+      }
+      slot(k, i) = x;
+      lowThresholds_[i] = slot(last, i);
+    }
+  }
+  if (capacity_high()!=0) {
+    const int first = capacity_low();
+    if (slot(first, i) < x) {
+      int k = first;
+      while (k < capacity()-1 && slot(k+1, i) < x) {
+        slot(k, i) = slot(k+1, i);
+        ++k;
+      }
+      slot(k, i) = x;
+      highThresholds_[i] = slot(first, i);
+    }
+  }
+}
+
+void OutlierStoreArray::sums(double* sums, double* sums2) const
+{
+  const std::size_t n = num_pixels_;
+  // same order of additions as std::accumulate() over the slots of a pixel
+  for (std::size_t i=0; i<n; i++) {
+    double sum = 0.0;
+    double sum2 = 0.0;
+    for (int k=0; k<num(); k++) {
+      const double x = slot(k, i);
+      sum += x;
+      sum2 += x*x;
+    }
+    sums[i] = sum;
+    sums2[i] = sum2;
+  }
+}
+
+} /* namespace comptonsoft */
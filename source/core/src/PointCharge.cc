@@ -18,12 +18,15 @@
  *************************************************************************/
 
 #include "PointCharge.hh"
+#include <cmath>
+#include <algorithm>
 
 namespace comptonsoft {
 
 PointCharge::PointCharge()
   : signals_(boost::extents[PixelExtenstion][PixelExtenstion]),
-    shifts_(boost::extents[PixelExtenstion][PixelExtenstion])
+    shifts_(boost::extents[PixelExtenstion][PixelExtenstion]),
+    wp0_(boost::extents[PixelExtenstion][PixelExtenstion])
 {
 }
 
@@ -42,6 +45,14 @@ void PointCharge::setPixelSeparations(const double x, const double y)
   shifts_[2][2] = vector3_t(+x,   +y, 0.0);
 }
 
+void PointCharge::setAdaptiveStep(const double minStep, const double maxStep, const double tolerance)
+{
+  adaptiveStep_ = true;
+  minStep_ = minStep;
+  maxStep_ = maxStep;
+  stepTolerance_ = tolerance;
+}
+
 boost::multi_array<double, 2> PointCharge::transport(const double dl)
 {
   {
@@ -52,10 +63,25 @@ boost::multi_array<double, 2> PointCharge::transport(const double dl)
     }
   }
 
-  while (true) {
-    advance(dl);
+  // The weighting potentials at the end of a step are kept for the next step.
+  for (int i=0; i<PixelExtenstion; i++) {
+    for (int j=0; j<PixelExtenstion; j++) {
+      wp0_[i][j] = field_->WeightingPotential(position_ + shifts_[i][j]);
+    }
+  }
+
+  double step = dl;
+  double previousStep = 0.0;
+  for (int numSteps=1; ; numSteps++) {
+    advance(step);
     if (t_ > endingTime_) { break; }
     if (goal_->isReached(position_)) { break; }
+
+    // velocity_ and velocity0_ are evaluated at the starting points of the
+    // last two steps, which are separated by the previous step length.
+    const double nextStep = (isAdaptiveStep() && numSteps >= 2) ? nextStepLength(previousStep) : step;
+    previousStep = step;
+    step = nextStep;
   }
   return signals_;
 }
@@ -64,29 +90,47 @@ void PointCharge::advance(const double dl)
 {
   t0_ = t_;
   position0_ = position_;
+  velocity0_ = velocity_;
 
-  const vector3_t velocity = field_->ChargeVelocity(position_);
-  const double v = velocity.mag();
+  velocity_ = field_->ChargeVelocity(position_);
+  const double v = velocity_.mag();
   const double tau = field_->Lifetime();
   const double dt = (v != 0.0) ? (dl/v) : tau;
   
   t_ += dt;
-  position_ += velocity*dt;
-  position_ += field_->Diffusion(dt);
+  position_ += velocity_*dt;
+  if (randomGenerator_) {
+    position_ += field_->Diffusion(dt, *randomGenerator_);
+  }
+  else {
+    position_ += field_->Diffusion(dt);
+  }
   
   integrateSignals();
   effectiveQ_ *= std::exp(-dt/tau);
 }
 
+double PointCharge::nextStepLength(const double dl) const
+{
+  // change of the drift velocity over the distance dl
+  const double dv = (velocity_ - velocity0_).mag();
+  const double v = velocity_.mag();
+  if (dv == 0.0) {
+    return maxStep_;
+  }
+
+  const double step = stepTolerance_ * v * dl / dv;
+  return std::min(std::max(step, minStep_), maxStep_);
+}
+
 void PointCharge::integrateSignals()
 {
   for (int i=0; i<PixelExtenstion; i++) {
     for (int j=0; j<PixelExtenstion; j++) {
-      const vector3_t r1 = position_  + shifts_[i][j];
-      const vector3_t r0 = position0_ + shifts_[i][j];
+      const vector3_t r1 = position_ + shifts_[i][j];
       const double wp1 = field_->WeightingPotential(r1);
-      const double wp0 = field_->WeightingPotential(r0);
-      signals_[i][j] += effectiveQ_*(wp1-wp0);
+      signals_[i][j] += effectiveQ_*(wp1-wp0_[i][j]);
+      wp0_[i][j] = wp1;
     }
   }
 }
@@ -0,0 +1,232 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "PointChargePacket.hh"
+#include <cmath>
+#include <algorithm>
+
+namespace comptonsoft {
+
+PointChargePacket::PointChargePacket()
+{
+  shiftX_.fill(0.0);
+  shiftY_.fill(0.0);
+  signals_.fill(0.0);
+}
+
+PointChargePacket::~PointChargePacket() = default;
+
+void PointChargePacket::setPixelSeparations(const double x, const double y)
+{
+  for (int i=0; i<PixelExtenstion; i++) {
+    for (int j=0; j<PixelExtenstion; j++) {
+      shiftX_[i*PixelExtenstion+j] = (i-1)*x;
+      shiftY_[i*PixelExtenstion+j] = (j-1)*y;
+    }
+  }
+}
+
+void PointChargePacket::setAdaptiveStep(const double minStep, const double maxStep, const double tolerance)
+{
+  adaptiveStep_ = true;
+  minStep_ = minStep;
+  maxStep_ = maxStep;
+  stepTolerance_ = tolerance;
+}
+
+void PointChargePacket::clear()
+{
+  x_.clear();
+  y_.clear();
+  z_.clear();
+  t_.clear();
+  effectiveQ_.clear();
+}
+
+void PointChargePacket::addCarrier(const vector3_t& position, const double effectiveQ)
+{
+  x_.push_back(position.x());
+  y_.push_back(position.y());
+  z_.push_back(position.z());
+  t_.push_back(0.0);
+  effectiveQ_.push_back(effectiveQ);
+}
+
+void PointChargePacket::addCarriers(const vector3_t& position, const double effectiveQ, const int n)
+{
+  for (int k=0; k<n; k++) {
+    addCarrier(position, effectiveQ);
+  }
+}
+
+boost::multi_array<double, 2> PointChargePacket::transport(const double dl)
+{
+  const int n = NumberOfCarriers();
+  vx_.assign(n, 0.0);
+  vy_.assign(n, 0.0);
+  vz_.assign(n, 0.0);
+  vx0_.assign(n, 0.0);
+  vy0_.assign(n, 0.0);
+  vz0_.assign(n, 0.0);
+  dt_.assign(n, 0.0);
+  step_.assign(n, dl);
+  previousStep_.assign(n, 0.0);
+  numSteps_.assign(n, 0);
+  wp0_.resize(NumShifts*n);
+  signals_.fill(0.0);
+
+  active_.resize(n);
+  for (int k=0; k<n; k++) {
+    active_[k] = k;
+  }
+
+  for (int s=0; s<NumShifts; s++) {
+    double* wp0 = &wp0_[s*n];
+    for (int k=0; k<n; k++) {
+      wp0[k] = field_->WeightingPotential(vector3_t(x_[k]+shiftX_[s], y_[k]+shiftY_[s], z_[k]));
+    }
+  }
+
+  while (!active_.empty()) {
+    computeVelocities();
+    move();
+    integrateSignals();
+    removeFinishedCarriers();
+    if (isAdaptiveStep()) {
+      updateStepLengths();
+    }
+  }
+
+  boost::multi_array<double, 2> signals(boost::extents[PixelExtenstion][PixelExtenstion]);
+  for (int i=0; i<PixelExtenstion; i++) {
+    for (int j=0; j<PixelExtenstion; j++) {
+      signals[i][j] = signals_[i*PixelExtenstion+j];
+    }
+  }
+  return signals;
+}
+
+void PointChargePacket::computeVelocities()
+{
+  for (const int k: active_) {
+    vx0_[k] = vx_[k];
+    vy0_[k] = vy_[k];
+    vz0_[k] = vz_[k];
+    const vector3_t v = field_->ChargeVelocity(vector3_t(x_[k], y_[k], z_[k]));
+    vx_[k] = v.x();
+    vy_[k] = v.y();
+    vz_[k] = v.z();
+  }
+}
+
+void PointChargePacket::move()
+{
+  const double tau = field_->Lifetime();
+  for (const int k: active_) {
+    const double v = std::sqrt(vx_[k]*vx_[k] + vy_[k]*vy_[k] + vz_[k]*vz_[k]);
+    const double dt = (v != 0.0) ? (step_[k]/v) : tau;
+    dt_[k] = dt;
+    t_[k] += dt;
+    x_[k] += vx_[k]*dt;
+    y_[k] += vy_[k]*dt;
+    z_[k] += vz_[k]*dt;
+  }
+
+  // diffusion draws are made in the order of the carriers.
+  for (const int k: active_) {
+    const vector3_t d = randomGenerator_
+      ? field_->Diffusion(dt_[k], *randomGenerator_)
+      : field_->Diffusion(dt_[k]);
+    x_[k] += d.x();
+    y_[k] += d.y();
+    z_[k] += d.z();
+  }
+}
+
+void PointChargePacket::integrateSignals()
+{
+  const int n = NumberOfCarriers();
+  const std::size_t m = active_.size();
+  queryX_.resize(m);
+  queryY_.resize(m);
+  queryZ_.resize(m);
+  wp1_.resize(m);
+  for (std::size_t a=0; a<m; a++) {
+    queryZ_[a] = z_[active_[a]];
+  }
+
+  for (int s=0; s<NumShifts; s++) {
+    for (std::size_t a=0; a<m; a++) {
+      const int k = active_[a];
+      queryX_[a] = x_[k] + shiftX_[s];
+      queryY_[a] = y_[k] + shiftY_[s];
+    }
+    field_->WeightingPotential(queryX_.data(), queryY_.data(), queryZ_.data(), wp1_.data(), m);
+
+    double* wp0 = &wp0_[s*n];
+    double signal = 0.0;
+    for (std::size_t a=0; a<m; a++) {
+      const int k = active_[a];
+      signal += effectiveQ_[k]*(wp1_[a]-wp0[k]);
+      wp0[k] = wp1_[a];
+    }
+    signals_[s] += signal;
+  }
+
+  const double tau = field_->Lifetime();
+  for (const int k: active_) {
+    effectiveQ_[k] *= std::exp(-dt_[k]/tau);
+  }
+}
+
+void PointChargePacket::removeFinishedCarriers()
+{
+  auto finished = [this](const int k) {
+    if (t_[k] > endingTime_) { return true; }
+    return goal_->isReached(vector3_t(x_[k], y_[k], z_[k]));
+  };
+  active_.erase(std::remove_if(active_.begin(), active_.end(), finished), active_.end());
+}
+
+void PointChargePacket::updateStepLengths()
+{
+  // same rule as PointCharge::nextStepLength(); the velocities are those at
+  // the starting points of the last two steps.
+  for (const int k: active_) {
+    const int numSteps = ++numSteps_[k];
+    const double step = step_[k];
+    if (numSteps >= 2) {
+      const double dx = vx_[k]-vx0_[k];
+      const double dy = vy_[k]-vy0_[k];
+      const double dz = vz_[k]-vz0_[k];
+      const double dv = std::sqrt(dx*dx + dy*dy + dz*dz);
+      if (dv == 0.0) {
+        step_[k] = maxStep_;
+      }
+      else {
+        const double v = std::sqrt(vx_[k]*vx_[k] + vy_[k]*vy_[k] + vz_[k]*vz_[k]);
+        const double nextStep = stepTolerance_ * v * previousStep_[k] / dv;
+        step_[k] = std::min(std::max(nextStep, minStep_), maxStep_);
+      }
+    }
+    previousStep_[k] = step;
+  }
+}
+
+} /* namespace comptonsoft */
@@ -18,6 +18,7 @@
  *************************************************************************/
 
 #include "RectangularGoalRegion.hh"
+#include <sstream>
 
 namespace comptonsoft {
 
@@ -44,4 +45,16 @@ bool RectangularGoalRegion::isReached(const vector3_t& position)
   return false;
 }
 
+std::string RectangularGoalRegion::description() const
+{
+  std::ostringstream os;
+  os.precision(17);
+  for (const region_t& r: regions_) {
+    os << "[" << std::get<0>(r) << "," << std::get<1>(r)
+       << "," << std::get<2>(r) << "," << std::get<3>(r)
+       << "," << std::get<4>(r) << "," << std::get<5>(r) << "]";
+  }
+  return os.str();
+}
+
 } /* namespace comptonsoft */
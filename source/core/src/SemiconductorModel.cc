@@ -20,13 +20,41 @@
 #include "SemiconductorModel.hh"
 
 #include <iostream>
+#include "TFile.h"
+#include "TH3.h"
+#include "TDirectory.h"
 #include "AstroUnits.hh"
 #include "NumericalField.hh"
+#include "VectorFieldTable.hh"
 #include "WeightingPotentialPixel.hh"
 
 namespace unit = anlgeant4::unit;
 namespace constant = anlgeant4::constant;
 
+namespace {
+
+bool has_grids(const comptonsoft::NumericalField& field,
+               const std::vector<double>& xs,
+               const std::vector<double>& ys,
+               const std::vector<double>& zs)
+{
+  if (field.num_x() != xs.size() || field.num_y() != ys.size() || field.num_z() != zs.size()) {
+    return false;
+  }
+  for (std::size_t i=0; i<xs.size(); i++) {
+    if (field.get_x(i) != xs[i]) { return false; }
+  }
+  for (std::size_t i=0; i<ys.size(); i++) {
+    if (field.get_y(i) != ys[i]) { return false; }
+  }
+  for (std::size_t i=0; i<zs.size(); i++) {
+    if (field.get_z(i) != zs[i]) { return false; }
+  }
+  return true;
+}
+
+} /* anonymous namespace */
+
 namespace comptonsoft {
 
 SemiconductorModel::SemiconductorModel()
@@ -44,12 +72,7 @@ SemiconductorModel::SemiconductorModel()
   diffusionCoefficient_ = constant::k_Boltzmann*temperature_*mobility_/constant::eplus;
 }
 
-SemiconductorModel::~SemiconductorModel()
-{
-  if (file_.get()) {
-    file_->Close();
-  }
-}
+SemiconductorModel::~SemiconductorModel() = default;
 
 void SemiconductorModel::setPixelDimensions(double x, double y, double z)
 {
@@ -72,33 +95,89 @@ void SemiconductorModel::setProperties(const bool carrier_positive,
 
   // D = kTmu/q
   diffusionCoefficient_ = constant::k_Boltzmann*temperature_*mobility_/constant::eplus;
+  velocityField_.reset();
 }
 
 void SemiconductorModel::setVelocitySaturation(double efield)
 {
   saturationMode_ = true;
   saturationEField_ = efield;
+  velocityField_.reset();
 }
 
 void SemiconductorModel::unsetVelocitySaturation()
 {
   saturationMode_ = false;
   saturationEField_ = 0.0;
+  velocityField_.reset();
 }
 
 void SemiconductorModel::load(const std::string& filename)
 {
-  file_ = std::make_unique<TFile>(filename.c_str());
-  fx_ = static_cast<TH3D*>(file_->Get("efieldx"));
-  fy_ = static_cast<TH3D*>(file_->Get("efieldy"));
-  fz_ = static_cast<TH3D*>(file_->Get("efieldz"));
+  EField_.reset();
+  velocityField_.reset();
+
+  TDirectory::TContext directoryContext;
+  std::unique_ptr<TFile> file(TFile::Open(filename.c_str()));
+  if (!file || file->IsZombie()) {
+    std::cout << "SemiconductorModel: file " << filename << " cannot be opened." << std::endl;
+    return;
+  }
+
+  const TH3* fx = dynamic_cast<TH3*>(file->Get("efieldx"));
+  const TH3* fy = dynamic_cast<TH3*>(file->Get("efieldy"));
+  const TH3* fz = dynamic_cast<TH3*>(file->Get("efieldz"));
+  if (fx == nullptr || fy == nullptr || fz == nullptr) {
+    std::cout << "SemiconductorModel: file " << filename << " does not have efieldx/y/z." << std::endl;
+    return;
+  }
+
+  auto table = std::make_unique<VectorFieldTable>();
+  if (!table->build(*fx, *fy, *fz, unit::volt/unit::cm)) {
+    std::cout << "SemiconductorModel: efieldx/y/z in " << filename << " have different binnings." << std::endl;
+    return;
+  }
+  EField_ = std::move(table);
+}
+
+void SemiconductorModel::setEFieldInterpolation(const bool v)
+{
+  EFieldInterpolation_ = v;
+}
+
+void SemiconductorModel::precomputeChargeVelocity()
+{
+  if (!EField_) {
+    return;
+  }
+  velocityField_ = std::make_unique<VectorFieldTable>(*EField_);
+  velocityField_->transform([this](const vector3_t& Evec) { return ChargeVelocityAtEField(Evec); });
 }
 
 void SemiconductorModel::
 useAccurateWeightingPotential(const std::vector<double>& grids_x,
                               const std::vector<double>& grids_y,
-                              const std::vector<double>& grids_z)
+                              const std::vector<double>& grids_z,
+                              const std::string& filename)
 {
+  // A table depends on the pixel geometry and the readout side as well as the grids.
+  const std::vector<double> parameters = {
+    pixelWidthX_, pixelWidthY_, thickness_, isUpsideReadout() ? 1.0 : 0.0
+  };
+
+  if (filename != "") {
+    auto field = std::make_unique<NumericalField>();
+    if (field->load(filename)) {
+      if (has_grids(*field, grids_x, grids_y, grids_z) && field->Parameters() == parameters) {
+        std::cout << "Weighting potentials are loaded from " << filename << std::endl;
+        WPField_ = std::move(field);
+        return;
+      }
+      std::cout << "Weighting potentials in " << filename
+                << " are for a different geometry; they are calculated again." << std::endl;
+    }
+  }
+
   auto WPModel = std::make_unique<WeightingPotentialPixel>();
   WPModel->setGeometry(pixelWidthX_, pixelWidthY_, thickness_);
   WPModel->initializeTable();
@@ -106,6 +185,7 @@ useAccurateWeightingPotential(const std::vector<double>& grids_x,
   WPField_ = std::make_unique<NumericalField>();
   WPField_->defineGrids(grids_x, grids_y, grids_z);
   WPField_->setZeros();
+  WPField_->setParameters(parameters);
   const std::size_t nx = WPField_->num_x();
   const std::size_t ny = WPField_->num_y();
   const std::size_t nz = WPField_->num_z();
@@ -153,6 +233,12 @@ useAccurateWeightingPotential(const std::vector<double>& grids_x,
     }
   }
   std::cout << std::endl;
+
+  if (filename != "") {
+    if (!WPField_->save(filename)) {
+      std::cout << "Warning: weighting potentials cannot be saved to " << filename << std::endl;
+    }
+  }
 }
 
 void SemiconductorModel::setRandomSeed(uint32_t seed)
@@ -162,27 +248,40 @@ void SemiconductorModel::setRandomSeed(uint32_t seed)
 
 vector3_t SemiconductorModel::EField(const vector3_t& position) const
 {
-  const int binx = fx_->GetXaxis()->FindBin(position.x()/unit::cm);
-  const int biny = fx_->GetYaxis()->FindBin(position.y()/unit::cm);
-  const int binz = fx_->GetZaxis()->FindBin(position.z()/unit::cm);
-  const double ex = fx_->GetBinContent(binx, biny, binz) * unit::volt/unit::cm;
-  const double ey = fy_->GetBinContent(binx, biny, binz) * unit::volt/unit::cm;
-  const double ez = fz_->GetBinContent(binx, biny, binz) * unit::volt/unit::cm;
-  return vector3_t(ex, ey, ez);
+  const double x = position.x()/unit::cm;
+  const double y = position.y()/unit::cm;
+  const double z = position.z()/unit::cm;
+  if (isEFieldInterpolation()) {
+    return EField_->trilinear(x, y, z);
+  }
+  return EField_->nearest(x, y, z);
 }
 
 vector3_t SemiconductorModel::ChargeVelocity(const vector3_t& position) const
+{
+  if (velocityField_) {
+    const double x = position.x()/unit::cm;
+    const double y = position.y()/unit::cm;
+    const double z = position.z()/unit::cm;
+    if (isEFieldInterpolation()) {
+      return velocityField_->trilinear(x, y, z);
+    }
+    return velocityField_->nearest(x, y, z);
+  }
+
+  return ChargeVelocityAtEField(EField(position));
+}
+
+vector3_t SemiconductorModel::ChargeVelocityAtEField(const vector3_t& Evec) const
 {
   vector3_t velocity;
   if (SaturationMode()) {
-    const vector3_t Evec = EField(position);
     const double E = Evec.mag();
     const double Es = SaturationEField();
     const double muEffective = Mobility()*Es/(E+Es);
     velocity = muEffective*Evec;
   }
   else {
-    const vector3_t Evec = EField(position);
     velocity = Mobility()*Evec;
   }
 
@@ -209,11 +308,23 @@ double SemiconductorModel::WeightingPotential(const vector3_t& position) const
   return WeightingPotentialPlaneParallel(z);
 }
 
+void SemiconductorModel::WeightingPotential(const double* xs, const double* ys, const double* zs,
+                                            double* wp, const std::size_t n) const
+{
+  if (WPField_.get()) {
+    WPField_->field(xs, ys, zs, wp, n);
+    return;
+  }
+
+  for (std::size_t i=0; i<n; i++) {
+    wp[i] = WeightingPotential(vector3_t(xs[i], ys[i], zs[i]));
+  }
+}
+
 double SemiconductorModel::WeightingPotentialPlaneParallel(double z) const
 {
-  const int nz = fx_->GetNbinsZ();
-  const double z0 = fx_->GetZaxis()->GetBinLowEdge(1) * unit::cm;
-  const double z1 = fx_->GetZaxis()->GetBinUpEdge(nz) * unit::cm;
+  const double z0 = EField_->MinimumZ() * unit::cm;
+  const double z1 = EField_->MaximumZ() * unit::cm;
 
   double wp = 0.0;
   if (isUpsideReadout()) {
@@ -227,14 +338,19 @@ double SemiconductorModel::WeightingPotentialPlaneParallel(double z) const
 }
 
 vector3_t SemiconductorModel::Diffusion(const double t)
+{
+  return Diffusion(t, randomGenerator_);
+}
+
+vector3_t SemiconductorModel::Diffusion(const double t, std::mt19937& generator) const
 {
   const double D = DiffusionCoefficient();
   const double spreadFactor = SpreadFactor();
   const double sigma = std::sqrt(2.0*D*t) * spreadFactor;
   std::normal_distribution<double> sampleGaussian(0.0, sigma);
-  const double dx = sampleGaussian(randomGenerator_);
-  const double dy = sampleGaussian(randomGenerator_);
-  const double dz = sampleGaussian(randomGenerator_);
+  const double dx = sampleGaussian(generator);
+  const double dy = sampleGaussian(generator);
+  const double dz = sampleGaussian(generator);
   return vector3_t(dx, dy, dz);
 }
 
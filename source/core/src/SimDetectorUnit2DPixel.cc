@@ -23,6 +23,7 @@
 #include <iostream>
 #include <algorithm>
 #include <memory>
+#include <vector>
 #include <cmath>
 #include <boost/format.hpp>
 
@@ -35,6 +36,8 @@
 #include "FlagDefinition.hh"
 #include "DetectorHit.hh"
 #include "WeightingPotentialPixel.hh"
+#include "ChargeCollectionMapCache.hh"
+#include "ParallelFor.hh"
 
 namespace unit = anlgeant4::unit;
 
@@ -289,6 +292,21 @@ void SimDetectorUnit2DPixel::buildWPMap(int nx, int ny, int nz,
     }
   }
   
+  const std::string cacheDescription
+    = (boost::format("2DPixel WP nx=%d ny=%d nz=%d pixel_factor=%.17g pitch=%.17g,%.17g "
+                     "thickness=%.17g num_pixels=%.17g upside_readout=%d")
+       % nx % ny % nz % pixel_factor % getPixelPitchX() % getPixelPitchY()
+       % getThickness() % NumPixelsInWPCalculation() % isUpSideReadout()).str();
+  ChargeCollectionMapCache* cache = getChargeCollectionMapCache();
+  if (cache) {
+    const std::vector<TH1*> maps = cache->find(cacheDescription, 1);
+    if (!maps.empty()) {
+      WPMap_ = static_cast<TH3D*>(maps[0]);
+      WPMapDescription_ = cacheDescription;
+      return;
+    }
+  }
+
   const std::string histname = (boost::format("wp_%04d")%getID()).str();
   WPMap_ =  new TH3D(histname.c_str(), histname.c_str(),
                      nx, -0.5*MapSizeX/unit::cm, +0.5*MapSizeX/unit::cm,
@@ -299,55 +317,55 @@ void SimDetectorUnit2DPixel::buildWPMap(int nx, int ny, int nz,
   wpModel->setGeometry(getPixelPitchX(), getPixelPitchY(), getThickness(),
                        NumPixelsInWPCalculation());
   wpModel->initializeTable();
+
+  // The inner depths are calculated by the model; the electrode surfaces are
+  // given by the boundary conditions.
+  const bool upside = isUpSideReadout();
+  const int izElectrode = upside ? nz : 1;
+  std::vector<double> zInner(nz-2);
+  for (int iz=2; iz<=nz-1; iz++) {
+    const double z = WPMap_->GetZaxis()->GetBinCenter(iz) * unit::cm;
+    zInner[iz-2] = upside ? z : -z;
+  }
+
+  // buffer[((ix-1)*ny + (iy-1))*nz + (iz-1)]
+  std::vector<double> buffer(nx*ny*nz, 0.0);
+  const TAxis* xaxis = WPMap_->GetXaxis();
+  const TAxis* yaxis = WPMap_->GetYaxis();
+  const double halfPitchX = 0.5*getPixelPitchX();
+  const double halfPitchY = 0.5*getPixelPitchY();
+
   std::cout << "calculating weighing potential..." << std::endl;
+  parallelFor(0, nx*ny, NumThreadsInMapCalculation(),
+              [&](int index, int) {
+                const int ix = index/ny + 1;
+                const int iy = index%ny + 1;
+                const double x = xaxis->GetBinCenter(ix) * unit::cm;
+                const double y = yaxis->GetBinCenter(iy) * unit::cm;
+                double* wp = &buffer[index*nz];
+                wpModel->calculateWeightingPotential(x, y, zInner.data(), wp+1, nz-2);
+                if (std::abs(x)<halfPitchX && std::abs(y)<halfPitchY) {
+                  wp[izElectrode-1] = 1.;
+                }
+                if (iy==ny) {
+                  std::cout << '*' << std::flush;
+                }
+              });
+
   for (int ix=1; ix<=nx; ix++) {
-    std::cout << '*' << std::flush;
-    const double x = WPMap_->GetXaxis()->GetBinCenter(ix) * unit::cm;
     for (int iy=1; iy<=ny; iy++) {
-      const double y = WPMap_->GetYaxis()->GetBinCenter(iy) * unit::cm;
-      wpModel->setXY(x, y);
+      const double* wp = &buffer[((ix-1)*ny + (iy-1))*nz];
       for (int iz=1; iz<=nz; iz++) {
-        const double z = WPMap_->GetZaxis()->GetBinCenter(iz) * unit::cm;
-        if (isUpSideReadout()) {
-          double wp = 0.;
-          if (iz==nz) {
-            if (std::abs(x)<0.5*getPixelPitchX() && std::abs(y)<0.5*getPixelPitchY()) {
-              wp = 1.;
-            }
-            else {
-              wp = 0.;
-            }
-          }
-          else if (iz==1) {
-            wp = 0.;
-          }
-          else {
-            wp = wpModel->calculateWeightingPotential(z);
-          }
-          WPMap_->SetBinContent(ix, iy, iz, wp);
-        }
-        else {
-          double wp = 0.;
-          if (iz==1) {
-            if (std::abs(x)<0.5*getPixelPitchX() && std::abs(y)<0.5*getPixelPitchY()) {
-              wp = 1.;
-            }
-            else {
-              wp = 0.;
-            }
-          }
-          else if (iz==nz) {
-            wp = 0.;
-          }
-          else {
-            wp = wpModel->calculateWeightingPotential(-z);
-          }
-          WPMap_->SetBinContent(ix, iy, iz, wp);
-        }
+        WPMap_->SetBinContent(ix, iy, iz, wp[iz-1]);
       }
     }
   }
   std::cout << std::endl;
+
+  WPMapDescription_ = cacheDescription;
+  if (cache) {
+    cache->store(cacheDescription, {WPMap_});
+  }
 }
 
 void SimDetectorUnit2DPixel::buildCCEMap()
@@ -387,6 +405,22 @@ void SimDetectorUnit2DPixel::buildCCEMap(int nx, int ny, int nz,
     }
   }
   
+  // The CCE map can be cached only when the WP map is described.
+  std::string cacheDescription;
+  ChargeCollectionMapCache* cache = nullptr;
+  if (getChargeCollectionMapCache() && !WPMapDescription_.empty()) {
+    cacheDescription
+      = (boost::format("2DPixel CCE nx=%d ny=%d nz=%d pixel_factor=%.17g pitch=%.17g,%.17g symmetry=%d; %s; %s")
+         % nx % ny % nz % pixel_factor % getPixelPitchX() % getPixelPitchY()
+         % isUsingSymmetry() % WPMapDescription_ % ChargeTransportDescription()).str();
+    cache = getChargeCollectionMapCache();
+    const std::vector<TH1*> maps = cache->find(cacheDescription, 1);
+    if (!maps.empty()) {
+      CCEMap_ = static_cast<TH3D*>(maps[0]);
+      return;
+    }
+  }
+
   const std::string histname = (boost::format("cce_%04d")%getID()).str();
   CCEMap_ =  new TH3D(histname.c_str(), histname.c_str(),
                       nx, -0.5*MapSizeX/unit::cm, +0.5*MapSizeX/unit::cm,
@@ -394,57 +428,88 @@ void SimDetectorUnit2DPixel::buildCCEMap(int nx, int ny, int nz,
                       nz, -0.5*MapSizeZ/unit::cm, +0.5*MapSizeZ/unit::cm);
   
   std::cout << "calculating charge collection efficiency..." << std::endl;
-  
-  for (int ix=1; ix<=nx; ix++) {
-    std::cout << '*' << std::flush;
-    for (int iy=1; iy<=ny; iy++) {
-      if (!isUsingSymmetry() || (ix<=(nx+1)/2 && iy<=(ny+1)/2)) {
-        const double x_in_cm = CCEMap_->GetXaxis()->GetBinCenter(ix);
-        const double y_in_cm = CCEMap_->GetYaxis()->GetBinCenter(iy);
-        const int binx = WPMap_->GetXaxis()->FindBin(x_in_cm);
-        const int biny = WPMap_->GetYaxis()->FindBin(y_in_cm);
-
-        const int numPoints = nz+1;
-        boost::shared_array<double> wp(new double[numPoints]);
-        for (int k=0; k<numPoints; k++) {
-          const double z_in_cm = CCEMap_->GetZaxis()->GetBinLowEdge(k+1);
-          const int binz = WPMap_->GetZaxis()->FindBin(z_in_cm);
-          wp[k] = WPMap_->GetBinContent(binx, biny, binz);
-        }
-        setWeightingPotential(isUpSideReadout(), wp, numPoints);
 
-        for (int iz=1; iz<=nz; iz++) {
-          const double z = CCEMap_->GetZaxis()->GetBinCenter(iz) * unit::cm;
-          const double cce = calculateCCE(z);
-          CCEMap_->SetBinContent(ix, iy, iz, cce);
-        }
-      }
-    }
-  }
+  // buffer[((ix-1)*ny + (iy-1))*nz + (iz-1)]
+  std::vector<double> buffer(nx*ny*nz, 0.0);
+  const TH3D* wpMap = WPMap_;
+  const TAxis* xaxis = CCEMap_->GetXaxis();
+  const TAxis* yaxis = CCEMap_->GetYaxis();
+  const TAxis* zaxis = CCEMap_->GetZaxis();
+  const bool upside = isUpSideReadout();
+  const EFieldModel& fieldPrototype = getEFieldModel();
+
+  parallelFor(0, nx*ny, NumThreadsInMapCalculation(),
+              [&](int index, int) {
+                const int ix = index/ny + 1;
+                const int iy = index%ny + 1;
+                if (iy==ny) {
+                  std::cout << '*' << std::flush;
+                }
+                if (isUsingSymmetry() && !(ix<=(nx+1)/2 && iy<=(ny+1)/2)) {
+                  return;
+                }
+
+                const double x_in_cm = xaxis->GetBinCenter(ix);
+                const double y_in_cm = yaxis->GetBinCenter(iy);
+                const int binx = wpMap->GetXaxis()->FindFixBin(x_in_cm);
+                const int biny = wpMap->GetYaxis()->FindFixBin(y_in_cm);
+
+                const int numPoints = nz+1;
+                boost::shared_array<double> wp(new double[numPoints]);
+                for (int k=0; k<numPoints; k++) {
+                  const double z_in_cm = zaxis->GetBinLowEdge(k+1);
+                  const int binz = wpMap->GetZaxis()->FindFixBin(z_in_cm);
+                  wp[k] = wpMap->GetBinContent(binx, biny, binz);
+                }
+
+                // each thread uses its own copy of the field model.
+                EFieldModel field(fieldPrototype);
+                field.setUpSideReadElectrode(upside);
+                field.setWeightingPotential(wp, numPoints);
+
+                double* cce = &buffer[index*nz];
+                for (int iz=1; iz<=nz; iz++) {
+                  const double z = zaxis->GetBinCenter(iz) * unit::cm;
+                  cce[iz-1] = field.CCE(z);
+                }
+              });
+
+  auto bufferIndex = [nx, ny, nz](int ix, int iy, int iz) {
+    return ((ix-1)*ny + (iy-1))*nz + (iz-1);
+  };
 
   if (isUsingSymmetry()) {
     for (int ix=1; ix<=nx; ix++) {
       for (int iy=1; iy<=ny; iy++) {
         for (int iz=1; iz<=nz; iz++) {
           if (ix>(nx+1)/2 && iy<=(ny+1)/2) {
-            const double cce = CCEMap_->GetBinContent(nx-ix+1, iy, iz);
-            CCEMap_->SetBinContent(ix, iy, iz, cce);
+            buffer[bufferIndex(ix, iy, iz)] = buffer[bufferIndex(nx-ix+1, iy, iz)];
           }
           else if (ix<=(nx+1)/2 && iy>(ny+1)/2) {
-            const double cce = CCEMap_->GetBinContent(ix, ny-iy+1, iz);
-            CCEMap_->SetBinContent(ix, iy, iz, cce);
+            buffer[bufferIndex(ix, iy, iz)] = buffer[bufferIndex(ix, ny-iy+1, iz)];
           }
           else if (ix>(ny+1)/2 && iy>(ny+1)/2) {
-            const double cce = CCEMap_->GetBinContent(nx-ix+1, ny-iy+1, iz);
-            CCEMap_->SetBinContent(ix, iy, iz, cce);
+            buffer[bufferIndex(ix, iy, iz)] = buffer[bufferIndex(nx-ix+1, ny-iy+1, iz)];
           }
         }
       }
     }
   }
 
+  for (int ix=1; ix<=nx; ix++) {
+    for (int iy=1; iy<=ny; iy++) {
+      for (int iz=1; iz<=nz; iz++) {
+        CCEMap_->SetBinContent(ix, iy, iz, buffer[bufferIndex(ix, iy, iz)]);
+      }
+    }
+  }
+
   std::cout << std::endl;
   std::cout << "Charge collection efficiency map is built." << std::endl;
+
+  if (cache) {
+    cache->store(cacheDescription, {CCEMap_});
+  }
 }
 
 void SimDetectorUnit2DPixel::printSimulationParameters(std::ostream& os) const
@@ -21,14 +21,18 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 #include <cmath>
 #include <boost/format.hpp>
 #include "TRandom3.h"
+#include "CLHEP/Units/PhysicalConstants.h"
 
 #include "AstroUnits.hh"
 #include "FlagDefinition.hh"
 #include "DetectorHit.hh"
 #include "WeightingPotentialStrip.hh"
+#include "ChargeCollectionMapCache.hh"
+#include "ParallelFor.hh"
 
 namespace unit = anlgeant4::unit;
 
@@ -91,26 +95,36 @@ void SimDetectorUnit2DStrip::simulatePulseHeights()
       continue;
     }
 
-    if (DiffusionMode()==0) {
-      const PixelID xsp(sp.X(), PixelID::Undefined);
-      const PixelID ysp(PixelID::Undefined, sp.Y());
-      DetectorHit_sptr xhit = generateHit(*rawhit, xsp);
-      DetectorHit_sptr yhit = generateHit(*rawhit, ysp);
+    const PixelID xsp(sp.X(), PixelID::Undefined);
+    const PixelID ysp(PixelID::Undefined, sp.Y());
+    DetectorHit_sptr xhit = generateHit(*rawhit, xsp);
+    DetectorHit_sptr yhit = generateHit(*rawhit, ysp);
+
+    if (DiffusionMode()==0 && ChargeCollectionMode()<3) {
       insertSimulatedHit(xhit);
       insertSimulatedHit(yhit);
+      continue;
     }
-    else {
-      const PixelID xsp(sp.X(), PixelID::Undefined);
-      const PixelID ysp(PixelID::Undefined, sp.Y());
-      DetectorHit_sptr xhit = generateHit(*rawhit, xsp);
-      DetectorHit_sptr yhit = generateHit(*rawhit, ysp);
-      const double xECharge = xhit->EnergyCharge();
-      const double yECharge = yhit->EnergyCharge();
 
+    // The signals of the strips reached by the diffusion cloud and of the
+    // near strips (induced charges) are summed up in dense accumulators,
+    // and a hit is made for each strip filled.
+    xStripAccumulator_.reset(getNumPixelX());
+    yStripAccumulator_.reset(getNumPixelY());
+
+    if (DiffusionMode()==0) {
+      if (checkRange(xsp)) {
+        xStripAccumulator_.add(xsp.X(), xhit->EnergyDeposit(), xhit->EnergyCharge());
+      }
+      if (checkRange(ysp)) {
+        yStripAccumulator_.add(ysp.Y(), yhit->EnergyDeposit(), yhit->EnergyCharge());
+      }
+    }
+    else {
       const int numDivision = DiffusionDivisionNumber();
       const double edepDivision = edep/numDivision;
-      const double xEChargeDivision = xECharge/numDivision;
-      const double yEChargeDivision = yECharge/numDivision;
+      const double xEChargeDivision = xhit->EnergyCharge()/numDivision;
+      const double yEChargeDivision = yhit->EnergyCharge()/numDivision;
       
       double xDiffusionSigma = 0.0;
       double yDiffusionSigma = 0.0;
@@ -123,138 +137,126 @@ void SimDetectorUnit2DStrip::simulatePulseHeights()
         yDiffusionSigma = DiffusionSigmaAnode(localposz);
       }
 
-      { // x-strip
-        std::vector<DetectorHit_sptr> diffusionHits;
-        for (int l=0; l<numDivision; l++) {
-          const double dx = gRandom->Gaus(0.0, xDiffusionSigma);
-          const double dy = gRandom->Gaus(0.0, xDiffusionSigma);
-          PixelID spDiff = findPixel(localposx+dx, localposy+dy);
-          spDiff.setY(PixelID::Undefined);
-          
-          auto itHit = find_if(diffusionHits.begin(), diffusionHits.end(),
-                               [&](const DetectorHit_sptr& hit)-> bool {
-                                 return (hit->Pixel()==spDiff);
-                               });
-          if (itHit != diffusionHits.end()) {
-            DetectorHit_sptr hit = *itHit;
-            hit->setEnergyDeposit( hit->EnergyDeposit() + edepDivision );
-            hit->setEnergyCharge( hit->EnergyCharge() + xEChargeDivision );
-          }
-          else {
-            DetectorHit_sptr hitDivision(new DetectorHit(*xhit));
-            hitDivision->setEnergyDeposit(edepDivision);
-            hitDivision->setEnergyCharge(xEChargeDivision);
-            hitDivision->setPixel(spDiff);
-            diffusionHits.push_back(hitDivision);
-          }
-        }
-        
-        for (auto& hit: diffusionHits) {
-          insertSimulatedHit(hit);
+      // x-strip
+      drawDiffusionDisplacements(numDivision, xDiffusionSigma);
+      for (int l=0; l<numDivision; l++) {
+        const PixelID spDiff = findPixel(localposx+diffusionDX_[l], localposy+diffusionDY_[l]);
+        if (spDiff.X()>=0 && spDiff.X()<getNumPixelX()) {
+          xStripAccumulator_.add(spDiff.X(), edepDivision, xEChargeDivision);
         }
       }
 
-      { // y-strip
-        std::vector<DetectorHit_sptr> diffusionHits;
-        for (int l=0; l<numDivision; l++) {
-          const double dx = gRandom->Gaus(0.0, yDiffusionSigma);
-          const double dy = gRandom->Gaus(0.0, yDiffusionSigma);
-          PixelID spDiff = findPixel(localposx+dx, localposy+dy);
-          spDiff.setX(PixelID::Undefined);
-          
-          auto itHit = find_if(diffusionHits.begin(), diffusionHits.end(),
-                               [&](const DetectorHit_sptr& hit)-> bool {
-                                 return (hit->Pixel()==spDiff);
-                               });
-          if (itHit != diffusionHits.end()) {
-            DetectorHit_sptr hit = *itHit;
-            (*itHit)->setEnergyDeposit( hit->EnergyDeposit() + edepDivision );
-            (*itHit)->setEnergyCharge( hit->EnergyCharge() + yEChargeDivision );
-          }
-          else {
-            DetectorHit_sptr hitDivision(new DetectorHit(*yhit));
-            hitDivision->setEnergyDeposit(edepDivision);
-            hitDivision->setEnergyCharge(yEChargeDivision);
-            hitDivision->setPixel(spDiff);
-            diffusionHits.push_back(hitDivision);
-          }
-        }
-
-        for (auto& hit: diffusionHits) {
-          insertSimulatedHit(hit);
+      // y-strip
+      drawDiffusionDisplacements(numDivision, yDiffusionSigma);
+      for (int l=0; l<numDivision; l++) {
+        const PixelID spDiff = findPixel(localposx+diffusionDX_[l], localposy+diffusionDY_[l]);
+        if (spDiff.Y()>=0 && spDiff.Y()<getNumPixelY()) {
+          yStripAccumulator_.add(spDiff.Y(), edepDivision, yEChargeDivision);
         }
       }
     }
       
     // near strips
+    int nearStripRange = 0;
     if (ChargeCollectionMode()==3) {
-      DetectorHit_sptr hit;
-      PixelID nearStrip;
-     
-      nearStrip.set(sp.X()+2, PixelID::Undefined);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
-      insertSimulatedHit(hit);
+      nearStripRange = 2;
+    }
+    else if (ChargeCollectionMode()>=4) {
+      nearStripRange = 7;
+    }
 
-      nearStrip.set(sp.X()+1, PixelID::Undefined);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
-      insertSimulatedHit(hit);
+    if (nearStripRange > 0) {
+      for (int delta_strip=-nearStripRange; delta_strip<=nearStripRange; delta_strip++) {
+        if (delta_strip==0) { continue; }
+        addNearStripSignal(*rawhit, *xhit, xsp, PixelID(sp.X()+delta_strip, PixelID::Undefined), xStripAccumulator_);
+        addNearStripSignal(*rawhit, *yhit, ysp, PixelID(PixelID::Undefined, sp.Y()+delta_strip), yStripAccumulator_);
+      }
+    }
 
-      nearStrip.set(sp.X()-1, PixelID::Undefined);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
+    for (const int strip: xStripAccumulator_.Strips()) {
+      DetectorHit_sptr hit(new DetectorHit(*xhit));
+      hit->setPixel(strip, PixelID::Undefined);
+      hit->setEnergyDeposit(xStripAccumulator_.EnergyDeposit(strip));
+      hit->setEnergyCharge(xStripAccumulator_.EnergyCharge(strip));
       insertSimulatedHit(hit);
+    }
 
-      nearStrip.set(sp.X()-2, PixelID::Undefined);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
-      insertSimulatedHit(hit);
-    
-      nearStrip.set(PixelID::Undefined, sp.Y()+2);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
+    for (const int strip: yStripAccumulator_.Strips()) {
+      DetectorHit_sptr hit(new DetectorHit(*yhit));
+      hit->setPixel(PixelID::Undefined, strip);
+      hit->setEnergyDeposit(yStripAccumulator_.EnergyDeposit(strip));
+      hit->setEnergyCharge(yStripAccumulator_.EnergyCharge(strip));
       insertSimulatedHit(hit);
+    }
+  }
+}
 
-      nearStrip.set(PixelID::Undefined, sp.Y()+1);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
-      insertSimulatedHit(hit);
+void SimDetectorUnit2DStrip::addNearStripSignal(const DetectorHit& rawhit,
+                                                const DetectorHit& hit,
+                                                const PixelID& sp,
+                                                const PixelID& nearStrip,
+                                                StripAccumulator& accumulator)
+{
+  if (!checkRange(sp)) {
+    // The hit is out of the strip range; the near-strip hit is made as it is.
+    DetectorHit_sptr nearHit = generateHit(rawhit, nearStrip);
+    nearHit->setEnergyDeposit(0.0);
+    insertSimulatedHit(nearHit);
+    return;
+  }
 
-      nearStrip.set(PixelID::Undefined, sp.Y()-1);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
-      insertSimulatedHit(hit);
+  if (!checkRange(nearStrip)) {
+    return;
+  }
 
-      nearStrip.set(PixelID::Undefined, sp.Y()-2);
-      hit = generateHit(*rawhit, nearStrip);
-      hit->setEnergyDeposit(0.0);
-      insertSimulatedHit(hit);   
-    }
-    else if (ChargeCollectionMode()>=4) {
-      const int strip_range = 7;
-
-      for (int delta_strip=-strip_range; delta_strip<=strip_range; delta_strip++) {
-        if (delta_strip!=0) {
-          PixelID nearStrip(sp.X()+delta_strip, PixelID::Undefined);
-          DetectorHit_sptr hit = generateHit(*rawhit, nearStrip);
-          hit->setEnergyDeposit(0.0);
-          insertSimulatedHit(hit);
-        }
-      }
+  // hit has the same flags and (quenched) energy deposit as generateHit() gives.
+  const double energyCharge = calculateEnergyCharge(nearStrip,
+                                                    hit.EnergyDeposit(),
+                                                    hit.LocalPositionX(),
+                                                    hit.LocalPositionY(),
+                                                    hit.LocalPositionZ());
+  const int strip = nearStrip.isXStrip() ? nearStrip.X() : nearStrip.Y();
+  accumulator.add(strip, 0.0, energyCharge);
+}
 
-      for (int delta_strip=-strip_range; delta_strip<=strip_range; delta_strip++) {
-        if (delta_strip!=0) {
-          PixelID nearStrip(PixelID::Undefined, sp.Y()+delta_strip);
-          DetectorHit_sptr hit = generateHit(*rawhit, nearStrip);
-          hit->setEnergyDeposit(0.0);
-          insertSimulatedHit(hit);
-        }
-      }
-    }
+void SimDetectorUnit2DStrip::drawDiffusionDisplacements(int n, double sigma)
+{
+  // Box-Muller transform of uniform random numbers drawn at once,
+  // which gives a pair of independent Gaussian displacements.
+  diffusionRandoms_.resize(2*n);
+  diffusionDX_.resize(n);
+  diffusionDY_.resize(n);
+  gRandom->RndmArray(2*n, diffusionRandoms_.data());
+
+  const double* u = diffusionRandoms_.data();
+  double* dx = diffusionDX_.data();
+  double* dy = diffusionDY_.data();
+  for (int l=0; l<n; l++) {
+    const double r = sigma * std::sqrt(-2.0*std::log(u[2*l]));
+    const double phi = CLHEP::twopi * u[2*l+1];
+    dx[l] = r * std::cos(phi);
+    dy[l] = r * std::sin(phi);
   }
 }
 
+void SimDetectorUnit2DStrip::StripAccumulator::reset(int numStrips)
+{
+  if (static_cast<int>(energyDeposit_.size()) != numStrips) {
+    energyDeposit_.assign(numStrips, 0.0);
+    energyCharge_.assign(numStrips, 0.0);
+    filled_.assign(numStrips, 0);
+    strips_.clear();
+    return;
+  }
+
+  for (const int strip: strips_) {
+    energyDeposit_[strip] = 0.0;
+    energyCharge_[strip] = 0.0;
+    filled_[strip] = 0;
+  }
+  strips_.clear();
+}
+
 DetectorHit_sptr SimDetectorUnit2DStrip::generateHit(const DetectorHit& rawhit,
                                                      const PixelID& sp)
 {
@@ -393,6 +395,23 @@ void SimDetectorUnit2DStrip::buildWPMap(int nx, int ny, int nz, double pixel_fac
     }
   }
   
+  const std::string cacheDescription
+    = (boost::format("2DStrip WP nx=%d ny=%d nz=%d pixel_factor=%.17g pitch=%.17g,%.17g "
+                     "thickness=%.17g num_pixels=%.17g upside_xstrip=%d upside_ystrip=%d")
+       % nx % ny % nz % pixel_factor % getPixelPitchX() % getPixelPitchY()
+       % getThickness() % NumPixelsInWPCalculation()
+       % isUpSideXStrip() % isUpSideYStrip()).str();
+  ChargeCollectionMapCache* cache = getChargeCollectionMapCache();
+  if (cache) {
+    const std::vector<TH1*> maps = cache->find(cacheDescription, 2);
+    if (!maps.empty()) {
+      WPMapXStrip_ = static_cast<TH2D*>(maps[0]);
+      WPMapYStrip_ = static_cast<TH2D*>(maps[1]);
+      WPMapDescription_ = cacheDescription;
+      return;
+    }
+  }
+
   const std::string histnameX = (boost::format("wp_%04d_x")%getID()).str();
   WPMapXStrip_ =  new TH2D(histnameX.c_str(), histnameX.c_str(),
                            nx, -0.5*MapSizeX/unit::cm, +0.5*MapSizeX/unit::cm,
@@ -403,104 +422,14 @@ void SimDetectorUnit2DStrip::buildWPMap(int nx, int ny, int nz, double pixel_fac
                            nz, -0.5*MapSizeZ/unit::cm, +0.5*MapSizeZ/unit::cm);
 
   std::cout << "calculating weighing potential..." << std::endl;
+  fillWPMap(WPMapXStrip_, getPixelPitchX(), isUpSideXStrip());
+  fillWPMap(WPMapYStrip_, getPixelPitchY(), isUpSideYStrip());
+  std::cout << std::endl;
 
-  auto wpModel = std::make_unique<WeightingPotentialStrip>();
-  wpModel->setGeometry(getPixelPitchX(), getThickness(),
-                       NumPixelsInWPCalculation());
-  wpModel->initializeTable();
-  for (int ix=1; ix<=nx; ix++) {
-    std::cout << '*' << std::flush;
-    const double x = WPMapXStrip_->GetXaxis()->GetBinCenter(ix) * unit::cm;
-    wpModel->setX(x);
-    for (int iz=1; iz<=nz; iz++) {
-      const double z = WPMapXStrip_->GetYaxis()->GetBinCenter(iz) * unit::cm;
-      if (isUpSideXStrip()) {
-        double wp = 0.;
-        if (iz==nz) {
-          if (std::abs(x)<0.5*getPixelPitchX()) {
-            wp = 1.;
-          }
-          else {
-            wp = 0.;
-          }
-        }
-        else if (iz==1) {
-          wp = 0.;
-        }
-        else {
-          wp = wpModel->calculateWeightingPotential(z);
-        }
-        WPMapXStrip_->SetBinContent(ix, iz, wp);
-      }
-      else {
-        double wp = 0.;
-        if (iz==1) {
-          if (std::abs(x)<0.5*getPixelPitchX()) {
-            wp = 1.;
-          }
-          else {
-            wp = 0.;
-          }
-        }
-        else if (iz==nz) {
-          wp = 0.;
-        }
-        else {
-          wp = wpModel->calculateWeightingPotential(-z);
-        }
-        WPMapXStrip_->SetBinContent(ix, iz, wp);
-      }
-    }
-  }
-
-  wpModel->setGeometry(getPixelPitchY(), getThickness(), NumPixelsInWPCalculation());
-  wpModel->initializeTable();
-  for (int iy=1; iy<=ny; iy++) {
-    std::cout << '*' << std::flush;
-    const double y = WPMapYStrip_->GetXaxis()->GetBinCenter(iy) * unit::cm;
-    wpModel->setX(y);
-    for (int iz=1; iz<=nz; iz++) {
-      const double z = WPMapYStrip_->GetYaxis()->GetBinCenter(iz) * unit::cm;
-      if (isUpSideYStrip()) {
-        double wp = 0.;
-        if (iz==nz) {
-          if (std::abs(y)<0.5*getPixelPitchY()) {
-            wp = 1.;
-          }
-          else {
-            wp = 0.;
-          }
-        }
-        else if (iz==1) {
-          wp = 0.;
-        }
-        else {
-          wp = wpModel->calculateWeightingPotential(z);
-        }
-        WPMapYStrip_->SetBinContent(iy, iz, wp);
-      }
-      else {
-        double wp = 0.;
-        if (iz==1) {
-          if (std::abs(y)<0.5*getPixelPitchY()) {
-            wp = 1.;
-          }
-          else {
-            wp = 0.;
-          }
-        }
-        else if (iz==nz) {
-          wp = 0.;
-        }
-        else {
-          wp = wpModel->calculateWeightingPotential(-z);
-        }
-        WPMapYStrip_->SetBinContent(iy, iz, wp);
-      }
-    }
+  WPMapDescription_ = cacheDescription;
+  if (cache) {
+    cache->store(cacheDescription, {WPMapXStrip_, WPMapYStrip_});
   }
-  
-  std::cout << std::endl;
 }
 
 void SimDetectorUnit2DStrip::buildCCEMap()
@@ -542,6 +471,23 @@ void SimDetectorUnit2DStrip::buildCCEMap(int nx, int ny, int nz, double pixel_fa
     }
   }
   
+  // The CCE maps can be cached only when the WP maps are described.
+  std::string cacheDescription;
+  ChargeCollectionMapCache* cache = nullptr;
+  if (getChargeCollectionMapCache() && !WPMapDescription_.empty()) {
+    cacheDescription
+      = (boost::format("2DStrip CCE nx=%d ny=%d nz=%d pixel_factor=%.17g pitch=%.17g,%.17g symmetry=%d; %s; %s")
+         % nx % ny % nz % pixel_factor % getPixelPitchX() % getPixelPitchY()
+         % isUsingSymmetry() % WPMapDescription_ % ChargeTransportDescription()).str();
+    cache = getChargeCollectionMapCache();
+    const std::vector<TH1*> maps = cache->find(cacheDescription, 2);
+    if (!maps.empty()) {
+      CCEMapXStrip_ = static_cast<TH2D*>(maps[0]);
+      CCEMapYStrip_ = static_cast<TH2D*>(maps[1]);
+      return;
+    }
+  }
+
   const std::string histnameX = (boost::format("cce_%04d_x")%getID()).str();
   CCEMapXStrip_ =  new TH2D(histnameX.c_str(), histnameX.c_str(),
                             nx, -0.5*MapSizeX/unit::cm, +0.5*MapSizeX/unit::cm,
@@ -552,78 +498,110 @@ void SimDetectorUnit2DStrip::buildCCEMap(int nx, int ny, int nz, double pixel_fa
                             nz, -0.5*MapSizeZ/unit::cm, +0.5*MapSizeZ/unit::cm);
   
   std::cout << "calculating charge collection efficiency..." << std::endl;
-  
-  for (int ix=1; ix<=nx; ix++) {
-    std::cout << '*' << std::flush;
-    if (!isUsingSymmetry() || ix<=(nx+1)/2) {
-      const double x_in_cm = CCEMapXStrip_->GetXaxis()->GetBinCenter(ix);
-      const int binx = WPMapXStrip_->GetXaxis()->FindBin(x_in_cm);
-      
-      const int numPoints = nz+1;
-      boost::shared_array<double> wp(new double[numPoints]);
-      for (int k=0; k<numPoints; k++) {
-        const double z_in_cm = CCEMapXStrip_->GetYaxis()->GetBinLowEdge(k+1);
-        const int binz = WPMapXStrip_->GetYaxis()->FindBin(z_in_cm);
-        wp[k] = WPMapXStrip_->GetBinContent(binx, binz);
-      }
-      setWeightingPotential(isUpSideXStrip(), wp, numPoints);
-      
-      for (int iz=1; iz<=nz; iz++) {
-        const double z = CCEMapXStrip_->GetYaxis()->GetBinCenter(iz) * unit::cm;
-        const double cce = calculateCCE(z);
-        // std::cout << cce << std::endl;
-        CCEMapXStrip_->SetBinContent(ix, iz, cce);
-      }
-    }
+  fillCCEMap(CCEMapXStrip_, WPMapXStrip_, isUpSideXStrip());
+  fillCCEMap(CCEMapYStrip_, WPMapYStrip_, isUpSideYStrip());
+
+  std::cout << std::endl;
+  std::cout << "Charge collection efficiency map is built." << std::endl;
+
+  if (cache) {
+    cache->store(cacheDescription, {CCEMapXStrip_, CCEMapYStrip_});
   }
+}
 
-  if (isUsingSymmetry()) {
-    for (int ix=1; ix<=nx; ix++) {
-      for (int iz=1; iz<=nz; iz++) {
-        if (ix>(nx+1)/2) {
-          const double cce = CCEMapXStrip_->GetBinContent(nx-ix+1, iz);
-          CCEMapXStrip_->SetBinContent(ix, iz, cce);
-        }
-      }
-    }
+void SimDetectorUnit2DStrip::fillWPMap(TH2D* wpMap, double pitch, bool upside)
+{
+  const int nx = wpMap->GetXaxis()->GetNbins();
+  const int nz = wpMap->GetYaxis()->GetNbins();
+
+  auto wpModel = std::make_unique<WeightingPotentialStrip>();
+  wpModel->setGeometry(pitch, getThickness(), NumPixelsInWPCalculation());
+  wpModel->initializeTable();
+
+  // The inner depths are calculated by the model; the electrode surfaces are
+  // given by the boundary conditions.
+  const int izElectrode = upside ? nz : 1;
+  std::vector<double> zInner(nz-2);
+  for (int iz=2; iz<=nz-1; iz++) {
+    const double z = wpMap->GetYaxis()->GetBinCenter(iz) * unit::cm;
+    zInner[iz-2] = upside ? z : -z;
   }
 
-  for (int iy=1; iy<=ny; iy++) {
-    std::cout << '*' << std::flush;
-    if (!isUsingSymmetry() || iy<=(ny+1)/2) {
-      const double y_in_cm = CCEMapYStrip_->GetXaxis()->GetBinCenter(iy);
-      const int biny = WPMapYStrip_->GetXaxis()->FindBin(y_in_cm);
-      
-      const int numPoints = nz+1;
-      boost::shared_array<double> wp(new double[numPoints]);
-      for (int k=0; k<numPoints; k++) {
-        const double z_in_cm = CCEMapYStrip_->GetYaxis()->GetBinLowEdge(k+1);
-        const int binz = WPMapYStrip_->GetYaxis()->FindBin(z_in_cm);
-        wp[k] = WPMapYStrip_->GetBinContent(biny, binz);
-      }
-      setWeightingPotential(isUpSideYStrip(), wp, numPoints);
-      
-      for (int iz=1; iz<=nz; iz++) {
-        const double z = CCEMapYStrip_->GetYaxis()->GetBinCenter(iz) * unit::cm;
-        const double cce = calculateCCE(z);
-        CCEMapYStrip_->SetBinContent(iy, iz, cce);
-      }
+  // buffer[(ix-1)*nz + (iz-1)]
+  std::vector<double> buffer(nx*nz, 0.0);
+  const TAxis* xaxis = wpMap->GetXaxis();
+  parallelFor(0, nx, NumThreadsInMapCalculation(),
+              [&](int index, int) {
+                std::cout << '*' << std::flush;
+                const double x = xaxis->GetBinCenter(index+1) * unit::cm;
+                double* wp = &buffer[index*nz];
+                wpModel->calculateWeightingPotential(x, zInner.data(), wp+1, nz-2);
+                if (std::abs(x)<0.5*pitch) {
+                  wp[izElectrode-1] = 1.;
+                }
+              });
+
+  for (int ix=1; ix<=nx; ix++) {
+    for (int iz=1; iz<=nz; iz++) {
+      wpMap->SetBinContent(ix, iz, buffer[(ix-1)*nz + (iz-1)]);
     }
   }
+}
+
+void SimDetectorUnit2DStrip::fillCCEMap(TH2D* cceMap, const TH2D* wpMap, bool upside)
+{
+  const int nx = cceMap->GetXaxis()->GetNbins();
+  const int nz = cceMap->GetYaxis()->GetNbins();
+  const TAxis* xaxis = cceMap->GetXaxis();
+  const TAxis* zaxis = cceMap->GetYaxis();
+  const EFieldModel& fieldPrototype = getEFieldModel();
+
+  // buffer[(ix-1)*nz + (iz-1)]
+  std::vector<double> buffer(nx*nz, 0.0);
+  parallelFor(0, nx, NumThreadsInMapCalculation(),
+              [&](int index, int) {
+                std::cout << '*' << std::flush;
+                const int ix = index + 1;
+                if (isUsingSymmetry() && ix>(nx+1)/2) {
+                  return;
+                }
+
+                const double x_in_cm = xaxis->GetBinCenter(ix);
+                const int binx = wpMap->GetXaxis()->FindFixBin(x_in_cm);
+
+                const int numPoints = nz+1;
+                boost::shared_array<double> wp(new double[numPoints]);
+                for (int k=0; k<numPoints; k++) {
+                  const double z_in_cm = zaxis->GetBinLowEdge(k+1);
+                  const int binz = wpMap->GetYaxis()->FindFixBin(z_in_cm);
+                  wp[k] = wpMap->GetBinContent(binx, binz);
+                }
+
+                // each thread uses its own copy of the field model.
+                EFieldModel field(fieldPrototype);
+                field.setUpSideReadElectrode(upside);
+                field.setWeightingPotential(wp, numPoints);
+
+                double* cce = &buffer[index*nz];
+                for (int iz=1; iz<=nz; iz++) {
+                  const double z = zaxis->GetBinCenter(iz) * unit::cm;
+                  cce[iz-1] = field.CCE(z);
+                }
+              });
 
   if (isUsingSymmetry()) {
-    for (int iy=1; iy<=ny; iy++) {
+    for (int ix=(nx+1)/2+1; ix<=nx; ix++) {
       for (int iz=1; iz<=nz; iz++) {
-        if (iy>(ny+1)/2) {
-          const double cce = CCEMapYStrip_->GetBinContent(ny-iy+1, iz);
-          CCEMapYStrip_->SetBinContent(iy, iz, cce);
-        }
+        buffer[(ix-1)*nz + (iz-1)] = buffer[(nx-ix)*nz + (iz-1)];
       }
     }
   }
 
-  std::cout << std::endl;
-  std::cout << "Charge collection efficiency map is built." << std::endl;
+  for (int ix=1; ix<=nx; ix++) {
+    for (int iz=1; iz<=nz; iz++) {
+      cceMap->SetBinContent(ix, iz, buffer[(ix-1)*nz + (iz-1)]);
+    }
+  }
 }
 
 void SimDetectorUnit2DStrip::printSimulationParameters(std::ostream& os) const
@@ -0,0 +1,174 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "SlidingWindowMedian.hh"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace
+{
+
+using index_t = uint16_t;
+
+/*
+ * Restore a heap after the value at position h has changed.
+ * The heap occupies positions [offset, offset+size) of values and slots;
+ * Above(a, b) is true if a has to be placed above b.
+ */
+template <typename Above>
+void sift(double* values, index_t* slots, index_t* positions,
+          const int offset, const int size, int h, Above above)
+{
+  double* v = values + offset;
+  index_t* s = slots + offset;
+
+  auto swap_entries = [&](const int a, const int b) {
+    std::swap(v[a], v[b]);
+    std::swap(s[a], s[b]);
+    positions[s[a]] = static_cast<index_t>(offset+a);
+    positions[s[b]] = static_cast<index_t>(offset+b);
+  };
+
+  while (h > 0) {
+    const int parent = (h-1)/2;
+    if (!above(v[h], v[parent])) { break; }
+    swap_entries(h, parent);
+    h = parent;
+  }
+
+  while (true) {
+    const int left = 2*h+1;
+    if (left >= size) { break; }
+    int child = left;
+    const int right = left+1;
+    if (right < size && above(v[right], v[left])) {
+      child = right;
+    }
+    if (!above(v[child], v[h])) { break; }
+    swap_entries(h, child);
+    h = child;
+  }
+}
+
+inline bool greater(double a, double b) { return a > b; }
+inline bool less(double a, double b) { return a < b; }
+
+} /* anonymous namespace */
+
+namespace comptonsoft
+{
+
+SlidingWindowMedian::SlidingWindowMedian(const std::size_t num_pixels, const int window)
+  : num_pixels_(num_pixels),
+    window_(std::min(std::max(window, 1), MaxWindowSize)),
+    lowerSize_((window_+1)/2),
+    heapValues_(num_pixels_*window_, 0.0),
+    heapSlots_(num_pixels_*window_, 0),
+    positions_(num_pixels_*window_, 0)
+{
+}
+
+SlidingWindowMedian::~SlidingWindowMedian() = default;
+
+void SlidingWindowMedian::fill(const int slot, const double* xs)
+{
+  const std::size_t W = window_;
+  for (std::size_t p=0; p<num_pixels_; p++) {
+    heapValues_[p*W+slot] = xs[p];
+  }
+}
+
+void SlidingWindowMedian::build()
+{
+  const std::size_t W = window_;
+  std::vector<index_t> order(W);
+  std::vector<double> values(W);
+  for (std::size_t p=0; p<num_pixels_; p++) {
+    double* v = &heapValues_[p*W];
+    index_t* s = &heapSlots_[p*W];
+    index_t* positions = &positions_[p*W];
+
+    // slot i holds the value filled at slot i.
+    std::copy(v, v+W, values.begin());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&values](index_t a, index_t b) { return values[a] < values[b]; });
+
+    // a descending array is a max-heap, and an ascending one is a min-heap.
+    for (int h=0; h<lowerSize_; h++) {
+      s[h] = order[lowerSize_-1-h];
+    }
+    for (int h=lowerSize_; h<window_; h++) {
+      s[h] = order[h];
+    }
+    for (int h=0; h<window_; h++) {
+      v[h] = values[s[h]];
+      positions[s[h]] = static_cast<index_t>(h);
+    }
+  }
+}
+
+void SlidingWindowMedian::replace(const int slot, const double* xs, double* medians)
+{
+  for (std::size_t p=0; p<num_pixels_; p++) {
+    replaceValue(p, slot, xs[p]);
+    medians[p] = median(p);
+  }
+}
+
+void SlidingWindowMedian::replaceValue(const std::size_t pixel, const int slot, const double x)
+{
+  const std::size_t W = window_;
+  double* v = &heapValues_[pixel*W];
+  index_t* s = &heapSlots_[pixel*W];
+  index_t* positions = &positions_[pixel*W];
+  const int L = lowerSize_;
+  const int U = window_ - lowerSize_;
+
+  const int h = positions[slot];
+  v[h] = x;
+  if (h < L) {
+    sift(v, s, positions, 0, L, h, greater);
+  }
+  else {
+    sift(v, s, positions, L, U, h-L, less);
+  }
+
+  // keep every value of the lower heap not above those of the upper heap
+  if (U > 0 && v[L] < v[0]) {
+    std::swap(v[0], v[L]);
+    std::swap(s[0], s[L]);
+    positions[s[0]] = 0;
+    positions[s[L]] = static_cast<index_t>(L);
+    sift(v, s, positions, 0, L, 0, greater);
+    sift(v, s, positions, L, U, 0, less);
+  }
+}
+
+double SlidingWindowMedian::median(const std::size_t pixel) const
+{
+  const double* v = &heapValues_[pixel*window_];
+  if (window_%2==1) {
+    return v[0];
+  }
+  return 0.5 * (v[lowerSize_] + v[0]);
+}
+
+} /* namespace comptonsoft */
@@ -24,6 +24,8 @@
 #include "DetectorHit.hh"
 #include "ComptonConstraints.hh"
 #include <boost/property_tree/json_parser.hpp>
+#include "TFile.h"
+#include "TGraph.h"
 
 namespace unit = anlgeant4::unit;
 
@@ -52,7 +54,8 @@ TangoAlgorithm::TangoAlgorithm()
     position_resolution_y_(0.2 * unit::cm),
     position_resolution_z_(0.2 * unit::cm),
     escape_weight_(1.0),
-    cross_section_filename_("crosssection.root")
+    cross_section_filename_("crosssection.root"),
+    cross_section_table_points_per_decade_(1000)
 {
   setParameterFile("parfile_TANGO.json");
 }
@@ -108,12 +111,16 @@ bool TangoAlgorithm::loadParameters(boost::property_tree::ptree& pt)
 
   escape_weight_ = pt.get<double>("TANGO.escape_weight");
   cross_section_filename_ = pt.get<std::string>("TANGO.cross_section_filename");
-  
-  cross_section_file_ = new TFile(cross_section_filename_.c_str(), "r");
-  tg_cross_section_compton_ = (TGraph*)cross_section_file_->Get("compton");
-  tg_cross_section_phot_abs_ = (TGraph*)cross_section_file_->Get("phot_abs");
-  tg_cross_section_pair_ = (TGraph*)cross_section_file_->Get("pair");
-  tg_cross_section_tot_ = (TGraph*)cross_section_file_->Get("tot_wo_coherent");
+
+  try{
+    cross_section_table_points_per_decade_ = pt.get<int>("TANGO.cross_section_table_points_per_decade");
+  }catch (...){
+
+  }
+
+  if (!loadCrossSectionTable()) {
+    return false;
+  }
 
   std::cout << std::endl;
   std::cout << "--- TANGO ---" << std::endl;
@@ -132,6 +139,7 @@ bool TangoAlgorithm::loadParameters(boost::property_tree::ptree& pt)
   std::cout << "par1_energy_resolution_ : " << par1_energy_resolution_ << std::endl;
   std::cout << "par2_energy_resolution_ : " << par2_energy_resolution_ << std::endl;
   std::cout << "cross_section_filename_ : " << cross_section_filename_ << std::endl;
+  std::cout << "cross_section_table_points_per_decade : " << cross_section_table_points_per_decade_ << std::endl;
   std::cout << "consider_position_resolution : " << consider_position_resolution << std::endl;
   if (consider_position_resolution) {
     std::cout << "position_resolution_x_ (cm) : " << position_resolution_x_ / unit::cm << std::endl;
@@ -164,6 +172,36 @@ bool TangoAlgorithm::loadParameters(boost::property_tree::ptree& pt)
   return true;
 }
 
+bool TangoAlgorithm::loadCrossSectionTable()
+{
+  std::unique_ptr<TFile> cross_section_file(TFile::Open(cross_section_filename_.c_str(), "r"));
+  if (!cross_section_file || cross_section_file->IsZombie()) {
+    std::cout << "TangoAlgorithm: cannot open " << cross_section_filename_ << std::endl;
+    return false;
+  }
+
+  std::unique_ptr<TGraph> tg_cross_section_tot(dynamic_cast<TGraph*>(cross_section_file->Get("tot_wo_coherent")));
+  std::unique_ptr<TGraph> tg_cross_section_compton(dynamic_cast<TGraph*>(cross_section_file->Get("compton")));
+  std::unique_ptr<TGraph> tg_cross_section_phot_abs(dynamic_cast<TGraph*>(cross_section_file->Get("phot_abs")));
+  if (!tg_cross_section_tot || !tg_cross_section_compton || !tg_cross_section_phot_abs) {
+    std::cout << "TangoAlgorithm: cross section graphs are not found in " << cross_section_filename_ << std::endl;
+    return false;
+  }
+
+  auto table = std::make_shared<CrossSectionTable>();
+  const bool built = table->build(*tg_cross_section_tot,
+                                  *tg_cross_section_compton,
+                                  *tg_cross_section_phot_abs,
+                                  cross_section_table_points_per_decade_);
+  if (!built) {
+    std::cout << "TangoAlgorithm: failed to build the cross section table." << std::endl;
+    return false;
+  }
+
+  cross_section_table_ = table;
+  return true;
+}
+
 void TangoAlgorithm::initializeEvent()
 {
 }
@@ -203,6 +241,10 @@ reconstructFullDepositEvent(const std::vector<DetectorHit_sptr>& hits,
                             const BasicComptonEvent& baseEvent,
                             std::vector<BasicComptonEvent_sptr>& eventsReconstructed)
 {
+  if (!Kroger_mode) {
+    return reconstructWithFixedIncidentEnergy(hits, baseEvent, total_energy_deposits_, false, eventsReconstructed);
+  }
+
   bool result = false;
 
   std::vector<int> scattering_order(num_hits_);
@@ -255,6 +297,10 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
                        const BasicComptonEvent& baseEvent,
                        std::vector<BasicComptonEvent_sptr>& eventsReconstructed)
 {
+  if (assume_initial_gammaray_energy) {
+    return reconstructWithFixedIncidentEnergy(hits, baseEvent, known_initial_gammaray_energy, true, eventsReconstructed);
+  }
+
   bool result = false;
 
   std::vector<int> scattering_order(num_hits_);
@@ -272,21 +318,16 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
     }
     
     bool this_result;
-    if (assume_initial_gammaray_energy){
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, known_initial_gammaray_energy, true);
-    }
-    else{
-      double escaped_energy = 0.0;
-      if (use_averaged_escaped_energy) {
-        this_result = estimateAveragedEscapedEnergy(ordered_hits, escaped_energy);
-      } else {
-        this_result = estimateEscapedEnergy(ordered_hits, escaped_energy);
-      }
-      if (!this_result) { continue; }
-      const double corrected_total_energy = total_energy_deposits_ + escaped_energy;
-      this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, corrected_total_energy, true);
+    double escaped_energy = 0.0;
+    if (use_averaged_escaped_energy) {
+      this_result = estimateAveragedEscapedEnergy(ordered_hits, escaped_energy);
+    } else {
+      this_result = estimateEscapedEnergy(ordered_hits, escaped_energy);
     }
-   
+    if (!this_result) { continue; }
+    const double corrected_total_energy = total_energy_deposits_ + escaped_energy;
+    this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, corrected_total_energy, true);
+
     if (this_result) {
       eventReconstructed->setReconstructedOrder(reconstructedOrder);
       eventsReconstructed.push_back(eventReconstructed);
@@ -299,6 +340,11 @@ reconstructEscapeEvent(const std::vector<DetectorHit_sptr>& hits,
   return result;
 }
 
+double TangoAlgorithm::energyMarginForScatteringAngle(double energy)
+{
+  return sigma_level_energy_margin_for_checkScatteringAngle_ * getEnergyResolution(energy);
+}
+
 bool TangoAlgorithm::
 reconstructOrderedHits(const std::vector<DetectorHit_sptr>& ordered_hits,
                        BasicComptonEvent& eventReconstructed,
@@ -342,40 +388,57 @@ calFOM(const std::vector<DetectorHit_sptr>& ordered_hits,
        double incident_energy,
        bool is_escape_event) 
 {
+  const double cos_theta_first_scattering = cosThetaKinematics( incident_energy,
+                                                                ordered_hits[0]->Energy() );
+  if (cos_theta_first_scattering < -1.0 || 1.0 < cos_theta_first_scattering) {
+    return 0.0;
+  }
+
+  // gamma-ray energies before each hit, and that after the last hit (for escape);
+  // all the cross sections needed are looked up at once.
+  const std::size_t num_energies = static_cast<std::size_t>(num_hits_) + 1;
+  energies_for_cross_section_.resize(num_energies);
+  cross_sections_.resize(num_energies);
+  {
+    double gammaray_energy_before_ihit = incident_energy;
+    for (int i_hit = 0; i_hit < num_hits_; ++i_hit) {
+      energies_for_cross_section_[i_hit] = gammaray_energy_before_ihit;
+      if (i_hit < num_hits_ - 1) {
+        gammaray_energy_before_ihit -= ordered_hits[i_hit]->Energy();
+      }
+    }
+    energies_for_cross_section_[num_hits_] = gammaray_energy_before_ihit - ordered_hits[num_hits_ - 1]->Energy();
+  }
+  cross_section_table_->interpolate(energies_for_cross_section_.data(), cross_sections_.data(), num_energies);
+
   double FOM_ = 1.0;
 
-  double gammaray_energy_before_ihit = incident_energy;
   for (int i_hit = 0; i_hit < num_hits_; ++i_hit) {
+    const double gammaray_energy_before_ihit = energies_for_cross_section_[i_hit];
+    const CrossSectionTable::Values& cross_section = cross_sections_[i_hit];
+
     if (i_hit == 0) {
-      double cos_theta_first_scattering = cosThetaKinematics( incident_energy, 
-                                                              ordered_hits[0]->Energy() ); 
-      if (cos_theta_first_scattering < -1.0 || 1.0 < cos_theta_first_scattering) {
-        FOM_ = 0.0;
-        break;
-      }
-    
-      FOM_ *= probComptonFirst(gammaray_energy_before_ihit);
+      FOM_ *= probComptonFirst(cross_section);
       FOM_ *= normalized_differentialCrossSection( incident_energy, cos_theta_first_scattering );
       if(assume_initial_direction){
         FOM_ *= compScatteringAngleWithInitialDirection(ordered_hits, incident_energy, is_escape_event); 
       }
-
-      gammaray_energy_before_ihit -= ordered_hits[0]->Energy();
     }
     else if (i_hit == num_hits_ - 1) {
       double path_length = (ordered_hits[i_hit]->Position() - ordered_hits[i_hit - 1]->Position()).mag() / unit::cm;
       if ( is_escape_event ) {
-        FOM_ *= probCompton(gammaray_energy_before_ihit, path_length);
+        const CrossSectionTable::Values& cross_section_escape = cross_sections_[num_hits_];
+        FOM_ *= probCompton(cross_section, path_length);
         if(use_original_escape_length_calc){
-          FOM_ *= probEscapeOriginal(gammaray_energy_before_ihit, ordered_hits[i_hit]->Energy(),
+          FOM_ *= probEscapeOriginal(cross_section_escape,
                                      ordered_hits[num_hits_ - 1]->Position(), 
                                      ordered_hits[num_hits_ - 2]->Position());
         }else{
-          FOM_ *= probEscapeSimple(gammaray_energy_before_ihit, ordered_hits[i_hit]->Energy());
+          FOM_ *= probEscapeSimple(cross_section_escape);
         }
       }
       else {
-        FOM_ *= probAbsorption(gammaray_energy_before_ihit, path_length);
+        FOM_ *= probAbsorption(cross_section, path_length);
       }
     }
     else {
@@ -383,11 +446,9 @@ calFOM(const std::vector<DetectorHit_sptr>& ordered_hits,
       double cos_theta_geom = cosThetaGeometry(ordered_hits[i_hit]->Position() - ordered_hits[i_hit - 1]->Position(),
                                                ordered_hits[i_hit + 1]->Position() - ordered_hits[i_hit]->Position());
 
-      FOM_ *= probCompton(gammaray_energy_before_ihit, path_length);
+      FOM_ *= probCompton(cross_section, path_length);
       FOM_ *= normalized_differentialCrossSection(gammaray_energy_before_ihit, cos_theta_geom);
       FOM_ *= compScatteringAngle(ordered_hits, i_hit, incident_energy, is_escape_event); 
-
-      gammaray_energy_before_ihit -= ordered_hits[i_hit]->Energy();
     }
   }
   
@@ -477,10 +538,10 @@ probEnergyDetection(double energy_real, double energy_detected, double sigma_ene
 }
 
 double TangoAlgorithm::
-probCompton(double gammaray_energy_before_hit, double path_length)
+probCompton(const CrossSectionTable::Values& cross_section, double path_length)
 {
-  const double cs_tot_ = tg_cross_section_tot_->Eval(gammaray_energy_before_hit);
-  const double cs_compton_ = tg_cross_section_compton_->Eval(gammaray_energy_before_hit);
+  const double cs_tot_ = cross_section.total;
+  const double cs_compton_ = cross_section.compton;
   if(ignore_length_inverse_square){
     const double prob_ = std::exp( -1 * cs_tot_ * path_length ) * cs_compton_;
     return prob_;
@@ -490,19 +551,19 @@ probCompton(double gammaray_energy_before_hit, double path_length)
 }
 
 double TangoAlgorithm::
-probComptonFirst(double gammaray_energy_before_hit) {
-  const double cs_tot_ = tg_cross_section_tot_->Eval(gammaray_energy_before_hit);
-  const double cs_compton_ = tg_cross_section_compton_->Eval(gammaray_energy_before_hit);
+probComptonFirst(const CrossSectionTable::Values& cross_section) {
+  const double cs_tot_ = cross_section.total;
+  const double cs_compton_ = cross_section.compton;
   double prob = std::exp( -1 * cs_tot_ * detector_length_scale) * cs_compton_;
 
   return prob;
 }
 
 double TangoAlgorithm::
-probAbsorption(double gammaray_energy_before_hit, double path_length)
+probAbsorption(const CrossSectionTable::Values& cross_section, double path_length)
 {
-  const double cs_tot_ = tg_cross_section_tot_->Eval(gammaray_energy_before_hit);
-  const double cs_phot_abs_ = tg_cross_section_phot_abs_->Eval(gammaray_energy_before_hit);
+  const double cs_tot_ = cross_section.total;
+  const double cs_phot_abs_ = cross_section.photoabsorption;
   if(ignore_length_inverse_square){
     const double prob_ = std::exp( -1 * cs_tot_ * path_length ) * cs_phot_abs_;
     return prob_;
@@ -512,9 +573,9 @@ probAbsorption(double gammaray_energy_before_hit, double path_length)
 }
 
 double TangoAlgorithm::
-probEscapeSimple(double gammaray_energy_before_lasthit, double energy_deposit_lasthit)
+probEscapeSimple(const CrossSectionTable::Values& cross_section_escape)
 {
-  const double cs_tot_escape = tg_cross_section_tot_->Eval( gammaray_energy_before_lasthit - energy_deposit_lasthit );
+  const double cs_tot_escape = cross_section_escape.total;
 /*
   if (cos_theta_last_scattering < -1.0 || 1.0 < cos_theta_last_scattering) {
   return 0.0;
@@ -526,12 +587,12 @@ probEscapeSimple(double gammaray_energy_before_lasthit, double energy_deposit_la
 }
 
 double TangoAlgorithm::
-probEscapeOriginal(double gammaray_energy_before_lasthit, double energy_deposit_lasthit, const vector3_t position_last, const vector3_t position_second_from_last)
+probEscapeOriginal(const CrossSectionTable::Values& cross_section_escape, const vector3_t position_last, const vector3_t position_second_from_last)
 {
   const double cube_size_x = 140; //cm
   const double cube_size_y = 140; //cm
   const double cube_size_z = 20; //cm
-  const double cs_tot_escape = tg_cross_section_tot_->Eval( gammaray_energy_before_lasthit - energy_deposit_lasthit );
+  const double cs_tot_escape = cross_section_escape.total;
 
   double scale_escape_lengh[3];
   if( position_last.x() - position_second_from_last.x() > 0){
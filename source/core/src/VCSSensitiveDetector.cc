@@ -21,6 +21,10 @@
 #include "VCSSensitiveDetector.hh"
 
 #include "G4VProcess.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4NavigationHistory.hh"
+#include "G4AffineTransform.hh"
+#include "WorkerEventRecord.hh"
 
 #include "DetectorHit.hh"
 #include "DetectorHit_sptr.hh"
@@ -41,11 +45,88 @@ VCSSensitiveDetector::VCSSensitiveDetector(G4String name)
 
 VCSSensitiveDetector::~VCSSensitiveDetector() = default;
 
+std::size_t VCSSensitiveDetector::VolumePathHash::operator()(const VolumePath& path) const
+{
+  std::size_t h = path.size();
+  for (const auto& v: path) {
+    h ^= std::hash<const G4VPhysicalVolume*>()(v.first) + 0x9e3779b97f4a7c15ULL + (h<<6) + (h>>2);
+    h ^= std::hash<G4int>()(v.second) + 0x9e3779b97f4a7c15ULL + (h<<6) + (h>>2);
+  }
+  return h;
+}
+
+void VCSSensitiveDetector::ClearDetectorCache()
+{
+  detectorCache_.clear();
+  lastVolumePath_.clear();
+  lastDetector_ = DetectorCacheEntry();
+}
+
+const VCSSensitiveDetector::DetectorCacheEntry&
+VCSSensitiveDetector::FindDetector(const G4VTouchable* touchable)
+{
+  volumePath_.clear();
+  for (G4int i=touchable->GetHistoryDepth(); i>=0; --i) {
+    volumePath_.emplace_back(touchable->GetVolume(i), touchable->GetReplicaNumber(i));
+  }
+
+  if (!lastVolumePath_.empty() && volumePath_ == lastVolumePath_) {
+    return lastDetector_;
+  }
+
+  auto it = detectorCache_.find(volumePath_);
+  if (it == detectorCache_.end()) {
+    DetectorCacheEntry entry;
+    entry.detectorID = GetDetectorID(touchable);
+    if (entry.detectorID != -1 && detectorSystem_ != nullptr) {
+      entry.device = detectorSystem_->getDeviceSimulationByID(entry.detectorID);
+    }
+    it = detectorCache_.emplace(volumePath_, entry).first;
+  }
+
+  lastVolumePath_ = volumePath_;
+  lastDetector_ = (*it).second;
+  return lastDetector_;
+}
+
+uint32_t VCSSensitiveDetector::ClassifyProcess(const G4VProcess* process)
+{
+  if (process == lastProcess_) {
+    return lastProcessFlag_;
+  }
+
+  auto it = processFlagCache_.find(process);
+  if (it == processFlagCache_.end()) {
+    uint32_t processFlag = 0;
+    if (process) {
+      const G4String& processName = process->GetProcessName();
+      if(processName.find("phot") != std::string::npos) {
+        processFlag = process::PhotoelectricAbsorption;
+      }
+      else if(processName.find("compt") != std::string::npos) {
+        processFlag = process::ComptonScattering;
+      }
+      else if(processName.find("Rayl") != std::string::npos) {
+        processFlag = process::RayleighScattering;
+      }
+      else if(processName.find("conv") != std::string::npos) {
+        processFlag = process::GammaConversion;
+      }
+    }
+    it = processFlagCache_.emplace(process, processFlag).first;
+  }
+
+  lastProcess_ = process;
+  lastProcessFlag_ = (*it).second;
+  return lastProcessFlag_;
+}
+
 G4bool
 VCSSensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory* )
 {
   const G4VTouchable* touchable = aStep->GetPreStepPoint()->GetTouchable();
-  const G4int DetectorID = GetDetectorID(touchable);
+  const DetectorCacheEntry& detector = FindDetector(touchable);
+  const G4int DetectorID = detector.detectorID;
   if (DetectorID == -1) {
     if (SDCheck_) {
       std::cout << "Detector unregistered: " << HierarchyString(touchable) << std::endl;
@@ -56,23 +137,7 @@ VCSSensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory* )
   G4Track* aTrack = aStep->GetTrack();
   G4double edep = aStep->GetTotalEnergyDeposit();
 
-  uint32_t processFlag = 0;
-  const G4VProcess* process = aStep->GetPostStepPoint()->GetProcessDefinedStep();
-  if (process) {
-    G4String processName = process->GetProcessName();
-    if(processName.find("phot") != std::string::npos) {
-      processFlag = process::PhotoelectricAbsorption;
-    }
-    else if(processName.find("compt") != std::string::npos) {
-      processFlag = process::ComptonScattering;
-    }
-    else if(processName.find("Rayl") != std::string::npos) {
-      processFlag = process::RayleighScattering;
-    }
-    else if(processName.find("conv") != std::string::npos) {
-      processFlag = process::GammaConversion;
-    }
-  }
+  uint32_t processFlag = ClassifyProcess(aStep->GetPostStepPoint()->GetProcessDefinedStep());
 
   const G4ParticleDefinition* particleDefinition = aTrack->GetDefinition();
   if (particleDefinition->GetParticleType() == "nucleus") {
@@ -105,17 +170,18 @@ VCSSensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory* )
   hit->setRealPosition(position);
   hit->setRealTime(aTrack->GetGlobalTime());
 
-  for (G4int i = touchable->GetHistoryDepth()-1; i >= 0; i--) {
-   G4VPhysicalVolume* physicalVolume = touchable->GetVolume(i);
-    position += physicalVolume->GetFrameTranslation();
-    if (physicalVolume->GetFrameRotation() != 0) {
-      position = (*physicalVolume->GetFrameRotation()) * position;
-    }
-  }
-  
+  // global-to-local transformation already computed by the navigator
+  position = touchable->GetHistory()->GetTopTransform().TransformPoint(position);
   hit->setLocalPosition(position);
 
-  detectorSystem_->getDeviceSimulationByID(DetectorID)->insertRawHit(hit);
+  anlgeant4::WorkerEventRecord* workerEvent = anlgeant4::WorkerEventRecord::current();
+  if (workerEvent) {
+    DeviceSimulation* device = detector.device;
+    workerEvent->defer([device, hit]() { device->insertRawHit(hit); });
+  }
+  else {
+    detector.device->insertRawHit(hit);
+  }
 
   if (positionCalculation_) {
     std::set<int>::iterator it = positionCalculationSet_.find(DetectorID);
@@ -138,10 +204,18 @@ VCSSensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory* )
       }
       
       VRealDetectorUnit* detector = detectorSystem_->getDetectorByID(DetectorID);
-      detector->setCenterPosition(center);
-      detector->setXAxisDirection(xdir);
-      detector->setYAxisDirection(ydir);
-      detector->setZAxisDirection(zdir);
+      auto setDetectorPosition = [detector, center, xdir, ydir, zdir]() {
+        detector->setCenterPosition(center);
+        detector->setXAxisDirection(xdir);
+        detector->setYAxisDirection(ydir);
+        detector->setZAxisDirection(zdir);
+      };
+      if (workerEvent) {
+        workerEvent->defer(setDetectorPosition);
+      }
+      else {
+        setDetectorPosition();
+      }
 
       positionCalculationSet_.erase(it);
     }
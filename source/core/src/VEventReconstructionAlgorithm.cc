@@ -20,6 +20,8 @@
 #include "VEventReconstructionAlgorithm.hh"
 #include <boost/property_tree/json_parser.hpp>
 #include "DetectorHit.hh"
+#include "ComptonConstraints.hh"
+#include "ScatteringOrderSearch.hh"
 
 namespace comptonsoft {
 
@@ -37,6 +39,72 @@ bool VEventReconstructionAlgorithm::readParameterFile()
   return loadParameters(pt);
 }
 
+/**
+ * The scattering at the (depth-1)-th hit is determined once the hits up to
+ * the depth-th are placed. Orders beginning with a rejected prefix are never
+ * accepted by reconstructOrderedHits(), so they can be skipped as a whole.
+ */
+bool VEventReconstructionAlgorithm::
+reconstructWithFixedIncidentEnergy(const std::vector<DetectorHit_sptr>& hits,
+                                   const BasicComptonEvent& baseEvent,
+                                   double incident_energy,
+                                   bool is_escape_event,
+                                   std::vector<BasicComptonEvent_sptr>& eventsReconstructed)
+{
+  using namespace compton_constraints;
+
+  const int num_hits = hits.size();
+  if (num_hits == 0) { return false; }
+
+  bool result = false;
+
+  std::vector<DetectorHit_sptr> ordered_hits(num_hits);
+  std::vector<double> gammaray_energy_before_hit(num_hits);
+  gammaray_energy_before_hit[0] = incident_energy;
+
+  auto acceptPrefix = [&](const std::vector<int>& scattering_order, int depth) {
+    ordered_hits[depth] = hits[ scattering_order[depth] ];
+
+    if (depth == 0) {
+      if (checksFirstScatteringKinematics()) {
+        const double cos_theta_first_scattering = cosThetaKinematics(incident_energy,
+                                                                     ordered_hits[0]->Energy());
+        if (cos_theta_first_scattering < -1.0 || 1.0 < cos_theta_first_scattering) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    gammaray_energy_before_hit[depth] = gammaray_energy_before_hit[depth-1] - ordered_hits[depth-1]->Energy();
+
+    if (depth >= 2) {
+      const int i_hit = depth - 1;
+      return checkScatteringAngle(ordered_hits[i_hit - 1],
+                                  ordered_hits[i_hit],
+                                  ordered_hits[i_hit + 1],
+                                  gammaray_energy_before_hit[i_hit],
+                                  energyMarginForScatteringAngle(ordered_hits[i_hit]->Energy()));
+    }
+
+    return true;
+  };
+
+  auto processOrder = [&](const std::vector<int>&, int reconstructedOrder) {
+    auto eventReconstructed = std::make_shared<BasicComptonEvent>(baseEvent);
+    const bool this_result = reconstructOrderedHits(ordered_hits, *eventReconstructed, incident_energy, is_escape_event);
+    if (this_result) {
+      eventReconstructed->setReconstructedOrder(reconstructedOrder);
+      eventsReconstructed.push_back(eventReconstructed);
+      result = true;
+    }
+  };
+
+  searchScatteringOrders(num_hits, acceptPrefix, processOrder);
+
+  return result;
+}
+
 double total_energy_deposits(const std::vector<DetectorHit_sptr>& hits)
 {
   double sum = 0.0;
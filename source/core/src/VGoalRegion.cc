@@ -24,4 +24,9 @@ namespace comptonsoft {
 
 VGoalRegion::~VGoalRegion() = default;
 
+std::string VGoalRegion::description() const
+{
+  return "";
+}
+
 } /* namespace comptonsoft */
\ No newline at end of file
@@ -0,0 +1,137 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "VectorFieldTable.hh"
+#include "TH3.h"
+#include "TAxis.h"
+
+namespace comptonsoft {
+
+void VectorFieldTable::Axis::define(const TAxis& axis)
+{
+  numBins = axis.GetNbins();
+  fixedBins = !axis.IsVariableBinSize();
+  min = axis.GetXmin();
+  max = axis.GetXmax();
+  edges.resize(numBins+1);
+  centers.resize(numBins+2);
+  for (int i=1; i<=numBins; i++) {
+    edges[i-1] = axis.GetBinLowEdge(i);
+    centers[i] = axis.GetBinCenter(i);
+  }
+  edges[numBins] = axis.GetBinUpEdge(numBins);
+  centers[0] = centers[1];
+  centers[numBins+1] = centers[numBins];
+}
+
+bool VectorFieldTable::Axis::isSame(const TAxis& axis) const
+{
+  if (axis.GetNbins() != numBins) { return false; }
+  for (int i=1; i<=numBins; i++) {
+    if (axis.GetBinLowEdge(i) != edges[i-1]) { return false; }
+  }
+  return axis.GetBinUpEdge(numBins) == edges[numBins];
+}
+
+void VectorFieldTable::Axis::findCenterPair(const double a, int& i0, int& i1, double& r) const
+{
+  if (!(a > centers[1])) {
+    i0 = i1 = 1;
+    r = 0.0;
+    return;
+  }
+  if (!(a < centers[numBins])) {
+    i0 = i1 = numBins;
+    r = 0.0;
+    return;
+  }
+
+  int bin = findBin(a);
+  if (a < centers[bin]) { --bin; }
+  i0 = bin;
+  i1 = bin+1;
+  r = (a-centers[i0])/(centers[i1]-centers[i0]);
+}
+
+bool VectorFieldTable::build(const TH3& fx, const TH3& fy, const TH3& fz, const double valueUnit)
+{
+  xAxis_.define(*fx.GetXaxis());
+  yAxis_.define(*fx.GetYaxis());
+  zAxis_.define(*fx.GetZaxis());
+
+  const TH3* others[2] = { &fy, &fz };
+  for (const TH3* h: others) {
+    if (!(xAxis_.isSame(*h->GetXaxis()) && yAxis_.isSame(*h->GetYaxis()) && zAxis_.isSame(*h->GetZaxis()))) {
+      values_.clear();
+      return false;
+    }
+  }
+
+  const int nx = xAxis_.numBins;
+  const int ny = yAxis_.numBins;
+  const int nz = zAxis_.numBins;
+  values_.resize(3*static_cast<std::size_t>(nx+2)*(ny+2)*(nz+2));
+  for (int ix=0; ix<=nx+1; ix++) {
+    for (int iy=0; iy<=ny+1; iy++) {
+      for (int iz=0; iz<=nz+1; iz++) {
+        const std::size_t k = index(ix, iy, iz);
+        values_[k] = fx.GetBinContent(ix, iy, iz) * valueUnit;
+        values_[k+1] = fy.GetBinContent(ix, iy, iz) * valueUnit;
+        values_[k+2] = fz.GetBinContent(ix, iy, iz) * valueUnit;
+      }
+    }
+  }
+  return true;
+}
+
+vector3_t VectorFieldTable::trilinear(const double x, const double y, const double z) const
+{
+  int ix0, ix1, iy0, iy1, iz0, iz1;
+  double rx, ry, rz;
+  xAxis_.findCenterPair(x, ix0, ix1, rx);
+  yAxis_.findCenterPair(y, iy0, iy1, ry);
+  zAxis_.findCenterPair(z, iz0, iz1, rz);
+
+  const double c[8] = {
+    (1.0-rx)*(1.0-ry)*(1.0-rz),
+    (1.0-rx)*(1.0-ry)*     rz,
+    (1.0-rx)*     ry *(1.0-rz),
+    (1.0-rx)*     ry *     rz,
+         rx *(1.0-ry)*(1.0-rz),
+         rx *(1.0-ry)*     rz,
+         rx *     ry *(1.0-rz),
+         rx *     ry *     rz,
+  };
+  const std::size_t k[8] = {
+    index(ix0, iy0, iz0), index(ix0, iy0, iz1),
+    index(ix0, iy1, iz0), index(ix0, iy1, iz1),
+    index(ix1, iy0, iz0), index(ix1, iy0, iz1),
+    index(ix1, iy1, iz0), index(ix1, iy1, iz1),
+  };
+
+  double v[3] = { 0.0, 0.0, 0.0 };
+  for (int i=0; i<8; i++) {
+    v[0] += c[i]*values_[k[i]];
+    v[1] += c[i]*values_[k[i]+1];
+    v[2] += c[i]*values_[k[i]+2];
+  }
+  return vector3_t(v[0], v[1], v[2]);
+}
+
+} /* namespace comptonsoft */
@@ -24,6 +24,8 @@
 #include "WeightingPotentialPixel.hh"
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include <boost/math/constants/constants.hpp>
 
 namespace comptonsoft {
@@ -107,4 +109,41 @@ double WeightingPotentialPixel::calculateWeightingPotential(double z0)
   return phi;
 }
 
+void WeightingPotentialPixel::calculateWeightingPotential(double x0, double y0,
+                                                          const double* z0, double* phi, int n) const
+{
+  const double x = 0.5*SizeX() + x0;
+  const double y = 0.5*SizeY() + y0;
+
+  std::array<double, NumGrids_> sinAX;
+  std::array<double, NumGrids_> sinBY;
+  for (int m=1; m<=NumGrids_; m++) {
+    sinAX[m-1] = std::sin(alpha_[m-1]*x);
+  }
+  for (int l=1; l<=NumGrids_; l++) {
+    sinBY[l-1] = std::sin(beta_[l-1]*y);
+  }
+
+  std::vector<double> z(n);
+  for (int k=0; k<n; k++) {
+    z[k] = 0.5*Thickness() + z0[k];
+  }
+
+  // The terms are summed up in the same order as the single-depth version;
+  // the innermost loop over the depths has no dependency between iterations.
+  std::fill(phi, phi+n, 0.0);
+  for (int m=NumGrids_; m>=1; m--) {
+    for (int l=NumGrids_; l>=1; l--) {
+      const double a0 = a0_[m-1][l-1];
+      if (a0==0.0) continue;
+      const double g = gamma_[m-1][l-1];
+      const double sx = sinAX[m-1];
+      const double sy = sinBY[l-1];
+      for (int k=0; k<n; k++) {
+        phi[k] += std::sinh(g*z[k]) * a0 * sx * sy;
+      }
+    }
+  }
+}
+
 } /* namespace comptonsoft */
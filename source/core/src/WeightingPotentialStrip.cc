@@ -24,6 +24,8 @@
 #include "WeightingPotentialStrip.hh"
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include <boost/math/constants/constants.hpp>
 
 namespace comptonsoft {
@@ -86,4 +88,33 @@ double WeightingPotentialStrip::calculateWeightingPotential(double z0)
   return phi;
 }
 
+void WeightingPotentialStrip::calculateWeightingPotential(double x0,
+                                                          const double* z0, double* phi, int n) const
+{
+  const double x = 0.5*SizeX() + x0;
+
+  std::array<double, NumGrids_> sinAX;
+  for (int m=1; m<=NumGrids_; m++) {
+    sinAX[m-1] = std::sin(alpha_[m-1]*x);
+  }
+
+  std::vector<double> z(n);
+  for (int k=0; k<n; k++) {
+    z[k] = 0.5*Thickness() + z0[k];
+  }
+
+  // The terms are summed up in the same order as the single-depth version;
+  // the innermost loop over the depths has no dependency between iterations.
+  std::fill(phi, phi+n, 0.0);
+  for (int m=NumGrids_; m>=1; m--) {
+    const double a0 = a0_[m-1];
+    if (a0==0.0) continue;
+    const double alpha = alpha_[m-1];
+    const double sx = sinAX[m-1];
+    for (int k=0; k<n; k++) {
+      phi[k] += std::sinh(alpha*z[k]) * a0 * sx;
+    }
+  }
+}
+
 } /* namespace comptonsoft */
@@ -23,6 +23,7 @@
  * @author Hirokazu Odaka
  * @date 2019-05-23
  * @date 2020-04-01 | v1.1
+ * @date 2026-10-17 | v1.2 | num_extraction_threads
  */
 
 #ifndef COMPTONSOFT_AnalyzeFrame_H
@@ -37,7 +38,7 @@ namespace comptonsoft {
 
 class AnalyzeFrame : public VCSModule
 {
-  DEFINE_ANL_MODULE(AnalyzeFrame, 1.1);
+  DEFINE_ANL_MODULE(AnalyzeFrame, 1.2);
   // ENABLE_PARALLEL_RUN();
 public:
   AnalyzeFrame();
@@ -59,6 +60,7 @@ private:
   int event_size_ = 1;
   int trim_size_ = 0;
   bool gain_correction_ = false;
+  int num_extraction_threads_ = 1;
 
   XrayEventCollection* collection_ = nullptr;
 };
@@ -22,6 +22,7 @@
 
 #include "VCSModule.hh"
 
+#include <vector>
 #include "TH2.h"
 #include "CSTypes.hh"
 #include "EventReconstruction.hh"
@@ -34,6 +35,7 @@ namespace comptonsoft {
  * @date 2007-xx-xx
  * @date 2012-03-14
  * @date 2019-07-03 | remove CdTeFluor flag
+ * @date 2026-10-17 | analytic rasterization of cones
  */
 class BackProjection : public VCSModule
 {
@@ -45,19 +47,66 @@ public:
   anlnext::ANLStatus mod_define() override;
   anlnext::ANLStatus mod_initialize() override;
   anlnext::ANLStatus mod_analyze() override;
+  anlnext::ANLStatus mod_end_run() override;
 
 protected:
+  /**
+   * directions on a cone surface, given as A + B cos(phi) + C sin(phi).
+   */
+  struct ConeDirections
+  {
+    vector3_t A;
+    vector3_t B;
+    vector3_t C;
+  };
+
   void setUnit(double unit, std::string name)
   {
     m_PixelUnit = unit;
     m_PixelUnitName = name;
   }
 
-  double PixelUnit() { return m_PixelUnit; }
+  double PixelUnit() const { return m_PixelUnit; }
 
   void fillImage(double x, double y, double weight);
   bool sectionConeAndPlane(const vector3_t& vertex, const vector3_t& cone, vector3_t& coneProjected);
 
+  bool Rasterize() const { return m_Rasterize; }
+
+  /**
+   * fill the image buffer with the exact image of a cone, in which the weight
+   * is distributed uniformly in the azimuth angle around the cone axis.
+   * The image pixels crossed by the cone are found analytically.
+   */
+  void rasterizeCone(const vector3_t& vertex,
+                     const vector3_t& axis,
+                     double cosTheta,
+                     double weight);
+
+  /**
+   * append solutions of alpha + beta cos(phi) + gamma sin(phi) = 0 in [0, 2pi).
+   */
+  static void appendConeCrossings(double alpha, double beta, double gamma,
+                                  std::vector<double>& phiList);
+
+  /**
+   * append azimuth angles at which the projected cone crosses pixel boundaries
+   * or becomes discontinuous. Boundaries are given in the image coordinate.
+   */
+  virtual void findConeCrossings(const vector3_t& vertex,
+                                 const ConeDirections& cone,
+                                 const std::vector<double>& edgesX,
+                                 const std::vector<double>& edgesY,
+                                 std::vector<double>& phiList) const;
+
+  /**
+   * project a direction from the vertex onto the image.
+   * @return false if the direction does not hit the image plane.
+   */
+  virtual bool projectDirection(const vector3_t& vertex,
+                                const vector3_t& direction,
+                                double& x, double& y) const;
+
   EventReconstruction* getEventReconstructionModule()
   { return m_EventReconstruction; }
   
@@ -79,6 +128,13 @@ private:
 
   double m_PixelUnit;
   std::string m_PixelUnitName;
+
+  bool m_Rasterize;
+  std::vector<double> m_EdgesX;
+  std::vector<double> m_EdgesY;
+  std::vector<double> m_ImageBuffer;
+  std::vector<double> m_PhiList;
+  std::vector<int> m_ImageIndices;
 };
 
 } /* namespace comptonsoft */
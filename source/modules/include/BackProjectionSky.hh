@@ -29,6 +29,7 @@ namespace comptonsoft {
  * make back projection image in sky
  * @author Hirokazu Odaka
  * @date 2013-05-20
+ * @date 2026-10-17 | analytic rasterization of cones
  */
 class BackProjectionSky : public BackProjection
 {
@@ -41,6 +42,16 @@ public:
   anlnext::ANLStatus mod_initialize() override;
   anlnext::ANLStatus mod_analyze() override;
 
+protected:
+  void findConeCrossings(const vector3_t& vertex,
+                         const ConeDirections& cone,
+                         const std::vector<double>& edgesX,
+                         const std::vector<double>& edgesY,
+                         std::vector<double>& phiList) const override;
+  bool projectDirection(const vector3_t& vertex,
+                        const vector3_t& direction,
+                        double& x, double& y) const override;
+
 private:
   double m_Rotation;
   vector3_t m_XAxis;
@@ -0,0 +1,79 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ConvertTreeToHitColumns_H
+#define COMPTONSOFT_ConvertTreeToHitColumns_H 1
+
+#include <anlnext/BasicModule.hh>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+class TChain;
+
+namespace comptonsoft {
+
+class EventTreeIOWithInitialInfo;
+class HitTreeIOWithInitialInfo;
+class HitColumnStoreWriter;
+
+/**
+ * convert event trees or hit trees in ROOT files into a columnar hit store.
+ * Each loop converts one event; the module quits when all the entries are converted.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class ConvertTreeToHitColumns : public anlnext::BasicModule
+{
+  DEFINE_ANL_MODULE(ConvertTreeToHitColumns, 1.0);
+public:
+  ConvertTreeToHitColumns();
+  ~ConvertTreeToHitColumns();
+  
+  anlnext::ANLStatus mod_define() override;
+  anlnext::ANLStatus mod_initialize() override;
+  anlnext::ANLStatus mod_analyze() override;
+  anlnext::ANLStatus mod_finalize() override;
+
+private:
+  void convertEventTreeEntry();
+  void convertHitTreeEntries();
+
+private:
+  std::vector<std::string> fileList_;
+  std::string treeType_;
+  std::string directory_;
+  bool compression_ = false;
+
+  TChain* tree_ = nullptr;
+  bool hitTree_ = false;
+  bool initialInfo_ = false;
+  int64_t numEntries_ = 0;
+  int64_t entryIndex_ = 0;
+
+  std::unique_ptr<EventTreeIOWithInitialInfo> eventTreeIO_;
+  std::unique_ptr<HitTreeIOWithInitialInfo> hitTreeIO_;
+  std::unique_ptr<HitColumnStoreWriter> store_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ConvertTreeToHitColumns_H */
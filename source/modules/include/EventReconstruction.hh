@@ -80,10 +80,16 @@ protected:
 
   void determineHitPatterns(const std::vector<DetectorHit_sptr>& hitvec);
   void determineHitPatterns(const std::vector<int>& idvec);
+  uint64_t calculateHitPatternFlags(const std::vector<DetectorHit_sptr>& hitvec) const;
   void retrieveHitPatterns();
   void printHitPatternData();
   
   void pushReconstructedEvent(const BasicComptonEvent_sptr& event);
+
+  const BasicComptonEvent& BaseEvent() const { return *m_BaseEvent; }
+  const VEventReconstructionAlgorithm& ReconstructionAlgorithm() const
+  { return *m_Reconstruction; }
+  CSHitCollection* getHitCollection() { return m_HitCollection; }
   
 private:
   int m_MaxHits;
@@ -21,12 +21,14 @@
 #define COMPTONSOFT_LoadFrame_H 1
 
 #include <anlnext/BasicModule.hh>
+#include <memory>
 #include <unordered_set>
 #include "VDataReader.hh"
+#include "FrameData.hh"
 
 namespace comptonsoft {
 
-class FrameData;
+class FramePrefetchQueue;
 
 
 /**
@@ -36,13 +38,15 @@ class FrameData;
  * @date 2019-05-23
  * @date 2020-04-01 | upgrade for new ConstructFrame
  * @date 2021-09-30 | Taihei Watanabe | use a hash for checking file overlap
+ * @date 2026-10-17 | Hirokazu Odaka | prefetch frames in a background thread, v1.3
  */
 class LoadFrame : public anlnext::BasicModule, public VDataReader
 {
-  DEFINE_ANL_MODULE(LoadFrame, 1.2);
+  DEFINE_ANL_MODULE(LoadFrame, 1.3);
   // ENABLE_PARALLEL_RUN();
 public:
   LoadFrame();
+  ~LoadFrame();
   
 protected:
   LoadFrame(const LoadFrame&);
@@ -51,6 +55,7 @@ public:
   anlnext::ANLStatus mod_define() override;
   anlnext::ANLStatus mod_initialize() override;
   anlnext::ANLStatus mod_analyze() override;
+  anlnext::ANLStatus mod_finalize() override;
 
   void addFile(const std::string& filename) override;
   bool hasFile(const std::string& filename) const override;
@@ -61,6 +66,16 @@ public:
 protected:
   virtual bool load(FrameData* frame, const std::string& filename);
 
+  /**
+   * return true if load() only reads the raw frame by FrameData::readRawFrame(),
+   * so that frames can be read in advance by a background thread.
+   */
+  virtual bool isPrefetchable() const { return true; }
+
+private:
+  void requestPrefetch();
+  bool loadPrefetchedFrame(std::size_t fileIndex);
+
 private:
   bool byte_order_ = true;
   int odd_row_pixel_shift_ = 0;
@@ -69,8 +84,15 @@ private:
   int detector_id_ = 0;
   std::vector<std::string> files_;
   std::unordered_set<std::string> file_hash_;
+  int num_prefetch_frames_ = 0;
   FrameData* frame_ = nullptr;
   std::string current_filename_;
+
+  FrameData::DecodeBuffers prefetchBuffers_;
+  std::unique_ptr<image_t> spareRawFrame_;
+  std::size_t numPrefetchRequested_ = 0;
+  std::size_t numPrefetchPopped_ = 0;
+  std::unique_ptr<FramePrefetchQueue> prefetchQueue_;
 };
 
 } /* namespace comptonsoft */
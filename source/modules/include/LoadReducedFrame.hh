@@ -30,16 +30,18 @@ namespace comptonsoft {
  * @author Taihei Watanabe
  * @date 2021-07-29
  * @date 2022-02-01 | 1.2 | Hirokazu Odaka | derived from LoadFrame
+ * @date 2026-10-17 | 1.3 | Hirokazu Odaka | not prefetchable since load() also sets event check pixels
  */
 class LoadReducedFrame : public LoadFrame
 {
-  DEFINE_ANL_MODULE(LoadReducedFrame, 1.2);
+  DEFINE_ANL_MODULE(LoadReducedFrame, 1.3);
 
 public:
   LoadReducedFrame();
 
 protected:
   bool load(FrameData* frame, const std::string& filename) override;
+  bool isPrefetchable() const override { return false; }
 };
 
 } /* namespace comptonsoft */
@@ -22,6 +22,7 @@
 #define COMPTONSOFT_LoadRootFrame_H 1
 
 #include <cstdint>
+#include <memory>
 #include <boost/multi_array.hpp>
 #include <TChain.h>
 #include <anlnext/BasicModule.hh>
@@ -31,6 +32,7 @@
 namespace comptonsoft {
 
 class FrameData;
+class FramePrefetchQueue;
 using raw_image_t = boost::multi_array<uint16_t, 2>;
 
 
@@ -40,13 +42,16 @@ using raw_image_t = boost::multi_array<uint16_t, 2>;
  * @author Tsubasa Tamba
  * @date 2019-07-22
  * @date 2020-04-01 | Hirokazu Odaka | upgrade for new ConstrcutFrame
+ * @date 2026-10-17 | Hirokazu Odaka | prefetch frames in a background thread, v1.2
+ * @date 2026-10-17 | Hirokazu Odaka | return AS_ERROR if a frame is not read, v1.2.1
  */
 class LoadRootFrame : public anlnext::BasicModule
 {
-  DEFINE_ANL_MODULE(LoadRootFrame, 1.1);
+  DEFINE_ANL_MODULE(LoadRootFrame, 1.2.1);
   // ENABLE_PARALLEL_RUN();
 public:
   LoadRootFrame();
+  ~LoadRootFrame();
   
 protected:
   LoadRootFrame(const LoadRootFrame&);
@@ -55,6 +60,12 @@ public:
   anlnext::ANLStatus mod_define() override;
   anlnext::ANLStatus mod_initialize() override;
   anlnext::ANLStatus mod_analyze() override;
+  anlnext::ANLStatus mod_finalize() override;
+
+private:
+  bool readEntry(std::size_t frameIndex, image_t& image);
+  void requestPrefetch();
+  bool loadPrefetchedFrame(std::size_t frameIndex);
 
 private:
   int detector_id_ = 0;
@@ -64,8 +75,15 @@ private:
   size_t numEntries_ = 0;
   TChain* frametree_;
 
+  int num_prefetch_frames_ = 0;
+
   FrameData* frame_ = nullptr;
   raw_image_t rawPH_;
+
+  std::unique_ptr<image_t> spareRawFrame_;
+  std::size_t numPrefetchRequested_ = 0;
+  std::size_t numPrefetchPopped_ = 0;
+  std::unique_ptr<FramePrefetchQueue> prefetchQueue_;
 };
 
 } /* namespace comptonsoft */
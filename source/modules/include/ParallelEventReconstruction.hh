@@ -0,0 +1,97 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ParallelEventReconstruction_H
+#define COMPTONSOFT_ParallelEventReconstruction_H 1
+
+#include "EventReconstruction.hh"
+#include "InitialInformation.hh"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+class TChain;
+
+namespace comptonsoft {
+
+class EventTreeIOWithInitialInfo;
+class EventReconstructionThreadPool;
+
+/**
+ * Event reconstruction of an event tree using multiple threads.
+ * This module reads event trees (the same as ReadEventTree), and reconstructs
+ * a batch of events in parallel by a pool of worker threads, each of which has
+ * its own clone of the reconstruction algorithm.
+ * The reconstructed events are provided to the following modules one by one
+ * in the original event order, in the same way as EventReconstruction.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class ParallelEventReconstruction : public EventReconstruction, public anlgeant4::InitialInformation
+{
+  DEFINE_ANL_MODULE(ParallelEventReconstruction, 1.0);
+public:
+  ParallelEventReconstruction();
+  ~ParallelEventReconstruction();
+
+  anlnext::ANLStatus mod_define() override;
+  anlnext::ANLStatus mod_initialize() override;
+  anlnext::ANLStatus mod_analyze() override;
+
+  int64_t NumEntries() const { return numEntries_; }
+
+private:
+  struct InputEvent
+  {
+    int64_t eventID = 0;
+    double initialEnergy = 0.0;
+    vector3_t initialDirection;
+    double initialTime = 0.0;
+    vector3_t initialPosition;
+    vector3_t initialPolarization;
+    double weight = 1.0;
+  };
+
+  bool readNextBatch();
+
+private:
+  std::vector<std::string> fileList_;
+  int numThreads_;
+  int batchSize_;
+
+  TChain* tree_;
+  int64_t numEntries_ = 0;
+  int64_t entryIndex_ = 0;
+  std::unique_ptr<EventTreeIOWithInitialInfo> treeIO_;
+
+  std::unique_ptr<EventReconstructionThreadPool> threadPool_;
+  std::vector<InputEvent> inputEvents_;
+  std::vector<std::vector<DetectorHit_sptr>> hitsBatch_;
+  std::vector<BasicComptonEvent> baseEvents_;
+  std::vector<std::vector<BasicComptonEvent_sptr>> eventsReconstructed_;
+  std::vector<bool> results_;
+  std::size_t batchIndex_ = 0;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ParallelEventReconstruction_H */
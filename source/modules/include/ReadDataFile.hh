@@ -24,27 +24,33 @@
 #include "VCSModule.hh"
 #include <string>
 #include <vector>
+#include <memory>
 
 namespace comptonsoft {
 
+class DataFileStream;
+
 /**
  * Module for reading data files.
  * @author Hirokazu Odaka
  * @date 2007-10-02
  * @date 2011-04-13
  * @date 2014-11-25
+ * @date 2026-10-17 | streaming input shared by the binary formats, v3.3
+ * @date 2026-10-17 | continued packets, v3.3.1
  */
 class ReadDataFile : public VCSModule
 {
-  DEFINE_ANL_MODULE(ReadDataFile, 3.2);
+  DEFINE_ANL_MODULE(ReadDataFile, 3.3.1);
 public:
   ReadDataFile();
-  ~ReadDataFile() = default;
+  ~ReadDataFile();
 
   anlnext::ANLStatus mod_define() override;
   anlnext::ANLStatus mod_initialize() override;
   anlnext::ANLStatus mod_analyze() override
   { ++m_EventID; return anlnext::AS_OK; }
+  anlnext::ANLStatus mod_finalize() override;
 
   int EventID() const { return m_EventID; }
   int Time() const { return m_Time; }
@@ -54,12 +60,31 @@ protected:
   std::string nextFile() { return *(m_FileIterator++); }
   bool wasLastFile() const { return (m_FileIterator==m_FileList.end()); }
   bool checkFiles();
+
+  /**
+   * start reading all the remaining files as a stream of packets.
+   */
+  void openStream();
+
+  /**
+   * read a packet from the stream. The files are switched automatically.
+   * @param size size of the packet in bytes.
+   * @param continued true if the packet continues the previous one, such as
+   * the body after a header. Then the packet is not read from the next file.
+   * @return pointer to the packet, valid until the next call,
+   * or nullptr if the last file was processed or if a continued packet
+   * is truncated at the end of the file.
+   */
+  const unsigned char* readPacket(std::size_t size, bool continued=false);
   
 private:
   int m_EventID;
   int m_Time;
   std::vector<std::string> m_FileList;
   std::vector<std::string>::const_iterator m_FileIterator;
+  int m_ChunkSize;
+  bool m_BackgroundRead;
+  std::unique_ptr<DataFileStream> m_Stream;
 };
 
 } /* namespace comptonsoft */
@@ -23,6 +23,7 @@
 
 #include "ReadDataFile.hh"
 #include <cstdint>
+#include <vector>
 
 namespace comptonsoft {
 
@@ -30,10 +31,13 @@ namespace comptonsoft {
  * Read data file: "NabeBinary" format.
  * @author Hirokazu Odaka
  * @date 2011-06-06 | Hirokazu Odaka | based on rawdata2root_vata461 by S. Watanabe
+ * @date 2026-10-17 | Hirokazu Odaka | decode the packed ASIC bit stream directly, v3.3
+ * @date 2026-10-17 | Hirokazu Odaka | read packets from the stream of ReadDataFile, v3.4
+ * @date 2026-10-17 | Hirokazu Odaka | events are searched only within the frame; a truncated frame is dropped, v3.4.1
  */
 class ReadDataFile_NB0 : public ReadDataFile
 {
-  DEFINE_ANL_MODULE(ReadDataFile_NB0, 3.2);
+  DEFINE_ANL_MODULE(ReadDataFile_NB0, 3.4.1);
 public:
   ReadDataFile_NB0();
   ~ReadDataFile_NB0() = default;
@@ -53,20 +57,18 @@ public:
 private:
   bool readHK();
   bool readFrame();
-  uint32_t* readEvent(uint32_t* p);
-  void decodeASICData();
+  const uint32_t* readEvent(const uint32_t* p);
+  void decodeASICData(const uint32_t* data, size_t length);
 
 private:
   static const int HK_LENGTH = 2061;
   static const size_t FRAME_LENGTH = 8194;
-  static const size_t DATABUF_SIZE = 4096;
   
-  std::ifstream m_fin;
-  uint32_t m_HKBuf[HK_LENGTH];
-  uint32_t m_FrameBuf[FRAME_LENGTH];
+  const uint32_t* m_HKBuf;
+  const uint32_t* m_FrameBuf;
   bool m_NewFrame;
-  uint32_t* m_PtrFrame;
-  uint32_t m_DataBitBuf[DATABUF_SIZE];
+  const uint32_t* m_PtrFrame;
+  std::vector<int> m_HitChannels;
 
   int m_EventLength;
 
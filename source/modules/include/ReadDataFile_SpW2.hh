@@ -22,20 +22,20 @@
 // 2007-10-02  Hirokazu Odaka 
 // 2007-11-02  Hirokazu Odaka 
 // 2008-08-31  Hirokazu Odaka 
+// 2026-10-17  Hirokazu Odaka  read packets from the stream of ReadDataFile
 
 #ifndef COMPTONSOFT_ReadDataFile_SpW2_H
 #define COMPTONSOFT_ReadDataFile_SpW2_H 1
 
 #include "ReadDataFile.hh"
 
-#include <fstream>
 #include <string>
 
 namespace comptonsoft {
 
 class ReadDataFile_SpW2 : public ReadDataFile
 {
-  DEFINE_ANL_MODULE(ReadDataFile_SpW2, 3.2);
+  DEFINE_ANL_MODULE(ReadDataFile_SpW2, 3.3);
 public:
   ReadDataFile_SpW2();
   ~ReadDataFile_SpW2() = default;
@@ -48,11 +48,9 @@ public:
   int DeltaTime() const { return m_DeltaTime; }
 
 private:
-  const static int READ_BUF_SIZE = 16384;
   const static int HEADER_SIZE = 32;
   const static int DATA_HEADER_LENGTH = 4;
 
-  std::ifstream m_fin;
   int m_ReadPacketSize;
   int m_DeltaTime;
 };
@@ -22,20 +22,20 @@
 // 2007-11-02  Hirokazu Odaka 
 // 2008-xx-xx  read dead time by Aono
 // 2008-08-31  Hirokazu Odaka 
+// 2026-10-17  Hirokazu Odaka  read packets from the stream of ReadDataFile
 
 #ifndef COMPTONSOFT_ReadDataFile_VME3_H
 #define COMPTONSOFT_ReadDataFile_VME3_H 1
 
 #include "ReadDataFile.hh"
 
-#include <fstream>
 #include <string>
 
 namespace comptonsoft {
 
 class ReadDataFile_VME3 : public ReadDataFile
 {
-  DEFINE_ANL_MODULE(ReadDataFile_VME3, 3.2);
+  DEFINE_ANL_MODULE(ReadDataFile_VME3, 3.3);
 public:
   ReadDataFile_VME3();
   ~ReadDataFile_VME3() = default;
@@ -48,13 +48,11 @@ public:
   unsigned short int DeadTime() const { return m_DeadTime; }
 
 private:
-  const static int READ_BUF_SIZE = 16384;
   const static int HEADER_SIZE = 16;
   const static int FOOTER_SIZE = 4;
   const static int DATA_HEADER_LENGTH = 1;
   const static int DATA_FOOTER_LENGTH = 1;
 
-  std::ifstream m_fin;
   int m_ReadPacketSize;
   unsigned short int m_DeadTime;
 };
@@ -40,10 +40,11 @@ class EventTreeIOWithInitialInfo;
  * @author Hitokazu Odaka
  * @date 2015-11-14
  * @date 2019-04-22 | initialization in mod_begin_run()
+ * @date 2026-10-17 | Hirokazu Odaka | selection of branches to be read, v2.2
  */
 class ReadEventTree : public VCSModule, public anlgeant4::InitialInformation
 {
-  DEFINE_ANL_MODULE(ReadEventTree, 2.1);
+  DEFINE_ANL_MODULE(ReadEventTree, 2.2);
 public:
   ReadEventTree();
   ~ReadEventTree();
@@ -60,6 +61,7 @@ protected:
   
 private:
   std::vector<std::string> fileList_;
+  std::vector<std::string> branches_;
 
   TChain* tree_;
   int64_t numEntries_ = 0;
@@ -0,0 +1,73 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_ReadHitColumns_H
+#define COMPTONSOFT_ReadHitColumns_H 1
+
+#include "VCSModule.hh"
+#include "InitialInformation.hh"
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "DetectorHit_sptr.hh"
+
+namespace comptonsoft {
+
+class CSHitCollection;
+class HitColumnStoreReader;
+
+/**
+ * read events from a columnar hit store written by WriteHitColumns or ConvertTreeToHitColumns.
+ * Each loop reads one event as ReadEventTree does.
+ * Other modules can also access the columns directly through getStore().
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class ReadHitColumns : public VCSModule, public anlgeant4::InitialInformation
+{
+  DEFINE_ANL_MODULE(ReadHitColumns, 1.0);
+public:
+  ReadHitColumns();
+  ~ReadHitColumns();
+  
+  anlnext::ANLStatus mod_define() override;
+  anlnext::ANLStatus mod_initialize() override;
+  anlnext::ANLStatus mod_begin_run() override;
+  anlnext::ANLStatus mod_analyze() override;
+
+  int64_t NumEntries() const { return numEntries_; }
+  const HitColumnStoreReader& getStore() const { return *store_; }
+
+protected:
+  virtual void insertHit(const DetectorHit_sptr& hit);
+  
+private:
+  std::string directory_;
+  int64_t numEntries_ = 0;
+  int64_t entryIndex_ = 0;
+
+  CSHitCollection* hitCollection_;
+  std::unique_ptr<HitColumnStoreReader> store_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_ReadHitColumns_H */
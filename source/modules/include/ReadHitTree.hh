@@ -34,15 +34,17 @@ namespace comptonsoft {
 
 class CSHitCollection;
 class HitTreeIOWithInitialInfo;
+class HitTreeBlockReader;
 
 /**
  * @author Hitokazu Odaka
  * @date 2014-11-30
  * @date 2019-04-22 | initialization in mod_begin_run()
+ * @date 2026-10-17 | Hirokazu Odaka | block reading, optionally in a background thread, v2.2
  */
 class ReadHitTree : public VCSModule, public anlgeant4::InitialInformation
 {
-  DEFINE_ANL_MODULE(ReadHitTree, 2.1);
+  DEFINE_ANL_MODULE(ReadHitTree, 2.2);
 public:
   ReadHitTree();
   ~ReadHitTree();
@@ -51,13 +53,19 @@ public:
   anlnext::ANLStatus mod_initialize() override;
   anlnext::ANLStatus mod_begin_run() override;
   anlnext::ANLStatus mod_analyze() override;
+  anlnext::ANLStatus mod_finalize() override;
 
 protected:
   virtual void insertHit(const DetectorHit_sptr& hit);
+
+private:
+  anlnext::ANLStatus readEventFromBlocks();
   
 private:
   std::vector<std::string> fileList_;
   bool trustNumHits_;
+  int blockSize_ = 0;
+  bool backgroundRead_ = false;
 
   TChain* hittree_;
   int64_t numEntries_ = 0;
@@ -65,6 +73,7 @@ private:
 
   CSHitCollection* hitCollection_;
   std::unique_ptr<HitTreeIOWithInitialInfo> treeIO_;
+  std::unique_ptr<HitTreeBlockReader> blockReader_;
 };
 
 } /* namespace comptonsoft */
@@ -24,36 +24,36 @@
  * @author Tsubasa Tamba
  * @date 2019-07-24
  * @date 2020-04-01 | v1.1
+ * @date 2026-10-17 | Hirokazu Odaka | v1.2: running medians by SlidingWindowMedian
  */
 
 #ifndef COMPTONSOFT_SetPedestalsByMedian_H
 #define COMPTONSOFT_SetPedestalsByMedian_H 1
 
 #include "VCSModule.hh"
-#include <boost/multi_array.hpp>
+#include <memory>
 
 namespace comptonsoft {
 
-using frames_t = boost::multi_array<std::vector<std::pair<int, double>>, 2>;
+class SlidingWindowMedian;
 
 class SetPedestalsByMedian : public VCSModule
 {
-  DEFINE_ANL_MODULE(SetPedestalsByMedian, 1.1);
+  DEFINE_ANL_MODULE(SetPedestalsByMedian, 1.2);
   // ENABLE_PARALLEL_RUN();
 public:
   SetPedestalsByMedian();
+  ~SetPedestalsByMedian();
   
 public:
   anlnext::ANLStatus mod_define() override;
   anlnext::ANLStatus mod_begin_run() override;
   anlnext::ANLStatus mod_analyze() override;
 
-  double calculateMedian(std::vector<std::pair<int, double>>& v);
-
 private:
   int detectorID_ = 0;
   int frameBin_ = 1;
-  frames_t frameStack_;
+  std::unique_ptr<SlidingWindowMedian> medians_;
   int nx_ = 1;
   int ny_ = 1;
   FrameData* frameData_ = nullptr;
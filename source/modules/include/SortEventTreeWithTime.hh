@@ -38,14 +38,16 @@ namespace comptonsoft {
 
 class CSHitCollection;
 class EventTreeIOWithInitialInfo;
+class ExternalTimeSorter;
 
 /**
  * @author Tsubasa Tamba
  * @date 2014-06-07
+ * @date 2026-10-17 | Hirokazu Odaka | external sort mode, v1.1
  */
 class SortEventTreeWithTime : public VCSModule, public anlgeant4::InitialInformation
 {
-  DEFINE_ANL_MODULE(SortEventTreeWithTime, 1.0);
+  DEFINE_ANL_MODULE(SortEventTreeWithTime, 1.1);
 public:
   SortEventTreeWithTime();
   ~SortEventTreeWithTime();
@@ -57,9 +59,15 @@ public:
 
 protected:
   virtual void insertHit(const DetectorHit_sptr& hit);
+
+private:
+  anlnext::ANLStatus sortExternally();
   
 private:
   std::vector<std::string> fileList_;
+  bool externalSort_ = false;
+  int memoryBudget_ = 1024;
+  std::string temporaryDirectory_;
 
   TChain* tree_;
   int64_t numEntries_ = 0;
@@ -69,6 +77,7 @@ private:
   std::unique_ptr<EventTreeIOWithInitialInfo> treeIO_;
   std::list<std::vector<DetectorHit_sptr>> eventList_;
   std::list<std::vector<DetectorHit_sptr>>::iterator eventIter_;
+  std::unique_ptr<ExternalTimeSorter> sorter_;
 };
 
 } /* namespace comptonsoft */
@@ -0,0 +1,66 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef COMPTONSOFT_WriteHitColumns_H
+#define COMPTONSOFT_WriteHitColumns_H 1
+
+#include "VCSModule.hh"
+#include <string>
+#include <memory>
+
+namespace anlgeant4 {
+class InitialInformation;
+}
+
+namespace comptonsoft {
+
+class HitColumnStoreWriter;
+class CSHitCollection;
+
+/**
+ * write hits into a columnar hit store (a directory of memory-mappable column files).
+ * As WriteEventTree, hits of each time group make one event.
+ *
+ * @author Hirokazu Odaka
+ * @date 2026-10-17
+ */
+class WriteHitColumns : public VCSModule
+{
+  DEFINE_ANL_MODULE(WriteHitColumns, 1.0);
+public:
+  WriteHitColumns();
+  ~WriteHitColumns();
+
+  anlnext::ANLStatus mod_define() override;
+  anlnext::ANLStatus mod_initialize() override;
+  anlnext::ANLStatus mod_analyze() override;
+  anlnext::ANLStatus mod_finalize() override;
+
+private:
+  std::string directory_;
+  bool compression_ = false;
+  bool notice_undetected_ = false;
+  const CSHitCollection* hitCollection_ = nullptr;
+  const anlgeant4::InitialInformation* initialInfo_ = nullptr;
+  std::unique_ptr<HitColumnStoreWriter> store_;
+};
+
+} /* namespace comptonsoft */
+
+#endif /* COMPTONSOFT_WriteHitColumns_H */
@@ -42,6 +42,7 @@ ANLStatus AnalyzeFrame::mod_define()
   define_parameter("event_size", &mod_class::event_size_);
   define_parameter("trim_size", &mod_class::trim_size_);
   define_parameter("gain_correction", &mod_class::gain_correction_);
+  define_parameter("num_extraction_threads", &mod_class::num_extraction_threads_);
   
   return AS_OK;
 }
@@ -66,6 +67,7 @@ ANLStatus AnalyzeFrame::mod_begin_run()
       frame->setPedestals(pedestal_level_);
       frame->setEventSize(event_size_);
       frame->setTrimSize(trim_size_);
+      frame->setNumEventExtractionThreads(num_extraction_threads_);
     }
   }
 
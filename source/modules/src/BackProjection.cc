@@ -20,6 +20,8 @@
 
 #include "BackProjection.hh"
 
+#include <cmath>
+#include <algorithm>
 #include "AstroUnits.hh"
 #include "TDirectory.h"
 #include "TRandom3.h"
@@ -40,7 +42,8 @@ BackProjection::BackProjection()
     m_NumPixelX(256), m_NumPixelY(256),
     m_RangeX1(-4.0*unit::cm), m_RangeX2(+4.0*unit::cm),
     m_RangeY1(-4.0*unit::cm), m_RangeY2(+4.0*unit::cm),
-    m_PixelUnit(unit::cm), m_PixelUnitName("cm")
+    m_PixelUnit(unit::cm), m_PixelUnitName("cm"),
+    m_Rasterize(false)
 {
 }
 
@@ -56,6 +59,8 @@ ANLStatus BackProjection::mod_define()
   register_parameter(&m_RangeX2, "x_max", 1, m_PixelUnitName);
   register_parameter(&m_RangeY1, "y_min", 1, m_PixelUnitName);
   register_parameter(&m_RangeY2, "y_max", 1, m_PixelUnitName);
+  register_parameter(&m_Rasterize, "rasterize");
+  set_parameter_description("If true, the cones are rasterized analytically instead of random sampling.");
 
   return AS_OK;
 }
@@ -81,12 +86,31 @@ ANLStatus BackProjection::mod_initialize()
     m_hist_vec[i] = new TH2D(hist_name.c_str(), hist_title.c_str(), m_NumPixelX, m_RangeX1, m_RangeX2, m_NumPixelY, m_RangeY1, m_RangeY2);
   }
 
+  if (m_Rasterize) {
+    m_EdgesX.resize(m_NumPixelX+1);
+    for (int i=0; i<=m_NumPixelX; i++) {
+      m_EdgesX[i] = m_RangeX1 + (m_RangeX2-m_RangeX1)*i/m_NumPixelX;
+    }
+    m_EdgesY.resize(m_NumPixelY+1);
+    for (int i=0; i<=m_NumPixelY; i++) {
+      m_EdgesY[i] = m_RangeY1 + (m_RangeY2-m_RangeY1)*i/m_NumPixelY;
+    }
+    m_ImageBuffer.assign((1+m_hist_vec.size())*m_NumPixelX*m_NumPixelY, 0.0);
+  }
+
   return AS_OK;
 }
 
 ANLStatus BackProjection::mod_analyze()
 {
   const std::vector<BasicComptonEvent_sptr> events = getEventReconstructionModule()->getReconstructedEvents();
+  if (m_Rasterize) {
+    for (const auto& event: events) {
+      rasterizeCone(event->ConeVertex(), event->ConeAxis(), event->CosThetaE(), event->ReconstructionFraction());
+    }
+    return AS_OK;
+  }
+
   for (const auto& event: events) {
     const double fraction = event->ReconstructionFraction();
 
@@ -124,6 +148,30 @@ ANLStatus BackProjection::mod_analyze()
   return AS_OK;
 }
 
+ANLStatus BackProjection::mod_end_run()
+{
+  if (!m_Rasterize) {
+    return AS_OK;
+  }
+
+  const std::size_t imageSize = m_NumPixelX*m_NumPixelY;
+  for (std::size_t k=0; k<=m_hist_vec.size(); k++) {
+    TH2D* hist = (k==0) ? m_hist_bp_All : m_hist_vec[k-1];
+    double* image = &m_ImageBuffer[k*imageSize];
+    for (int ix=0; ix<m_NumPixelX; ix++) {
+      for (int iy=0; iy<m_NumPixelY; iy++) {
+        const double v = image[ix*m_NumPixelY+iy];
+        if (v != 0.0) {
+          hist->AddBinContent(hist->GetBin(ix+1, iy+1), v);
+        }
+      }
+    }
+    std::fill(image, image+imageSize, 0.0);
+  }
+
+  return AS_OK;
+}
+
 void BackProjection::fillImage(double x, double y, double weight)
 {
   // Filling histograms 
@@ -144,4 +192,120 @@ bool BackProjection::sectionConeAndPlane(const vector3_t& vertex, const vector3_
   return true;
 }
 
-} /* namespace comptonsoft */
\ No newline at end of file
+void BackProjection::appendConeCrossings(double alpha, double beta, double gamma,
+                                         std::vector<double>& phiList)
+{
+  const double r = std::sqrt(beta*beta+gamma*gamma);
+  if (r == 0.0) { return; }
+  const double c = -alpha/r;
+  if (c < -1.0 || c > 1.0) { return; }
+  const double psi = std::atan2(gamma, beta);
+  const double delta = std::acos(c);
+  for (double phi: {psi+delta, psi-delta}) {
+    phi = std::fmod(phi, CLHEP::twopi);
+    if (phi < 0.0) { phi += CLHEP::twopi; }
+    phiList.push_back(phi);
+  }
+}
+
+void BackProjection::rasterizeCone(const vector3_t& vertex,
+                                   const vector3_t& axis,
+                                   double cosTheta,
+                                   double weight)
+{
+  const vector3_t e0 = axis.unit();
+  const vector3_t e1 = e0.orthogonal().unit();
+  const vector3_t e2 = e0.cross(e1);
+  const double c = std::max(-1.0, std::min(1.0, cosTheta));
+  const double s = std::sqrt(1.0-c*c);
+  ConeDirections cone;
+  cone.A = c*e0;
+  cone.B = s*e1;
+  cone.C = s*e2;
+
+  m_PhiList.clear();
+  m_PhiList.push_back(0.0);
+  m_PhiList.push_back(CLHEP::twopi);
+  findConeCrossings(vertex, cone, m_EdgesX, m_EdgesY, m_PhiList);
+  std::sort(m_PhiList.begin(), m_PhiList.end());
+
+  m_ImageIndices.clear();
+  m_ImageIndices.push_back(0);
+  for (unsigned int i=0; i<m_hist_vec.size(); i++) {
+    if (m_EventReconstruction->HitPatternFlag(i)) {
+      m_ImageIndices.push_back(i+1);
+    }
+  }
+
+  const std::size_t imageSize = m_NumPixelX*m_NumPixelY;
+  const double scaleX = m_NumPixelX/(m_RangeX2-m_RangeX1);
+  const double scaleY = m_NumPixelY/(m_RangeY2-m_RangeY1);
+  const double weightPerPhi = weight/CLHEP::twopi;
+
+  // the cone stays in one pixel between two adjacent crossings.
+  for (std::size_t k=0; k+1<m_PhiList.size(); k++) {
+    const double phi0 = m_PhiList[k];
+    const double phi1 = m_PhiList[k+1];
+    if (phi1 <= phi0) { continue; }
+
+    const double phi = 0.5*(phi0+phi1);
+    const vector3_t direction = cone.A + std::cos(phi)*cone.B + std::sin(phi)*cone.C;
+    double x = 0.0, y = 0.0;
+    if (!projectDirection(vertex, direction, x, y)) {
+      continue;
+    }
+
+    const int ix = static_cast<int>(std::floor((x-m_RangeX1)*scaleX));
+    const int iy = static_cast<int>(std::floor((y-m_RangeY1)*scaleY));
+    if (ix<0 || ix>=m_NumPixelX || iy<0 || iy>=m_NumPixelY) {
+      continue;
+    }
+
+    const double w = weightPerPhi*(phi1-phi0);
+    const std::size_t pixel = ix*m_NumPixelY+iy;
+    for (const int index: m_ImageIndices) {
+      m_ImageBuffer[index*imageSize+pixel] += w;
+    }
+  }
+}
+
+void BackProjection::findConeCrossings(const vector3_t& vertex,
+                                       const ConeDirections& cone,
+                                       const std::vector<double>& edgesX,
+                                       const std::vector<double>& edgesY,
+                                       std::vector<double>& phiList) const
+{
+  // plane point: vertex + h/(n.d) d, where d = A + B cos(phi) + C sin(phi).
+  const double h = m_PlaneNormal*(m_PlanePoint-vertex);
+  const double nA = m_PlaneNormal*cone.A;
+  const double nB = m_PlaneNormal*cone.B;
+  const double nC = m_PlaneNormal*cone.C;
+
+  // n.d changes its sign.
+  appendConeCrossings(nA, nB, nC, phiList);
+
+  for (const double edge: edgesX) {
+    const double u = vertex.x() - edge*m_PixelUnit;
+    appendConeCrossings(u*nA+h*cone.A.x(), u*nB+h*cone.B.x(), u*nC+h*cone.C.x(), phiList);
+  }
+  for (const double edge: edgesY) {
+    const double u = vertex.y() - edge*m_PixelUnit;
+    appendConeCrossings(u*nA+h*cone.A.y(), u*nB+h*cone.B.y(), u*nC+h*cone.C.y(), phiList);
+  }
+}
+
+bool BackProjection::projectDirection(const vector3_t& vertex,
+                                      const vector3_t& direction,
+                                      double& x, double& y) const
+{
+  const double denominator = m_PlaneNormal*direction;
+  if (denominator == 0.0) { return false; }
+  const double t = (m_PlaneNormal*(m_PlanePoint-vertex)) / denominator;
+  if (t < 0.0) { return false; }
+  const vector3_t projected = vertex + t*direction;
+  x = projected.x()/m_PixelUnit;
+  y = projected.y()/m_PixelUnit;
+  return true;
+}
+
+} /* namespace comptonsoft */
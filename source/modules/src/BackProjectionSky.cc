@@ -20,6 +20,8 @@
 
 #include "BackProjectionSky.hh"
 
+#include <cmath>
+#include <algorithm>
 #include "AstroUnits.hh"
 #include "TDirectory.h"
 #include "TRandom3.h"
@@ -65,6 +67,13 @@ ANLStatus BackProjectionSky::mod_initialize()
 ANLStatus BackProjectionSky::mod_analyze()
 {
   const std::vector<BasicComptonEvent_sptr> events = getEventReconstructionModule()->getReconstructedEvents();
+  if (Rasterize()) {
+    for (const auto& event: events) {
+      rasterizeCone(event->ConeVertex(), event->ConeAxis(), event->CosThetaE(), event->ReconstructionFraction());
+    }
+    return AS_OK;
+  }
+
   for (const auto& event: events) {
     const double fraction = event->ReconstructionFraction();
 
@@ -101,4 +110,38 @@ ANLStatus BackProjectionSky::mod_analyze()
   return AS_OK;
 }
 
-} /* namespace comptonsoft */
\ No newline at end of file
+void BackProjectionSky::findConeCrossings(const vector3_t& /* vertex */,
+                                          const ConeDirections& cone,
+                                          const std::vector<double>& edgesX,
+                                          const std::vector<double>& edgesY,
+                                          std::vector<double>& phiList) const
+{
+  // x = atan2(ux, uz) jumps at ux = 0 (uz < 0).
+  appendConeCrossings(cone.A.dot(m_XAxis), cone.B.dot(m_XAxis), cone.C.dot(m_XAxis), phiList);
+
+  // x = X: ux cos(X) - uz sin(X) = 0
+  for (const double edge: edgesX) {
+    const double angle = edge*PixelUnit();
+    const vector3_t w = std::cos(angle)*m_XAxis - std::sin(angle)*m_ZAxis;
+    appendConeCrossings(cone.A.dot(w), cone.B.dot(w), cone.C.dot(w), phiList);
+  }
+  // y = Y: uy = sin(Y)
+  for (const double edge: edgesY) {
+    const double angle = edge*PixelUnit();
+    appendConeCrossings(cone.A.dot(m_YAxis)-std::sin(angle), cone.B.dot(m_YAxis), cone.C.dot(m_YAxis), phiList);
+  }
+}
+
+bool BackProjectionSky::projectDirection(const vector3_t& /* vertex */,
+                                         const vector3_t& direction,
+                                         double& x, double& y) const
+{
+  const double ux = direction.dot(m_XAxis);
+  const double uy = std::max(-1.0, std::min(1.0, direction.dot(m_YAxis)));
+  const double uz = direction.dot(m_ZAxis);
+  x = std::atan2(ux, uz)/PixelUnit();
+  y = (0.5*CLHEP::pi - std::acos(uy))/PixelUnit();
+  return true;
+}
+
+} /* namespace comptonsoft */
@@ -24,6 +24,7 @@
 #include "VRealDetectorUnit.hh"
 #include "DeviceSimulation.hh"
 #include "DetectorSystem.hh"
+#include "Geant4Body.hh"
 
 using namespace anlnext;
 
@@ -69,6 +70,22 @@ ANLStatus ConstructDetectorForSimulation::mod_initialize()
     }
   }
 
+  // In the multithreaded mode, each worker thread needs its own sensitive detectors,
+  // which must be registered before Geant4Body starts the worker threads.
+  if (exist_module("Geant4Body")) {
+    anlgeant4::Geant4Body* geant4Body = nullptr;
+    get_module_NC("Geant4Body", &geant4Body);
+    if (geant4Body->isMultithreaded()) {
+      const bool registered = geant4Body->addWorkerInitialization([detectorManager]() {
+          detectorManager->registerGeant4SensitiveDetectorsForWorker();
+        });
+      if (!registered) {
+        std::cout << "ConstructDetectorForSimulation: this module must be placed before Geant4Body." << std::endl;
+        return AS_QUIT_ERROR;
+      }
+    }
+  }
+
   return AS_OK;
 }
 
@@ -80,6 +97,7 @@ ANLStatus ConstructDetectorForSimulation::mod_begin_run()
 
   DetectorSystem* detectorManager = getDetectorManager();
   detectorManager->registerGeant4SensitiveDetectors();
+
   return AS_OK;
 }
 
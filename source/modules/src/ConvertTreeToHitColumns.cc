@@ -0,0 +1,176 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ConvertTreeToHitColumns.hh"
+#include "TChain.h"
+#include "DetectorHit.hh"
+#include "EventTreeIOWithInitialInfo.hh"
+#include "HitTreeIOWithInitialInfo.hh"
+#include "HitColumnStore.hh"
+
+using namespace anlnext;
+
+namespace comptonsoft
+{
+
+ConvertTreeToHitColumns::ConvertTreeToHitColumns()
+  : treeType_("eventtree"),
+    directory_("hit_columns"),
+    store_(new HitColumnStoreWriter)
+{
+}
+
+ConvertTreeToHitColumns::~ConvertTreeToHitColumns() = default;
+
+ANLStatus ConvertTreeToHitColumns::mod_define()
+{
+  define_parameter("file_list", &mod_class::fileList_);
+  define_parameter("tree_type", &mod_class::treeType_);
+  set_parameter_description("eventtree or hittree");
+  define_parameter("directory", &mod_class::directory_);
+  set_parameter_description("Directory of the column files");
+  define_parameter("compression", &mod_class::compression_);
+  set_parameter_description("If true, integer columns are delta-encoded.");
+  return AS_OK;
+}
+
+ANLStatus ConvertTreeToHitColumns::mod_initialize()
+{
+  if (treeType_ == "eventtree") {
+    hitTree_ = false;
+  }
+  else if (treeType_ == "hittree") {
+    hitTree_ = true;
+  }
+  else {
+    std::cout << "ConvertTreeToHitColumns: unknown tree type " << treeType_ << std::endl;
+    return AS_QUIT_ERROR;
+  }
+
+  tree_ = new TChain(treeType_.c_str());
+  for (const std::string& filename: fileList_) {
+    tree_->Add(filename.c_str());
+  }
+  initialInfo_ = (tree_->GetBranch("ini_energy") != nullptr);
+
+  if (hitTree_) {
+    hitTreeIO_.reset(new HitTreeIOWithInitialInfo);
+    hitTreeIO_->setTree(tree_);
+    if (initialInfo_) {
+      hitTreeIO_->enableInitialInfoRecord();
+    }
+    else {
+      hitTreeIO_->disableInitialInfoRecord();
+    }
+    hitTreeIO_->setBranchAddresses();
+  }
+  else {
+    eventTreeIO_.reset(new EventTreeIOWithInitialInfo);
+    eventTreeIO_->setTree(tree_);
+    if (initialInfo_) {
+      eventTreeIO_->enableInitialInfoRecord();
+    }
+    else {
+      eventTreeIO_->disableInitialInfoRecord();
+    }
+    eventTreeIO_->setBranchAddresses();
+  }
+
+  numEntries_ = tree_->GetEntries();
+  std::cout << "Number of entries: " << numEntries_ << std::endl;
+
+  if (!store_->open(directory_, initialInfo_, compression_)) {
+    std::cout << "ConvertTreeToHitColumns: cannot create a store in " << directory_ << std::endl;
+    return AS_QUIT_ERROR;
+  }
+
+  return AS_OK;
+}
+
+ANLStatus ConvertTreeToHitColumns::mod_analyze()
+{
+  if (entryIndex_ == numEntries_) {
+    return AS_QUIT;
+  }
+
+  if (hitTree_) {
+    convertHitTreeEntries();
+  }
+  else {
+    convertEventTreeEntry();
+  }
+
+  return AS_OK;
+}
+
+void ConvertTreeToHitColumns::convertEventTreeEntry()
+{
+  eventTreeIO_->getEntry(entryIndex_);
+
+  if (initialInfo_) {
+    store_->setInitialInfo(eventTreeIO_->getInitialEnergy(),
+                           eventTreeIO_->getInitialDirection(),
+                           eventTreeIO_->getInitialTime(),
+                           eventTreeIO_->getInitialPosition(),
+                           eventTreeIO_->getInitialPolarization());
+    store_->setWeight(eventTreeIO_->getWeight());
+  }
+
+  const std::vector<DetectorHit_sptr> hits = eventTreeIO_->retrieveHits(entryIndex_, false);
+  store_->fillHits(eventTreeIO_->getEventID(), hits);
+}
+
+void ConvertTreeToHitColumns::convertHitTreeEntries()
+{
+  tree_->GetEntry(entryIndex_);
+
+  const int64_t EventID = hitTreeIO_->getEventID();
+  if (initialInfo_) {
+    store_->setInitialInfo(hitTreeIO_->getInitialEnergy(),
+                           hitTreeIO_->getInitialDirection(),
+                           hitTreeIO_->getInitialTime(),
+                           hitTreeIO_->getInitialPosition(),
+                           hitTreeIO_->getInitialPolarization());
+    store_->setWeight(hitTreeIO_->getWeight());
+  }
+
+  std::vector<DetectorHit_sptr> hits;
+  do {
+    hits.push_back(hitTreeIO_->retrieveHit());
+    entryIndex_++;
+    if (entryIndex_ == numEntries_) {
+      break;
+    }
+    tree_->GetEntry(entryIndex_);
+  } while (hitTreeIO_->getEventID() == EventID);
+
+  store_->fillHits(EventID, hits);
+}
+
+ANLStatus ConvertTreeToHitColumns::mod_finalize()
+{
+  std::cout << "ConvertTreeToHitColumns: " << store_->NumberOfEvents() << " events, "
+            << store_->NumberOfHits() << " hits" << std::endl;
+  if (!store_->close()) {
+    return AS_QUIT_ERROR;
+  }
+  return AS_OK;
+}
+
+} /* namespace comptonsoft */
@@ -222,6 +222,20 @@ void EventReconstruction::determineHitPatterns(const std::vector<int>& detectorI
   m_BaseEvent->setHitPattern(flags);
 }
 
+uint64_t EventReconstruction::
+calculateHitPatternFlags(const std::vector<DetectorHit_sptr>& hits) const
+{
+  const std::vector<HitPattern>& hitPatterns
+    = getDetectorManager()->getHitPatterns();
+  uint64_t flags(0ul);
+  for (const HitPattern& hitPattern: hitPatterns) {
+    if (hitPattern.match(hits)) {
+      flags |= (1ul<<hitPattern.Bit());
+    }
+  }
+  return flags;
+}
+
 void EventReconstruction::retrieveHitPatterns()
 {
   if (NumberOfReconstructedEvents() == 0) { return; }
@@ -21,6 +21,7 @@
 #include "LoadFrame.hh"
 #include <algorithm>
 #include "FrameData.hh"
+#include "FramePrefetchQueue.hh"
 #include "ConstructDetector.hh"
 #include "DetectorSystem.hh"
 #include "VRealDetectorUnit.hh"
@@ -33,6 +34,8 @@ LoadFrame::LoadFrame()
 {
 }
 
+LoadFrame::~LoadFrame() = default;
+
 ANLStatus LoadFrame::mod_define()
 {
   define_parameter("byte_order", &mod_class::byte_order_);
@@ -41,6 +44,8 @@ ANLStatus LoadFrame::mod_define()
   define_parameter("read_direction_x", &mod_class::read_direction_x_);
   define_parameter("detector_id", &mod_class::detector_id_);
   define_parameter("files", &mod_class::files_);
+  define_parameter("num_prefetch_frames", &mod_class::num_prefetch_frames_);
+  set_parameter_description("Number of frames read in advance by a background thread. If zero, each frame is read in the analysis loop.");
   
   return AS_OK;
 }
@@ -67,6 +72,17 @@ ANLStatus LoadFrame::mod_initialize()
     return AS_QUIT;
   }
 
+  if (num_prefetch_frames_ > 0) {
+    if (isPrefetchable()) {
+      prefetchQueue_.reset(new FramePrefetchQueue(num_prefetch_frames_, frame_->getRawFrame()));
+      spareRawFrame_.reset(new image_t(frame_->getRawFrame()));
+      requestPrefetch();
+    }
+    else {
+      std::cout << "[LoadFrame] prefetch is not available for " << module_id() << "." << std::endl;
+    }
+  }
+
   return AS_OK;
 }
 
@@ -81,7 +97,7 @@ ANLStatus LoadFrame::mod_analyze()
   std::cout << "[LoadFrame] filename: " << current_filename_ << std::endl;
 
   frame_->setFrameID(fileIndex);
-  bool status = load(frame_, current_filename_);
+  const bool status = prefetchQueue_ ? loadPrefetchedFrame(fileIndex) : load(frame_, current_filename_);
   if (!status) {
     return AS_ERROR;
   }
@@ -89,6 +105,43 @@ ANLStatus LoadFrame::mod_analyze()
   return AS_OK;
 }
 
+ANLStatus LoadFrame::mod_finalize()
+{
+  // the reader thread refers to the frame owned by another module.
+  prefetchQueue_.reset();
+  return AS_OK;
+}
+
+void LoadFrame::requestPrefetch()
+{
+  const FrameData* frame = frame_;
+  FrameData::DecodeBuffers* buffers = &prefetchBuffers_;
+  while (numPrefetchRequested_ < files_.size() && !prefetchQueue_->isFull()) {
+    const std::string filename = files_[numPrefetchRequested_];
+    prefetchQueue_->push([frame, buffers, filename](image_t& image) {
+        return frame->readRawFrame(filename, image, *buffers);
+      });
+    ++numPrefetchRequested_;
+  }
+}
+
+bool LoadFrame::loadPrefetchedFrame(std::size_t fileIndex)
+{
+  // frames of the loops in which this module was not called are discarded.
+  bool status = false;
+  while (numPrefetchPopped_ <= fileIndex) {
+    requestPrefetch();
+    status = prefetchQueue_->pop(spareRawFrame_);
+    ++numPrefetchPopped_;
+  }
+  requestPrefetch();
+
+  if (status) {
+    frame_->swapRawFrame(spareRawFrame_);
+  }
+  return status;
+}
+
 bool LoadFrame::load(FrameData* frame, const std::string& filename)
 {
   return frame->load(filename);
@@ -98,6 +151,9 @@ void LoadFrame::addFile(const std::string& filename)
 {
   files_.push_back(filename);
   file_hash_.insert(filename);
+  if (prefetchQueue_) {
+    requestPrefetch();
+  }
 }
 
 bool LoadFrame::hasFile(const std::string& filename) const
@@ -18,7 +18,9 @@
  *************************************************************************/
 
 #include "LoadRootFrame.hh"
+#include <TROOT.h>
 #include "FrameData.hh"
+#include "FramePrefetchQueue.hh"
 #include "ConstructFrame.hh"
 
 using namespace anlnext;
@@ -31,11 +33,15 @@ LoadRootFrame::LoadRootFrame()
 {
 }
 
+LoadRootFrame::~LoadRootFrame() = default;
+
 ANLStatus LoadRootFrame::mod_define()
 {
   define_parameter("files", &mod_class::files_);
   define_parameter("tree_name", &mod_class::treename_);
   define_parameter("branch_name", &mod_class::branchname_);
+  define_parameter("num_prefetch_frames", &mod_class::num_prefetch_frames_);
+  set_parameter_description("Number of frames read in advance by a background thread. If zero, each frame is read in the analysis loop.");
   
   return AS_OK;
 }
@@ -69,6 +75,14 @@ ANLStatus LoadRootFrame::mod_initialize()
   frametree_->SetBranchAddress(branchname_.c_str(), &rawPH_[0][0]);
   numEntries_ = frametree_->GetEntries();
 
+  if (num_prefetch_frames_ > 0) {
+    // the tree is read by the background thread while the other modules use ROOT.
+    ROOT::EnableThreadSafety();
+    prefetchQueue_.reset(new FramePrefetchQueue(num_prefetch_frames_, frame_->getRawFrame()));
+    spareRawFrame_.reset(new image_t(frame_->getRawFrame()));
+    requestPrefetch();
+  }
+
   return AS_OK;
 }
 
@@ -80,18 +94,64 @@ ANLStatus LoadRootFrame::mod_analyze()
   }
 
   frame_->setFrameID(frameIndex);
-  frametree_->GetEntry(frameIndex);
+  const bool status = prefetchQueue_ ? loadPrefetchedFrame(frameIndex) : readEntry(frameIndex, frame_->getRawFrame());
+  if (!status) {
+    return AS_ERROR;
+  }
+
+  return AS_OK;
+}
+
+ANLStatus LoadRootFrame::mod_finalize()
+{
+  // the reader thread refers to the frame owned by another module.
+  prefetchQueue_.reset();
+  return AS_OK;
+}
+
+bool LoadRootFrame::readEntry(std::size_t frameIndex, image_t& image)
+{
+  if (frametree_->GetEntry(frameIndex) <= 0) {
+    std::cout << "LoadRootFrame: entry " << frameIndex << " cannot be read." << std::endl;
+    return false;
+  }
 
   const int nx = frame_->NumPixelsX();
   const int ny = frame_->NumPixelsX();
-  image_t& rawFrame = frame_->getRawFrame();
   for (int i=0; i<nx; i++) {
     for (int j=0; j<ny; j++) {
-      rawFrame[i][j] = static_cast<double>(rawPH_[i][j]);
+      image[i][j] = static_cast<double>(rawPH_[i][j]);
     }
   }
+  return true;
+}
 
-  return AS_OK;
+void LoadRootFrame::requestPrefetch()
+{
+  while (numPrefetchRequested_ < numEntries_ && !prefetchQueue_->isFull()) {
+    const std::size_t frameIndex = numPrefetchRequested_;
+    prefetchQueue_->push([this, frameIndex](image_t& image) {
+        return readEntry(frameIndex, image);
+      });
+    ++numPrefetchRequested_;
+  }
+}
+
+bool LoadRootFrame::loadPrefetchedFrame(std::size_t frameIndex)
+{
+  // frames of the loops in which this module was not called are discarded.
+  bool status = false;
+  while (numPrefetchPopped_ <= frameIndex) {
+    requestPrefetch();
+    status = prefetchQueue_->pop(spareRawFrame_);
+    ++numPrefetchPopped_;
+  }
+  requestPrefetch();
+
+  if (status) {
+    frame_->swapRawFrame(spareRawFrame_);
+  }
+  return status;
 }
 
 } /* namespace comptonsoft */
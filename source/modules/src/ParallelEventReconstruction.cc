@@ -0,0 +1,182 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ParallelEventReconstruction.hh"
+
+#include <algorithm>
+#include <thread>
+#include "TChain.h"
+#include "DetectorHit.hh"
+#include "BasicComptonEvent.hh"
+#include "EventTreeIOWithInitialInfo.hh"
+#include "EventReconstructionThreadPool.hh"
+#include "CSHitCollection.hh"
+
+using namespace anlnext;
+
+namespace comptonsoft
+{
+
+ParallelEventReconstruction::ParallelEventReconstruction()
+  : anlgeant4::InitialInformation(false),
+    numThreads_(std::thread::hardware_concurrency()),
+    batchSize_(1024),
+    tree_(nullptr),
+    treeIO_(new EventTreeIOWithInitialInfo)
+{
+  add_alias("InitialInformation");
+}
+
+ParallelEventReconstruction::~ParallelEventReconstruction() = default;
+
+ANLStatus ParallelEventReconstruction::mod_define()
+{
+  EventReconstruction::mod_define();
+  define_parameter("file_list", &mod_class::fileList_);
+  define_parameter("num_threads", &mod_class::numThreads_);
+  define_parameter("batch_size", &mod_class::batchSize_);
+  return AS_OK;
+}
+
+ANLStatus ParallelEventReconstruction::mod_initialize()
+{
+  const ANLStatus status = EventReconstruction::mod_initialize();
+  if (status != AS_OK) {
+    return status;
+  }
+
+  if (numThreads_ < 1) {
+    numThreads_ = 1;
+  }
+  if (batchSize_ < 1) {
+    std::cout << "ParallelEventReconstruction: batch_size must be positive." << std::endl;
+    return AS_QUIT_ERROR;
+  }
+
+  tree_ = new TChain("eventtree");
+  for (const std::string& filename: fileList_) {
+    tree_->Add(filename.c_str());
+  }
+
+  treeIO_->setTree(tree_);
+  if (tree_->GetBranch("ini_energy")) {
+    setInitialInformationStored();
+    treeIO_->enableInitialInfoRecord();
+  }
+  else {
+    treeIO_->disableInitialInfoRecord();
+  }
+  treeIO_->setBranchAddresses();
+
+  numEntries_ = tree_->GetEntries();
+  std::cout << "Number of entries: " << numEntries_ << std::endl;
+
+  threadPool_.reset(new EventReconstructionThreadPool(ReconstructionAlgorithm(), numThreads_));
+  std::cout << "Number of reconstruction threads: " << threadPool_->NumberOfThreads() << std::endl;
+
+  return AS_OK;
+}
+
+ANLStatus ParallelEventReconstruction::mod_analyze()
+{
+  if (batchIndex_ == inputEvents_.size()) {
+    if (!readNextBatch()) {
+      return AS_QUIT;
+    }
+  }
+
+  initializeEvent();
+
+  const std::size_t index = batchIndex_;
+  ++batchIndex_;
+
+  const InputEvent& inputEvent = inputEvents_[index];
+  setEventID(inputEvent.eventID);
+
+  if (InitialInformationStored()) {
+    setInitialEnergy(inputEvent.initialEnergy);
+    setInitialDirection(inputEvent.initialDirection);
+    setInitialTime(inputEvent.initialTime);
+    setInitialPosition(inputEvent.initialPosition);
+    setInitialPolarization(inputEvent.initialPolarization);
+  }
+
+  if (WeightStored()) {
+    setWeight(inputEvent.weight);
+  }
+
+  const std::vector<DetectorHit_sptr>& hits = hitsBatch_[index];
+  for (const auto& hit: hits) {
+    getHitCollection()->insertHit(hit);
+  }
+  determineHitPatterns(hits);
+
+  for (const auto& event: eventsReconstructed_[index]) {
+    pushReconstructedEvent(event);
+  }
+
+  if (results_[index]) {
+    set_evs("EventReconstruction:OK");
+  }
+  else {
+    set_evs("EventReconstruction:NG");
+    return AS_SKIP;
+  }
+
+  return AS_OK;
+}
+
+bool ParallelEventReconstruction::readNextBatch()
+{
+  if (entryIndex_ >= numEntries_) {
+    return false;
+  }
+
+  const std::size_t n = std::min<int64_t>(batchSize_, numEntries_-entryIndex_);
+  inputEvents_.resize(n);
+  hitsBatch_.resize(n);
+  baseEvents_.assign(n, BaseEvent());
+
+  for (std::size_t i=0; i<n; i++) {
+    treeIO_->getEntry(entryIndex_);
+
+    InputEvent& inputEvent = inputEvents_[i];
+    inputEvent.eventID = treeIO_->getEventID();
+    if (InitialInformationStored()) {
+      inputEvent.initialEnergy = treeIO_->getInitialEnergy();
+      inputEvent.initialDirection = treeIO_->getInitialDirection();
+      inputEvent.initialTime = treeIO_->getInitialTime();
+      inputEvent.initialPosition = treeIO_->getInitialPosition();
+      inputEvent.initialPolarization = treeIO_->getInitialPolarization();
+    }
+    if (WeightStored()) {
+      inputEvent.weight = treeIO_->getWeight();
+    }
+
+    hitsBatch_[i] = treeIO_->retrieveHits(entryIndex_, false);
+    baseEvents_[i].setHitPattern(calculateHitPatternFlags(hitsBatch_[i]));
+  }
+
+  threadPool_->reconstruct(hitsBatch_, baseEvents_, eventsReconstructed_, results_);
+  batchIndex_ = 0;
+
+  return true;
+}
+
+} /* namespace comptonsoft */
@@ -96,6 +96,7 @@ ANLStatus ProcessCodedAperture::mod_define()
   define_parameter("sky_offset_y", &mod_class::skyOffsetY_, unit::degree, "degree");
   define_parameter("num_decoding_iterations", &mod_class::numDecodingIterations_);
   define_parameter("decoding_mode", &mod_class::decodingMode_);
+  set_parameter_description("1: sampling on sky coordinate, 2: sampling on aperture coordinate, 3: FFT cross-correlation, 4: precomputed projection matrix");
   define_parameter("pattern_file", &mod_class::patternFile_);
   define_parameter("image_owner_module", &mod_class::imageOwnerModule_);
   define_parameter("output_name", &mod_class::outputName_);
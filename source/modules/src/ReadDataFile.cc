@@ -18,6 +18,8 @@
  *************************************************************************/
 
 #include "ReadDataFile.hh"
+#include <algorithm>
+#include "DataFileStream.hh"
 
 using namespace anlnext;
 
@@ -25,14 +27,21 @@ namespace comptonsoft
 {
 
 ReadDataFile::ReadDataFile()
-  : m_EventID(0), m_Time(0)
+  : m_EventID(0), m_Time(0),
+    m_ChunkSize(16), m_BackgroundRead(true)
 {
   add_alias("ReadDataFile");
 }
 
+ReadDataFile::~ReadDataFile() = default;
+
 ANLStatus ReadDataFile::mod_define()
 {
   register_parameter(&m_FileList, "file_list");
+  register_parameter(&m_ChunkSize, "chunk_size");
+  set_parameter_description("Size of chunks in which binary data files are read (MB)");
+  register_parameter(&m_BackgroundRead, "background_read");
+  set_parameter_description("If true, binary data files are read in a background thread.");
   return AS_OK;
 }
 
@@ -56,4 +65,35 @@ bool ReadDataFile::checkFiles()
   return true;
 }
 
+void ReadDataFile::openStream()
+{
+  std::vector<std::string> files(m_FileIterator, m_FileList.cend());
+  m_FileIterator = m_FileList.end();
+
+  const std::size_t chunkSize = static_cast<std::size_t>(std::max(m_ChunkSize, 1)) << 20;
+  m_Stream.reset(new DataFileStream(chunkSize, m_BackgroundRead));
+  m_Stream->open(files);
+}
+
+const unsigned char* ReadDataFile::readPacket(std::size_t size, bool continued)
+{
+  return reinterpret_cast<const unsigned char*>(m_Stream->read(size, continued));
+}
+
+ANLStatus ReadDataFile::mod_finalize()
+{
+  if (m_Stream) {
+    const double elapsed = m_Stream->ElapsedTime();
+    std::cout << "ReadDataFile: " << m_Stream->NumberOfPackets() << " packets, "
+              << m_Stream->NumberOfBytes() << " bytes in " << elapsed << " s";
+    if (elapsed > 0.0) {
+      std::cout << " (" << m_Stream->NumberOfBytes()/elapsed*1.0e-6 << " MB/s, "
+                << m_Stream->NumberOfPackets()/elapsed << " packets/s)";
+    }
+    std::cout << std::endl;
+    m_Stream->close();
+  }
+  return AS_OK;
+}
+
 } /* namespace comptonsoft */
@@ -21,6 +21,9 @@
 
 #include <iostream>
 #include <iomanip>
+#include <array>
+#include <algorithm>
+#include <cstring>
 
 #include "ReadoutModule.hh"
 #include "MultiChannelData.hh"
@@ -30,8 +33,80 @@ using namespace anlnext;
 namespace comptonsoft
 {
 
+namespace {
+
+/*
+ * reader of a bit stream packed into 32-bit words from the most significant bit.
+ * Bits beyond the end of the stream are read as zero.
+ */
+class BitStreamReader
+{
+public:
+  BitStreamReader(const uint32_t* words, size_t numWords)
+    : word_(words), end_(words+numWords)
+  {
+    refill();
+  }
+
+  /* read n bits (1 <= n <= 32); the first bit becomes the most significant bit */
+  uint32_t read(int n)
+  {
+    const uint32_t v = static_cast<uint32_t>(buffer_ >> (64-n));
+    buffer_ <<= n;
+    numBits_ = std::max(numBits_-n, 0);
+    refill();
+    return v;
+  }
+
+  void skip(int n) { read(n); }
+
+private:
+  void refill()
+  {
+    while (numBits_ <= 32 && word_ != end_) {
+      buffer_ |= static_cast<uint64_t>(*word_) << (32-numBits_);
+      numBits_ += 32;
+      ++word_;
+    }
+  }
+
+private:
+  const uint32_t* word_;
+  const uint32_t* end_;
+  uint64_t buffer_ = 0;
+  int numBits_ = 0;
+};
+
+constexpr int ADCResolution = 10;
+
+/* ADC values are sent from the least significant bit. */
+std::array<uint16_t, (1<<ADCResolution)> make_bit_reversal_table()
+{
+  std::array<uint16_t, (1<<ADCResolution)> table;
+  for (uint32_t v=0; v<table.size(); v++) {
+    uint16_t r = 0;
+    for (int b=0; b<ADCResolution; b++) {
+      r |= ((v >> b) & 1u) << (ADCResolution-1-b);
+    }
+    table[v] = r;
+  }
+  return table;
+}
+
+const std::array<uint16_t, (1<<ADCResolution)> ADCBitReversal = make_bit_reversal_table();
+
+inline uint16_t read_adc(BitStreamReader& bits)
+{
+  return ADCBitReversal[bits.read(ADCResolution)];
+}
+
+} /* anonymous namespace */
+
 ReadDataFile_NB0::ReadDataFile_NB0()
-  : m_NewFrame(true),
+  : m_HKBuf(nullptr),
+    m_FrameBuf(nullptr),
+    m_NewFrame(true),
+    m_PtrFrame(nullptr),
     m_EventLength(1024)
 {
 }
@@ -63,45 +138,25 @@ ANLStatus ReadDataFile_NB0::mod_begin_run()
     return AS_QUIT;
   }
   
-  std::string filename = nextFile();
-  m_fin.open(filename.c_str());
-  if (!m_fin) {
-    std::cout << "ReadDataFile: cannot open " << filename << std::endl;
-    return AS_QUIT;
-  }
+  openStream();
   return AS_OK;
 }
 
 ANLStatus ReadDataFile_NB0::mod_analyze()
 {
-  unsigned int tmp;
-
- read_start:
   if (m_NewFrame) {
     m_NewFrame = false;
-    m_fin.read((char*)&tmp, sizeof(int));
+    const unsigned char* packet = readPacket(sizeof(uint32_t));
 
-    if (m_fin.eof()) {
-      std::cout << "ReadDataFile: reach end of file" << std::endl;
-      m_fin.close();
+    if (packet == nullptr) {
+      std::cout << "ReadDataFile: the last file was processed." << std::endl;
       m_NewFrame = true;
-
-      if (wasLastFile()) {
-        std::cout << "ReadDataFile: the last file was processed." << std::endl;
-        return AS_QUIT;
-      }
-      else {
-        std::string filename = nextFile();
-        m_fin.open(filename.c_str());
-        if (!m_fin) {
-          std::cout << "ReadDataFile: cannot open " << filename << std::endl;
-          return AS_QUIT;
-        }
-        std::cout << "ReadDataFile: open next file." << std::endl;
-        goto read_start;
-      }
+      return AS_QUIT;
     }
 
+    uint32_t tmp;
+    std::memcpy(&tmp, packet, sizeof(uint32_t));
+
     if ((tmp&0x00FFFFFF) != 0x00efcdab) {
       m_NewFrame = true;
       return AS_SKIP;
@@ -139,7 +194,12 @@ ANLStatus ReadDataFile_NB0::mod_analyze()
 
 bool ReadDataFile_NB0::readHK()
 {
-  m_fin.read((char*)m_HKBuf, HK_LENGTH*sizeof(int));
+  const unsigned char* packet = readPacket(HK_LENGTH*sizeof(uint32_t), true);
+  if (packet == nullptr) {
+    return false;
+  }
+
+  m_HKBuf = reinterpret_cast<const uint32_t*>(packet);
   if (m_HKBuf[HK_LENGTH-1]==0x2301FFFF) {
     ;
   }
@@ -153,7 +213,12 @@ bool ReadDataFile_NB0::readHK()
 
 bool ReadDataFile_NB0::readFrame()
 {
-  m_fin.read((char*)m_FrameBuf, FRAME_LENGTH*sizeof(int));
+  const unsigned char* packet = readPacket(FRAME_LENGTH*sizeof(uint32_t), true);
+  if (packet == nullptr) {
+    return false;
+  }
+
+  m_FrameBuf = reinterpret_cast<const uint32_t*>(packet);
   if (m_FrameBuf[FRAME_LENGTH-1]==0x2301FFFF) {
     m_UnixTime = m_FrameBuf[FRAME_LENGTH-2];
   }
@@ -165,20 +230,21 @@ bool ReadDataFile_NB0::readFrame()
   return true;
 }
 
-uint32_t* ReadDataFile_NB0::readEvent(uint32_t* pEvent)
+const uint32_t* ReadDataFile_NB0::readEvent(const uint32_t* pEvent)
 {
   const size_t EventLength = m_EventLength;
-  uint32_t* p = pEvent;
+  const uint32_t* p = pEvent;
   
-  size_t j = 0;
-  while ((*p & 0xFFFF0000)!=0x3c3c0000 && j<FRAME_LENGTH) {
+  // j is counted from the frame start, so that the scan never goes beyond the frame.
+  size_t j = p - m_FrameBuf;
+  while (j<FRAME_LENGTH && (*p & 0xFFFF0000)!=0x3c3c0000) {
     ++p;
     ++j;
   }
   
   size_t i=0;
-  unsigned int* pBit = m_DataBitBuf;
-  while ((*p & 0x0000FFFF)!=0x00007777 && i<EventLength && j<FRAME_LENGTH) {
+  const uint32_t* data = nullptr;
+  while (j<FRAME_LENGTH && (*p & 0x0000FFFF)!=0x00007777 && i<EventLength) {
     if (i==0) {
       ;
     }
@@ -195,10 +261,8 @@ uint32_t* ReadDataFile_NB0::readEvent(uint32_t* pEvent)
       m_TrigHitPat = *p;
       m_ADCClkCnt = 0;
     }
-    else {
-      for (int ib=0; ib<32; ++ib) {
-        *(pBit++) = (*p >> (31-ib)) & 0x00000001;
-      }
+    else if (i==5) {
+      data = p;
     }
     
     ++p;
@@ -206,7 +270,8 @@ uint32_t* ReadDataFile_NB0::readEvent(uint32_t* pEvent)
     ++i;
   }
 
-  decodeASICData();
+  const size_t dataLength = (i>5) ? i-5 : 0;
+  decodeASICData(data, dataLength);
 
   if (j>=FRAME_LENGTH) {
     p = m_FrameBuf;
@@ -216,9 +281,9 @@ uint32_t* ReadDataFile_NB0::readEvent(uint32_t* pEvent)
   return p;
 }
 
-void ReadDataFile_NB0::decodeASICData()
+void ReadDataFile_NB0::decodeASICData(const uint32_t* data, size_t length)
 {
-  const uint32_t* p = m_DataBitBuf;
+  BitStreamReader bits(data, length);
   
   DetectorSystem* detectorManager = getDetectorManager();
   for (auto& readoutModule: detectorManager->getReadoutModules()) {
@@ -227,39 +292,28 @@ void ReadDataFile_NB0::decodeASICData()
       const int nCh = mcd->NumberOfChannels();
       mcd->resetRawADCVector();
       
-      std::vector<unsigned int> indexVec;
-      p += 5;
-      for (int l=0; l<nCh; l++) {
-        uint32_t flag = *(p++);
-        if (flag) {
-          indexVec.push_back(l);
+      m_HitChannels.clear();
+      bits.skip(5);
+      for (int l=0; l<nCh; l+=32) {
+        const int n = std::min(32, nCh-l);
+        uint32_t flags = bits.read(n) << (32-n);
+        while (flags) {
+          const int k = __builtin_clz(flags);
+          m_HitChannels.push_back(l+k);
+          flags ^= 0x80000000u >> k;
         }
       }
-      ++p;
+      bits.skip(1);
       
-      const int ADCRes = 10;
-      uint16_t ref = 0;
-      for (int b=0; b<ADCRes; b++) {
-        ref += *(p++) << b;
-      }
-      mcd->setReferenceLevel(ref);
+      mcd->setReferenceLevel(read_adc(bits));
       
-      const int hitnum = indexVec.size();
-      for (int i=0; i<hitnum; i++) {
-        uint16_t adc = 0;
-        for (int b=0; b<ADCRes; b++) {
-          adc += *(p++) << b;
-        }
-        mcd->setRawADC(indexVec[i], adc);
+      for (const int channel: m_HitChannels) {
+        mcd->setRawADC(channel, read_adc(bits));
       }
       
-      uint16_t cmn = 0;
-      for (int b=0; b<ADCRes; b++) {
-        cmn += *(p++) << b;
-      }
-      mcd->setCommonModeNoise(cmn);
+      mcd->setCommonModeNoise(read_adc(bits));
       
-      ++p;
+      bits.skip(1);
     }
   }
 }
@@ -66,11 +66,6 @@ ANLStatus ReadDataFile_VME3::mod_initialize()
   std::cout << std::endl;
   std::cout << "Data size: " << readPacketSize << std::endl;
 
-  if (readPacketSize > READ_BUF_SIZE) {
-    std::cout << "Read buffer is too small." << std::endl;
-    return AS_QUIT;
-  }
-
   m_ReadPacketSize = readPacketSize;
 
   return AS_OK;
@@ -83,43 +78,19 @@ ANLStatus ReadDataFile_VME3::mod_begin_run()
     return AS_QUIT;
   }
   
-  std::string filename = nextFile();
-  m_fin.open(filename.c_str());
-  if (!m_fin) {
-    std::cout << "ReadDataFile: cannot open " << filename << std::endl;
-    return AS_QUIT;
-  }
+  openStream();
   return AS_OK;
 }
 
 ANLStatus ReadDataFile_VME3::mod_analyze()
 {
-  static unsigned char buf[READ_BUF_SIZE];
-  
- read_start:
-  m_fin.read((char*)buf, m_ReadPacketSize);
-
-  if (m_fin.eof()) {
-    std::cout << "ReadDataFile: reach end of file." << std::endl;
-    m_fin.close();
-
-    if (wasLastFile()) {
-      std::cout << "ReadDataFile: the last file was processed." << std::endl;
-      return AS_QUIT;
-    }
-    else {
-      std::string filename = nextFile();
-      m_fin.open(filename.c_str());
-      if (!m_fin) {
-        std::cout << "ReadDataFile: cannot open " << filename << std::endl;
-        return AS_QUIT;
-      }
-      std::cout << "ReadDataFile: open next file." << std::endl;
-      goto read_start;
-    }
+  const unsigned char* buf = readPacket(m_ReadPacketSize);
+  if (buf == nullptr) {
+    std::cout << "ReadDataFile: the last file was processed." << std::endl;
+    return AS_QUIT;
   }
 
-  unsigned char* p = buf;
+  const unsigned char* p = buf;
 
   // read Header of one event
   //p += 4;
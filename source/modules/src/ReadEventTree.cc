@@ -41,6 +41,8 @@ ReadEventTree::~ReadEventTree() = default;
 ANLStatus ReadEventTree::mod_define()
 {
   register_parameter(&fileList_, "file_list");
+  register_parameter(&branches_, "branches");
+  set_parameter_description("Branches to be read in addition to eventid and num_hits. If empty, all the branches are read.");
   return AS_OK;
 }
 
@@ -64,6 +66,11 @@ ANLStatus ReadEventTree::mod_initialize()
     treeIO_->disableInitialInfoRecord();
   }
   treeIO_->setBranchAddresses();
+  if (!branches_.empty()) {
+    std::vector<std::string> branches(branches_);
+    branches.push_back("eventid");
+    treeIO_->readOnlyBranches(branches);
+  }
 
   numEntries_ = tree_->GetEntries();
   std::cout << "Number of entries: " << numEntries_ << std::endl;
@@ -75,7 +82,7 @@ ANLStatus ReadEventTree::mod_begin_run()
 {
   if (numEntries_ == 0) { return AS_OK; }
   
-  tree_->GetEntry(0);
+  treeIO_->getEntry(0);
   const int64_t EventID = treeIO_->getEventID();
   setEventID(EventID);
 
@@ -88,7 +95,7 @@ ANLStatus ReadEventTree::mod_analyze()
     return AS_QUIT;
   }
 
-  tree_->GetEntry(entryIndex_);
+  treeIO_->getEntry(entryIndex_);
 
   const int64_t EventID = treeIO_->getEventID();
   setEventID(EventID);
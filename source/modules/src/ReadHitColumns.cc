@@ -0,0 +1,114 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "ReadHitColumns.hh"
+#include "DetectorHit.hh"
+#include "HitColumnStore.hh"
+#include "CSHitCollection.hh"
+
+using namespace anlnext;
+
+namespace comptonsoft
+{
+
+ReadHitColumns::ReadHitColumns()
+  : anlgeant4::InitialInformation(false),
+    directory_("hit_columns"),
+    hitCollection_(nullptr),
+    store_(new HitColumnStoreReader)
+{
+  add_alias("InitialInformation");
+}
+
+ReadHitColumns::~ReadHitColumns() = default;
+
+ANLStatus ReadHitColumns::mod_define()
+{
+  define_parameter("directory", &mod_class::directory_);
+  set_parameter_description("Directory of the column files");
+  return AS_OK;
+}
+
+ANLStatus ReadHitColumns::mod_initialize()
+{
+  VCSModule::mod_initialize();
+  
+  get_module_NC("CSHitCollection", &hitCollection_);
+
+  if (!store_->open(directory_)) {
+    std::cout << "ReadHitColumns: cannot open a store in " << directory_ << std::endl;
+    return AS_QUIT_ERROR;
+  }
+
+  if (store_->hasInitialInfo()) {
+    setInitialInformationStored();
+    setWeightStored();
+  }
+
+  numEntries_ = store_->NumberOfEvents();
+  std::cout << "Number of entries: " << numEntries_ << std::endl;
+
+  return AS_OK;
+}
+
+ANLStatus ReadHitColumns::mod_begin_run()
+{
+  if (numEntries_ == 0) { return AS_OK; }
+
+  setEventID(store_->EventID(0));
+
+  return AS_OK;
+}
+
+ANLStatus ReadHitColumns::mod_analyze()
+{
+  if (entryIndex_ == numEntries_) {
+    return AS_QUIT;
+  }
+
+  setEventID(store_->EventID(entryIndex_));
+
+  if (InitialInformationStored()) {
+    setInitialEnergy(store_->InitialEnergy(entryIndex_));
+    setInitialDirection(store_->InitialDirection(entryIndex_));
+    setInitialTime(store_->InitialTime(entryIndex_));
+    setInitialPosition(store_->InitialPosition(entryIndex_));
+    setInitialPolarization(store_->InitialPolarization(entryIndex_));
+  }
+  
+  if (WeightStored()) {
+    setWeight(store_->Weight(entryIndex_));
+  }
+
+  std::vector<DetectorHit_sptr> hits = store_->retrieveHits(entryIndex_);
+  for (auto& hit: hits) {
+    insertHit(hit);
+  }
+
+  ++entryIndex_;
+  
+  return AS_OK;
+}
+
+void ReadHitColumns::insertHit(const DetectorHit_sptr& hit)
+{
+  hitCollection_->insertHit(hit);
+}
+
+} /* namespace comptonsoft */
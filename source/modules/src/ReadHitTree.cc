@@ -19,9 +19,11 @@
  *************************************************************************/
 
 #include "ReadHitTree.hh"
+#include "TROOT.h"
 #include "TChain.h"
 #include "DetectorHit.hh"
 #include "HitTreeIOWithInitialInfo.hh"
+#include "HitTreeBlockReader.hh"
 #include "CSHitCollection.hh"
 
 using namespace anlnext;
@@ -44,6 +46,10 @@ ANLStatus ReadHitTree::mod_define()
 {
   register_parameter(&fileList_, "file_list");
   register_parameter(&trustNumHits_, "trust_num_hits");
+  register_parameter(&blockSize_, "block_size");
+  set_parameter_description("Number of entries read at once. If 0, entries are read one by one.");
+  register_parameter(&backgroundRead_, "background_read");
+  set_parameter_description("If true, the next block is read in a background thread while the current event is being analyzed. Valid only if block_size is positive.");
   return AS_OK;
 }
 
@@ -72,6 +78,10 @@ ANLStatus ReadHitTree::mod_initialize()
   numEntries_ = hittree_->GetEntries();
   std::cout << "Number of entries: " << numEntries_ << std::endl;
 
+  if (blockSize_ > 0 && backgroundRead_) {
+    ROOT::EnableThreadSafety();
+  }
+
   return AS_OK;
 }
 
@@ -83,11 +93,19 @@ ANLStatus ReadHitTree::mod_begin_run()
   const int64_t EventID = treeIO_->getEventID();
   setEventID(EventID);
 
+  if (blockSize_ > 0 && !blockReader_) {
+    blockReader_.reset(new HitTreeBlockReader(treeIO_.get(), numEntries_, blockSize_, backgroundRead_));
+  }
+
   return AS_OK;
 }
 
 ANLStatus ReadHitTree::mod_analyze()
 {
+  if (blockReader_) {
+    return readEventFromBlocks();
+  }
+
   if (entryIndex_ == numEntries_) {
     return AS_QUIT;
   }
@@ -130,6 +148,42 @@ ANLStatus ReadHitTree::mod_analyze()
   return AS_OK;
 }
 
+ANLStatus ReadHitTree::readEventFromBlocks()
+{
+  std::vector<DetectorHit_sptr> hits;
+  if (!blockReader_->retrieveHits(hits, trustNumHits_)) {
+    return AS_QUIT;
+  }
+
+  setEventID(blockReader_->EventID());
+
+  const HitTreeBlock::InitialInfo& info = blockReader_->getInitialInfo();
+  if (InitialInformationStored()) {
+    setInitialEnergy(info.energy);
+    setInitialDirection(info.direction);
+    setInitialTime(info.time);
+    setInitialPosition(info.position);
+    setInitialPolarization(info.polarization);
+  }
+  
+  if (WeightStored()) {
+    setWeight(info.weight);
+  }
+
+  for (auto& hit: hits) {
+    insertHit(hit);
+  }
+  entryIndex_ += hits.size();
+
+  return AS_OK;
+}
+
+ANLStatus ReadHitTree::mod_finalize()
+{
+  blockReader_.reset();
+  return AS_OK;
+}
+
 void ReadHitTree::insertHit(const DetectorHit_sptr& hit)
 {
   hitCollection_->insertHit(hit);
@@ -20,6 +20,7 @@
 #include "SetPedestalsByMedian.hh"
 #include "FrameData.hh"
 #include "ConstructFrame.hh"
+#include "SlidingWindowMedian.hh"
 
 using namespace anlnext;
 
@@ -30,6 +31,8 @@ SetPedestalsByMedian::SetPedestalsByMedian()
 {
 }
 
+SetPedestalsByMedian::~SetPedestalsByMedian() = default;
+
 ANLStatus SetPedestalsByMedian::mod_define()
 {
   define_parameter("detector_id", &mod_class::detectorID_);
@@ -53,69 +56,42 @@ ANLStatus SetPedestalsByMedian::mod_begin_run()
     return AS_QUIT;
   }
 
+  if (frameBin_ < 1 || frameBin_ > SlidingWindowMedian::MaxWindowSize) {
+    std::cout << "SetPedestalsByMedian: frame_bin must be between 1 and "
+              << SlidingWindowMedian::MaxWindowSize << "." << std::endl;
+    return AS_QUIT;
+  }
+
   nx_ = frameData_->NumPixelsX();
   ny_ = frameData_->NumPixelsY();
-  frameStack_.resize(boost::extents[nx_][ny_]);
+  medians_.reset(new SlidingWindowMedian(static_cast<std::size_t>(nx_)*ny_, frameBin_));
 
   return AS_OK;
 }
 
 ANLStatus SetPedestalsByMedian::mod_analyze()
 {
+  // The window of frame IDs [frameID-frameBin+1, frameID] is kept in slots
+  // indexed by frameID % frameBin; frame IDs are assumed to be consecutive.
   const int frameID = frameData_->FrameID();
   image_t& pedestals = frameData_->getPedestals();
   image_t& rawFrame = frameData_->getRawFrame();
 
   if (frameID<frameBin_) {
     frameData_->setBadFrame(true);
-    for (int ix=0; ix<nx_; ix++){
-      for (int iy=0; iy<ny_; iy++){
-        frameStack_[ix][iy].emplace_back(frameID, rawFrame[ix][iy]);
-      }
-    }
+    medians_->fill(frameID, rawFrame.origin());
   }
 
   if (frameID==frameBin_) {
     frameData_->setBadFrame(false);
-    for (int ix=0; ix<nx_; ix++){
-      for (int iy=0; iy<ny_; iy++){
-        auto comp = [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
-                      return a.second < b.second;
-                    };
-        std::sort(frameStack_[ix][iy].begin(), frameStack_[ix][iy].end(), comp);          
-      }
-    }
+    medians_->build();
   }
 
   if (frameID>=frameBin_) {
-    for (int ix=0; ix<nx_; ix++){
-      for (int iy=0; iy<ny_; iy++){
-        frameStack_[ix][iy].erase(remove_if(frameStack_[ix][iy].begin(), frameStack_[ix][iy].end(),
-                                            [frameID, this](std::pair<int, double> x) { return x.first==frameID-frameBin_; }), 
-                                  frameStack_[ix][iy].end());
-        const std::pair<int, double> p = std::make_pair(frameID, rawFrame[ix][iy]);
-        auto comp = [](const std::pair<int, double>& a, const std::pair<int, double>& b){
-          return a.second < b.second;
-        };
-        auto it = std::upper_bound(frameStack_[ix][iy].begin(), frameStack_[ix][iy].end(), p, comp);
-        frameStack_[ix][iy].insert(it, p);
-        pedestals[ix][iy] = calculateMedian(frameStack_[ix][iy]);
-      }
-    }
+    medians_->replace(frameID%frameBin_, rawFrame.origin(), pedestals.origin());
   }
 
   return AS_OK;
 }
 
-double SetPedestalsByMedian::calculateMedian(std::vector<std::pair<int, double>>& v)
-{
-  const size_t size = v.size();
-  if (size%2==1) {
-    return v[size/2].second;
-  }
-  else {
-    return 0.5 * (v[size/2].second + v[size/2-1].second);
-  }
-}
-
 } /* namespace comptonsoft */
@@ -22,8 +22,11 @@
 #include "DetectorHit.hh"
 #include "EventTreeIOWithInitialInfo.hh"
 #include "CSHitCollection.hh"
+#include "ExternalTimeSorter.hh"
 
 #include <vector>
+#include <limits>
+#include <boost/filesystem.hpp>
 
 using namespace anlnext;
 
@@ -43,6 +46,12 @@ SortEventTreeWithTime::~SortEventTreeWithTime() = default;
 ANLStatus SortEventTreeWithTime::mod_define()
 {
   register_parameter(&fileList_, "file_list");
+  register_parameter(&externalSort_, "external_sort");
+  set_parameter_description("If true, only (time, entry) keys are sorted through temporary files, and events are read in time order.");
+  register_parameter(&memoryBudget_, "memory_budget");
+  set_parameter_description("Memory for the sort keys in MB (external sort only).");
+  register_parameter(&temporaryDirectory_, "temporary_directory");
+  set_parameter_description("Directory of temporary files. If empty, the system temporary directory is used.");
   return AS_OK;
 }
 
@@ -75,10 +84,14 @@ ANLStatus SortEventTreeWithTime::mod_initialize()
 
 ANLStatus SortEventTreeWithTime::mod_begin_run()
 {
+  if (externalSort_) {
+    return sortExternally();
+  }
+
   if (numEntries_ == 0) { return AS_OK; }
 
   while (entryIndex_ < numEntries_) {
-    tree_->GetEntry(entryIndex_);
+    treeIO_->getEntry(entryIndex_);
     eventList_.push_back( treeIO_->retrieveHits(entryIndex_, false) );
   }
 
@@ -90,8 +103,57 @@ ANLStatus SortEventTreeWithTime::mod_begin_run()
   return AS_OK;
 }
 
+ANLStatus SortEventTreeWithTime::sortExternally()
+{
+  if (memoryBudget_ < 1) {
+    std::cout << "SortEventTreeWithTime: memory_budget must be positive." << std::endl;
+    return AS_QUIT_ERROR;
+  }
+
+  const std::string directory = temporaryDirectory_.empty()
+    ? boost::filesystem::temp_directory_path().string()
+    : temporaryDirectory_;
+  sorter_.reset(new ExternalTimeSorter(static_cast<std::size_t>(memoryBudget_)*1024*1024, directory));
+
+  // only the hit times are read to make the keys.
+  treeIO_->readOnlyBranches({"real_time"});
+  for (int64_t entry=0; entry<numEntries_; entry++) {
+    treeIO_->getEntry(entry);
+    // events without hits are placed at the beginning.
+    const double time = (treeIO_->getNumberOfHits() > 0)
+      ? treeIO_->getRealTime(0)
+      : -std::numeric_limits<double>::infinity();
+    if (!sorter_->add(time, entry)) {
+      return AS_QUIT_ERROR;
+    }
+  }
+  treeIO_->readAllBranches();
+
+  if (!sorter_->finish()) {
+    return AS_QUIT_ERROR;
+  }
+  std::cout << "SortEventTreeWithTime: " << sorter_->NumberOfKeys() << " events sorted with "
+            << sorter_->NumberOfRuns() << " run files." << std::endl;
+
+  return AS_OK;
+}
+
 ANLStatus SortEventTreeWithTime::mod_analyze()
 {
+  if (sorter_) {
+    ExternalTimeSorter::Key key;
+    if (!sorter_->next(key)) {
+      return AS_QUIT;
+    }
+
+    int64_t entry = key.entry;
+    const std::vector<DetectorHit_sptr> hits = treeIO_->retrieveHits(entry);
+    for (auto& hit: hits) {
+      insertHit(hit);
+    }
+    return AS_OK;
+  }
+
   if (eventIter_ == eventList_.end()) {
     return AS_QUIT;
   }
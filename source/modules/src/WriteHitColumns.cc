@@ -0,0 +1,118 @@
+/*************************************************************************
+ *                                                                       *
+ * Copyright (c) 2011 Hirokazu Odaka                                     *
+ *                                                                       *
+ * This program is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                       *
+ *************************************************************************/
+
+#include "WriteHitColumns.hh"
+#include "InitialInformation.hh"
+#include "DetectorHit.hh"
+#include "HitColumnStore.hh"
+#include "CSHitCollection.hh"
+
+using namespace anlnext;
+
+namespace comptonsoft
+{
+
+WriteHitColumns::WriteHitColumns()
+  : directory_("hit_columns"),
+    store_(new HitColumnStoreWriter)
+{
+}
+
+WriteHitColumns::~WriteHitColumns() = default;
+
+ANLStatus WriteHitColumns::mod_define()
+{
+  define_parameter("directory", &mod_class::directory_);
+  set_parameter_description("Directory of the column files");
+  define_parameter("compression", &mod_class::compression_);
+  set_parameter_description("If true, integer columns are delta-encoded. They are then decoded into memory by the reader instead of being mapped.");
+  define_parameter("notice_undetected", &mod_class::notice_undetected_);
+  return AS_OK;
+}
+
+ANLStatus WriteHitColumns::mod_initialize()
+{
+  VCSModule::mod_initialize();
+
+  get_module("CSHitCollection", &hitCollection_);
+  define_evs("WriteHitColumns:Fill");
+  define_evs("WriteHitColumns:FillUndetected");
+
+  if (exist_module("InitialInformation")) {
+    get_module_IF("InitialInformation", &initialInfo_);
+  }
+
+  if (!store_->open(directory_, initialInfo_!=nullptr, compression_)) {
+    std::cout << "WriteHitColumns: cannot create a store in " << directory_ << std::endl;
+    return AS_QUIT_ERROR;
+  }
+
+  return AS_OK;
+}
+
+ANLStatus WriteHitColumns::mod_analyze()
+{
+  int64_t eventID = -1;
+  
+  if (initialInfo_) {
+    eventID = initialInfo_->EventID();
+    store_->setInitialInfo(initialInfo_->InitialEnergy(),
+                           initialInfo_->InitialDirection(),
+                           initialInfo_->InitialTime(),
+                           initialInfo_->InitialPosition(),
+                           initialInfo_->InitialPolarization());
+    store_->setWeight(initialInfo_->Weight());
+  }
+  else {
+    eventID = get_loop_index();
+  }
+
+  bool filled = false;
+  const int NumTimeGroups = hitCollection_->NumberOfTimeGroups();
+  for (int timeGroup=0; timeGroup<NumTimeGroups; timeGroup++) {
+    const std::vector<DetectorHit_sptr>& hits
+      = hitCollection_->getHits(timeGroup);
+    if (hits.size() > 0) {
+      store_->fillHits(eventID, hits);
+      filled = true;
+    }
+  }
+
+  if (filled) {
+    set_evs("WriteHitColumns:Fill");
+  }
+  else if (notice_undetected_) {
+    store_->fillHits(eventID, std::vector<DetectorHit_sptr>());
+    set_evs("WriteHitColumns:FillUndetected");
+  }
+
+  return AS_OK;
+}
+
+ANLStatus WriteHitColumns::mod_finalize()
+{
+  std::cout << "WriteHitColumns: " << store_->NumberOfEvents() << " events, "
+            << store_->NumberOfHits() << " hits" << std::endl;
+  if (!store_->close()) {
+    return AS_QUIT_ERROR;
+  }
+  return AS_OK;
+}
+
+} /* namespace comptonsoft */
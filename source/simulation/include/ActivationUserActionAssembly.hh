@@ -68,6 +68,8 @@ public:
   void TrackActionAtBeginning(const G4Track* track) override;
   void SteppingAction(const G4Step* step) override;
 
+  bool isMultithreadingSupported() const override { return false; }
+
   void createUserActions() override;
   
 protected:
@@ -45,6 +45,8 @@ public:
 
   void SteppingAction(const G4Step* aStep) override;
 
+  bool isMultithreadingSupported() const override { return false; }
+
   void SetTerminationTime(double v) { terminationTime_ = v; }
   double TerminationTime() const { return terminationTime_; }
 